@@ -98,8 +98,11 @@ int build_config( const char* hercules_cnf )
 
     /* Set max number device threads */
     sysblk.devtmax  = MAX_DEVICE_THREADS;
-    sysblk.devtwait = sysblk.devtnbr =
-    sysblk.devthwm  = sysblk.devtunavail = 0;
+    sysblk.devtnbr  = sysblk.devthwm = 0;
+
+    /* Set number of I/O request queues */
+    sysblk.numioq   = DEF_IOQS;
+    sysblk.ioqspin  = 0;
 
     /* Default the licence setting */
     losc_set( PGM_PRD_OS_RESTRICTED );
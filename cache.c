@@ -22,6 +22,23 @@ static int  cache_check(int ix, int i);
 static int  cache_isbusy(int ix, int i);
 static int  cache_isempty(int ix, int i);
 static void cache_allocbuf(int ix, int i, int len);
+static U32  cache_hash_key(int ix, U64 key);
+static void cache_hash_add(int ix, int i);
+static void cache_hash_del(int ix, int i);
+static void cache_ghost_add(int ix, U64 key);
+static int  cache_ghost_del(int ix, U64 key);
+static void cache_age_unlink(int ix, int i);
+static void cache_age_oldest(int ix, int i, int seg);
+static void cache_age_newest(int ix, int i, int seg);
+static int  cache_victim(int ix, CACHEOWN *own);
+static void cache_policy_locked(int ix);
+static CACHEOWN *cache_owner(int ix, U64 key, int add);
+static int  cache_own_grow(int ix);
+static void cache_own_count(int ix, U64 key, int n);
+static int  cache_quota_rule(int ix, U32 owner);
+static int  cache_quota_ok(int ix, int i, CACHEOWN *own);
+static void cache_quota_locked(int ix);
+static void cache_devstats(int ix);
 
 DISABLE_GCC_UNUSED_FUNCTION_WARNING;
 
@@ -30,6 +47,13 @@ DISABLE_GCC_UNUSED_FUNCTION_WARNING;
 /*-------------------------------------------------------------------*/
 static CACHEBLK  cacheblk[ CACHE_MAX_INDEX ] = {0};
 
+/* Replacement policy; survives the cache being destroyed */
+static int       cachepolicy[ CACHE_MAX_INDEX ] = {0};
+
+/* Quota rules; likewise survive the cache being destroyed */
+static CACHEQUOTA cachequota[ CACHE_MAX_INDEX ][ CACHE_MAX_QUOTA ];
+static int       cachenquota[ CACHE_MAX_INDEX ] = {0};
+
 #define OBTAIN_GLOBAL_CACHE_LOCK()   obtain_lock(  &sysblk.dasdcache_lock )
 #define RELEASE_GLOBAL_CACHE_LOCK()  release_lock( &sysblk.dasdcache_lock )
 
@@ -102,57 +126,170 @@ int cache_hit_percent (int ix)
 
 int cache_lookup (int ix, U64 key, int *oldest_entry)
 {
-    int i,p;
+    int i;
+    CACHEOWN *own;
 
     if (oldest_entry)
         *oldest_entry = -1;
     if (cache_check_ix(ix))
         return -1;
-    /* `p' is the preferred index */
-    p = (int)(key % cacheblk[ix].nbr);
+    own = cache_owner(ix, key, 1);
+
+    /* Search the hash chain for the key */
+    i = cacheblk[ix].hash[cache_hash_key(ix, key)];
+    if (i >= 0 && cacheblk[ix].cache[i].key == key)
+        cacheblk[ix].fasthits++;
+    else
+        while (i >= 0 && cacheblk[ix].cache[i].key != key)
+            i = cacheblk[ix].cache[i].hnext;
 
-    if (cacheblk[ix].cache[p].key == key)
+    if (i >= 0)
     {
-        i = p;
-        if (!cache_isempty(ix, i))
-        {
-            cacheblk[ix].fasthits++;
-        }
+        cacheblk[ix].hits++;
+        if (own) own->hits++;
+        return i;
     }
-    else
+    cacheblk[ix].misses++;
+    if (own) own->misses++;
+
+    if (oldest_entry)
+        *oldest_entry = cache_victim(ix, own);
+    return -1;
+}
+
+int cache_getpolicy (int ix)
+{
+    if (cache_check_ix(ix)) return -1;
+    return cachepolicy[ix];
+}
+
+int cache_setpolicy (int ix, int policy)
+{
+    int oldpolicy;
+    int created;
+
+    if (cache_check_ix(ix)
+     || (policy != CACHE_POLICY_LRU && policy != CACHE_POLICY_2Q))
+        return -1;
+
+    OBTAIN_GLOBAL_CACHE_LOCK();
     {
-        if (cache_isbusy(ix, p) || cacheblk[ix].age - cacheblk[ix].cache[p].age < 20)
-            p = -2;
-        for (i = 0; i < cacheblk[ix].nbr; i++)
+        oldpolicy = cachepolicy[ix];
+        cachepolicy[ix] = policy;
+        created = cacheblk[ix].magic == CACHE_MAGIC;
+    }
+    RELEASE_GLOBAL_CACHE_LOCK();
+
+    /* Rebuild the segments of an existing cache */
+    if (created && policy != oldpolicy && cache_lock(ix) == 0)
+    {
+        cache_policy_locked(ix);
+        cache_unlock(ix);
+    }
+    return oldpolicy;
+}
+
+int cache_promote (int ix, int i)
+{
+    if (cache_check(ix,i)) return -1;
+    if (cacheblk[ix].policy == CACHE_POLICY_2Q
+     && cacheblk[ix].cache[i].seg != CACHE_SEG_PROTECTED)
+    {
+        cache_age_newest(ix, i, CACHE_SEG_PROTECTED);
+        cacheblk[ix].promotes++;
+    }
+    return 0;
+}
+
+int cache_protected (int ix, int i)
+{
+    if (cache_check(ix,i)) return -1;
+    return cacheblk[ix].cache[i].seg == CACHE_SEG_PROTECTED;
+}
+
+int cache_setquota (int ix, U16 lo, U16 hi, U16 devtype, int min, int max)
+{
+    CACHEQUOTA quota[CACHE_MAX_QUOTA];
+    int n, nquota;
+    int created;
+
+    if (cache_check_ix(ix) || lo > hi || min < 0 || min > max || max > 100)
+        return -1;
+
+    OBTAIN_GLOBAL_CACHE_LOCK();
+    {
+        /* Replace the rule for the same devices, else add one */
+        for (n = 0; n < cachenquota[ix]; n++)
+            if (devtype ? cachequota[ix][n].devtype == devtype
+                        : cachequota[ix][n].devtype == 0
+                       && cachequota[ix][n].lo == lo
+                       && cachequota[ix][n].hi == hi)
+                break;
+        if (n < CACHE_MAX_QUOTA)
         {
-            if (cacheblk[ix].cache[i].key == key) break;
-            if (oldest_entry && !cache_isbusy(ix, i)
-             && (*oldest_entry < 0 || i == p || cacheblk[ix].cache[i].age < cacheblk[ix].cache[*oldest_entry].age))
-                if (*oldest_entry != p) *oldest_entry = i;
+            cachequota[ix][n].lo = lo;
+            cachequota[ix][n].hi = hi;
+            cachequota[ix][n].devtype = devtype;
+            cachequota[ix][n].min = min;
+            cachequota[ix][n].max = max;
+            if (n == cachenquota[ix])
+                cachenquota[ix]++;
         }
+        nquota = cachenquota[ix];
+        memcpy(quota, cachequota[ix], sizeof(quota));
+        created = cacheblk[ix].magic == CACHE_MAGIC;
     }
+    RELEASE_GLOBAL_CACHE_LOCK();
+
+    if (n >= CACHE_MAX_QUOTA)
+        return -1;
 
-    if (i >= cacheblk[ix].nbr)
+    /* Regroup the owners of an existing cache */
+    if (created && cache_lock(ix) == 0)
     {
-        i = -1;
+        memcpy(cacheblk[ix].quota, quota, sizeof(quota));
+        cacheblk[ix].nquota = nquota;
+        cache_quota_locked(ix);
+        cache_unlock(ix);
     }
-    else if ( i >= 0 && cache_isempty(ix, i) )
+    return 0;
+}
+
+int cache_getquota (int ix, int n, CACHEQUOTA *q)
+{
+    int rc = -1;
+    if (cache_check_ix(ix)) return -1;
+    OBTAIN_GLOBAL_CACHE_LOCK();
     {
-        if ( oldest_entry && *oldest_entry < 0 )
+        if (n >= 0 && n < cachenquota[ix])
         {
-            *oldest_entry = i;
+            *q = cachequota[ix][n];
+            rc = 0;
         }
-        i = -1;
     }
-    if ( i >= 0 )
+    RELEASE_GLOBAL_CACHE_LOCK();
+    return rc;
+}
+
+int cache_resetquota (int ix)
+{
+    int created;
+
+    if (cache_check_ix(ix)) return -1;
+    OBTAIN_GLOBAL_CACHE_LOCK();
     {
-        cacheblk[ix].hits++;
+        cachenquota[ix] = 0;
+        created = cacheblk[ix].magic == CACHE_MAGIC;
     }
-    else
+    RELEASE_GLOBAL_CACHE_LOCK();
+
+    if (created && cache_lock(ix) == 0)
     {
-        cacheblk[ix].misses++;
+        cacheblk[ix].nquota = 0;
+        cache_quota_locked(ix);
+        cache_unlock(ix);
     }
-    return i;
+    return 0;
 }
 
 int cache_scan (int ix, CACHE_SCAN_RTN rtn, void *data)
@@ -171,8 +308,14 @@ int      answer = -1;                   /* Answer from routine       */
 
 int cache_lock(int ix)
 {
+    int busy;
     if (cache_check_cache(ix)) return -1;
-    obtain_lock(&cacheblk[ix].lock);
+    busy = try_obtain_lock(&cacheblk[ix].lock);
+    if (busy)
+        obtain_lock(&cacheblk[ix].lock);
+    cacheblk[ix].locks++;
+    if (busy)
+        cacheblk[ix].lockwaits++;
     return 0;
 }
 
@@ -221,11 +364,37 @@ U64 cache_setkey(int ix, int i, U64 key)
 {
     U64 oldkey;
     int empty;
+    int hashed;
 
     if (cache_check(ix,i)) return (U64)-1;
     empty = cache_isempty(ix, i);
     oldkey = cacheblk[ix].cache[i].key;
-    cacheblk[ix].cache[i].key = key;
+    hashed = cacheblk[ix].cache[i].hashed;
+
+    /* Zero is a valid key, so an entry is hashed (and counted for
+       its owner) from the time its key is first set */
+    if (oldkey != key || !hashed)
+    {
+        cache_hash_del(ix, i);
+        cacheblk[ix].cache[i].key = key;
+        cache_hash_add(ix, i);
+
+        /* Under 2Q a stolen probation entry leaves its key on the
+           ghost list; a key found there goes straight to the
+           protected segment */
+        if (cacheblk[ix].policy == CACHE_POLICY_2Q)
+        {
+            int seg = CACHE_SEG_PROBATION;
+            if (hashed && cacheblk[ix].cache[i].seg == CACHE_SEG_PROBATION)
+                cache_ghost_add(ix, oldkey);
+            if (cache_ghost_del(ix, key))
+            {
+                cacheblk[ix].ghosthits++;
+                seg = CACHE_SEG_PROTECTED;
+            }
+            cache_age_newest(ix, i, seg);
+        }
+    }
     if (empty && !cache_isempty(ix, i))
         cacheblk[ix].empty--;
     else if (!empty && cache_isempty(ix, i))
@@ -282,6 +451,7 @@ U64 cache_setage(int ix, int i)
     empty = cache_isempty(ix, i);
     oldage = cacheblk[ix].cache[i].age;
     cacheblk[ix].cache[i].age = ++cacheblk[ix].age;
+    cache_age_newest(ix, i, cacheblk[ix].cache[i].seg);
     if (empty) cacheblk[ix].empty--;
     return oldage;
 }
@@ -350,7 +520,11 @@ int cache_release(int ix, int i, int flag)
     buf = cacheblk[ix].cache[i].buf;
     len = cacheblk[ix].cache[i].len;
 
+    cache_hash_del(ix, i);
+    cache_age_unlink(ix, i);
     memset(&cacheblk[ix].cache[i], 0, sizeof(CACHE));
+    cacheblk[ix].cache[i].hnext = -1;
+    cache_age_oldest(ix, i, CACHE_SEG_PROBATION);
 
     if ((flag & CACHE_FREEBUF) && buf != NULL) {
         free (buf);
@@ -377,8 +551,14 @@ DLL_EXPORT int cachestats_cmd(int argc, char *argv[], char *cmdline)
     char buf[128];
 
     UNREFERENCED(cmdline);
-    UNREFERENCED(argc);
-    UNREFERENCED(argv);
+
+    /* Per device report; each cache is locked in turn */
+    if (argc > 1 && strcasecmp(argv[1], "dev") == 0)
+    {
+        for (ix = 0; ix < CACHE_MAX_INDEX; ix++)
+            cache_devstats(ix);
+        return 0;
+    }
 
     OBTAIN_GLOBAL_CACHE_LOCK();
 
@@ -427,6 +607,31 @@ DLL_EXPORT int cachestats_cmd(int argc, char *argv[], char *cmdline)
         MSGBUF( buf, "hit%% ............ %10d", cache_hit_percent(ix));
         WRMSG(HHC02294, "I", buf);
 
+        MSGBUF( buf, "locks ........... %10"PRId64, cacheblk[ix].locks);
+        WRMSG(HHC02294, "I", buf);
+
+        MSGBUF( buf, "lock waits ...... %10"PRId64, cacheblk[ix].lockwaits);
+        WRMSG(HHC02294, "I", buf);
+
+        MSGBUF( buf, "hash chains ..... %10u", cacheblk[ix].hashmask + 1);
+        WRMSG(HHC02294, "I", buf);
+
+        MSGBUF( buf, "policy .......... %10s",
+            cacheblk[ix].policy == CACHE_POLICY_2Q ? "2Q" : "LRU");
+        WRMSG(HHC02294, "I", buf);
+
+        if (cacheblk[ix].policy == CACHE_POLICY_2Q)
+        {
+            MSGBUF( buf, "protected ....... %10d", cacheblk[ix].nseg[CACHE_SEG_PROTECTED]);
+            WRMSG(HHC02294, "I", buf);
+
+            MSGBUF( buf, "promotes ........ %10"PRId64, cacheblk[ix].promotes);
+            WRMSG(HHC02294, "I", buf);
+
+            MSGBUF( buf, "ghost hits ...... %10"PRId64, cacheblk[ix].ghosthits);
+            WRMSG(HHC02294, "I", buf);
+        }
+
         MSGBUF( buf, "age ............. %10"PRId64, cacheblk[ix].age);
         WRMSG(HHC02294, "I", buf);
 
@@ -458,6 +663,81 @@ DLL_EXPORT int cachestats_cmd(int argc, char *argv[], char *cmdline)
     return 0;
 }
 
+/*-------------------------------------------------------------------*/
+/* cachequota [ccuu[-ccuu]|type=xxxx min max | reset]                */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int cachequota_cmd(int argc, char *argv[], char *cmdline)
+{
+    CACHEQUOTA q;
+    U16  lo, hi, devtype = 0;
+    int  min, max, n;
+    char c, c2;
+    char buf[128];
+
+    UNREFERENCED(cmdline);
+
+    if (argc == 2 && strcasecmp(argv[1], "reset") == 0)
+        cache_resetquota(CACHE_DEVBUF);
+    else if (argc == 4)
+    {
+        if (strncasecmp(argv[1], "type=", 5) == 0)
+        {
+            if (sscanf(argv[1] + 5, "%hx%c", &devtype, &c) != 1 || devtype == 0)
+            {
+                WRMSG(HHC02205, "E", argv[1], "");
+                return -1;
+            }
+            lo = 0;
+            hi = 0xFFFF;
+        }
+        else
+        {
+            n = sscanf(argv[1], "%hx%c%hx%c", &lo, &c, &hi, &c2);
+            if (n == 1)
+                hi = lo;
+            else if (n != 3 || c != '-' || hi < lo)
+            {
+                WRMSG(HHC02205, "E", argv[1], "");
+                return -1;
+            }
+        }
+        if (sscanf(argv[2], "%d%c", &min, &c) != 1 || min < 0 || min > 100)
+        {
+            WRMSG(HHC02205, "E", argv[2], "");
+            return -1;
+        }
+        if (sscanf(argv[3], "%d%c", &max, &c) != 1 || max < min || max > 100)
+        {
+            WRMSG(HHC02205, "E", argv[3], "");
+            return -1;
+        }
+        if (cache_setquota(CACHE_DEVBUF, lo, hi, devtype, min, max) != 0)
+        {
+            WRMSG(HHC02205, "E", argv[1], "; too many quotas");
+            return -1;
+        }
+    }
+    else if (argc != 1)
+    {
+        WRMSG(HHC02299, "E", argv[0]);
+        return -1;
+    }
+
+    for (n = 0; cache_getquota(CACHE_DEVBUF, n, &q) == 0; n++)
+    {
+        if (q.devtype)
+            MSGBUF(buf, "Quota[%2d] type %4.4X       min %3d%% max %3d%%",
+                n, q.devtype, q.min, q.max);
+        else
+            MSGBUF(buf, "Quota[%2d] dev  %4.4X-%4.4X  min %3d%% max %3d%%",
+                n, q.lo, q.hi, q.min, q.max);
+        WRMSG(HHC02294, "I", buf);
+    }
+    if (n == 0)
+        WRMSG(HHC02294, "I", "No cache quotas");
+    return 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* Private functions                                                 */
 /*-------------------------------------------------------------------*/
@@ -476,6 +756,12 @@ static int cache_destroy_locked (int ix)
 
             free (cacheblk[ix].cache);
         }
+        free (cacheblk[ix].hash);
+        free (cacheblk[ix].ghost);
+        free (cacheblk[ix].ghostused);
+        free (cacheblk[ix].ghostnext);
+        free (cacheblk[ix].ghosthash);
+        free (cacheblk[ix].own);
     }
     memset(&cacheblk[ix], 0, sizeof(CACHEBLK));
     return 0;
@@ -483,6 +769,9 @@ static int cache_destroy_locked (int ix)
 
 static int cache_create_locked( int ix )
 {
+    int i;
+    U32 n;
+
     cache_destroy_locked (ix);
     cacheblk[ix].magic = CACHE_MAGIC;
 
@@ -506,6 +795,45 @@ static int cache_create_locked( int ix )
             errno, strerror(errno));
         return -1;
     }
+
+    /* At least two hash chains per entry, rounded up to a power of 2 */
+    for (n = 1; n < 2 * (U32)cacheblk[ix].nbr; n <<= 1);
+    cacheblk[ix].hashmask = n - 1;
+    cacheblk[ix].nghost = cacheblk[ix].nbr * CACHE_2Q_GHOSTS / 100 + 1;
+    cacheblk[ix].hash = malloc (n * sizeof(int));
+    cacheblk[ix].ghosthash = malloc (n * sizeof(int));
+    cacheblk[ix].ghostnext = calloc (cacheblk[ix].nghost, sizeof(int));
+    cacheblk[ix].ghost = calloc (cacheblk[ix].nghost, sizeof(U64));
+    cacheblk[ix].ghostused = calloc (cacheblk[ix].nghost, sizeof(BYTE));
+
+    if (cacheblk[ix].hash == NULL || cacheblk[ix].ghosthash == NULL
+     || cacheblk[ix].ghostnext == NULL || cacheblk[ix].ghost == NULL
+     || cacheblk[ix].ghostused == NULL)
+    {
+        // "Function %s failed; cache %d size %d: [%02d] %s"
+        WRMSG (HHC00011, "E", "cache()", ix,
+            (int)(n * sizeof(int)), errno, strerror(errno));
+        return -1;
+    }
+    for (n = 0; n <= cacheblk[ix].hashmask; n++)
+        cacheblk[ix].hash[n] = cacheblk[ix].ghosthash[n] = -1;
+
+    /* All entries start out empty, hence oldest, in index order */
+    for (i = 0; i < cacheblk[ix].nbr; i++)
+        cacheblk[ix].cache[i].hnext = -1;
+    cacheblk[ix].policy = cachepolicy[ix];
+    cache_policy_locked(ix);
+
+    /* Without an owner table entries are simply not accounted */
+    cacheblk[ix].own = malloc (CACHE_OWN_INITIAL * sizeof(CACHEOWN));
+    if (cacheblk[ix].own)
+    {
+        cacheblk[ix].ownmask = CACHE_OWN_INITIAL - 1;
+        for (n = 0; n < CACHE_OWN_INITIAL; n++)
+            cacheblk[ix].own[n].owner = CACHE_NO_OWNER;
+    }
+    memcpy(cacheblk[ix].quota, cachequota[ix], sizeof(cacheblk[ix].quota));
+    cacheblk[ix].nquota = cachenquota[ix];
     return 0;
 }
 
@@ -585,3 +913,451 @@ static void cache_allocbuf(int ix, int i, int len)
     cacheblk[ix].cache[i].len = len;
     cacheblk[ix].size += len;
 }
+
+/*-------------------------------------------------------------------*/
+/* Hash index: entries whose key has been set are chained by key,    */
+/* which may be zero, and are counted for the key's owner            */
+/*-------------------------------------------------------------------*/
+static U32 cache_hash_key(int ix, U64 key)
+{
+    return (U32)((key * CACHE_HASH_MULT) >> 32) & cacheblk[ix].hashmask;
+}
+
+static void cache_hash_add(int ix, int i)
+{
+    int *h;
+    if (cacheblk[ix].cache[i].hashed) return;
+    h = &cacheblk[ix].hash[cache_hash_key(ix, cacheblk[ix].cache[i].key)];
+    cacheblk[ix].cache[i].hnext = *h;
+    *h = i;
+    cacheblk[ix].cache[i].hashed = 1;
+    cache_own_count(ix, cacheblk[ix].cache[i].key, 1);
+}
+
+static void cache_hash_del(int ix, int i)
+{
+    int *h;
+    if (!cacheblk[ix].cache[i].hashed) return;
+    h = &cacheblk[ix].hash[cache_hash_key(ix, cacheblk[ix].cache[i].key)];
+    while (*h >= 0 && *h != i)
+        h = &cacheblk[ix].cache[*h].hnext;
+    if (*h == i)
+        *h = cacheblk[ix].cache[i].hnext;
+    cacheblk[ix].cache[i].hnext = -1;
+    cacheblk[ix].cache[i].hashed = 0;
+    cache_own_count(ix, cacheblk[ix].cache[i].key, -1);
+}
+
+/*-------------------------------------------------------------------*/
+/* Ghost list: a ring of recently stolen keys, also hashed by key    */
+/*-------------------------------------------------------------------*/
+static void cache_ghost_add(int ix, U64 key)
+{
+    int  g = cacheblk[ix].ghostpos;
+    int *h;
+
+    if (cacheblk[ix].ghostused[g])
+        cache_ghost_del(ix, cacheblk[ix].ghost[g]);
+    cacheblk[ix].ghost[g] = key;
+    cacheblk[ix].ghostused[g] = 1;
+    h = &cacheblk[ix].ghosthash[cache_hash_key(ix, key)];
+    cacheblk[ix].ghostnext[g] = *h;
+    *h = g;
+    cacheblk[ix].ghostpos = (g + 1) % cacheblk[ix].nghost;
+}
+
+static int cache_ghost_del(int ix, U64 key)
+{
+    int  g;
+    int *h = &cacheblk[ix].ghosthash[cache_hash_key(ix, key)];
+
+    while (*h >= 0 && cacheblk[ix].ghost[*h] != key)
+        h = &cacheblk[ix].ghostnext[*h];
+    if ((g = *h) < 0)
+        return 0;
+    *h = cacheblk[ix].ghostnext[g];
+    cacheblk[ix].ghost[g] = 0;
+    cacheblk[ix].ghostused[g] = 0;
+    return 1;
+}
+
+/*-------------------------------------------------------------------*/
+/* Age lists: entries of each segment in ascending `age' order.  An  */
+/* entry only ever becomes the newest of a segment (cache_setage,    */
+/* cache_setkey, cache_promote) or, when released, the oldest.       */
+/*-------------------------------------------------------------------*/
+static void cache_age_unlink(int ix, int i)
+{
+    int s = cacheblk[ix].cache[i].seg;
+    int p = cacheblk[ix].cache[i].lprev;
+    int n = cacheblk[ix].cache[i].lnext;
+    if (p >= 0) cacheblk[ix].cache[p].lnext = n;
+    else        cacheblk[ix].head[s] = n;
+    if (n >= 0) cacheblk[ix].cache[n].lprev = p;
+    else        cacheblk[ix].tail[s] = p;
+    cacheblk[ix].cache[i].lprev = cacheblk[ix].cache[i].lnext = -1;
+    cacheblk[ix].nseg[s]--;
+}
+
+static void cache_age_oldest(int ix, int i, int seg)
+{
+    cacheblk[ix].cache[i].seg = seg;
+    cacheblk[ix].cache[i].lprev = -1;
+    cacheblk[ix].cache[i].lnext = cacheblk[ix].head[seg];
+    if (cacheblk[ix].head[seg] >= 0)
+        cacheblk[ix].cache[cacheblk[ix].head[seg]].lprev = i;
+    else
+        cacheblk[ix].tail[seg] = i;
+    cacheblk[ix].head[seg] = i;
+    cacheblk[ix].nseg[seg]++;
+}
+
+static void cache_age_newest(int ix, int i, int seg)
+{
+    if (cacheblk[ix].tail[seg] == i) return;
+    cache_age_unlink(ix, i);
+    cacheblk[ix].cache[i].seg = seg;
+    cacheblk[ix].cache[i].lprev = cacheblk[ix].tail[seg];
+    if (cacheblk[ix].tail[seg] >= 0)
+        cacheblk[ix].cache[cacheblk[ix].tail[seg]].lnext = i;
+    else
+        cacheblk[ix].head[seg] = i;
+    cacheblk[ix].tail[seg] = i;
+    cacheblk[ix].nseg[seg]++;
+}
+
+/*-------------------------------------------------------------------*/
+/* Choose the entry to be stolen.  Empty entries are the oldest      */
+/* probation entries.  Under LRU every entry is in probation; under  */
+/* 2Q the protected segment is only used once probation has shrunk   */
+/* to CACHE_2Q_PROBATION percent of the cache.                       */
+/*-------------------------------------------------------------------*/
+static int cache_victim(int ix, CACHEOWN *own)
+{
+    int i, p = -1, v = -1, s, seg;
+
+    for (i = cacheblk[ix].head[CACHE_SEG_PROBATION]; i >= 0; i = cacheblk[ix].cache[i].lnext)
+        if (!cache_isbusy(ix, i))
+        {
+            p = i;
+            break;
+        }
+    if (p >= 0 && (cache_isempty(ix, p)
+     || cacheblk[ix].nseg[CACHE_SEG_PROBATION] * 100 > cacheblk[ix].nbr * CACHE_2Q_PROBATION))
+        v = p;
+    else
+    {
+        for (i = cacheblk[ix].head[CACHE_SEG_PROTECTED]; i >= 0; i = cacheblk[ix].cache[i].lnext)
+            if (!cache_isbusy(ix, i))
+                break;
+        v = i >= 0 ? i : p;
+    }
+
+    /* Failing the quotas, take the next candidate in the same
+       order, the victim's segment first, that satisfies them */
+    if (v < 0 || cacheblk[ix].nquota == 0 || cache_quota_ok(ix, v, own))
+        return v;
+    for (s = 0; s < CACHE_SEGS; s++)
+    {
+        seg = s == 0 ? cacheblk[ix].cache[v].seg
+                     : CACHE_SEGS - 1 - cacheblk[ix].cache[v].seg;
+        for (i = cacheblk[ix].head[seg]; i >= 0; i = cacheblk[ix].cache[i].lnext)
+            if (!cache_isbusy(ix, i) && cache_quota_ok(ix, i, own))
+                return i;
+    }
+    return v;
+}
+
+/*-------------------------------------------------------------------*/
+/* (Re)build the age lists for the current policy: every entry goes  */
+/* to probation in `age' order and the ghost list is emptied.        */
+/*-------------------------------------------------------------------*/
+static int cache_age_compare(const void *a, const void *b)
+{
+    U64 x = ((const U64 *)a)[0], y = ((const U64 *)b)[0];
+    return x < y ? -1 : x > y;
+}
+
+static void cache_policy_locked(int ix)
+{
+    U64 *order;
+    int  i, s;
+
+    cacheblk[ix].policy = cachepolicy[ix];
+    for (s = 0; s < CACHE_SEGS; s++)
+    {
+        cacheblk[ix].head[s] = cacheblk[ix].tail[s] = -1;
+        cacheblk[ix].nseg[s] = 0;
+    }
+    for (i = 0; i < cacheblk[ix].nghost; i++)
+        if (cacheblk[ix].ghostused[i])
+            cache_ghost_del(ix, cacheblk[ix].ghost[i]);
+    cacheblk[ix].ghostpos = 0;
+
+    /* Sort (age, index) pairs; without memory keep index order */
+    order = malloc (cacheblk[ix].nbr * 2 * sizeof(U64));
+    for (i = 0; i < cacheblk[ix].nbr; i++)
+    {
+        cacheblk[ix].cache[i].lprev = cacheblk[ix].cache[i].lnext = -1;
+        if (order)
+        {
+            order[2*i]   = cacheblk[ix].cache[i].age;
+            order[2*i+1] = i;
+        }
+    }
+    if (order)
+        qsort (order, cacheblk[ix].nbr, 2 * sizeof(U64), cache_age_compare);
+    for (i = 0; i < cacheblk[ix].nbr; i++)
+    {
+        int e = order ? (int)order[2*i+1] : i;
+        cacheblk[ix].cache[e].seg = CACHE_SEG_PROBATION;
+        cacheblk[ix].cache[e].lprev = cacheblk[ix].tail[CACHE_SEG_PROBATION];
+        if (cacheblk[ix].tail[CACHE_SEG_PROBATION] >= 0)
+            cacheblk[ix].cache[cacheblk[ix].tail[CACHE_SEG_PROBATION]].lnext = e;
+        else
+            cacheblk[ix].head[CACHE_SEG_PROBATION] = e;
+        cacheblk[ix].tail[CACHE_SEG_PROBATION] = e;
+        cacheblk[ix].nseg[CACHE_SEG_PROBATION]++;
+    }
+    free (order);
+}
+
+/*-------------------------------------------------------------------*/
+/* Owner table: per device entry counts and lookup statistics, open  */
+/* addressed by the owner (device number) part of the key.           */
+/*-------------------------------------------------------------------*/
+static CACHEOWN *cache_owner(int ix, U64 key, int add)
+{
+    U32       owner = CACHE_OWNER(key);
+    U32       h;
+    CACHEOWN *own;
+
+    if (cacheblk[ix].own == NULL)
+        return NULL;
+    for (h = (owner * 0x9E3779B1U) >> 12;; h++)
+    {
+        own = &cacheblk[ix].own[h & cacheblk[ix].ownmask];
+        if (own->owner == owner)
+        {
+            /* Retry a rule that could not be resolved before */
+            if (add && own->quota == CACHE_QUOTA_RETRY
+             && (own->quota = cache_quota_rule(ix, owner)) >= 0)
+                cacheblk[ix].quotacount[own->quota] += own->count;
+            return own;
+        }
+        if (own->owner == CACHE_NO_OWNER)
+            break;
+    }
+    if (!add)
+        return NULL;
+
+    /* Keep the table at most half full */
+    if (2 * (U32)(cacheblk[ix].nown + 1) > cacheblk[ix].ownmask + 1)
+        return cache_own_grow(ix) ? NULL : cache_owner(ix, key, add);
+
+    own->owner  = owner;
+    own->quota  = cache_quota_rule(ix, owner);
+    own->count  = 0;
+    own->hits   = own->misses = 0;
+    cacheblk[ix].nown++;
+    return own;
+}
+
+static int cache_own_grow(int ix)
+{
+    U32       n = 2 * (cacheblk[ix].ownmask + 1);
+    U32       j, h;
+    CACHEOWN *own = malloc (n * sizeof(CACHEOWN));
+
+    if (own == NULL)
+        return -1;
+    for (j = 0; j < n; j++)
+        own[j].owner = CACHE_NO_OWNER;
+    for (j = 0; j <= cacheblk[ix].ownmask; j++)
+    {
+        if (cacheblk[ix].own[j].owner == CACHE_NO_OWNER)
+            continue;
+        for (h = (cacheblk[ix].own[j].owner * 0x9E3779B1U) >> 12;
+             own[h & (n - 1)].owner != CACHE_NO_OWNER; h++);
+        own[h & (n - 1)] = cacheblk[ix].own[j];
+    }
+    free (cacheblk[ix].own);
+    cacheblk[ix].own = own;
+    cacheblk[ix].ownmask = n - 1;
+    return 0;
+}
+
+static void cache_own_count(int ix, U64 key, int n)
+{
+    CACHEOWN *own;
+
+    if ((own = cache_owner(ix, key, n > 0)) == NULL
+     || own->count + n < 0)
+        return;
+    own->count += n;
+    if (own->quota >= 0)
+        cacheblk[ix].quotacount[own->quota] += n;
+}
+
+/*-------------------------------------------------------------------*/
+/* Quotas: the first rule matching an owner's device number range    */
+/* or, through its DEVBLK, its device type applies to it.            */
+/*                                                                   */
+/* The device chain is walked holding sysblk.config.  Attaching and  */
+/* detaching a device call into the cache with that lock held, so    */
+/* it is not waited for here: if it is busy CACHE_QUOTA_RETRY is     */
+/* returned and the owner's rule is resolved on a later lookup.      */
+/*-------------------------------------------------------------------*/
+static int cache_quota_rule(int ix, U32 owner)
+{
+    DEVBLK *dev;
+    int     q, looked = 0, locked;
+    U16     devtype = 0;
+
+    for (q = 0; q < cacheblk[ix].nquota; q++)
+    {
+        if (cacheblk[ix].quota[q].devtype == 0)
+        {
+            if (owner >= cacheblk[ix].quota[q].lo
+             && owner <= cacheblk[ix].quota[q].hi)
+                return q;
+            continue;
+        }
+        if (!looked)
+        {
+            locked = have_lock(&sysblk.config);
+            if (!locked && try_obtain_lock(&sysblk.config) != 0)
+                return CACHE_QUOTA_RETRY;
+            looked = 1;
+            for (dev = sysblk.firstdev; dev != NULL; dev = dev->nextdev)
+                if (dev->allocated && dev->devnum == owner)
+                {
+                    devtype = dev->devtype;
+                    break;
+                }
+            if (!locked)
+                release_lock(&sysblk.config);
+        }
+        if (cacheblk[ix].quota[q].devtype == devtype)
+            return q;
+    }
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/* May entry `i' be stolen for a lookup by `own'?  A group at its    */
+/* maximum share may only reuse its own entries, and entries of any  */
+/* other group at or below its minimum share are left alone.         */
+/*-------------------------------------------------------------------*/
+static int cache_quota_ok(int ix, int i, CACHEOWN *own)
+{
+    CACHEOWN *o;
+    int       q, myq = own ? own->quota : -1;
+
+    o = cacheblk[ix].cache[i].hashed ? cache_owner(ix, cacheblk[ix].cache[i].key, 0) : NULL;
+    q = o ? o->quota : -1;
+
+    if (myq >= 0 && cacheblk[ix].quotacount[myq] * 100
+                 >= cacheblk[ix].nbr * cacheblk[ix].quota[myq].max)
+        return q == myq;
+    if (q >= 0 && q != myq && cacheblk[ix].quotacount[q] * 100
+                           <= cacheblk[ix].nbr * cacheblk[ix].quota[q].min)
+        return 0;
+    return 1;
+}
+
+static void cache_quota_locked(int ix)
+{
+    U32 j;
+    int q;
+
+    for (q = 0; q < CACHE_MAX_QUOTA; q++)
+        cacheblk[ix].quotacount[q] = 0;
+    for (j = 0; cacheblk[ix].own && j <= cacheblk[ix].ownmask; j++)
+    {
+        if (cacheblk[ix].own[j].owner == CACHE_NO_OWNER)
+            continue;
+        q = cache_quota_rule(ix, cacheblk[ix].own[j].owner);
+        cacheblk[ix].own[j].quota = q;
+        if (q >= 0)
+            cacheblk[ix].quotacount[q] += cacheblk[ix].own[j].count;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* cachestats dev: occupancy and hit ratio by device                 */
+/*-------------------------------------------------------------------*/
+static int cache_own_compare(const void *a, const void *b)
+{
+    U32 x = ((const CACHEOWN *)a)->owner, y = ((const CACHEOWN *)b)->owner;
+    return x < y ? -1 : x > y;
+}
+
+static void cache_devstats(int ix)
+{
+    CACHEOWN   *own = NULL;
+    CACHEQUOTA  quota[CACHE_MAX_QUOTA];
+    int         quotacount[CACHE_MAX_QUOTA];
+    int         i, n = 0, nquota = 0, nbr = 0, created;
+    S64         total;
+    U32         j;
+    char        buf[128];
+    char        qbuf[16];
+
+    OBTAIN_GLOBAL_CACHE_LOCK();
+    {
+        created = cacheblk[ix].magic == CACHE_MAGIC;
+    }
+    RELEASE_GLOBAL_CACHE_LOCK();
+
+    /* Copy the owner table while holding the cache lock */
+    if (created && cache_lock(ix) == 0)
+    {
+        nbr = cacheblk[ix].nbr;
+        if (cacheblk[ix].own
+         && (own = malloc ((cacheblk[ix].nown + 1) * sizeof(CACHEOWN))) != NULL)
+            for (j = 0; j <= cacheblk[ix].ownmask; j++)
+                if (cacheblk[ix].own[j].owner != CACHE_NO_OWNER)
+                    own[n++] = cacheblk[ix].own[j];
+        nquota = cacheblk[ix].nquota;
+        memcpy(quota, cacheblk[ix].quota, sizeof(quota));
+        memcpy(quotacount, cacheblk[ix].quotacount, sizeof(quotacount));
+        cache_unlock(ix);
+    }
+    if (!created || nbr == 0)
+    {
+        MSGBUF(buf, "Cache[%d] ....... not created", ix);
+        WRMSG(HHC02294, "I", buf);
+        return;
+    }
+
+    MSGBUF(buf, "Cache[%d] device  entries share%%       hits     misses  hit%%  quota", ix);
+    WRMSG(HHC02294, "I", buf);
+    if (n > 1)
+        qsort (own, n, sizeof(CACHEOWN), cache_own_compare);
+    for (i = 0; i < n; i++)
+    {
+        total = own[i].hits + own[i].misses;
+        qbuf[0] = '\0';
+        if (own[i].quota >= 0)
+            MSGBUF(qbuf, "%d", own[i].quota);
+        MSGBUF(buf, "           %4.4X %8d %5d%% %10"PRId64" %10"PRId64" %4d%%  %s",
+            own[i].owner, own[i].count, own[i].count * 100 / nbr,
+            own[i].hits, own[i].misses,
+            total ? (int)(own[i].hits * 100 / total) : 0, qbuf);
+        WRMSG(HHC02294, "I", buf);
+    }
+    for (i = 0; i < nquota; i++)
+    {
+        if (quota[i].devtype)
+            MSGBUF(buf, "Quota[%2d] type %4.4X       min %3d%% max %3d%% entries %8d %3d%%",
+                i, quota[i].devtype, quota[i].min, quota[i].max,
+                quotacount[i], quotacount[i] * 100 / nbr);
+        else
+            MSGBUF(buf, "Quota[%2d] dev  %4.4X-%4.4X  min %3d%% max %3d%% entries %8d %3d%%",
+                i, quota[i].lo, quota[i].hi, quota[i].min, quota[i].max,
+                quotacount[i], quotacount[i] * 100 / nbr);
+        WRMSG(HHC02294, "I", buf);
+    }
+    free (own);
+}
@@ -65,11 +65,76 @@
 
      Notes        [0] `ix' identifies the cache.  This is an integer
                       and is reserved in `cache.h'
-                  [1] An empty entry contains a zero key value.
-                      A valid key should not be all zeroes
-                      (0x0000000000000000) or all ones
-                      (0xffffffffffffffff).   All ones is used to
-                      indicate an error circumstance.
+                  [1] An empty entry contains a zero key, flag
+                      and age value.  A valid key may be zero but
+                      should not be all ones (0xffffffffffffffff).
+                      All ones is used to indicate an error
+                      circumstance.
+
+    Replacement policy functions:
+
+      int         cache_getpolicy(int ix);
+                  Return the replacement policy for cache `ix'
+
+      int         cache_setpolicy(int ix, int policy);
+                  Set the replacement policy; the old policy is
+                  returned.  The setting is kept across the cache
+                  being destroyed and re-created.  Policies are:
+
+                  CACHE_POLICY_LRU  The oldest entry that is not
+                                    busy is stolen.  This is the
+                                    default.
+
+                  CACHE_POLICY_2Q   Entries start out in a
+                                    `probation' segment and only
+                                    move to the `protected' segment
+                                    when cache_promote is called.
+                                    Probation entries are stolen
+                                    first while that segment holds
+                                    more than CACHE_2Q_PROBATION
+                                    percent of the entries, so a
+                                    long sequential scan cannot
+                                    flush the protected entries.
+                                    The keys of stolen probation
+                                    entries are remembered on a
+                                    `ghost' list; a key found there
+                                    by cache_setkey is put straight
+                                    into the protected segment.
+
+      int         cache_promote(int ix, int i);
+                  The entry has been referenced again (as opposed
+                  to merely read ahead).  Under CACHE_POLICY_2Q it
+                  is moved to the protected segment.
+
+      int         cache_protected(int ix, int i);
+                  Return 1 if the entry is in the protected
+                  segment.  Immediately after cache_setkey this
+                  means the key was found on the ghost list.
+
+    Quota functions:
+
+      int         cache_setquota(int ix, U16 lo, U16 hi, U16 devtype,
+                                 int min, int max);
+                  Add or replace a quota rule.  Entries are grouped
+                  by `owner', bits 32-47 of the key, which is the
+                  device number for CACHE_DEVBUF and CACHE_L2 keys.
+                  An owner belongs to the first rule whose device
+                  number range `lo'..`hi' contains it or, when
+                  `devtype' is non-zero, whose device type matches.
+                  All owners of a rule share one group; the group
+                  is guaranteed `min' and limited to `max' percent
+                  of the entries.  Shares are honoured by the choice
+                  of entry to be stolen; if no entry satisfies them
+                  the replacement policy's choice is used anyway.
+                  Rules are kept across the cache being destroyed.
+                  Returns -1 if the arguments are invalid or all
+                  CACHE_MAX_QUOTA rules are in use.
+
+      int         cache_getquota(int ix, int n, CACHEQUOTA *q);
+                  Copy rule `n' to `q'; -1 if there is no such rule.
+
+      int         cache_resetquota(int ix);
+                  Remove all quota rules.
 
     Entry specific functions:
 
@@ -133,8 +198,11 @@
       int         cache_lookup(int ix, U64 key, int *o);
                   Search cache `ix' for entry matching `key'.
                   If a non-NULL pointer `o' is provided, then the
-                  oldest or preferred cache entry index is returned
-                  that is available to be stolen.
+                  index of the entry to be stolen according to the
+                  replacement policy is returned.  Entries are found
+                  through a hash index on `key' and are kept on
+                  lists in `age' order, so neither search scans the
+                  cache.
 
       int         cache_scan (int ix, int (rtn)(), void *data);
                   Scan a cache routine entry by entry calling routine
@@ -179,6 +247,46 @@
 #define  CACHE_6                      6 /*      (available)          */
 #define  CACHE_7                      7 /*      (available)          */
 
+/*-------------------------------------------------------------------*/
+/* Replacement policies                                              */
+/*-------------------------------------------------------------------*/
+#define  CACHE_POLICY_LRU             0 /* Steal oldest entry        */
+#define  CACHE_POLICY_2Q              1 /* Scan resistant 2Q         */
+
+#define  CACHE_SEG_PROBATION          0 /* Referenced once           */
+#define  CACHE_SEG_PROTECTED          1 /* Referenced again          */
+#define  CACHE_SEGS                   2 /* Number of segments        */
+
+#define  CACHE_2Q_PROBATION          25 /* Probation share (%)       */
+#define  CACHE_2Q_GHOSTS             50 /* Ghost keys (% of entries) */
+
+/*-------------------------------------------------------------------*/
+/* Quotas                                                            */
+/*-------------------------------------------------------------------*/
+#define  CACHE_MAX_QUOTA             16 /* Max quota rules per cache */
+#define  CACHE_OWN_INITIAL           64 /* Initial owner table size  */
+#define  CACHE_NO_OWNER      0xFFFFFFFF /* Unused owner table slot   */
+#define  CACHE_QUOTA_RETRY           -2 /* Owner's rule not resolved */
+
+#define  CACHE_OWNER(_key)   ((U32)(((_key) >> 32) & 0xFFFF))
+
+typedef struct _CACHEQUOTA {            /* Quota rule                */
+      U16       lo;                     /* First device number       */
+      U16       hi;                     /* Last device number        */
+      U16       devtype;                /* Device type or zero       */
+      int       min;                    /* Guaranteed share (%)      */
+      int       max;                    /* Maximum share (%)         */
+    } CACHEQUOTA;
+
+typedef struct _CACHEOWN {              /* Owner (device) statistics */
+      U32       owner;                  /* Owner or CACHE_NO_OWNER   */
+      int       quota;                  /* Quota rule index, -1 or
+                                           CACHE_QUOTA_RETRY         */
+      int       count;                  /* Entries held              */
+      S64       hits;                   /* Lookup hits               */
+      S64       misses;                 /* Lookup misses             */
+    } CACHEOWN;
+
 /*-------------------------------------------------------------------*/
 /* Cache entry                                                       */
 /*-------------------------------------------------------------------*/
@@ -189,6 +297,11 @@ typedef struct _CACHE {                 /* Cache entry               */
       void     *buf;                    /* Buffer address            */
       int       value;                  /* Arbitrary value           */
       U64       age;                    /* Age                       */
+      int       hnext;                  /* Next entry in hash chain  */
+      int       hashed;                 /* 1=Entry is on hash chain  */
+      int       lprev;                  /* Prev entry in age order   */
+      int       lnext;                  /* Next entry in age order   */
+      int       seg;                    /* Segment (CACHE_SEG_xxx)   */
     } CACHE;
 
 /*-------------------------------------------------------------------*/
@@ -205,10 +318,32 @@ typedef struct _CACHEBLK {              /* Cache header              */
       S64       hits;                   /* Number lookup hits        */
       S64       fasthits;               /* Number fast lookup hits   */
       S64       misses;                 /* Number lookup misses      */
+      S64       locks;                  /* Number times locked       */
+      S64       lockwaits;              /* Number times lock was busy*/
       U64       age;                    /* Age counter               */
       LOCK      lock;                   /* Lock                      */
       COND      waitcond;               /* Wait for available entry  */
       CACHE    *cache;                  /* Cache table address       */
+      int      *hash;                   /* Hash chain heads by key   */
+      U32       hashmask;               /* Number hash chains - 1    */
+      int       head[CACHE_SEGS];       /* Oldest entry per segment  */
+      int       tail[CACHE_SEGS];       /* Newest entry per segment  */
+      int       nseg[CACHE_SEGS];       /* Entries per segment       */
+      int       policy;                 /* Replacement policy        */
+      U64      *ghost;                  /* Keys of stolen entries    */
+      BYTE     *ghostused;              /* 1=Ghost key slot in use   */
+      int      *ghostnext;              /* Ghost hash chain          */
+      int      *ghosthash;              /* Ghost hash chain heads    */
+      int       nghost;                 /* Number ghost keys         */
+      int       ghostpos;               /* Next ghost key to replace */
+      S64       ghosthits;              /* Keys found on ghost list  */
+      S64       promotes;               /* Entries promoted          */
+      CACHEOWN *own;                    /* Owner table               */
+      U32       ownmask;                /* Owner table size - 1      */
+      int       nown;                   /* Owners in the table       */
+      CACHEQUOTA quota[CACHE_MAX_QUOTA];/* Quota rules               */
+      int       nquota;                 /* Number of quota rules     */
+      int       quotacount[CACHE_MAX_QUOTA]; /* Entries per rule     */
       time_t    atime;                  /* Time last adjustment      */
       time_t    wtime;                  /* Time last wait            */
       int       adjusts;                /* Number of adjustments     */
@@ -232,6 +367,7 @@ typedef struct _CACHEBLK {              /* Cache header              */
 #define CACHE_DEFAULT_L2_NBR       1031 /* Initial entries for L2    */
 
 #define CACHE_WAITTIME             1000 /* Wait time for entry(usec) */
+#define CACHE_HASH_MULT 0x9E3779B97F4A7C15ULL /* Fibonacci key hash  */
 
 #define CACHE_ADJUST_INTERVAL        15 /* Adjustment interval (sec) */
 #define CACHE_ADJUST_NUMBER         128 /* Uninhibited nbr entries   */
@@ -250,6 +386,7 @@ typedef struct _CACHEBLK {              /* Cache header              */
 /* Functions                                                         */
 /*-------------------------------------------------------------------*/
 CCH_DLL_IMPORT int cachestats_cmd(int argc, char *argv[], char *cmdline);
+CCH_DLL_IMPORT int cachequota_cmd(int argc, char *argv[], char *cmdline);
 
 int         cache_nbr(int ix);
 int         cache_busy(int ix);
@@ -261,6 +398,13 @@ S64         cache_misses(int ix);
 int         cache_busy_percent(int ix);
 int         cache_empty_percent(int ix);
 int         cache_hit_percent(int ix);
+int         cache_getpolicy(int ix);
+int         cache_setpolicy(int ix, int policy);
+int         cache_promote(int ix, int i);
+int         cache_protected(int ix, int i);
+int         cache_setquota(int ix, U16 lo, U16 hi, U16 devtype, int min, int max);
+int         cache_getquota(int ix, int n, CACHEQUOTA *q);
+int         cache_resetquota(int ix);
 int         cache_lookup(int ix, U64 key, int *o);
 typedef int CACHE_SCAN_RTN (int *answer, int ix, int i, void *data);
 int         cache_scan (int ix, CACHE_SCAN_RTN rtn, void *data);
@@ -34,6 +34,12 @@ typedef struct CCKD_L2ENT       CCKD_L2ENT;     // Level 2 table entry
 typedef struct CCKD_FREEBLK     CCKD_FREEBLK;   // Free block
 typedef struct CCKD_IFREEBLK    CCKD_IFREEBLK;  // Free block (internal)
 typedef struct CCKD_RA          CCKD_RA;        // Readahead queue entry
+typedef struct CCKD_WRBATCH     CCKD_WRBATCH;   // Writer batch
+typedef struct CCKD_WRDEFER     CCKD_WRDEFER;   // Queued track image write
+typedef struct CCKD_AIOREQ      CCKD_AIOREQ;    // Batched I/O request
+typedef struct CCKD_AIO         CCKD_AIO;       // Batched I/O queue
+typedef struct CCKD_IOSTATS     CCKD_IOSTATS;   // File I/O statistics
+typedef struct CCKD_DICT        CCKD_DICT;      // Compression dictionary
 typedef struct CCKDBLK          CCKDBLK;        // Global CCKD dasd block
 typedef struct CCKD_EXT         CCKD_EXT;       // CCKD Extension block
 typedef struct SPCTAB           SPCTAB;         // Space table
@@ -105,7 +111,10 @@ struct CKD_RECHDR {                     /* Record header             */
 /*-------------------------------------------------------------------*/
 /*    NOTE: The num_L1tab, num_L2tab, cyls, cdh_size, cdh_used,      */
 /*    free_off, free_total, free_largest, free_num, free_imbed,      */
-/*    and cmp_parm fields are kept in LITTLE endian format.          */
+/*    cmp_parm, dict_off and dict_len fields are kept in LITTLE      */
+/*    endian format.                                                 */
+/*    The dict_off, dict_len and dict_algo fields are only valid     */
+/*    with CCKD_OPT_DICT on.                                         */
 /*-------------------------------------------------------------------*/
 struct CCKD_DEVHDR                      /* Compress device header    */
 {
@@ -125,7 +134,10 @@ struct CCKD_DEVHDR                      /* Compress device header    */
 /* 44 */BYTE             cdh_nullfmt;   /* Null track format         */
 /* 45 */BYTE             cmp_algo;      /* Compression algorithm     */
 /* 46 */S16              cmp_parm;      /* Compression parameter     */
-/* 48 */BYTE             resv2[464];    /* Reserved                  */
+/* 48 */U32              dict_off;      /* Offset to dictionary      */
+/* 52 */U32              dict_len;      /* Dictionary length         */
+/* 56 */BYTE             dict_algo;     /* Dictionary algorithm      */
+/* 57 */BYTE             resv2[455];    /* Reserved                  */
 };
 
 #define CCKD_VERSION           0
@@ -133,14 +145,28 @@ struct CCKD_DEVHDR                      /* Compress device header    */
 #define CCKD_MODLVL            1
 
 #define CCKD_OPT_BIGEND        0x02  /* file in BIG endian format    */
+#define CCKD_OPT_DICT          0x04  /* Images may use a dictionary  */
 #define CCKD_OPT_SPERRS        0x20  /* Space errors detected        */
 #define CCKD_OPT_OPENRW        0x40  /* Opened R/W since last chkdsk */
 #define CCKD_OPT_OPENED        0x80
 
+/* Options this level understands; a file with any other option bit
+   set was written by a newer level and is not opened.  0x01 is the
+   obsolete `nofudge' bit that old files may still have on.         */
+#define CCKD_OPT_KNOWN         ( 0x01            | CCKD_OPT_BIGEND    \
+                               | CCKD_OPT_DICT   | CCKD_OPT_SPERRS    \
+                               | CCKD_OPT_OPENRW | CCKD_OPT_OPENED )
+
 #define CCKD_COMPRESS_NONE     0x00
 #define CCKD_COMPRESS_ZLIB     0x01
 #define CCKD_COMPRESS_BZIP2    0x02
-#define CCKD_COMPRESS_MASK     0x03
+#define CCKD_COMPRESS_ZSTD     0x04
+#define CCKD_COMPRESS_LZ4      0x08
+#define CCKD_COMPRESS_MASK     0x0F
+
+#define CCKD_DICT_MAXSIZE      65536    /* Max zstd dictionary size  */
+#define CCKD_DICT_ZLIBSIZE     32768    /* Max zlib preset dictionary*/
+#define CCKD_DICT_NSAMPLES     256      /* Max images to train from  */
 
 #define CCKD_STRESS_MINLEN     4096
 #if defined( HAVE_ZLIB )
@@ -227,6 +253,10 @@ typedef  char         CCKD_ITRACE[256]; /* Trace table entry         */
 #define CCKD_MIN_READAHEADS    0        /* Min readahead trks        */
 #define CCKD_DEF_READAHEADS    2        /* Def readahead trks        */
 #define CCKD_MAX_READAHEADS    16       /* Max readahead trks        */
+#define CCKD_RA_SEQMIN         4        /* Sequential reads needed to
+                                           resume readahead after it
+                                           was turned off for random
+                                           access                    */
 
 #define CCKD_DEF_RA_SIZE       4        /* Readahead queue size      */
 #define CCKD_MAX_RA_SIZE       16       /* Readahead queue size      */
@@ -236,8 +266,21 @@ typedef  char         CCKD_ITRACE[256]; /* Trace table entry         */
 #define CCKD_MAX_RA            9        /* Max readahead threads     */
 
 #define CCKD_MIN_WRITER        1        /* Min writer threads        */
-#define CCKD_DEF_WRITER        2        /* Def writer threads        */
-#define CCKD_MAX_WRITER        9        /* Max writer threads        */
+#define CCKD_DEF_WRITER        2        /* Def writer threads (or the
+                                           number of host processors
+                                           if that is greater)       */
+#define CCKD_MAX_WRITER        32       /* Max writer threads        */
+
+#define CCKD_WR_BATCH          8        /* Max tracks per writer batch */
+#define CCKD_WR_BUFSIZE    (64*1024)    /* Writer compress buffer    */
+
+#define CCKD_AIO_DEPTH         16       /* Max requests per batched
+                                           I/O submission (at least
+                                           CCKD_WR_BATCH and
+                                           CCKD_MAX_READAHEADS)      */
+#define CCKD_IOLAT_NBR         8        /* I/O latency histogram
+                                           buckets: <8us, <32us, ...
+                                           <32ms, 32ms and more      */
 
 #define CCKD_MIN_GCOL          0        /* Min garbage collectors    */
 #define CCKD_DEF_GCOL          1        /* Def garbage collectors    */
@@ -251,6 +294,12 @@ typedef  char         CCKD_ITRACE[256]; /* Trace table entry         */
 #define CCKD_DEF_GCPARM        0        /* Def gcol adjustment parm  */
 #define CCKD_MAX_GCPARM       +8        /* max gcol adjustment parm  */
 
+#define CCKD_MAX_GCSLICE       1000     /* Max msecs per gcol slice  */
+#define CCKD_MAX_GCRATE        1048576  /* Max gcol KB per second    */
+#define CCKD_GC_SLICE_READ     65536    /* Max bytes read per slice  */
+#define CCKD_GC_YIELD          10       /* Max msecs gcol waits for
+                                           foreground i/o per slice  */
+
 #define CCKD_DEF_NUM_TRACE     64       /* Def nbr of trace entries  */
 #define CCKD_MAX_NUM_TRACE     262144   /* Max nbr of trace entries  */
 
@@ -268,6 +317,114 @@ typedef  char         CCKD_ITRACE[256]; /* Trace table entry         */
 #define CCKD_MAX_DHMAX         1        /* Max DASD hardeners allowed*/
                                         /* *** ONLY ONE ALLOWED ***  */
 
+/*-------------------------------------------------------------------*/
+/*                   Writer thread batch                             */
+/*-------------------------------------------------------------------*/
+struct CCKD_WRDEFER {                   /* Queued track image write  */
+        int              trk;           /* Track number              */
+        int              rc;            /* Write return code         */
+        U64              off;           /* New image offset          */
+        int              len;           /* New image length          */
+        int              size;          /* New image size            */
+        U64              oldoff;        /* Old image offset          */
+        int              oldlen;        /* Old image length          */
+        int              oldsize;       /* Old image size            */
+};
+
+struct CCKD_WRBATCH {                   /* Writer batch              */
+        int              n;             /* Number of entries         */
+        int              max;           /* Max number of entries     */
+        int              o[CCKD_WR_BATCH];    /* Cache entries       */
+        BYTE            *bufp[CCKD_WR_BATCH]; /* Images to write     */
+        int              bufl[CCKD_WR_BATCH]; /* Image lengths       */
+        CCKD_AIO        *aio;           /* Writer's I/O queue or NULL*/
+        int              ndefer;        /* Number of queued writes   */
+        CCKD_WRDEFER     defer[CCKD_WR_BATCH]; /* Queued image writes
+                                           awaiting their L2 update  */
+        U64              compusecs;     /* Compress stage time       */
+        U64              writeusecs;    /* Write stage time          */
+};
+
+/*-------------------------------------------------------------------*/
+/*                   Batched file I/O                                */
+/*-------------------------------------------------------------------*/
+/* A CCKD_AIO queue belongs to one writer or readahead thread and is */
+/* only used with the device's file lock held.  Queued requests are  */
+/* started together by cckd_aio_submit with one io_uring_enter call. */
+/* Without io_uring (or if it fails) they are done synchronously.    */
+/*-------------------------------------------------------------------*/
+#if defined( HAVE_LINUX_IO_URING_H ) && defined( __NR_io_uring_setup )
+  #define CCKD_IOURING                  /* Linux io_uring available  */
+#endif
+
+struct CCKD_AIOREQ {                    /* Batched I/O request       */
+        DEVBLK          *dev;           /* Device                    */
+        int              sfx;           /* File index                */
+        int              write;         /* 1=write, 0=read           */
+        U64              off;           /* File offset               */
+        BYTE            *buf;           /* Buffer                    */
+        unsigned int     len;           /* Length                    */
+        int             *rc;            /* -> Return code or NULL    */
+};
+
+struct CCKD_AIO {                       /* Batched I/O queue         */
+        int              n;             /* Number requests queued    */
+        CCKD_AIOREQ      req[CCKD_AIO_DEPTH]; /* Queued requests     */
+        BYTE            *fixbuf;        /* Registered buffer or NULL */
+        size_t           fixlen;        /* Registered buffer length  */
+#if defined( CCKD_IOURING )
+        int              fd;            /* io_uring file descriptor  */
+        void            *sqring;        /* Submission ring mapping   */
+        size_t           sqringsz;      /* Submission ring size      */
+        void            *cqring;        /* Completion ring mapping   */
+        size_t           cqringsz;      /* Completion ring size      */
+        struct io_uring_sqe *sqes;      /* Submission queue entries  */
+        size_t           sqessz;        /* Submission entries size   */
+        unsigned        *sqtail;        /* Submission ring tail      */
+        unsigned        *sqmask;        /* Submission ring mask      */
+        unsigned        *sqarray;       /* Submission ring array     */
+        unsigned        *cqhead;        /* Completion ring head      */
+        unsigned        *cqtail;        /* Completion ring tail      */
+        unsigned        *cqmask;        /* Completion ring mask      */
+        struct io_uring_cqe *cqes;      /* Completion queue entries  */
+#endif
+};
+
+struct CCKD_IOSTATS {                   /* File I/O statistics       */
+        U64              subs;          /* Submissions               */
+        U64              ops;           /* Requests                  */
+        U64              aioops;        /* Requests done by io_uring */
+        unsigned int     qdmax;         /* Max requests per submit   */
+        unsigned int     rdlat[CCKD_IOLAT_NBR]; /* Read latencies    */
+        unsigned int     wrlat[CCKD_IOLAT_NBR]; /* Write latencies   */
+};
+
+/*-------------------------------------------------------------------*/
+/*                   Compression dictionary                          */
+/*-------------------------------------------------------------------*/
+/* A trained dictionary is stored in the file at `dict_off' and      */
+/* used to compress images with `dict_algo' (zlib or zstd).  Images  */
+/* identify the dictionary they were compressed with by its id:      */
+/* the adler32 in the zlib header or the dictID in the zstd frame.   */
+/*-------------------------------------------------------------------*/
+struct CCKD_DICT {                      /* Compression dictionary    */
+        BYTE            *dict_buf;      /* Dictionary contents       */
+        U32              dict_len;      /* Dictionary length         */
+        U32              dict_id;       /* Dictionary id             */
+        BYTE             dict_algo;     /* Compression algorithm     */
+        int              dict_level;    /* zstd cdict level          */
+        void            *dict_cdict;    /* zstd compression dict     */
+        void            *dict_ddict;    /* zstd decompression dict   */
+                                        /* Statistics, updated atomically
+                                           by concurrent writers     */
+        S32              comps;         /* Images compressed         */
+        S64              cinbytes;      /* Bytes before compression  */
+        S64              coutbytes;     /* Bytes after compression   */
+        S32              decomps;       /* Images uncompressed       */
+        S64              dbytes;        /* Bytes uncompressed        */
+        S64              dusecs;        /* Time spent uncompressing  */
+};
+
 /*-------------------------------------------------------------------*/
 /*                   Global CCKD dasd block                          */
 /*-------------------------------------------------------------------*/
@@ -302,6 +459,8 @@ struct CCKDBLK {                        /* Global cckd dasd block    */
         int              gcmax;         /* Max garbage collectors    */
         int              gcint;         /* Wait time in seconds      */
         int              gcparm;        /* Adjustment parm           */
+        int              gcslice;       /* Max msecs per slice or 0  */
+        int              gcrate;        /* Max KB moved per second   */
         bool             gcstart;       /* 1=start Garbage Collector */
         LOCK             wrlock;        /* I/O lock                  */
         COND             wrcond;        /* I/O condition             */
@@ -334,18 +493,27 @@ struct CCKDBLK {                        /* Global cckd dasd block    */
         int              gcmsgs;        /* Garbage collector msgs    */
         int              nosfd;         /* 1=No stats rpt at close   */
         int              nostress;      /* 1=No stress writes        */
+        int              cache2q;       /* 1=2Q track cache policy   */
         int              linuxnull;     /* 1=Always check nulltrk    */
         int              fsync;         /* 1=Perform fsync()         */
+        int              aio;           /* 1=Batch I/O with io_uring */
         COND             termcond;      /* Termination condition     */
 
         U64              stats_switches;       /* Switches           */
         U64              stats_cachehits;      /* Cache hits         */
         U64              stats_cachemisses;    /* Cache misses       */
+        U64              stats_ghosthits;      /* Ghost list hits    */
         U64              stats_readaheads;     /* Readaheads         */
+        U64              stats_readaheadused;  /* Readaheads used    */
         U64              stats_readaheadmisses;/* Readahead misses   */
         U64              stats_iowaits;        /* Waits for i/o      */
         U64              stats_cachewaits;     /* Waits for cache    */
         U64              stats_stresswrites;   /* Writes under stress*/
+        U64              stats_wrbatches;      /* Writer batches     */
+        U64              stats_wrtrks;         /* Tracks compressed  */
+        U64              stats_compusecs;      /* Compress stage usec*/
+        U64              stats_wrusecs;        /* Write stage usecs  */
+        U64              stats_wrqmax;         /* Max writes pending */
         U64              stats_l2cachehits;    /* L2 cache hits      */
         U64              stats_l2cachemisses;  /* L2 cache misses    */
         U64              stats_l2reads;        /* L2 reads           */
@@ -428,6 +596,11 @@ struct CCKD_EXT {                       /* Ext for compressed ckd    */
         int              ralkup[CCKD_MAX_RA_SIZE];/* Lookup table    */
 
         int              ratrk;         /* Track to readahead        */
+        int              ralast;        /* Last track read           */
+        int              raseq;         /* Nbr sequential reads      */
+        int              radepth;       /* Nbr tracks to read ahead  */
+        int              raqueued;      /* Nbr trks queued for stream*/
+        int              rahits;        /* Nbr trks used by stream   */
         unsigned int     totreads;      /* Total nbr trk reads       */
         unsigned int     totwrites;     /* Total nbr trk writes      */
         unsigned int     totl2reads;    /* Total nbr l2 reads        */
@@ -435,8 +608,20 @@ struct CCKD_EXT {                       /* Ext for compressed ckd    */
         unsigned int     cachehits;     /* Cache hits                */
 
         unsigned int     readaheads;    /* Number trks read ahead    */
+        unsigned int     raused;        /* Number readaheads used    */
         unsigned int     switches;      /* Number trk switches       */
-        unsigned int     misses;        /* Number readahead misses   */
+        unsigned int     misses;        /* Number readaheads dropped
+                                           from cache unused         */
+        unsigned int     ghosthits;     /* Number ghost list hits    */
+
+        S32              decomps;       /* Images uncompressed without
+                                           a dictionary (atomic)     */
+        S64              dbytes;        /* Bytes uncompressed        */
+        S64              dusecs;        /* Time spent uncompressing  */
+
+        CCKD_WRBATCH    *wrbatch;       /* Writer batch queueing the
+                                           track image writes or NULL*/
+        CCKD_IOSTATS     iostats;       /* File I/O statistics       */
 
         int              fd[CCKD_MAX_SF+1];      /* File descriptors */
         BYTE             swapend[CCKD_MAX_SF+1]; /* Swap endian flag */
@@ -446,6 +631,7 @@ struct CCKD_EXT {                       /* Ext for compressed ckd    */
         int              writes[CCKD_MAX_SF+1];  /* Nbr track writes */
         CCKD_L1ENT      *L1tab[CCKD_MAX_SF+1];   /* Level 1 tables   */
         CCKD_DEVHDR      cdevhdr[CCKD_MAX_SF+1]; /* cckd device hdr  */
+        CCKD_DICT        dict[CCKD_MAX_SF+1];    /* Dictionaries     */
 };
 
 #define CCKD_MIN_FREESIZE( free_count )     (CCKD_FREE_MIN_SIZE +   \
@@ -483,6 +669,7 @@ struct SPCTAB
 #define SPCTAB_L2UPPER        10        /* Space is L2 upper bound   */
 #define SPCTAB_DATA           11        /* Space is track/block data */
 #define SPCTAB_UNKNOWN        12        /* Unknown space             */
+#define SPCTAB_DICT           13        /* Space is dictionary       */
 
 /*-------------------------------------------------------------------*/
 /* Definitions for sense data format codes and message codes         */
@@ -60,7 +60,8 @@ const   CKD_RECHDR   CKD_ENDTRK  =      /* END-OF-TRACK marker is a     \
 /*-------------------------------------------------------------------*/
 /*    NOTE: The num_L1tab, num_L2tab, cyls, cdh_size, cdh_used,      */
 /*    free_off, free_total, free_largest, free_num, free_imbed,      */
-/*    and cmp_parm fields are kept in LITTLE endian format.          */
+/*    cmp_parm, dict_len and dict_off fields are kept in LITTLE      */
+/*    endian format.                                                 */
 /*-------------------------------------------------------------------*/
 struct CCKD64_DEVHDR                    /* Compress device header    */
 {
@@ -80,7 +81,10 @@ struct CCKD64_DEVHDR                    /* Compress device header    */
 /* 72 */BYTE             cdh_nullfmt;   /* Null track format         */
 /* 73 */BYTE             cmp_algo;      /* Compression algorithm     */
 /* 74 */S16              cmp_parm;      /* Compression parameter     */
-/* 76 */BYTE             resv2[436];    /* Reserved                  */
+/* 76 */U32              dict_len;      /* Dictionary length         */
+/* 80 */U64              dict_off;      /* Offset to dictionary      */
+/* 88 */BYTE             dict_algo;     /* Dictionary algorithm      */
+/* 89 */BYTE             resv2[423];    /* Reserved                  */
 };
 
 struct CCKD64_L2ENT {                   /* Level 2 table entry       */
@@ -192,6 +196,11 @@ struct CCKD64_EXT {                     /* Ext for compressed ckd    */
         int              ralkup[CCKD_MAX_RA_SIZE];/* Lookup table    */
 
         int              ratrk;         /* Track to readahead        */
+        int              ralast;        /* Last track read           */
+        int              raseq;         /* Nbr sequential reads      */
+        int              radepth;       /* Nbr tracks to read ahead  */
+        int              raqueued;      /* Nbr trks queued for stream*/
+        int              rahits;        /* Nbr trks used by stream   */
         unsigned int     totreads;      /* Total nbr trk reads       */
         unsigned int     totwrites;     /* Total nbr trk writes      */
         unsigned int     totl2reads;    /* Total nbr l2 reads        */
@@ -199,8 +208,20 @@ struct CCKD64_EXT {                     /* Ext for compressed ckd    */
         unsigned int     cachehits;     /* Cache hits                */
 
         unsigned int     readaheads;    /* Number trks read ahead    */
+        unsigned int     raused;        /* Number readaheads used    */
         unsigned int     switches;      /* Number trk switches       */
-        unsigned int     misses;        /* Number readahead misses   */
+        unsigned int     misses;        /* Number readaheads dropped
+                                           from cache unused         */
+        unsigned int     ghosthits;     /* Number ghost list hits    */
+
+        unsigned int     decomps;       /* Images uncompressed without
+                                           a dictionary              */
+        U64              dbytes;        /* Bytes uncompressed        */
+        U64              dusecs;        /* Time spent uncompressing  */
+
+        CCKD_WRBATCH    *wrbatch;       /* Writer batch queueing the
+                                           track image writes or NULL*/
+        CCKD_IOSTATS     iostats;       /* File I/O statistics       */
 
         int              fd[CCKD_MAX_SF+1];      /* File descriptors */
         BYTE             swapend[CCKD_MAX_SF+1]; /* Swap endian flag */
@@ -210,6 +231,7 @@ struct CCKD64_EXT {                     /* Ext for compressed ckd    */
         int              writes[CCKD_MAX_SF+1];  /* Nbr track writes */
         CCKD64_L1ENT    *L1tab[CCKD_MAX_SF+1];   /* Level 1 tables   */
         CCKD64_DEVHDR    cdevhdr[CCKD_MAX_SF+1]; /* cckd device hdr  */
+        CCKD_DICT        dict[CCKD_MAX_SF+1];    /* Dictionaries     */
 };
 
 /*-------------------------------------------------------------------*/
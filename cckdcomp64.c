@@ -31,6 +31,9 @@ int             i;                      /* Index                     */
 int             rc;                     /* Return code               */
 int             level=-1;               /* Level for chkdsk          */
 int             force=0;                /* 1=Compress if OPENED set  */
+int             comp=-1;                /* Recompress algorithm      */
+int             parm=-1;                /* Recompress parameter      */
+int             train=0;                /* 1=Train a dictionary      */
 CKD_DEVHDR      devhdr;                 /* CKD device header         */
 CCKD64_DEVHDR   cdevhdr;                /* Compressed CKD device hdr */
 DEVBLK          devblk;                 /* DEVBLK                    */
@@ -43,6 +46,53 @@ DEVBLK         *dev=&devblk;            /* -> DEVBLK                 */
     {
         if(**argv != '-') break;
 
+        /* recompression options */
+        if (strcmp(argv[0], "-none") == 0)
+        {
+            comp = CCKD_COMPRESS_NONE;
+            continue;
+        }
+#if defined( HAVE_ZLIB )
+        if (strcmp(argv[0], "-z") == 0)
+        {
+            comp = CCKD_COMPRESS_ZLIB;
+            continue;
+        }
+#endif
+#if defined( CCKD_BZIP2 )
+        if (strcmp(argv[0], "-bz2") == 0)
+        {
+            comp = CCKD_COMPRESS_BZIP2;
+            continue;
+        }
+#endif
+#if defined( CCKD_ZSTD )
+        if (strcmp(argv[0], "-zstd") == 0)
+        {
+            comp = CCKD_COMPRESS_ZSTD;
+            continue;
+        }
+#endif
+#if defined( CCKD_LZ4 )
+        if (strcmp(argv[0], "-lz4") == 0)
+        {
+            comp = CCKD_COMPRESS_LZ4;
+            continue;
+        }
+#endif
+        if (strcmp(argv[0], "-dict") == 0)
+        {
+            train = 1;
+            continue;
+        }
+        if (strcmp(argv[0], "-p") == 0)
+        {
+            if (argc < 2 || (parm = atoi(argv[1])) < 0 || parm > 22)
+                return syntax( pgm );
+            argc--; argv++;
+            continue;
+        }
+
         switch(argv[0][1])
         {
             case '0':
@@ -58,7 +108,9 @@ DEVBLK         *dev=&devblk;            /* -> DEVBLK                 */
         }
     }
 
-    if (argc < 1) return syntax( pgm );
+    if (argc < 1 || (parm >= 0 && comp < 0)) return syntax( pgm );
+    if (train && comp != CCKD_COMPRESS_ZLIB && comp != CCKD_COMPRESS_ZSTD)
+        return syntax( pgm );
 
     for (i = 0; i < argc; i++)
     {
@@ -137,6 +189,13 @@ DEVBLK         *dev=&devblk;            /* -> DEVBLK                 */
             continue;
         }
 
+        /* recompress the images if requested */
+        if (comp >= 0 && cckd64_recomp (dev, comp, parm, train) < 0)
+        {
+            close (dev->fd);
+            continue;
+        }
+
         /* call compress */
         rc = cckd64_comp (dev);
 
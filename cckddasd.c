@@ -33,7 +33,10 @@ DISABLE_GCC_UNUSED_SET_WARNING;
 
 DLL_EXPORT  CCKDBLK  cckdblk;       /* cckd global area */
 
-char*         compname   [] = { "none", "zlib", "bzip2" };
+char*         compname   [] = { "none", "zlib", "bzip2", "?",
+                                "zstd", "?",    "?",     "?",
+                                "lz4",  "?",    "?",     "?",
+                                "?",    "?",    "?",     "?" };
 CCKD_L2ENT    empty_l2   [ CKD_NULLTRK_FMTMAX + 1 ][256] = {0};
 CCKD64_L2ENT  empty64_l2 [ CKD_NULLTRK_FMTMAX + 1 ][256] = {0};
 
@@ -93,7 +96,7 @@ int cckd_dasd_init( int argc, BYTE* argv[] )
 
     cckdblk.ranbr      = CCKD_DEF_RA_SIZE;
     cckdblk.ramax      = CCKD_DEF_RA;
-    cckdblk.wrmax      = CCKD_DEF_WRITER;
+    cckdblk.wrmax      = MIN( CCKD_MAX_WRITER, MAX( CCKD_DEF_WRITER, hostinfo.num_procs ));
     cckdblk.dhmax      = CCKD_DEF_DHMAX;
     cckdblk.dhint      = CCKD_DEF_DHINT;
     cckdblk.dhstart    = CCKD_DEF_DHSTART;
@@ -108,6 +111,12 @@ int cckd_dasd_init( int argc, BYTE* argv[] )
 #endif
 #if defined( CCKD_BZIP2 )
     cckdblk.comps     |= CCKD_COMPRESS_BZIP2;
+#endif
+#if defined( CCKD_ZSTD )
+    cckdblk.comps     |= CCKD_COMPRESS_ZSTD;
+#endif
+#if defined( CCKD_LZ4 )
+    cckdblk.comps     |= CCKD_COMPRESS_LZ4;
 #endif
     cckdblk.comp       = 0xff;
     cckdblk.compparm   = -1;
@@ -267,6 +276,8 @@ char         buf[32];                   /* Work buffer                      */
     {
         cckd->L1idx = cckd->sfx = cckd->L2_active = -1;
         dev->cache = cckd->free_idx1st = -1;
+        cckd->ralast = -1;
+        cckd->radepth = cckdblk.readaheads;
         cckd->fd[0] = dev->fd;
         fdflags = get_file_accmode_flags( dev->fd );
         cckd->open[0] = (fdflags & O_RDWR) ? CCKD_OPEN_RW : CCKD_OPEN_RO;
@@ -411,9 +422,12 @@ int             rc, i;                  /* Return code, Loop index   */
             cckd->open[i] = 0;
         }
 
-        /* free the level 1 tables */
+        /* free the level 1 tables and dictionaries */
         for (i = 0; i <= cckd->sfn; i++)
+        {
             cckd->L1tab[i] = cckd_free (dev, "l1", cckd->L1tab[i]);
+            cckd_dict_free (&cckd->dict[i]);
+        }
 
         /* reset the device handler */
         if (cckd->ckddasd)
@@ -644,6 +658,8 @@ int             rc = 0;                 /* Return code               */
     cckd->fd[sfx] = -1;
     if (sfx == 0) dev->fd = -1;
 
+    cckd_dict_free (&cckd->dict[sfx]);
+
     return rc;
 
 } /* end function cckd_close */
@@ -655,12 +671,15 @@ int cckd_read( DEVBLK* dev, int sfx, off_t off, void* buf, unsigned int len )
 {
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
 int             rc;                     /* Return code               */
+struct timeval  beg;                    /* Start time                */
 
     cckd = dev->cckd_ext;
 
     CCKD_TRACE( "file[%d] fd[%d] read, off 0x%16.16"PRIx64" len %d",
                 sfx, cckd->fd[ sfx ], off, len );
 
+    gettimeofday( &beg, NULL );
+
     /* Seek to specified offset */
     if (lseek( cckd->fd[ sfx ], off, SEEK_SET ) < 0)
     {
@@ -673,6 +692,7 @@ int             rc;                     /* Return code               */
 
     /* Read the data */
     rc = read( cckd->fd[ sfx ], buf, len );
+    cckd_iostat( &cckd->iostats, 0, 1, &beg );
     if (rc < (int)len)
     {
         if (rc < 0)
@@ -702,12 +722,15 @@ int cckd_write( DEVBLK* dev, int sfx, off_t off, void* buf, unsigned int len )
 {
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
 int             rc = 0;                 /* Return code               */
+struct timeval  beg;                    /* Start time                */
 
     cckd = dev->cckd_ext;
 
     CCKD_TRACE( "file[%d] fd[%d] write, off 0x%16.16"PRIx64" len %d",
                 sfx, cckd->fd[ sfx ], off, len );
 
+    gettimeofday( &beg, NULL );
+
     /* Seek to specified offset */
     if (lseek( cckd->fd[ sfx ], off, SEEK_SET ) < 0)
     {
@@ -720,6 +743,7 @@ int             rc = 0;                 /* Return code               */
 
     /* Write the data */
     rc = write( cckd->fd[ sfx ], buf, len );
+    cckd_iostat( &cckd->iostats, 1, 1, &beg );
     if (rc < (int)len)
     {
         if (rc < 0)
@@ -767,6 +791,376 @@ CCKD_EXT       *cckd;                   /* -> cckd extension         */
 
 } /* end function cckd_ftruncate */
 
+/*-------------------------------------------------------------------*/
+/* Record a file I/O request in the device's I/O statistics          */
+/*                                                                   */
+/* `n' is the number of requests started together if this request   */
+/* is the first of a submission, otherwise zero.                     */
+/*-------------------------------------------------------------------*/
+void cckd_iostat( CCKD_IOSTATS* st, int write, int n, struct timeval* beg )
+{
+struct timeval  end;                    /* End time                  */
+U64             usecs;                  /* Latency                   */
+int             i;                      /* Histogram bucket          */
+
+    gettimeofday( &end, NULL );
+    usecs = (U64)(end.tv_sec - beg->tv_sec) * 1000000
+          + end.tv_usec - beg->tv_usec;
+
+    /* Buckets are <8us, <32us, <128us, ... <32ms, 32ms and more */
+    for (i = 0, usecs >>= 3; usecs && i < CCKD_IOLAT_NBR - 1; usecs >>= 2)
+        i++;
+
+    if (write) st->wrlat[i]++;
+    else       st->rdlat[i]++;
+
+    st->ops++;
+    if (n)
+    {
+        st->subs++;
+        if ((unsigned int)n > st->qdmax)
+            st->qdmax = n;
+    }
+} /* end function cckd_iostat */
+
+#if defined( CCKD_IOURING )
+/*-------------------------------------------------------------------*/
+/* Batched file I/O helper: statistics and descriptor for a request  */
+/*-------------------------------------------------------------------*/
+static CCKD_IOSTATS* cckd_aio_iostats( DEVBLK* dev )
+{
+    if (dev->cckd64)
+        return &((CCKD64_EXT*) dev->cckd_ext)->iostats;
+    return &((CCKD_EXT*) dev->cckd_ext)->iostats;
+}
+
+static int cckd_aio_fd( DEVBLK* dev, int sfx )
+{
+    if (dev->cckd64)
+        return ((CCKD64_EXT*) dev->cckd_ext)->fd[ sfx ];
+    return ((CCKD_EXT*) dev->cckd_ext)->fd[ sfx ];
+}
+#endif
+
+/*-------------------------------------------------------------------*/
+/* Create a batched I/O queue                                        */
+/*                                                                   */
+/* Returns NULL if io_uring is not available.  `fixbuf', if not      */
+/* NULL, is registered with the ring so that requests for buffers    */
+/* within it need not have their pages mapped on every submission.   */
+/*-------------------------------------------------------------------*/
+CCKD_AIO* cckd_aio_init( BYTE* fixbuf, size_t fixlen )
+{
+#if defined( CCKD_IOURING )
+CCKD_AIO       *aio;                    /* -> I/O queue              */
+struct io_uring_params p;               /* Ring parameters           */
+struct iovec    iov;                    /* Registered buffer         */
+BYTE           *sq, *cq;                /* Ring mappings             */
+
+    if (!(aio = calloc( 1, sizeof( CCKD_AIO ))))
+    {
+        // "CCKD file: io_uring not available: %s; using synchronous I/O"
+        WRMSG( HHC00465, "W", strerror( errno ));
+        return NULL;
+    }
+
+    memset( &p, 0, sizeof( p ));
+    aio->fd = (int) syscall( __NR_io_uring_setup, CCKD_AIO_DEPTH, &p );
+    if (aio->fd < 0)
+        goto cckd_aio_init_error;
+
+    aio->sqringsz = p.sq_off.array + p.sq_entries * sizeof( unsigned );
+    aio->cqringsz = p.cq_off.cqes  + p.cq_entries * sizeof( struct io_uring_cqe );
+    aio->sqessz   = p.sq_entries * sizeof( struct io_uring_sqe );
+
+    aio->sqring = mmap( NULL, aio->sqringsz, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, aio->fd, IORING_OFF_SQ_RING );
+    if (aio->sqring == MAP_FAILED)
+    {
+        aio->sqring = NULL;
+        goto cckd_aio_init_error;
+    }
+    aio->cqring = mmap( NULL, aio->cqringsz, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, aio->fd, IORING_OFF_CQ_RING );
+    if (aio->cqring == MAP_FAILED)
+    {
+        aio->cqring = NULL;
+        goto cckd_aio_init_error;
+    }
+    aio->sqes = mmap( NULL, aio->sqessz, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, aio->fd, IORING_OFF_SQES );
+    if (aio->sqes == MAP_FAILED)
+    {
+        aio->sqes = NULL;
+        goto cckd_aio_init_error;
+    }
+
+    sq = aio->sqring;
+    cq = aio->cqring;
+    aio->sqtail  = (unsigned*)(sq + p.sq_off.tail);
+    aio->sqmask  = (unsigned*)(sq + p.sq_off.ring_mask);
+    aio->sqarray = (unsigned*)(sq + p.sq_off.array);
+    aio->cqhead  = (unsigned*)(cq + p.cq_off.head);
+    aio->cqtail  = (unsigned*)(cq + p.cq_off.tail);
+    aio->cqmask  = (unsigned*)(cq + p.cq_off.ring_mask);
+    aio->cqes    = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    /* Failing to register the buffer (RLIMIT_MEMLOCK) is not an error */
+    if (fixbuf)
+    {
+        iov.iov_base = fixbuf;
+        iov.iov_len  = fixlen;
+        if (syscall( __NR_io_uring_register, aio->fd,
+                     IORING_REGISTER_BUFFERS, &iov, 1 ) == 0)
+        {
+            aio->fixbuf = fixbuf;
+            aio->fixlen = fixlen;
+        }
+    }
+
+    return aio;
+
+cckd_aio_init_error:
+
+    // "CCKD file: io_uring not available: %s; using synchronous I/O"
+    WRMSG( HHC00465, "W", strerror( errno ));
+    cckd_aio_term( aio );
+    return NULL;
+
+#else /* !defined( CCKD_IOURING ) */
+
+    UNREFERENCED( fixbuf );
+    UNREFERENCED( fixlen );
+
+    // "CCKD file: io_uring not available: %s; using synchronous I/O"
+    WRMSG( HHC00465, "W", strerror( ENOSYS ));
+    return NULL;
+
+#endif
+} /* end function cckd_aio_init */
+
+/*-------------------------------------------------------------------*/
+/* Destroy a batched I/O queue                                       */
+/*-------------------------------------------------------------------*/
+void cckd_aio_term( CCKD_AIO* aio )
+{
+    if (!aio)
+        return;
+
+#if defined( CCKD_IOURING )
+    if (aio->sqes)   munmap( aio->sqes,   aio->sqessz   );
+    if (aio->cqring) munmap( aio->cqring, aio->cqringsz );
+    if (aio->sqring) munmap( aio->sqring, aio->sqringsz );
+    if (aio->fd >= 0)
+        close( aio->fd );
+#endif
+
+    free( aio );
+} /* end function cckd_aio_term */
+
+/*-------------------------------------------------------------------*/
+/* Create or destroy a thread's batched I/O queue per `cckd aio='    */
+/*-------------------------------------------------------------------*/
+void cckd_aio_update( CCKD_AIO** aio, BYTE* fixbuf, size_t fixlen )
+{
+    if (cckdblk.aio && !*aio)
+    {
+        /* Don't retry (and warn) for every batch */
+        if (!(*aio = cckd_aio_init( fixbuf, fixlen )))
+            cckdblk.aio = 0;
+    }
+    else if (!cckdblk.aio && *aio)
+    {
+        cckd_aio_term( *aio );
+        *aio = NULL;
+    }
+} /* end function cckd_aio_update */
+
+/*-------------------------------------------------------------------*/
+/* Queue a read or write request                                     */
+/*                                                                   */
+/* The buffer must not be changed or freed until the request has     */
+/* been submitted.  If `rc' is not NULL it receives the return code  */
+/* cckd_read or cckd_write would have returned.  A full queue is     */
+/* submitted first.                                                  */
+/*-------------------------------------------------------------------*/
+void cckd_aio_queue( CCKD_AIO* aio, DEVBLK* dev, int sfx, U64 off,
+                     void* buf, unsigned int len, int write, int* rc )
+{
+CCKD_AIOREQ    *req;                    /* -> Request                */
+
+    CCKD_TRACE( "file[%d] queue %s, off 0x%16.16"PRIx64" len %d",
+                sfx, write ? "write" : "read", off, len );
+
+    if (aio->n >= CCKD_AIO_DEPTH)
+        cckd_aio_submit( aio );
+
+    req = &aio->req[ aio->n++ ];
+    req->dev   = dev;
+    req->sfx   = sfx;
+    req->write = write;
+    req->off   = off;
+    req->buf   = buf;
+    req->len   = len;
+    req->rc    = rc;
+
+} /* end function cckd_aio_queue */
+
+#if defined( CCKD_IOURING )
+/*-------------------------------------------------------------------*/
+/* Batched I/O helper: start the queued requests on the io_uring     */
+/* and wait for them to complete.  done[i] is set for each request   */
+/* that completed in full.  If io_uring_enter fails, the requests    */
+/* already started are still waited for before the ring is released */
+/* and the caller redoes the rest synchronously.                     */
+/*-------------------------------------------------------------------*/
+static void cckd_aio_ring( CCKD_AIO* aio, BYTE* done )
+{
+CCKD_AIOREQ    *req;                    /* -> Request                */
+struct io_uring_sqe *sqe;               /* -> Submission entry       */
+struct io_uring_cqe *cqe;               /* -> Completion entry       */
+struct timeval  beg;                    /* Submission time           */
+unsigned        tail, head;             /* Ring indexes              */
+int             i, rc;                  /* Index, return code        */
+int             tosubmit, pending;      /* Requests not yet ...      */
+int             fixed;                  /* 1=Registered buffer       */
+int             err = 0;                /* io_uring_enter errno      */
+
+    gettimeofday( &beg, NULL );
+
+    tail = *aio->sqtail;
+    for (i = 0; i < aio->n; i++, tail++)
+    {
+        req = &aio->req[i];
+        sqe = &aio->sqes[ tail & *aio->sqmask ];
+        memset( sqe, 0, sizeof( *sqe ));
+
+        fixed = aio->fixbuf
+             && req->buf >= aio->fixbuf
+             && req->buf + req->len <= aio->fixbuf + aio->fixlen;
+
+        if (req->write)
+            sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        else
+            sqe->opcode = fixed ? IORING_OP_READ_FIXED  : IORING_OP_READ;
+
+        sqe->fd        = cckd_aio_fd( req->dev, req->sfx );
+        sqe->off       = req->off;
+        sqe->addr      = (U64)(uintptr_t) req->buf;
+        sqe->len       = req->len;
+        sqe->user_data = i;
+
+        aio->sqarray[ tail & *aio->sqmask ] = tail & *aio->sqmask;
+    }
+    __atomic_store_n( aio->sqtail, tail, __ATOMIC_RELEASE );
+
+    /* After a failure only the requests the kernel has already
+       taken can still complete: stop submitting and wait for those */
+    for (tosubmit = pending = aio->n; pending > (err ? tosubmit : 0); )
+    {
+        rc = (int) syscall( __NR_io_uring_enter, aio->fd,
+                            err ? 0 : tosubmit, 1,
+                            IORING_ENTER_GETEVENTS, NULL, 0 );
+        if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            if (err)
+                break;
+            err = errno;
+            continue;
+        }
+        if (rc > 0 && !err)
+            tosubmit -= rc;
+
+        /* Reap the completions */
+        head = *aio->cqhead;
+        while (head != __atomic_load_n( aio->cqtail, __ATOMIC_ACQUIRE ))
+        {
+            cqe = &aio->cqes[ head++ & *aio->cqmask ];
+            i = (int) cqe->user_data;
+            if (i >= aio->n || done[i] == 2)
+                continue;
+            req = &aio->req[i];
+            pending--;
+
+            /* Errors and short transfers are redone synchronously */
+            done[i] = cqe->res == (int) req->len ? 1 : 2;
+            if (done[i] == 1)
+            {
+                CCKD_IOSTATS* st = cckd_aio_iostats( req->dev );
+                cckd_iostat( st, req->write, i ? 0 : aio->n, &beg );
+                st->aioops++;
+                if (req->rc)
+                    *req->rc = cqe->res;
+            }
+        }
+        __atomic_store_n( aio->cqhead, head, __ATOMIC_RELEASE );
+    }
+
+    if (err)
+    {
+        /* The ring is unusable: stop using io_uring */
+        // "CCKD file: io_uring not available: %s; using synchronous I/O"
+        WRMSG( HHC00465, "W", strerror( err ));
+        cckdblk.aio = 0;
+
+        /* If even waiting failed, requests may still complete into
+           the ring and their buffers: leave it for cckd_aio_term */
+        if (pending > tosubmit)
+            return;
+
+        munmap( aio->sqes,   aio->sqessz   );
+        munmap( aio->cqring, aio->cqringsz );
+        munmap( aio->sqring, aio->sqringsz );
+        close( aio->fd );
+        aio->sqes = aio->cqring = aio->sqring = NULL;
+        aio->fd = -1;
+    }
+} /* end function cckd_aio_ring */
+#endif /* defined( CCKD_IOURING ) */
+
+/*-------------------------------------------------------------------*/
+/* Submit the queued requests and wait for them to complete          */
+/*-------------------------------------------------------------------*/
+void cckd_aio_submit( CCKD_AIO* aio )
+{
+CCKD_AIOREQ    *req;                    /* -> Request                */
+DEVBLK         *dev;                    /* -> Device (for trace)     */
+BYTE            done[ CCKD_AIO_DEPTH ]; /* 1=Request completed       */
+int             i, rc;                  /* Index, return code        */
+
+    if (!aio->n)
+        return;
+
+    dev = aio->req[0].dev;
+    CCKD_TRACE( "submit %d requests", aio->n );
+
+    memset( done, 0, sizeof( done ));
+
+#if defined( CCKD_IOURING )
+    if (aio->fd >= 0 && cckdblk.aio)
+        cckd_aio_ring( aio, done );
+#endif
+
+    /* Do the rest synchronously; cckd_read and cckd_write report errors */
+    for (i = 0; i < aio->n; i++)
+    {
+        if (done[i] == 1)
+            continue;
+        req = &aio->req[i];
+        if (req->dev->cckd64)
+            rc = req->write ? cckd64_write( req->dev, req->sfx, req->off, req->buf, req->len )
+                            : cckd64_read ( req->dev, req->sfx, req->off, req->buf, req->len );
+        else
+            rc = req->write ? cckd_write( req->dev, req->sfx, (off_t) req->off, req->buf, req->len )
+                            : cckd_read ( req->dev, req->sfx, (off_t) req->off, req->buf, req->len );
+        if (req->rc)
+            *req->rc = rc;
+    }
+
+    aio->n = 0;
+
+} /* end function cckd_aio_submit */
+
 /*-------------------------------------------------------------------*/
 /*                          malloc                                   */
 /*-------------------------------------------------------------------*/
@@ -1072,7 +1466,7 @@ int             maxlen;                 /* Size for cache entry      */
         if ((cbuf[0] & CCKD_COMPRESS_MASK) != 0
          && (cbuf[0] & dev->comps) == 0)
         {
-            len = cache_getval(CACHE_DEVBUF, dev->cache) + CKD_TRKHDR_SIZE;
+            len = cache_getval(CACHE_DEVBUF, dev->cache);
             newbuf = cckd_uncompress (dev, cbuf, len, maxlen, blkgrp);
             if (newbuf == NULL)
             {
@@ -1114,10 +1508,14 @@ int             maxlen;                 /* Size for cache entry      */
     dev->bufoff   = 0;
     dev->bufoffhi = CFBA_BLKGRP_SIZE;
     dev->buflen   = CFBA_BLKGRP_SIZE;
-    cache_setval  (CACHE_DEVBUF, dev->cache, dev->buflen);
     dev->bufsize  = cache_getlen (CACHE_DEVBUF, dev->cache);
     dev->comp     = cbuf[0] & CCKD_COMPRESS_MASK;
 
+    /* Keep the image length from cckd_read_trk while the image is
+       still compressed; the decompressors need the exact length */
+    if (dev->comp == 0 || (dev->comp & dev->comps) != 0)
+        cache_setval (CACHE_DEVBUF, dev->cache, dev->buflen);
+
     /* If the image is compressed then call ourself recursively
        to cause the image to get uncompressed.  This is because
       `bufcur' will match blkgrp and `comps' won't match `comp' */
@@ -1230,9 +1628,7 @@ int             fnd;                    /* Cache index for hit       */
 int             lru;                    /* Oldest unused cache index */
 int             len;                    /* Length of track image     */
 int             maxlen;                 /* Length for buffer         */
-int             curtrk = -1;            /* Current track (at entry)  */
-U16             devnum;                 /* Device number             */
-U32             oldtrk;                 /* Stolen track number       */
+int             used = 0;               /* 1=Hit a track read ahead  */
 U32             flag;                   /* Cache flag                */
 BYTE           *buf;                    /* Read buffer               */
 
@@ -1253,7 +1649,6 @@ BYTE           *buf;                    /* Read buffer               */
     /* Inactivate the old entry */
     if (!ra)
     {
-        curtrk = dev->bufcur;
         if (dev->cache >= 0)
             cache_setflag(CACHE_DEVBUF, dev->cache, ~CCKD_CACHE_ACTIVE, 0);
         dev->bufcur = dev->cache = -1;
@@ -1272,6 +1667,15 @@ cckd_read_trk_retry:
             return fnd;
         }
 
+        /* A track read before (not just read ahead) is promoted */
+        if (cache_getflag(CACHE_DEVBUF, fnd) & CCKD_CACHE_USED)
+            cache_promote(CACHE_DEVBUF, fnd);
+        else
+        {
+            cckdblk.stats_readaheadused++; cckd->raused++;
+            used = 1;
+        }
+
         /* Mark the new entry active */
         cache_setflag(CACHE_DEVBUF, fnd, ~0, CCKD_CACHE_ACTIVE | CCKD_CACHE_USED);
         cache_setage(CACHE_DEVBUF, fnd);
@@ -1313,8 +1717,7 @@ cckd_read_trk_retry:
         release_lock (&cckd->cckdiolock);
 
         /* Asynchrously schedule readaheads */
-        if (curtrk > 0 && trk > curtrk && trk <= curtrk + 2)
-            cckd_readahead (dev, trk);
+        cckd_readahead (dev, trk, used);
 
         return fnd;
 
@@ -1345,42 +1748,15 @@ cckd_read_trk_retry:
         goto cckd_read_trk_retry;
     }
 
-    CCKD_CACHE_GETKEY(lru, devnum, oldtrk);
-    if (devnum != 0)
-    {
-        CCKD_TRACE( "%d rdtrk[%d] %d dropping %4.4X:%d from cache",
-                    ra, lru, trk, devnum, oldtrk);
-        if (!(cache_getflag(CACHE_DEVBUF, lru) & CCKD_CACHE_USED))
-        {
-            cckdblk.stats_readaheadmisses++;  cckd->misses++;
-        }
-    }
-
-    /* Initialize the entry */
-    cache_setkey(CACHE_DEVBUF, lru, CCKD_CACHE_SETKEY(dev->devnum, trk));
-    cache_setflag(CACHE_DEVBUF, lru, 0, CCKD_CACHE_READING);
-    cache_setage(CACHE_DEVBUF, lru);
-    cache_setval(CACHE_DEVBUF, lru, 0);
-    if (!ra)
-    {
-        cckdblk.stats_switches++; cckd->switches++;
-        cckdblk.stats_cachemisses++;
-        cache_setflag(CACHE_DEVBUF, lru, ~0, CCKD_CACHE_ACTIVE|CCKD_CACHE_USED);
-    }
-    cache_setflag(CACHE_DEVBUF, lru, ~CACHE_TYPE,
-                  cckd->ckddasd ? DEVBUF_TYPE_CCKD : DEVBUF_TYPE_CFBA);
-    buf = cache_getbuf(CACHE_DEVBUF, lru, maxlen);
-
-    CCKD_TRACE( "%d rdtrk[%d] %d buf %p len %d",
-                ra, lru, trk, buf, cache_getlen(CACHE_DEVBUF, lru));
+    buf = cckd_read_trk_entry (dev, lru, trk, ra, maxlen);
 
     cache_unlock (CACHE_DEVBUF);
 
     if (!ra) release_lock (&cckd->cckdiolock);
 
     /* Asynchronously schedule readaheads */
-    if (!ra && curtrk > 0 && trk > curtrk && trk <= curtrk + 2)
-        cckd_readahead (dev, trk);
+    if (!ra)
+        cckd_readahead (dev, trk, 0);
 
     /* Clear the buffer if batch mode */
     if (dev->batch) memset(buf, 0, maxlen);
@@ -1425,43 +1801,241 @@ cckd_read_trk_retry:
 } /* end function cckd_read_trk */
 
 /*-------------------------------------------------------------------*/
-/* Schedule asynchronous readaheads                                  */
+/* Initialize the stolen cache entry `lru' for reading a track       */
+/*                                                                   */
+/* Called with the cache lock held.  Returns the entry's buffer.     */
 /*-------------------------------------------------------------------*/
-void cckd_readahead (DEVBLK *dev, int trk)
+BYTE* cckd_read_trk_entry (DEVBLK *dev, int lru, int trk, int ra, int maxlen)
 {
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
-int             i, r;                   /* Indexes                   */
-TID             tid;                    /* Readahead thread id       */
-int             rc;
+U16             devnum;                 /* Device number             */
+U32             oldtrk;                 /* Stolen track number       */
+BYTE           *buf;                    /* Read buffer               */
 
     cckd = dev->cckd_ext;
 
-    if (cckdblk.ramax < 1 || cckdblk.readaheads < 1)
+    CCKD_CACHE_GETKEY(lru, devnum, oldtrk);
+    if (devnum != 0)
+    {
+        CCKD_TRACE( "%d rdtrk[%d] %d dropping %4.4X:%d from cache",
+                    ra, lru, trk, devnum, oldtrk);
+        if (!(cache_getflag(CACHE_DEVBUF, lru) & CCKD_CACHE_USED))
+            cckd_readahead_wasted (dev, devnum);
+    }
+
+    /* Initialize the entry */
+    cache_setkey(CACHE_DEVBUF, lru, CCKD_CACHE_SETKEY(dev->devnum, trk));
+    if (cache_protected(CACHE_DEVBUF, lru))
+    {
+        cckdblk.stats_ghosthits++; cckd->ghosthits++;
+    }
+    cache_setflag(CACHE_DEVBUF, lru, 0, CCKD_CACHE_READING);
+    cache_setage(CACHE_DEVBUF, lru);
+    cache_setval(CACHE_DEVBUF, lru, 0);
+    if (!ra)
+    {
+        cckdblk.stats_switches++; cckd->switches++;
+        cckdblk.stats_cachemisses++;
+        cache_setflag(CACHE_DEVBUF, lru, ~0, CCKD_CACHE_ACTIVE|CCKD_CACHE_USED);
+    }
+    cache_setflag(CACHE_DEVBUF, lru, ~CACHE_TYPE,
+                  cckd->ckddasd ? DEVBUF_TYPE_CCKD : DEVBUF_TYPE_CFBA);
+    buf = cache_getbuf(CACHE_DEVBUF, lru, maxlen);
+
+    CCKD_TRACE( "%d rdtrk[%d] %d buf %p len %d",
+                ra, lru, trk, buf, cache_getlen(CACHE_DEVBUF, lru));
+
+    return buf;
+
+} /* end function cckd_read_trk_entry */
+
+/*-------------------------------------------------------------------*/
+/* Read ahead several tracks with one submission                     */
+/*                                                                   */
+/* Like cckd_read_trk (with `ra' nonzero) for each of the `n' tracks */
+/* except that the track images are read together using `aio'.       */
+/*-------------------------------------------------------------------*/
+void cckd_readahead_trks (DEVBLK *dev, int *trks, int n, int ra, CCKD_AIO *aio)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             fnd;                    /* Cache index for hit       */
+int             lru;                    /* Oldest unused cache index */
+int             maxlen;                 /* Length for buffer         */
+int             i, k, j;                /* Indexes                   */
+int             o[CCKD_AIO_DEPTH];      /* Cache entries             */
+int             t[CCKD_AIO_DEPTH];      /* Tracks being read         */
+int             lens[CCKD_AIO_DEPTH];   /* Track image lengths       */
+BYTE           *bufs[CCKD_AIO_DEPTH];   /* Read buffers              */
+U32             flag;                   /* Cache flag                */
+int             signal = 0;             /* 1=Signal read complete    */
+
+    if (dev->cckd64)
+    {
+        cckd64_readahead_trks( dev, trks, n, ra, aio );
         return;
+    }
 
-    obtain_lock (&cckdblk.ralock);
+    cckd = dev->cckd_ext;
 
-    /* Scan the cache to see if the tracks are already there */
-    memset( cckd->ralkup, 0, sizeof(cckd->ralkup) );
-    cckd->ratrk = trk;
-    cache_lock(CACHE_DEVBUF);
-    cache_scan(CACHE_DEVBUF, cckd_readahead_scan, dev);
-    cache_unlock(CACHE_DEVBUF);
+    maxlen = cckd->ckddasd ? dev->ckdtrksz
+                           : CFBA_BLKGRP_SIZE + CKD_TRKHDR_SIZE;
 
-    /* Scan the queue to see if the tracks are already there */
-    for (r = cckdblk.ra1st; r >= 0; r = cckdblk.ra[r].ra_idxnxt)
-        if (cckdblk.ra[r].ra_dev == dev)
+    /* Get cache entries for the tracks not already cached */
+    cache_lock (CACHE_DEVBUF);
+    for (i = k = 0; i < n && k < CCKD_AIO_DEPTH; i++)
+    {
+        CCKD_TRACE( "%d rdtrk     %d", ra, trks[i]);
+
+        fnd = cache_lookup (CACHE_DEVBUF, CCKD_CACHE_SETKEY(dev->devnum, trks[i]), &lru);
+        if (fnd >= 0)
+            continue;
+
+        /* The rest are read by cckd_read_trk, which waits for entries */
+        if (lru < 0)
+            break;
+
+        CCKD_TRACE( "%d rdtrk[%d] %d cache miss", ra, lru, trks[i]);
+
+        t[k] = trks[i];
+        o[k] = lru;
+        bufs[k] = cckd_read_trk_entry (dev, lru, trks[i], ra, maxlen);
+        k++;
+    }
+    cache_unlock (CACHE_DEVBUF);
+
+    /* Read the track images */
+    if (k)
+    {
+        /* Clear the buffers if batch mode */
+        if (dev->batch)
+            for (j = 0; j < k; j++)
+                memset(bufs[j], 0, maxlen);
+
+        obtain_lock( &cckd->filelock );
         {
-            i = cckdblk.ra[r].ra_trk - trk;
-            if (i > 0 && i <= cckdblk.readaheads)
-                cckd->ralkup[i-1] = 1;
+            cckd_read_trkimgs (dev, bufs, t, lens, k, aio);
         }
+        release_lock( &cckd->filelock );
+    }
 
-    /* Queue the tracks to the readahead queue */
-    for (i = 1; i <= cckdblk.readaheads && cckdblk.rafree >= 0; i++)
+    obtain_lock (&cckd->cckdiolock);
     {
-        if (cckd->ralkup[i-1]) continue;
-        if (trk + i >= dev->ckdtrks) break;
+        for (j = 0; j < k; j++)
+        {
+            cache_setval (CACHE_DEVBUF, o[j], lens[j]);
+
+            /* Turn off the READING bit */
+            cache_lock (CACHE_DEVBUF);
+            flag = cache_setflag(CACHE_DEVBUF, o[j], ~CCKD_CACHE_READING, 0);
+            cache_unlock (CACHE_DEVBUF);
+
+            if (cckd->cckdwaiters && (flag & CCKD_CACHE_IOWAIT))
+            {   CCKD_TRACE( "%d rdtrk[%d] %d signalling read complete",
+                            ra, o[j], t[j]);
+                signal = 1;
+            }
+
+            cckdblk.stats_readaheads++; cckd->readaheads++;
+
+            CCKD_TRACE( "%d rdtrk[%d] %d complete buf %p:%2.2x%2.2x%2.2x%2.2x%2.2x",
+                        ra, o[j], t[j], bufs[j], bufs[j][0], bufs[j][1],
+                        bufs[j][2], bufs[j][3], bufs[j][4]);
+        }
+
+        /* Wakeup other threads waiting for these reads */
+        if (signal)
+            broadcast_condition (&cckd->cckdiocond);
+    }
+    release_lock (&cckd->cckdiolock);
+
+    for (; i < n; i++)
+        cckd_read_trk (dev, trks[i], ra, NULL);
+
+    if (cache_busy_percent(CACHE_DEVBUF) > 80) cckd_flush_cache_all();
+
+} /* end function cckd_readahead_trks */
+
+/*-------------------------------------------------------------------*/
+/* Schedule asynchronous readaheads                                  */
+/*                                                                   */
+/* Called by the i/o thread for each track it reads; `used' is 1 if  */
+/* the track had been read ahead.  A read of one of the next two     */
+/* tracks continues a sequential stream, any other read ends it.     */
+/* The number of tracks read ahead for the device starts at          */
+/* cckdblk.readaheads and doubles, up to CCKD_MAX_READAHEADS, each   */
+/* time one of them is used.  A stream that used fewer than half of  */
+/* the tracks read ahead for it halves the number; at zero the       */
+/* device is taken to be read randomly and nothing more is read      */
+/* ahead until CCKD_RA_SEQMIN sequential reads in a row.             */
+/*-------------------------------------------------------------------*/
+void cckd_readahead (DEVBLK *dev, int trk, int used)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             i, r;                   /* Indexes                   */
+int             n;                      /* Nbr tracks to read ahead  */
+int             trks;                   /* Nbr tracks on the device  */
+TID             tid;                    /* Readahead thread id       */
+int             rc;
+
+    cckd = dev->cckd_ext;
+
+    if (cckdblk.ramax < 1 || cckdblk.readaheads < 1)
+        return;
+
+    /* Follow the access pattern */
+    if (trk <= cckd->ralast || trk > cckd->ralast + 2)
+    {
+        if (cckd->rahits * 2 < cckd->raqueued)
+            cckd->radepth /= 2;
+        cckd->ralast = trk;
+        cckd->raseq = cckd->raqueued = cckd->rahits = 0;
+        return;
+    }
+    cckd->ralast = trk;
+    cckd->raseq++;
+    if (used)
+    {
+        cckd->rahits++;
+        if (cckd->radepth < CCKD_MAX_READAHEADS / 2)
+            cckd->radepth = cckd->radepth ? cckd->radepth * 2 : 1;
+        else
+            cckd->radepth = CCKD_MAX_READAHEADS;
+    }
+    else if (!cckd->radepth)
+    {
+        if (cckd->raseq < CCKD_RA_SEQMIN)
+            return;
+        cckd->radepth = 1;
+    }
+    n = cckd->radepth;
+
+    trks = cckd->ckddasd ? dev->ckdtrks
+         : (dev->fbanumblk + CFBA_BLKS_PER_GRP - 1) / CFBA_BLKS_PER_GRP;
+
+    obtain_lock (&cckdblk.ralock);
+
+    /* Scan the cache to see if the tracks are already there */
+    memset( cckd->ralkup, 0, sizeof(cckd->ralkup) );
+    cckd->ratrk = trk;
+    cache_lock(CACHE_DEVBUF);
+    cache_scan(CACHE_DEVBUF, cckd_readahead_scan, dev);
+    cache_unlock(CACHE_DEVBUF);
+
+    /* Scan the queue to see if the tracks are already there */
+    for (r = cckdblk.ra1st; r >= 0; r = cckdblk.ra[r].ra_idxnxt)
+        if (cckdblk.ra[r].ra_dev == dev)
+        {
+            i = cckdblk.ra[r].ra_trk - trk;
+            if (i > 0 && i <= n)
+                cckd->ralkup[i-1] = 1;
+        }
+
+    /* Queue the tracks to the readahead queue */
+    for (i = 1; i <= n && cckdblk.rafree >= 0; i++)
+    {
+        if (cckd->ralkup[i-1]) continue;
+        if (trk + i >= trks) break;
+        cckd->raqueued++;
         r = cckdblk.rafree;
         cckdblk.rafree = cckdblk.ra[r].ra_idxnxt;
         if (cckdblk.ralast < 0)
@@ -1532,12 +2106,32 @@ int             k;                      /* Index                     */
     if (devnum == dev->devnum)
     {
         k = (int)trk - cckd->ratrk;
-        if (k > 0 && k <= cckdblk.readaheads)
+        if (k > 0 && k <= CCKD_MAX_READAHEADS)
             cckd->ralkup[k-1] = 1;
     }
     return 0;
 }
 
+/*-------------------------------------------------------------------*/
+/* Count a track read ahead for `devnum' dropped from cache unused   */
+/*                                                                   */
+/* Called with the cache lock held by the device stealing the entry. */
+/*-------------------------------------------------------------------*/
+void cckd_readahead_wasted (DEVBLK *dev, U16 devnum)
+{
+    cckdblk.stats_readaheadmisses++;
+
+    if (dev->devnum != devnum)
+        dev = cckd_find_device_by_devnum (devnum);
+    if (dev == NULL)
+        return;
+
+    if (dev->cckd64)
+        ((CCKD64_EXT*) dev->cckd_ext)->misses++;
+    else
+        ((CCKD_EXT*) dev->cckd_ext)->misses++;
+} /* end function cckd_readahead_wasted */
+
 /*-------------------------------------------------------------------*/
 /* Asynchronous readahead thread                                     */
 /*-------------------------------------------------------------------*/
@@ -1545,9 +2139,11 @@ void* cckd_ra (void* arg)
 {
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
 DEVBLK         *dev;                    /* Readahead devblk          */
-int             trk;                    /* Readahead track           */
 int             ra;                     /* Readahead index           */
 int             r;                      /* Readahead queue index     */
+int             trks[CCKD_AIO_DEPTH];   /* Readahead tracks          */
+int             n;                      /* Number readahead tracks   */
+CCKD_AIO       *aio = NULL;             /* Batched I/O queue         */
 TID             tid;                    /* Readahead thread id       */
 char            threadname[40];
 int             rc;
@@ -1600,19 +2196,31 @@ int             ras;
         if (cckdblk.ra1st < 0)
             continue;
 
+        cckd_aio_update( &aio, NULL, 0 );
+
         r = cckdblk.ra1st;
-        trk = cckdblk.ra[r].ra_trk;
         dev = cckdblk.ra[r].ra_dev;
 
         cckd = dev->cckd_ext;
 
-        /* Requeue the 1st entry to the readahead free queue */
-        cckdblk.ra1st = cckdblk.ra[r].ra_idxnxt;
-        if (cckdblk.ra[r].ra_idxnxt > -1)
-            cckdblk.ra[cckdblk.ra[r].ra_idxnxt].ra_idxprv = -1;
-        else cckdblk.ralast = -1;
-        cckdblk.ra[r].ra_idxnxt = cckdblk.rafree;
-        cckdblk.rafree = r;
+        /* With an I/O queue, take the following entries for the same
+           device too so that their tracks are read together */
+        n = 0;
+        do
+        {
+            trks[n++] = cckdblk.ra[r].ra_trk;
+
+            /* Requeue the 1st entry to the readahead free queue */
+            cckdblk.ra1st = cckdblk.ra[r].ra_idxnxt;
+            if (cckdblk.ra[r].ra_idxnxt > -1)
+                cckdblk.ra[cckdblk.ra[r].ra_idxnxt].ra_idxprv = -1;
+            else cckdblk.ralast = -1;
+            cckdblk.ra[r].ra_idxnxt = cckdblk.rafree;
+            cckdblk.rafree = r;
+
+            r = cckdblk.ra1st;
+        }
+        while (aio && r >= 0 && n < CCKD_AIO_DEPTH && cckdblk.ra[r].ra_dev == dev);
 
         /* Schedule the other readaheads if any are still pending */
         if (cckdblk.ra1st)
@@ -1652,8 +2260,11 @@ int             ras;
 
         release_lock (&cckdblk.ralock);
         {
-            /* Read the readahead track */
-            cckd_read_trk (dev, trk, ra, NULL);
+            /* Read the readahead tracks */
+            if (n > 1)
+                cckd_readahead_trks (dev, trks, n, ra, aio);
+            else
+                cckd_read_trk (dev, trks[0], ra, NULL);
         }
         obtain_lock (&cckdblk.ralock);
 
@@ -1671,6 +2282,8 @@ int             ras;
 
     release_lock( &cckdblk.ralock );
 
+    cckd_aio_term( aio );
+
     if (!ras)
         signal_condition( &cckdblk.termcond );
 
@@ -2024,7 +2637,11 @@ DEVBLK         *dev = data;             /* -> device block           */
 void* cckd_writer( void* arg )
 {
 int             writer;                 /* Writer identifier         */
-int             o;                      /* Cache entry found         */
+int             i;                      /* Index                     */
+CCKD_WRBATCH    batch;                  /* Pending writes taken      */
+int             maxbatch;               /* Max writes per batch      */
+BYTE*           bufs;                   /* Compress buffers          */
+BYTE            buf2[ CCKD_WR_BUFSIZE ];/* Compress buffer if no bufs*/
 TID             tid;                    /* Writer thead id           */
 char            threadname[40];
 int             rc;
@@ -2032,6 +2649,13 @@ int             wrs;
 
     UNREFERENCED( arg );
 
+    /* One compress buffer per track of a batch */
+    if ((bufs = malloc( CCKD_WR_BATCH * CCKD_WR_BUFSIZE )) != NULL)
+        maxbatch = CCKD_WR_BATCH;
+    else
+        maxbatch = 1;
+    batch.aio = NULL;
+
     /* Set the writer thread's priority just BELOW the CPU threads'
        in order to minimize any potential impact from compression.
     */
@@ -2066,6 +2690,7 @@ int             wrs;
 
         release_lock( &cckdblk.wrlock );
         signal_condition( &cckdblk.termcond );/* shutting down */
+        free( bufs );
         return NULL;
     }
 
@@ -2085,28 +2710,38 @@ int             wrs;
             cckdblk.wrwaiting--;
         }
 
-        /* Scan the cache for the oldest pending write */
+        if ((U64)cckdblk.wrpending > cckdblk.stats_wrqmax)
+            cckdblk.stats_wrqmax = cckdblk.wrpending;
+
+        /* Take an even share of the pending writes, so that every
+           active writer has some to compress */
+        batch.n   = 0;
+        batch.max = cckdblk.wrpending / MAX( cckdblk.wra, 1 );
+        batch.max = MIN( maxbatch, MAX( batch.max, 1 ));
+
+        /* Scan the cache for the oldest pending writes */
         cache_lock( CACHE_DEVBUF );
         {
-            o = cache_scan( CACHE_DEVBUF, cckd_writer_scan, NULL );
+            cache_scan( CACHE_DEVBUF, cckd_writer_scan, &batch );
 
             /* Possibly shutting down if no writes pending */
-            if (o < 0)
+            if (batch.n == 0)
             {
                 cache_unlock( CACHE_DEVBUF );
                 cckdblk.wrpending = 0;
                 continue;
             }
 
-            /* We will process this cache entry. Clear flags to prevent
-               any other writer threads from trying to process it too. */
-            cache_setflag( CACHE_DEVBUF, o, ~CCKD_CACHE_WRITE, CCKD_CACHE_WRITING );
+            /* We will process these cache entries. Clear flags to prevent
+               any other writer threads from trying to process them too. */
+            for (i = 0; i < batch.n; i++)
+                cache_setflag( CACHE_DEVBUF, batch.o[i], ~CCKD_CACHE_WRITE, CCKD_CACHE_WRITING );
         }
         cache_unlock (CACHE_DEVBUF);
 
         /* Schedule the other writers if any writes are still pending */
 
-        cckdblk.wrpending--;
+        cckdblk.wrpending = MAX( cckdblk.wrpending - batch.n, 0 );
 
         if (cckdblk.wrpending)
         {
@@ -2143,12 +2778,21 @@ int             wrs;
             }
         }
 
-        /* Write the updated track image */
+        /* Compress and write the updated track images */
         release_lock( &cckdblk.wrlock );
         {
-            cckd_writer_write( writer, o );
+            if (bufs)
+                cckd_aio_update( &batch.aio, bufs, CCKD_WR_BATCH * CCKD_WR_BUFSIZE );
+            else
+                cckd_aio_update( &batch.aio, NULL, 0 );
+            cckd_writer_batch( writer, &batch, bufs ? bufs : buf2 );
         }
         obtain_lock( &cckdblk.wrlock );
+
+        cckdblk.stats_wrbatches++;
+        cckdblk.stats_wrtrks    += batch.n;
+        cckdblk.stats_compusecs += batch.compusecs;
+        cckdblk.stats_wrusecs   += batch.writeusecs;
     }
     /* end while (writer <= cckdblk.wrmax || cckdblk.wrpending) */
 
@@ -2166,54 +2810,122 @@ int             wrs;
     if (!wrs)
         signal_condition( &cckdblk.termcond );
 
+    cckd_aio_term( batch.aio );
+    free( bufs );
     return NULL;
 } /* end thread cckd_writer */
 
+/*-------------------------------------------------------------------*/
+/* Collect the `max' oldest pending writes, oldest first             */
+/*-------------------------------------------------------------------*/
 int cckd_writer_scan( int* o, int ix, int i, void* data )
 {
-    UNREFERENCED( data );
+CCKD_WRBATCH*   batch = data;           /* -> writer batch           */
+U64             age;                    /* Age of this entry         */
+int             j;                      /* Insertion point           */
+
+    UNREFERENCED( o );
 
-    if (1
-        && (cache_getflag( ix, i ) & DEVBUF_TYPE_COMP)
-        && (cache_getflag( ix, i ) & CCKD_CACHE_WRITE)
-        && (0
-            || *o == -1
-            || cache_getage( ix, i ) < cache_getage( ix, *o )
-           )
+    if (0
+        || !(cache_getflag( ix, i ) & DEVBUF_TYPE_COMP)
+        || !(cache_getflag( ix, i ) & CCKD_CACHE_WRITE)
     )
-        *o = i;
+        return 0;
+
+    age = cache_getage( ix, i );
+    if (batch->n == batch->max && age >= cache_getage( ix, batch->o[ batch->n - 1 ]))
+        return 0;
+
+    j = batch->n < batch->max ? batch->n++ : batch->n - 1;
+    for (; j > 0 && age < cache_getage( ix, batch->o[ j-1 ]); j--)
+        batch->o[ j ] = batch->o[ j-1 ];
+    batch->o[ j ] = i;
 
     return 0;
 }
 
 /*-------------------------------------------------------------------*/
-/* cckd writer thread helper:   write the cached track image         */
+/* cckd writer thread helper:   compress, then write, a batch        */
+/*                                                                   */
+/* All images are compressed before any is written.  The writes are  */
+/* then done in key (device, track) order so that consecutive tracks */
+/* are given ascending space by cckd_get_space.  Each device's images*/
+/* are written together, with one submission if `cckd aio=1'.        */
+/*-------------------------------------------------------------------*/
+void cckd_writer_batch( int writer, CCKD_WRBATCH* batch, BYTE* bufs )
+{
+struct timeval  beg, mid, end;          /* Stage times               */
+int             i, j;                   /* Indexes                   */
+int             o, bufl;                /* Entry being moved         */
+BYTE*           bufp;                   /* Entry being moved         */
+U16             devnum, devnum2;        /* Device numbers            */
+U32             trk;                    /* Track number              */
+
+    gettimeofday( &beg, NULL );
+
+    for (i = 0; i < batch->n; i++)
+        batch->bufl[i] = cckd_writer_comp( writer, batch->o[i],
+                                           bufs + i * CCKD_WR_BUFSIZE,
+                                           &batch->bufp[i] );
+    gettimeofday( &mid, NULL );
+
+    /* Keys are not changed while the entries are busy writing */
+    for (i = 1; i < batch->n; i++)
+    {
+        o    = batch->o[i];
+        bufp = batch->bufp[i];
+        bufl = batch->bufl[i];
+        for (j = i; j > 0 && cache_getkey( CACHE_DEVBUF, batch->o[j-1] )
+                           > cache_getkey( CACHE_DEVBUF, o ); j--)
+        {
+            batch->o[j]    = batch->o[j-1];
+            batch->bufp[j] = batch->bufp[j-1];
+            batch->bufl[j] = batch->bufl[j-1];
+        }
+        batch->o[j]    = o;
+        batch->bufp[j] = bufp;
+        batch->bufl[j] = bufl;
+    }
+
+    for (i = 0; i < batch->n; i = j)
+    {
+        CCKD_CACHE_GETKEY( batch->o[i], devnum, trk );
+        for (j = i + 1; j < batch->n; j++)
+        {
+            CCKD_CACHE_GETKEY( batch->o[j], devnum2, trk );
+            if (devnum2 != devnum)
+                break;
+        }
+        cckd_writer_write( writer, batch, i, j );
+    }
+    gettimeofday( &end, NULL );
+
+    batch->compusecs  = (U64)(mid.tv_sec - beg.tv_sec) * 1000000
+                      + mid.tv_usec - beg.tv_usec;
+    batch->writeusecs = (U64)(end.tv_sec - mid.tv_sec) * 1000000
+                      + end.tv_usec - mid.tv_usec;
+}
+
+/*-------------------------------------------------------------------*/
+/* cckd writer thread helper:   compress the cached track image      */
 /*-------------------------------------------------------------------*/
-void cckd_writer_write( int writer, int o )
+int cckd_writer_comp( int writer, int o, BYTE* buf2, BYTE** bufp )
 {
-TID             tid;                    /* Writer thead id           */
 CCKD_EXT*       cckd;                   /* -> cckd extension         */
 DEVBLK*         dev;                    /* Device block              */
 U16             devnum;                 /* Device number             */
-int             rc;                     /* (work) return code        */
 int             trk;                    /* Track number              */
 BYTE*           buf;                    /* Buffer                    */
-BYTE*           bufp;                   /* Buffer to be written      */
 int             len, bufl;              /* Buffer lengths            */
 int             comp;                   /* Compression algorithm     */
 int             parm;                   /* Compression parameter     */
-U32             flag;                   /* Cache flag                */
-BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
 
     /* Prepare to compress */
     CCKD_CACHE_GETKEY( o, devnum, trk );
     dev = cckd_find_device_by_devnum( devnum );
 
     if (dev->cckd64)
-    {
-        cckd64_writer_write( writer, o );
-        return;
-    }
+        return cckd64_writer_comp( writer, o, buf2, bufp );
 
     cckd = dev->cckd_ext;
     buf  = cache_getbuf( CACHE_DEVBUF, o, 0 );
@@ -2254,18 +2966,53 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
         CCKD_TRACE( "%d wrtrk[%d] %d comp %s parm %d",
                     writer, o, trk, compname[ comp ], parm );
 
-        bufp = (BYTE*) &buf2;
-        bufl = cckd_compress( dev, &bufp, buf, len, comp, parm );
+        *bufp = buf2;
+        bufl = cckd_compress( dev, bufp, buf, len, comp, parm );
 
         CCKD_TRACE( "%d wrtrk[%d] %d compressed length %d",
                     writer, o, trk, bufl );
     }
     else
     {
-        bufp = buf;
+        *bufp = buf;
         bufl = len;
     }
 
+    return bufl;
+} /* end function cckd_writer_comp */
+
+/*-------------------------------------------------------------------*/
+/* cckd writer thread helper:   write a device's compressed images   */
+/*                                                                   */
+/* Writes batch entries `beg' up to `end', which are for the same    */
+/* device.  With an I/O queue the image writes are only queued by    */
+/* cckd_write_trkimg and are all started before the file lock is     */
+/* released; cckd_write_trkimg_done then updates the level 2 entries */
+/* of the images that were written.                                  */
+/*-------------------------------------------------------------------*/
+void cckd_writer_write( int writer, CCKD_WRBATCH* batch, int beg, int end )
+{
+TID             tid;                    /* Writer thead id           */
+CCKD_EXT*       cckd;                   /* -> cckd extension         */
+DEVBLK*         dev;                    /* Device block              */
+U16             devnum;                 /* Device number             */
+int             rc;                     /* (work) return code        */
+int             trk;                    /* Track number              */
+U32             flag;                   /* Cache flag                */
+int             i, o;                   /* Batch index, cache entry  */
+int             signal = 0;             /* 1=Signal write complete   */
+
+    CCKD_CACHE_GETKEY( batch->o[ beg ], devnum, trk );
+    dev = cckd_find_device_by_devnum( devnum );
+
+    if (dev->cckd64)
+    {
+        cckd64_writer_write( writer, batch, beg, end );
+        return;
+    }
+
+    cckd = dev->cckd_ext;
+
     obtain_lock( &cckd->filelock );
     {
         /* Turn on read-write header bits if not already on */
@@ -2275,8 +3022,20 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
             cckd_write_chdr( dev );
         }
 
-        /* Write the track image */
-        cckd_write_trkimg( dev, bufp, bufl, trk, CCKD_SIZE_ANY );
+        /* Write the track images */
+        cckd->wrbatch = batch->aio ? batch : NULL;
+        batch->ndefer = 0;
+        for (i = beg; i < end; i++)
+        {
+            CCKD_CACHE_GETKEY( batch->o[i], devnum, trk );
+            cckd_write_trkimg( dev, batch->bufp[i], batch->bufl[i], trk, CCKD_SIZE_ANY );
+        }
+        if (cckd->wrbatch)
+        {
+            cckd_aio_submit( batch->aio );
+            cckd_write_trkimg_done( dev, batch );
+        }
+        cckd->wrbatch = NULL;
         cckd->needsdh = 1;    /* We've updated the file. */
     }
     release_lock( &cckd->filelock );
@@ -2320,33 +3079,41 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
 
     obtain_lock( &cckd->cckdiolock );
     {
-        cache_lock( CACHE_DEVBUF );
+        for (i = beg; i < end; i++)
         {
-            flag = cache_setflag( CACHE_DEVBUF, o, ~CCKD_CACHE_WRITING, 0 );
-        }
-        cache_unlock( CACHE_DEVBUF );
+            o = batch->o[i];
+            CCKD_CACHE_GETKEY( o, devnum, trk );
 
-        cckd->wrpending--;
+            cache_lock( CACHE_DEVBUF );
+            {
+                flag = cache_setflag( CACHE_DEVBUF, o, ~CCKD_CACHE_WRITING, 0 );
+            }
+            cache_unlock( CACHE_DEVBUF );
 
-        if (1
-            && cckd->cckdwaiters
-            && (0
-                || (flag & CCKD_CACHE_IOWAIT)
-                || !cckd->wrpending
-               )
-        )
-        {
-            CCKD_TRACE( "writer[%d] cache[%2.2d] %d signalling write complete",
-                       writer, o, trk );
+            cckd->wrpending--;
 
-            broadcast_condition( &cckd->cckdiocond );
+            if (1
+                && cckd->cckdwaiters
+                && (0
+                    || (flag & CCKD_CACHE_IOWAIT)
+                    || !cckd->wrpending
+                   )
+            )
+            {
+                CCKD_TRACE( "writer[%d] cache[%2.2d] %d signalling write complete",
+                           writer, o, trk );
+                signal = 1;
+            }
+
+            CCKD_TRACE( "%d wrtrk[%2.2d] %d complete flags:%8.8x",
+                        writer, o, trk, cache_getflag( CACHE_DEVBUF, o ));
         }
+
+        if (signal)
+            broadcast_condition( &cckd->cckdiocond );
     }
     release_lock( &cckd->cckdiolock );
 
-    CCKD_TRACE( "%d wrtrk[%2.2d] %d complete flags:%8.8x",
-                writer, o, trk, cache_getflag( CACHE_DEVBUF, o ));
-
 } /* end function cckd_writer_write */
 
 #if defined( DEBUG_FREESPACE )
@@ -2886,6 +3653,90 @@ int             sfx;                    /* File index                */
 
 } /* end function cckd_write_chdr */
 
+/*-------------------------------------------------------------------*/
+/* Read the compression dictionary                                   */
+/*-------------------------------------------------------------------*/
+int cckd_read_dict (DEVBLK *dev)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             sfx;                    /* File index                */
+BYTE           *buf;                    /* Dictionary buffer         */
+U32             len;                    /* Dictionary length         */
+
+    if (dev->cckd64)
+        return cckd64_read_dict( dev );
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+
+    cckd_dict_free (&cckd->dict[sfx]);
+
+    len = cckd->cdevhdr[sfx].dict_len;
+    if (len == 0)
+        return 0;
+
+    CCKD_TRACE( "file[%d] read_dict off 0x%x len %u",
+                sfx, cckd->cdevhdr[sfx].dict_off, len );
+
+    if ((buf = cckd_malloc (dev, "dict", len)) == NULL)
+        return -1;
+
+    if (cckd_read (dev, sfx, (off_t)cckd->cdevhdr[sfx].dict_off, buf, len) < 0)
+    {
+        cckd_free (dev, "dict", buf);
+        return -1;
+    }
+
+    if (cckd_dict_init (&cckd->dict[sfx], buf, len,
+                        cckd->cdevhdr[sfx].dict_algo,
+                        cckd->cdevhdr[sfx].cmp_parm) < 0)
+    {
+        // "%1d:%04X CCKD file[%d] %s: compression %s not supported"
+        WRMSG (HHC00344, "E", LCSS_DEVNUM, sfx, cckd_sf_name (dev, sfx),
+               "dictionary");
+        cckd_free (dev, "dict", buf);
+        return -1;
+    }
+
+    return 0;
+
+} /* end function cckd_read_dict */
+
+/*-------------------------------------------------------------------*/
+/* Relocate the compression dictionary                               */
+/*-------------------------------------------------------------------*/
+int cckd_write_dict (DEVBLK *dev, BYTE *buf)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             sfx;                    /* File index                */
+off_t           off, old_off;           /* New/old file offsets      */
+int             size;                   /* Dictionary length         */
+
+    if (dev->cckd64)
+        return cckd64_write_dict( dev, buf );
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+    size = (int)cckd->cdevhdr[sfx].dict_len;
+    old_off = (off_t)cckd->cdevhdr[sfx].dict_off;
+
+    CCKD_TRACE( "file[%d] write_dict len %d", sfx, size );
+
+    if ((off = cckd_get_space( dev, &size, CCKD_SIZE_EXACT )) < 0)
+        return -1;
+    if (cckd_write( dev, sfx, off, buf, cckd->cdevhdr[sfx].dict_len ) < 0)
+        return -1;
+
+    cckd->cdevhdr[sfx].dict_off = (U32)off;
+    if (cckd_write_chdr( dev ) < 0)
+        return -1;
+
+    cckd_rel_space( dev, old_off, cckd->cdevhdr[sfx].dict_len,
+                                  cckd->cdevhdr[sfx].dict_len );
+    return 0;
+
+} /* end function cckd_write_dict */
+
 /*-------------------------------------------------------------------*/
 /* Read the level 1 table                                            */
 /*-------------------------------------------------------------------*/
@@ -3040,6 +3891,10 @@ int cckd_read_init (DEVBLK *dev)
     if (cckd_read_l1( dev ) < 0)
         return -1;
 
+    /* Load the compression dictionary; images that need it
+       will fail to uncompress if it can't be loaded */
+    cckd_read_dict( dev );
+
     return 0;
 } /* end function cckd_read_init */
 
@@ -3635,6 +4490,64 @@ cckd_read_trkimg_error:
 
 } /* end function cckd_read_trkimg */
 
+/*-------------------------------------------------------------------*/
+/* Read several track images with one submission                     */
+/*                                                                   */
+/* Like cckd_read_trkimg (without unitstat) for each of the `n'      */
+/* tracks, except that the image reads are queued on `aio' and then  */
+/* submitted together.  Called with the file lock held.  The image   */
+/* lengths are returned in `lens'.                                   */
+/*-------------------------------------------------------------------*/
+void cckd_read_trkimgs (DEVBLK *dev, BYTE **bufs, int *trks, int *lens,
+                        int n, CCKD_AIO *aio)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             rc[CCKD_AIO_DEPTH];     /* Return codes              */
+int             sfx[CCKD_AIO_DEPTH];    /* File indexes              */
+CCKD_L2ENT      l2;                     /* Level 2 entry             */
+int             i;                      /* Index                     */
+
+    cckd = dev->cckd_ext;
+
+    for (i = 0; i < n; i++)
+    {
+        CCKD_TRACE( "trk[%d] read_trkimg", trks[i]);
+
+        /* Queue the track image read or build a null track image */
+        if ((sfx[i] = cckd_read_l2ent (dev, &l2, trks[i])) < 0)
+            rc[i] = -1;
+        else if (l2.L2_trkoff != 0)
+            cckd_aio_queue (aio, dev, sfx[i], (U64)l2.L2_trkoff,
+                            bufs[i], l2.L2_len, 0, &rc[i]);
+        else
+        {
+            rc[i] = cckd_null_trk (dev, bufs[i], trks[i], l2.L2_len);
+            sfx[i] = -1;
+        }
+    }
+
+    cckd_aio_submit (aio);
+
+    for (i = 0; i < n; i++)
+    {
+        if (rc[i] >= 0 && sfx[i] >= 0)
+        {
+            cckd->reads[sfx[i]]++;
+            cckd->totreads++;
+            cckdblk.stats_reads++;
+            cckdblk.stats_readbytes += rc[i];
+            if (cckd->notnull == 0 && trks[i] > 1) cckd->notnull = 1;
+        }
+
+        /* Validate the track image */
+        if (rc[i] < 0 || cckd_cchh (dev, bufs[i], trks[i]) < 0)
+            rc[i] = cckd_null_trk (dev, bufs[i], trks[i], 0);
+
+        lens[i] = rc[i];
+    }
+
+} /* end function cckd_read_trkimgs */
+
 /*-------------------------------------------------------------------*/
 /* Write a track image                                               */
 /*-------------------------------------------------------------------*/
@@ -3647,6 +4560,7 @@ CCKD_L2ENT      l2, oldl2;              /* Level 2 entries           */
 int             sfx,L1idx,l2x;          /* Lookup table indices      */
 int             after = 0;              /* 1=New track after old     */
 int             size;                   /* Size of new track         */
+CCKD_WRDEFER   *d;                      /* -> Queued write           */
 
     if (dev->cckd64)
         return cckd64_write_trkimg( dev, buf, len, trk, flags );
@@ -3696,6 +4610,25 @@ int             size;                   /* Size of new track         */
         )
             after = 1;
 
+        /* Queue the write of the track image.  The level 2 entry is
+           only updated, and the previous space released, by
+           cckd_write_trkimg_done once the write has completed */
+        if (cckd->wrbatch)
+        {
+            d = &cckd->wrbatch->defer[ cckd->wrbatch->ndefer++ ];
+            d->trk     = trk;
+            d->rc      = -1;
+            d->off     = (U64)off;
+            d->len     = len;
+            d->size    = size;
+            d->oldoff  = oldl2.L2_trkoff;
+            d->oldlen  = oldl2.L2_len;
+            d->oldsize = oldl2.L2_size;
+
+            cckd_aio_queue (cckd->wrbatch->aio, dev, sfx, d->off, buf, len, 1, &d->rc);
+            return after;
+        }
+
         /* Write the track image */
         if ((rc = cckd_write (dev, sfx, off, buf, len)) < 0)
             return -1;
@@ -3724,16 +4657,79 @@ int             size;                   /* Size of new track         */
 } /* end function cckd_write_trkimg */
 
 /*-------------------------------------------------------------------*/
-/* Harden the file                                                   */
-/*-------------------------------------------------------------------*/
-int cckd_harden(DEVBLK *dev)
+/* Complete the queued track image writes of a writer batch          */
+/*                                                                   */
+/* Called with the file lock held after the batch's I/O queue has    */
+/* been submitted.  A track whose image was written in full has its  */
+/* level 2 entry updated and its previous space released.  If the    */
+/* write failed (the error has been reported) the new space is       */
+/* released instead, so the level 2 entry still points to the old    */
+/* image, as it does when a synchronous write fails.                 */
+/*-------------------------------------------------------------------*/
+void cckd_write_trkimg_done (DEVBLK *dev, CCKD_WRBATCH *batch)
 {
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
-int             rc=0;                   /* Return code               */
+CCKD_WRDEFER   *d;                      /* -> Queued write           */
+CCKD_L2ENT      l2;                     /* Level 2 entry             */
+int             sfx;                    /* File index                */
+int             i;                      /* Index                     */
 
     if (dev->cckd64)
-        return cckd64_harden( dev );
-
+    {
+        cckd64_write_trkimg_done( dev, batch );
+        return;
+    }
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+
+    for (i = 0; i < batch->ndefer; i++)
+    {
+        d = &batch->defer[i];
+
+        if (d->rc != d->len)
+        {
+            CCKD_TRACE( "file[%d] trk[%d] write_trkimg failed, rc %d",
+                        sfx, d->trk, d->rc);
+            cckd_rel_space (dev, (off_t)d->off, d->len, d->size);
+            continue;
+        }
+
+        cckd->writes[sfx]++;
+        cckd->totwrites++;
+        cckdblk.stats_writes++;
+        cckdblk.stats_writebytes += d->rc;
+
+        l2.L2_trkoff = (U32)d->off;
+        l2.L2_len    = (U16)d->len;
+        l2.L2_size   = (U16)d->size;
+
+        /* Update the level 2 entry */
+        if (0
+            || cckd_read_l2 (dev, sfx, d->trk >> 8) < 0
+            || cckd_write_l2ent (dev, &l2, d->trk) < 0
+        )
+            continue;
+
+        /* Release the previous space */
+        cckd_rel_space (dev, (off_t)d->oldoff, d->oldlen, d->oldsize);
+    }
+
+    batch->ndefer = 0;
+
+} /* end function cckd_write_trkimg_done */
+
+/*-------------------------------------------------------------------*/
+/* Harden the file                                                   */
+/*-------------------------------------------------------------------*/
+int cckd_harden(DEVBLK *dev)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             rc=0;                   /* Return code               */
+
+    if (dev->cckd64)
+        return cckd64_harden( dev );
+
     cckd = dev->cckd_ext;
 
     if ((dev->ckdrdonly && cckd->sfn == 0)
@@ -4342,6 +5338,12 @@ CKD_DEVHDR      devhdr;                 /* Device header             */
     cckd->cdevhdr[cckd->sfn+1].free_num =
     cckd->cdevhdr[cckd->sfn+1].free_imbed = 0;
 
+    /* Shadow files are written without a dictionary */
+    cckd->cdevhdr[cckd->sfn+1].dict_off =
+    cckd->cdevhdr[cckd->sfn+1].dict_len = 0;
+    cckd->cdevhdr[cckd->sfn+1].dict_algo = 0;
+    cckd->cdevhdr[cckd->sfn+1].cdh_opts &= ~CCKD_OPT_DICT;
+
     /* Init the level 1 table */
     if ((cckd->L1tab[cckd->sfn+1] = cckd_malloc (dev, "l1", l1size)) == NULL)
         goto sf_new_error;
@@ -5023,7 +6025,7 @@ DLL_EXPORT void* cckd_sf_stats( void* data )
 DEVBLK         *dev = data;             /* -> DEVBLK                 */
 CCKD_EXT       *cckd;                   /* -> cckd extension         */
 struct stat     st = {0};               /* File information          */
-int             i;                      /* Index                     */
+int             i, n;                   /* Index, dictionary count   */
 char           *ost[] = {"  ", "ro", "rd", "rw"};
 U64             usize=0,ufree=0;        /* Total size, free space    */
 int             free_count=0;           /* Total number free spaces  */
@@ -5077,8 +6079,8 @@ int             free_count=0;           /* Total number free spaces  */
     // "%1d:%04X   32/64       size free  nbr st   reads  writes l2reads    hits switches"
     WRMSG (HHC00333, "I", LCSS_DEVNUM);
 
-    if (cckd->readaheads || cckd->misses)
-    // "%1d:%04X                                                      readaheads   misses"
+    if (cckd->readaheads || cckd->misses || cckd->ghosthits)
+    // "%1d:%04X                                             readaheads     used   wasted   ghosts"
     WRMSG (HHC00334, "I", LCSS_DEVNUM);
 
     // "%1d:%04X ------------------------------------------------------------------------"
@@ -5098,10 +6100,10 @@ int             free_count=0;           /* Total number free spaces  */
         , cckd->switches
     );
 
-    if (cckd->readaheads || cckd->misses)
-    // "%1d:%04X                                                         %7.7d  %7.7d"
+    if (cckd->readaheads || cckd->misses || cckd->ghosthits)
+    // "%1d:%04X                                                %7.7d  %7.7d  %7.7d  %7.7d"
     WRMSG (HHC00337, "I", LCSS_DEVNUM,
-            cckd->readaheads, cckd->misses);
+            cckd->readaheads, cckd->raused, cckd->misses, cckd->ghosthits);
 
     /* base file statistics */
 
@@ -5140,6 +6142,40 @@ int             free_count=0;           /* Total number free spaces  */
         );
     }
 
+    /* dictionary statistics */
+    for (i = 0, n = 0; i <= cckd->sfn; i++)
+    {
+        CCKD_DICT *dict = &cckd->dict[i];
+        if (dict->dict_buf == NULL)
+            continue;
+        // "%1d:%04X [%d] %s dictionary %u bytes: %u images compressed, %"PRId64"%% saved; %u uncompressed at %"PRIu64" MB/s"
+        WRMSG( HHC00395, "I", LCSS_DEVNUM, i, compname[dict->dict_algo],
+               dict->dict_len, (U32)dict->comps,
+               dict->cinbytes ? 100 - dict->coutbytes * 100 / dict->cinbytes : 0,
+               (U32)dict->decomps,
+               (U64)(dict->dusecs ? dict->dbytes / dict->dusecs : 0) );
+        n++;
+    }
+    if (n)
+        // "%1d:%04X [*] %u images uncompressed without dictionary at %"PRIu64" MB/s"
+        WRMSG( HHC00397, "I", LCSS_DEVNUM, (U32)cckd->decomps,
+               (U64)(cckd->dusecs ? cckd->dbytes / cckd->dusecs : 0) );
+
+    /* file I/O statistics */
+    if (cckd->iostats.ops)
+    {
+        CCKD_IOSTATS *st = &cckd->iostats;
+        // "%1d:%04X [*] %"PRIu64" file I/Os in %"PRIu64" submissions, %"PRIu64" by io_uring, max %u per submission"
+        WRMSG( HHC00463, "I", LCSS_DEVNUM, st->ops, st->subs, st->aioops, st->qdmax );
+        // "%1d:%04X [*] %-5s usecs <8 %u <32 %u <128 %u <512 %u <2K %u <8K %u <32K %u more %u"
+        WRMSG( HHC00464, "I", LCSS_DEVNUM, "read",
+               st->rdlat[0], st->rdlat[1], st->rdlat[2], st->rdlat[3],
+               st->rdlat[4], st->rdlat[5], st->rdlat[6], st->rdlat[7] );
+        WRMSG( HHC00464, "I", LCSS_DEVNUM, "write",
+               st->wrlat[0], st->wrlat[1], st->wrlat[2], st->wrlat[3],
+               st->wrlat[4], st->wrlat[5], st->wrlat[6], st->wrlat[7] );
+    }
+
     return NULL;
 } /* end function cckd_sf_stats */
 
@@ -5620,6 +6656,62 @@ static int cckd_gc_perc_space_error( DEVBLK* dev, CCKD_EXT* cckd, off_t upos, in
 }
 #define GC_PERC_SPACE_ERROR()   cckd_gc_perc_space_error( dev, cckd, upos, i, buf, moved, __FILE__, __LINE__)
 
+/*-------------------------------------------------------------------*/
+/* Garbage Collection -- Pace the percolate algorithm                */
+/*                                                                   */
+/* Called before each pass, without the file lock.  With gcslice=    */
+/* set, foreground i/o to the device (a channel program in progress  */
+/* or a thread waiting for a track) goes first for up to             */
+/* CCKD_GC_YIELD milliseconds.  With gcrate= set, sleeps until the   */
+/* `moved' bytes since `beg' are within the budget.                  */
+/*-------------------------------------------------------------------*/
+void cckd_gc_yield( DEVBLK* dev, U64 moved, struct timeval* beg )
+{
+struct timeval  now;                    /* Time of day               */
+S64             usecs;                  /* Time since `beg'          */
+S64             want;                   /* Time `moved' should take  */
+bool            busy;                   /* Foreground i/o active     */
+int             i;
+
+    for (i = 0; cckdblk.gcslice && i < CCKD_GC_YIELD; i++)
+    {
+        if (dev->cckd64)
+            busy = ((CCKD64_EXT*) dev->cckd_ext)->cckdioact
+                || ((CCKD64_EXT*) dev->cckd_ext)->cckdwaiters;
+        else
+            busy = ((CCKD_EXT*) dev->cckd_ext)->cckdioact
+                || ((CCKD_EXT*) dev->cckd_ext)->cckdwaiters;
+        if (!busy)
+            break;
+        USLEEP( 1000 );
+    }
+
+    if (cckdblk.gcrate && moved)
+    {
+        gettimeofday( &now, NULL );
+        usecs = (S64)(now.tv_sec - beg->tv_sec) * 1000000
+              + (now.tv_usec - beg->tv_usec);
+        want  = (S64)((moved * 1000000) / ((U64) cckdblk.gcrate << SHIFT_1K));
+        if (want > usecs)
+            USLEEP( (useconds_t) MIN( want - usecs, 1000000 ));
+    }
+} /* end function cckd_gc_yield */
+
+/*-------------------------------------------------------------------*/
+/* Garbage Collection -- Return true when a slice's time is up       */
+/*-------------------------------------------------------------------*/
+bool cckd_gc_slice_done( struct timeval* beg )
+{
+struct timeval  now;                    /* Time of day               */
+
+    if (!cckdblk.gcslice)
+        return false;
+
+    gettimeofday( &now, NULL );
+    return (now.tv_sec - beg->tv_sec) * 1000
+         + (now.tv_usec - beg->tv_usec) / 1000 >= cckdblk.gcslice;
+} /* end function cckd_gc_slice_done */
+
 /*-------------------------------------------------------------------*/
 /* Garbage Collection -- Percolate algorithm                         */
 /*-------------------------------------------------------------------*/
@@ -5638,6 +6730,7 @@ unsigned int    flen, ulen, len;        /* Lengths                   */
 int             trk;                    /* Track number              */
 int             L1idx, l2x;             /* Table Indexes             */
 CCKD_L2ENT      l2;                     /* Copied level 2 entry      */
+struct timeval  beg, slice;             /* Start of run, of slice    */
 BYTE            buf[256*1024];          /* Buffer                    */
 
     if (dev->cckd64)
@@ -5683,10 +6776,15 @@ BYTE            buf[256*1024];          /* Buffer                    */
     if (!cckd->L2ok)
         cckd_gc_l2(dev, buf);
 
+    gettimeofday (&beg, NULL);
+
     /* garbage collection cycle... */
     while (moved < size && after < 4)
     {
+        cckd_gc_yield (dev, moved, &beg);
+
         obtain_lock (&cckd->filelock);
+        gettimeofday (&slice, NULL);
         sfx = cckd->sfn;
 
         /* Exit if no more free space */
@@ -5783,6 +6881,10 @@ BYTE            buf[256*1024];          /* Buffer                    */
         if (ulen > flen + 65536) ulen = flen + 65536;
         if (ulen > sizeof(buf))  ulen = sizeof(buf);
 
+        /* A slice reads no more than the largest space it may move */
+        if (cckdblk.gcslice && ulen > CCKD_GC_SLICE_READ)
+            ulen = CCKD_GC_SLICE_READ;
+
         CCKD_TRACE( "gcperc selected space 0x%16.16"PRIx64" len %d", upos, ulen);
 
         if (cckd_read (dev, sfx, upos, buf, ulen) < 0)
@@ -5792,6 +6894,10 @@ BYTE            buf[256*1024];          /* Buffer                    */
         flags = cckd->cdevhdr[sfx].free_num < 100 ? CCKD_SIZE_EXACT : CCKD_SIZE_ANY;
         for (i = a = 0; i + CKD_TRKHDR_SIZE <= (int)ulen; i += len)
         {
+            /* End the slice when its time is up */
+            if (i && cckd_gc_slice_done (&slice))
+                break;
+
             /* Check for level 2 table */
             for (j = 0; j < cckd->cdevhdr[sfx].num_L1tab; j++)
                 if (cckd->L1tab[sfx][j] == (U32)(upos + i)) break;
@@ -5820,6 +6926,18 @@ BYTE            buf[256*1024];          /* Buffer                    */
                 if (cckd_write_l2 (dev) < 0)
                     return GC_PERC_ERROR();
             }
+            else if (cckd->cdevhdr[sfx].dict_len
+                  && cckd->cdevhdr[sfx].dict_off == (U32)(upos + i))
+            {
+                /* Moving the dictionary */
+                len = cckd->cdevhdr[sfx].dict_len;
+                if (i + len > ulen) break;
+                CCKD_TRACE( "gcperc move dict at pos 0x%16.16"PRIx64" len %d",
+                            upos + i, len);
+
+                if (cckd_write_dict (dev, buf + i) < 0)
+                    return GC_PERC_ERROR();
+            }
             else
             {
                 /* Moving a track image */
@@ -6056,6 +7174,7 @@ CCKD_EXT       *cckd;
 BYTE           *to = NULL;                /* Uncompressed buffer     */
 int             newlen;                   /* Uncompressed length     */
 BYTE            comp;                     /* Compression type        */
+struct timeval  beg, end;                 /* Uncompress times        */
 
     cckd = dev->cckd_ext;
 
@@ -6074,6 +7193,7 @@ BYTE            comp;                     /* Compression type        */
     }
 
     /* Uncompress the track image */
+    gettimeofday (&beg, NULL);
     switch (comp)
     {
     case CCKD_COMPRESS_NONE:
@@ -6088,11 +7208,30 @@ BYTE            comp;                     /* Compression type        */
         to = cckd->newbuf;
         newlen = cckd_uncompress_bzip2 (dev, to, from, len, maxlen);
         break;
+    case CCKD_COMPRESS_ZSTD:
+        to = cckd->newbuf;
+        newlen = cckd_uncompress_zstd (dev, to, from, len, maxlen);
+        break;
+    case CCKD_COMPRESS_LZ4:
+        to = cckd->newbuf;
+        newlen = cckd_uncompress_lz4 (dev, to, from, len, maxlen);
+        break;
     default:
         newlen = -1;
         break;
     }
 
+    /* Dictionary images are timed by cckd_dict_uncompress */
+    if (comp != CCKD_COMPRESS_NONE && newlen > 0
+     && !cckd_dict_id (comp, from, len))
+    {
+        gettimeofday (&end, NULL);
+        atomic_update32( &cckd->decomps, 1 );
+        atomic_update64( &cckd->dbytes, newlen );
+        atomic_update64( &cckd->dusecs, (S64)(end.tv_sec - beg.tv_sec) * 1000000
+                                      + end.tv_usec - beg.tv_usec );
+    }
+
     /* Validate the uncompressed track image */
     newlen = cckd_validate (dev, to, trk, newlen);
 
@@ -6145,6 +7284,28 @@ BYTE            comp;                     /* Compression type        */
         return to;
     }
 
+    /* zstd compression */
+    to = cckd->newbuf;
+    newlen = cckd_uncompress_zstd  (dev, to, from, len, maxlen);
+    newlen = cckd_validate         (dev, to, trk, newlen);
+    if (newlen > 0)
+    {
+        cckd->newbuf = from;
+        cckd->bufused = 1;
+        return to;
+    }
+
+    /* lz4 compression */
+    to = cckd->newbuf;
+    newlen = cckd_uncompress_lz4   (dev, to, from, len, maxlen);
+    newlen = cckd_validate         (dev, to, trk, newlen);
+    if (newlen > 0)
+    {
+        cckd->newbuf = from;
+        cckd->bufused = 1;
+        return to;
+    }
+
     // "%1d:%04X CCKD file[%d] %s: uncompress error trk %d: %2.2x%2.2x%2.2x%2.2x%2.2x"
     WRMSG (HHC00343, "E",
             LCSS_DEVNUM, cckd->sfn, cckd_sf_name(dev, cckd->sfn), trk,
@@ -6163,8 +7324,17 @@ int cckd_uncompress_zlib (DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen
 #if defined( HAVE_ZLIB )
 unsigned long newlen;
 int rc;
+U32 id;
+
+    /* Image compressed using a preset dictionary */
+    if ((id = cckd_dict_id (CCKD_COMPRESS_ZLIB, from, len)) != 0)
+    {
+        CCKD_DICT *dict = cckd_dict_find (dev, CCKD_COMPRESS_ZLIB, id);
+        rc = dict ? cckd_dict_uncompress (dict, to, from, len, maxlen) : -1;
+        CCKD_TRACE( "uncompress zlib dict %8.8x newlen %d", id, rc);
+        return rc;
+    }
 
-    UNREFERENCED(dev);
     memcpy (to, from, CKD_TRKHDR_SIZE);
     newlen = maxlen - CKD_TRKHDR_SIZE;
     rc = uncompress(&to[CKD_TRKHDR_SIZE], &newlen,
@@ -6227,6 +7397,85 @@ int rc;
 #endif
 }
 
+/*-------------------------------------------------------------------*/
+/* cckd_uncompress_zstd                                              */
+/*-------------------------------------------------------------------*/
+int cckd_uncompress_zstd (DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen)
+{
+#if defined( CCKD_ZSTD )
+size_t newlen;
+int rc;
+U32 id;
+
+    /* Frame compressed using a dictionary */
+    if ((id = cckd_dict_id (CCKD_COMPRESS_ZSTD, from, len)) != 0)
+    {
+        CCKD_DICT *dict = cckd_dict_find (dev, CCKD_COMPRESS_ZSTD, id);
+        rc = dict ? cckd_dict_uncompress (dict, to, from, len, maxlen) : -1;
+        CCKD_TRACE( "uncompress zstd dict %8.8x newlen %d", id, rc);
+        return rc;
+    }
+
+    memcpy (to, from, CKD_TRKHDR_SIZE);
+    newlen = ZSTD_decompress (&to[CKD_TRKHDR_SIZE], maxlen - CKD_TRKHDR_SIZE,
+                              &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE);
+    rc = ZSTD_isError (newlen) ? -1 : 0;
+    if (rc == 0)
+    {
+        newlen += CKD_TRKHDR_SIZE;
+        to[0] = 0;
+    }
+    else
+        newlen = (size_t) -1;
+
+    CCKD_TRACE( "uncompress zstd newlen %d rc %d",(int)newlen,rc);
+
+    return (int)newlen;
+#else
+    UNREFERENCED(dev);
+    UNREFERENCED(to);
+    UNREFERENCED(from);
+    UNREFERENCED(len);
+    UNREFERENCED(maxlen);
+    return -1;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* cckd_uncompress_lz4                                               */
+/*-------------------------------------------------------------------*/
+int cckd_uncompress_lz4 (DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen)
+{
+#if defined( CCKD_LZ4 )
+int newlen;
+
+    UNREFERENCED(dev);
+    memcpy (to, from, CKD_TRKHDR_SIZE);
+    newlen = LZ4_decompress_safe ((const char *)&from[CKD_TRKHDR_SIZE],
+                                  (char *)&to[CKD_TRKHDR_SIZE],
+                                  len - CKD_TRKHDR_SIZE,
+                                  maxlen - CKD_TRKHDR_SIZE);
+    if (newlen >= 0)
+    {
+        newlen += CKD_TRKHDR_SIZE;
+        to[0] = 0;
+    }
+    else
+        newlen = -1;
+
+    CCKD_TRACE( "uncompress lz4 newlen %d",newlen);
+
+    return newlen;
+#else
+    UNREFERENCED(dev);
+    UNREFERENCED(to);
+    UNREFERENCED(from);
+    UNREFERENCED(len);
+    UNREFERENCED(maxlen);
+    return -1;
+#endif
+}
+
 /*-------------------------------------------------------------------*/
 /* Compress a track image                                            */
 /*-------------------------------------------------------------------*/
@@ -6246,6 +7495,12 @@ int newlen;
     case CCKD_COMPRESS_BZIP2:
         newlen = cckd_compress_bzip2 (dev, to, from, len, parm);
         break;
+    case CCKD_COMPRESS_ZSTD:
+        newlen = cckd_compress_zstd (dev, to, from, len, parm);
+        break;
+    case CCKD_COMPRESS_LZ4:
+        newlen = cckd_compress_lz4 (dev, to, from, len, parm);
+        break;
     default:
         newlen = cckd_compress_bzip2 (dev, to, from, len, parm);
         break;
@@ -6274,16 +7529,29 @@ int cckd_compress_zlib (DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm)
 unsigned long newlen;
 int rc;
 BYTE *buf;
+CCKD_DICT *dict;
 
-    UNREFERENCED(dev);
     buf = *to;
+
+    /* Use the file's preset dictionary if it has one */
+    if ((dict = cckd_dict_active (dev, CCKD_COMPRESS_ZLIB)) != NULL)
+    {
+        rc = cckd_dict_compress (dict, buf, from, len, parm);
+        if (rc < 0 || rc >= len)
+        {
+            *to = from;
+            rc = len;
+        }
+        return rc;
+    }
+
     from[0] = CCKD_COMPRESS_NONE;
     memcpy (buf, from, CKD_TRKHDR_SIZE);
     buf[0] = CCKD_COMPRESS_ZLIB;
     newlen = 65535 - CKD_TRKHDR_SIZE;
     rc = compress2 (&buf[CKD_TRKHDR_SIZE], &newlen,
                     &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE,
-                    parm);
+                    parm <= 9 ? parm : 9);
     newlen += CKD_TRKHDR_SIZE;
     if (rc != Z_OK || (int)newlen >= len)
     {
@@ -6330,6 +7598,473 @@ BYTE *buf;
 #endif
 }
 
+/*-------------------------------------------------------------------*/
+/* cckd_compress_zstd                                                */
+/*-------------------------------------------------------------------*/
+int cckd_compress_zstd (DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm)
+{
+#if defined( CCKD_ZSTD )
+size_t newlen;
+BYTE *buf;
+CCKD_DICT *dict;
+int rc;
+
+    buf = *to;
+
+    /* Use the file's dictionary if it has one */
+    if ((dict = cckd_dict_active (dev, CCKD_COMPRESS_ZSTD)) != NULL)
+    {
+        rc = cckd_dict_compress (dict, buf, from, len, parm);
+        if (rc < 0 || rc >= len)
+        {
+            *to = from;
+            rc = len;
+        }
+        return rc;
+    }
+
+    from[0] = CCKD_COMPRESS_NONE;
+    memcpy (buf, from, CKD_TRKHDR_SIZE);
+    buf[0] = CCKD_COMPRESS_ZSTD;
+    newlen = ZSTD_compress (&buf[CKD_TRKHDR_SIZE], 65535 - CKD_TRKHDR_SIZE,
+                            &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE,
+                            parm >= 1 && parm <= ZSTD_maxCLevel() ? parm : 3);
+    if (ZSTD_isError (newlen)
+     || (int)(newlen += CKD_TRKHDR_SIZE) >= len)
+    {
+        *to = from;
+        newlen = len;
+    }
+    return (int)newlen;
+#else
+    return cckd_compress_zlib (dev, to, from, len, parm);
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* cckd_compress_lz4                                                 */
+/*-------------------------------------------------------------------*/
+int cckd_compress_lz4 (DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm)
+{
+#if defined( CCKD_LZ4 )
+int newlen;
+BYTE *buf;
+
+    UNREFERENCED(dev);
+    UNREFERENCED(parm);
+    buf = *to;
+    from[0] = CCKD_COMPRESS_NONE;
+    memcpy (buf, from, CKD_TRKHDR_SIZE);
+    buf[0] = CCKD_COMPRESS_LZ4;
+    newlen = LZ4_compress_default ((const char *)&from[CKD_TRKHDR_SIZE],
+                                   (char *)&buf[CKD_TRKHDR_SIZE],
+                                   len - CKD_TRKHDR_SIZE,
+                                   65535 - CKD_TRKHDR_SIZE);
+    newlen += CKD_TRKHDR_SIZE;
+    if (newlen <= CKD_TRKHDR_SIZE || newlen >= len)
+    {
+        *to = from;
+        newlen = len;
+    }
+    return newlen;
+#else
+    return cckd_compress_zlib (dev, to, from, len, parm);
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/* Initialize a compression dictionary                               */
+/*                                                                   */
+/* On success the dictionary owns `buf' and cckd_dict_free will      */
+/* free it.  zstd dictionaries must be in zstd dictionary format so  */
+/* that frames compressed with them carry the dictionary id.         */
+/*-------------------------------------------------------------------*/
+int cckd_dict_init (CCKD_DICT *dict, BYTE *buf, U32 len, int algo, int level)
+{
+    memset (dict, 0, sizeof(CCKD_DICT));
+
+    switch (algo)
+    {
+#if defined( HAVE_ZLIB )
+    case CCKD_COMPRESS_ZLIB:
+        if (len == 0 || len > CCKD_DICT_ZLIBSIZE)
+            return -1;
+        dict->dict_id = (U32)adler32 (1L, buf, len);
+        break;
+#endif
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+        /* Magic number 0xEC30A437 then the dictionary id */
+        if (len < 8 || len > CCKD_DICT_MAXSIZE
+         || buf[0] != 0x37 || buf[1] != 0xA4
+         || buf[2] != 0x30 || buf[3] != 0xEC)
+            return -1;
+        dict->dict_id = (U32)buf[4]         | ((U32)buf[5] << 8)
+                     | ((U32)buf[6] << 16) | ((U32)buf[7] << 24);
+        if (dict->dict_id == 0)
+            return -1;
+        dict->dict_level = level >= 1 && level <= ZSTD_maxCLevel() ? level : 3;
+        dict->dict_cdict = ZSTD_createCDict (buf, len, dict->dict_level);
+        dict->dict_ddict = ZSTD_createDDict (buf, len);
+        if (dict->dict_cdict == NULL || dict->dict_ddict == NULL)
+        {
+            ZSTD_freeCDict (dict->dict_cdict);
+            ZSTD_freeDDict (dict->dict_ddict);
+            memset (dict, 0, sizeof(CCKD_DICT));
+            return -1;
+        }
+        break;
+#endif
+    default:
+        UNREFERENCED(buf);
+        UNREFERENCED(len);
+        UNREFERENCED(level);
+        return -1;
+    }
+
+    dict->dict_buf  = buf;
+    dict->dict_len  = len;
+    dict->dict_algo = (BYTE)algo;
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* Free a compression dictionary                                     */
+/*-------------------------------------------------------------------*/
+void cckd_dict_free (CCKD_DICT *dict)
+{
+    if (dict->dict_buf == NULL)
+        return;
+#if defined( CCKD_ZSTD )
+    ZSTD_freeCDict (dict->dict_cdict);
+    ZSTD_freeDDict (dict->dict_ddict);
+#endif
+    free (dict->dict_buf);
+    memset (dict, 0, sizeof(CCKD_DICT));
+}
+
+/*-------------------------------------------------------------------*/
+/* Return the id of the dictionary a compressed image needs, or 0    */
+/*-------------------------------------------------------------------*/
+U32 cckd_dict_id (int comp, BYTE *from, int len)
+{
+BYTE *p = from + CKD_TRKHDR_SIZE;
+
+    len -= CKD_TRKHDR_SIZE;
+    switch (comp)
+    {
+    case CCKD_COMPRESS_ZLIB:
+        /* RFC 1950: deflate CMF, FLG with FDICT set, then DICTID */
+        if (len >= 6 && (p[0] & 0x0F) == 8 && (p[1] & 0x20))
+            return fetch_fw (p + 2);
+        return 0;
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+        return len > 0 ? ZSTD_getDictID_fromFrame (p, len) : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Find a loaded dictionary by algorithm and id                      */
+/*-------------------------------------------------------------------*/
+CCKD_DICT *cckd_dict_find (DEVBLK *dev, int comp, U32 id)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             i;                      /* File index                */
+
+    if (dev->cckd64)
+        return cckd64_dict_find( dev, comp, id );
+
+    if ((cckd = dev->cckd_ext) == NULL || id == 0)
+        return NULL;
+
+    for (i = cckd->sfn; i >= 0; i--)
+        if (cckd->dict[i].dict_buf
+         && cckd->dict[i].dict_algo == comp
+         && cckd->dict[i].dict_id == id)
+            return &cckd->dict[i];
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/* Return the dictionary new images are compressed with, if any      */
+/*-------------------------------------------------------------------*/
+CCKD_DICT *cckd_dict_active (DEVBLK *dev, int comp)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+
+    if (dev->cckd64)
+        return cckd64_dict_active( dev, comp );
+
+    if ((cckd = dev->cckd_ext) == NULL
+     || cckd->dict[cckd->sfn].dict_buf == NULL
+     || cckd->dict[cckd->sfn].dict_algo != comp)
+        return NULL;
+    return &cckd->dict[cckd->sfn];
+}
+
+/*-------------------------------------------------------------------*/
+/* Compress a track image using a dictionary                         */
+/*                                                                   */
+/* `to' must hold 65535 bytes.  Returns the compressed length or -1. */
+/*-------------------------------------------------------------------*/
+int cckd_dict_compress (CCKD_DICT *dict, BYTE *to, BYTE *from, int len, int parm)
+{
+int newlen = -1;
+
+    from[0] = CCKD_COMPRESS_NONE;
+    memcpy (to, from, CKD_TRKHDR_SIZE);
+    to[0] = dict->dict_algo;
+
+    switch (dict->dict_algo)
+    {
+#if defined( HAVE_ZLIB )
+    case CCKD_COMPRESS_ZLIB:
+    {
+        z_stream strm;
+        int rc;
+
+        memset (&strm, 0, sizeof(strm));
+        if (deflateInit (&strm, parm <= 9 ? parm : 9) != Z_OK)
+            break;
+        rc = deflateSetDictionary (&strm, dict->dict_buf, dict->dict_len);
+        strm.next_in   = &from[CKD_TRKHDR_SIZE];
+        strm.avail_in  = len - CKD_TRKHDR_SIZE;
+        strm.next_out  = &to[CKD_TRKHDR_SIZE];
+        strm.avail_out = 65535 - CKD_TRKHDR_SIZE;
+        if (rc == Z_OK)
+            rc = deflate (&strm, Z_FINISH);
+        if (rc == Z_STREAM_END)
+            newlen = (int)strm.total_out + CKD_TRKHDR_SIZE;
+        deflateEnd (&strm);
+        break;
+    }
+#endif
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+    {
+        ZSTD_CCtx *cctx;
+        size_t rc;
+        int level = parm >= 1 && parm <= ZSTD_maxCLevel() ? parm : 3;
+
+        if ((cctx = ZSTD_createCCtx ()) == NULL)
+            break;
+        if (level == dict->dict_level)
+            rc = ZSTD_compress_usingCDict (cctx,
+                        &to[CKD_TRKHDR_SIZE], 65535 - CKD_TRKHDR_SIZE,
+                        &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE,
+                        dict->dict_cdict);
+        else
+            rc = ZSTD_compress_usingDict (cctx,
+                        &to[CKD_TRKHDR_SIZE], 65535 - CKD_TRKHDR_SIZE,
+                        &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE,
+                        dict->dict_buf, dict->dict_len, level);
+        if (!ZSTD_isError (rc))
+            newlen = (int)rc + CKD_TRKHDR_SIZE;
+        ZSTD_freeCCtx (cctx);
+        break;
+    }
+#endif
+    default:
+        UNREFERENCED(len);
+        UNREFERENCED(parm);
+        break;
+    }
+
+    /* Several writer threads may compress with the same dictionary */
+    atomic_update32( &dict->comps, 1 );
+    atomic_update64( &dict->cinbytes, len );
+    atomic_update64( &dict->coutbytes, newlen > 0 && newlen < len ? newlen : len );
+    return newlen;
+}
+
+/*-------------------------------------------------------------------*/
+/* Uncompress a track image using a dictionary                       */
+/*-------------------------------------------------------------------*/
+int cckd_dict_uncompress (CCKD_DICT *dict, BYTE *to, BYTE *from, int len, int maxlen)
+{
+int newlen = -1;
+struct timeval beg, end;
+
+    gettimeofday (&beg, NULL);
+    memcpy (to, from, CKD_TRKHDR_SIZE);
+
+    switch (dict->dict_algo)
+    {
+#if defined( HAVE_ZLIB )
+    case CCKD_COMPRESS_ZLIB:
+    {
+        z_stream strm;
+        int rc;
+
+        memset (&strm, 0, sizeof(strm));
+        strm.next_in   = &from[CKD_TRKHDR_SIZE];
+        strm.avail_in  = len - CKD_TRKHDR_SIZE;
+        if (inflateInit (&strm) != Z_OK)
+            break;
+        strm.next_out  = &to[CKD_TRKHDR_SIZE];
+        strm.avail_out = maxlen - CKD_TRKHDR_SIZE;
+        rc = inflate (&strm, Z_FINISH);
+        if (rc == Z_NEED_DICT && strm.adler == dict->dict_id)
+        {
+            rc = inflateSetDictionary (&strm, dict->dict_buf, dict->dict_len);
+            if (rc == Z_OK)
+                rc = inflate (&strm, Z_FINISH);
+        }
+        if (rc == Z_STREAM_END)
+            newlen = (int)strm.total_out + CKD_TRKHDR_SIZE;
+        inflateEnd (&strm);
+        break;
+    }
+#endif
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+    {
+        ZSTD_DCtx *dctx;
+        size_t rc;
+
+        if ((dctx = ZSTD_createDCtx ()) == NULL)
+            break;
+        rc = ZSTD_decompress_usingDDict (dctx,
+                        &to[CKD_TRKHDR_SIZE], maxlen - CKD_TRKHDR_SIZE,
+                        &from[CKD_TRKHDR_SIZE], len - CKD_TRKHDR_SIZE,
+                        dict->dict_ddict);
+        if (!ZSTD_isError (rc))
+            newlen = (int)rc + CKD_TRKHDR_SIZE;
+        ZSTD_freeDCtx (dctx);
+        break;
+    }
+#endif
+    default:
+        UNREFERENCED(len);
+        UNREFERENCED(maxlen);
+        break;
+    }
+
+    if (newlen > 0)
+    {
+        to[0] = 0;
+        gettimeofday (&end, NULL);
+        atomic_update32( &dict->decomps, 1 );
+        atomic_update64( &dict->dbytes, newlen );
+        atomic_update64( &dict->dusecs, (S64)(end.tv_sec - beg.tv_sec) * 1000000
+                                      + end.tv_usec - beg.tv_usec );
+    }
+    return newlen;
+}
+
+/*-------------------------------------------------------------------*/
+/* Train a zlib preset dictionary                                    */
+/*                                                                   */
+/* zlib has no trainer of its own.  Count how often each 64 byte     */
+/* segment of the samples occurs and build the dictionary from the   */
+/* segments that repeat, most frequent last since deflate reaches    */
+/* the end of the window most cheaply.                               */
+/*-------------------------------------------------------------------*/
+#define CCKD_DICT_SEGSIZE       64
+#define CCKD_DICT_HASHSIZE      65536
+
+typedef struct {
+        U32     hash;                   /* Segment hash              */
+        U32     count;                  /* Times seen                */
+        size_t  off;                    /* Offset in samples         */
+} CCKD_DICTSEG;
+
+static int cckd_dict_seg_sort (const void *a, const void *b)
+{
+const CCKD_DICTSEG *x = a, *y = b;
+
+    return x->count < y->count ? -1 : x->count > y->count ? 1 : 0;
+}
+
+static int cckd_dict_train_zlib (BYTE *dict, int size, BYTE *samples,
+                                 size_t *sizes, int n)
+{
+CCKD_DICTSEG   *tab;                    /* Segment hash table        */
+BYTE           *seg;                    /* -> Segment                */
+size_t          off, pos;               /* Sample offsets            */
+U32             hash;                   /* FNV-1a hash               */
+int             i, j, k, nsegs;         /* Indexes                   */
+
+    if ((tab = calloc (CCKD_DICT_HASHSIZE, sizeof(CCKD_DICTSEG))) == NULL)
+        return -1;
+
+    for (i = 0, off = 0; i < n; off += sizes[i++])
+    {
+        for (pos = off; pos + CCKD_DICT_SEGSIZE <= off + sizes[i];
+             pos += CCKD_DICT_SEGSIZE / 4)
+        {
+            seg = samples + pos;
+
+            /* Runs of one byte value compress well without help */
+            if (memcmp (seg, seg + 1, CCKD_DICT_SEGSIZE - 1) == 0)
+                continue;
+
+            for (hash = 2166136261U, j = 0; j < CCKD_DICT_SEGSIZE; j++)
+                hash = (hash ^ seg[j]) * 16777619U;
+
+            for (j = 0, k = hash % CCKD_DICT_HASHSIZE; j < 8;
+                 j++, k = (k + 1) % CCKD_DICT_HASHSIZE)
+            {
+                if (tab[k].count == 0)
+                {
+                    tab[k].hash  = hash;
+                    tab[k].count = 1;
+                    tab[k].off   = pos;
+                    break;
+                }
+                if (tab[k].hash == hash)
+                {
+                    tab[k].count++;
+                    break;
+                }
+            }
+        }
+    }
+
+    /* Keep the segments that were seen more than once */
+    for (i = nsegs = 0; i < CCKD_DICT_HASHSIZE; i++)
+        if (tab[i].count > 1)
+            tab[nsegs++] = tab[i];
+    qsort (tab, nsegs, sizeof(CCKD_DICTSEG), cckd_dict_seg_sort);
+
+    i = nsegs > size / CCKD_DICT_SEGSIZE ? nsegs - size / CCKD_DICT_SEGSIZE : 0;
+    for (k = 0; i < nsegs; i++, k += CCKD_DICT_SEGSIZE)
+        memcpy (dict + k, samples + tab[i].off, CCKD_DICT_SEGSIZE);
+
+    free (tab);
+    return k > 0 ? k : -1;
+}
+
+/*-------------------------------------------------------------------*/
+/* Train a dictionary from `n' uncompressed sample images            */
+/*                                                                   */
+/* Returns the dictionary length or -1 if one could not be built.    */
+/*-------------------------------------------------------------------*/
+int cckd_dict_train (BYTE *dict, int size, BYTE *samples, size_t *sizes,
+                     int n, int comp)
+{
+    switch (comp)
+    {
+    case CCKD_COMPRESS_ZLIB:
+        return cckd_dict_train_zlib (dict, size < CCKD_DICT_ZLIBSIZE ?
+                                     size : CCKD_DICT_ZLIBSIZE,
+                                     samples, sizes, n);
+#if defined( CCKD_ZSTD ) && defined( HAVE_ZDICT_H )
+    case CCKD_COMPRESS_ZSTD:
+    {
+        size_t rc = ZDICT_trainFromBuffer (dict, size, samples, sizes, n);
+        return ZDICT_isError (rc) ? -1 : (int)rc;
+    }
+#endif
+    default:
+        return -1;
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /* cckd command help                                                 */
 /*-------------------------------------------------------------------*/
@@ -6347,8 +8082,10 @@ void cckd_command_help()
 
         //    ***  Please keep these in alphabetical order!  ***
 
-        , "  comp=<n>      Override compression                 (-1,0,1,2)"
-        , "  compparm=<n>  Override compression parm            (-1 ... 9)"
+        , "  aio=<n>       Batch file I/O using io_uring          (0 or 1)"
+        , "  cache2q=<n>   Scan resistant 2Q track cache          (0 or 1)"
+        , "  comp=<n>      Override compression           (-1,0,1,2,4,8)"
+        , "  compparm=<n>  Override compression parm           (-1 ... 22)"
         , "  debug=<n>     Enable CCW tracing debug messages      (0 or 1)"
         , "  dhint=<n>     Set Dasd Hardener interval (sec)    (0 ... 999)"
         , "  dhstart=<n>   Start Dasd Hardener                    (0 or 1)"
@@ -6358,6 +8095,8 @@ void cckd_command_help()
         , "  gcint=<n>     Set garbage collector interval (sec) ( 0 .. 60)"
         , "  gcmsgs=<n>    Display garbage collector messages     (0 or 1)"
         , "  gcparm=<n>    Set garbage collector parameter      (-8 ... 8)"
+        , "  gcrate=<n>    Max garbage collector KB/sec    (0 ... 1048576)"
+        , "  gcslice=<n>   Max garbage collector msecs/slice  (0 ... 1000)"
         , "  gcstart=<n>   Start garbage collector                (0 or 1)"
         , "  linuxnull=<n> Check for null linux tracks            (0 or 1)"
         , "  nosfd=<n>     Disable stats report at close          (0 or 1)"
@@ -6366,7 +8105,7 @@ void cckd_command_help()
         , "  raq=<n>       Set readahead queue size             ( 0 .. 16)"
         , "  rat=<n>       Set number tracks to read ahead      ( 0 .. 16)"
         , "  trace=<n>     Set trace table size             (0 ... 200000)"
-        , "  wr=<n>        Set number writer threads            ( 1 ... 9)"
+        , "  wr=<n>        Set number writer threads            ( 1 .. 32)"
 
         , NULL
     };
@@ -6387,7 +8126,9 @@ void cckd_command_opts()
 
         // ***  Please keep these in alphabetical order!  ***
 
-        " "   "comp=%d"
+        " "   "aio=%d"
+        ","   "cache2q=%d"
+        ","   "comp=%d"
         ","   "compparm=%d"
         ","   "debug=%d"
         ","   "dhint=%d"
@@ -6395,6 +8136,8 @@ void cckd_command_opts()
         ","   "dtax=%d"
         ","   "freepend=%d"
 
+        , cckdblk.aio
+        , cckdblk.cache2q
         , cckdblk.comp == 0xff ? -1 : cckdblk.comp
         , cckdblk.compparm
         , cckdblk.debug
@@ -6413,6 +8156,8 @@ void cckd_command_opts()
         ","   "gcint=%d"
         ","   "gcmsgs=%d"
         ","   "gcparm=%d"
+        ","   "gcrate=%d"
+        ","   "gcslice=%d"
         ","   "gcstart=%d"
         ","   "linuxnull=%d"
         ","   "nosfd=%d"
@@ -6421,6 +8166,8 @@ void cckd_command_opts()
         , cckdblk.gcint
         , cckdblk.gcmsgs
         , cckdblk.gcparm
+        , cckdblk.gcrate
+        , cckdblk.gcslice
         , cckdblk.gcstart
         , cckdblk.linuxnull
         , cckdblk.nosfd
@@ -6467,8 +8214,9 @@ void cckd_command_stats()
                     cckdblk.stats_writes, cckdblk.stats_writebytes >> SHIFT_1K );
     WRMSG( HHC00347, "I", msgbuf );
 
-    MSGBUF( msgbuf, "  readaheads%9"PRId64" misses...%10"PRId64,
-                    cckdblk.stats_readaheads, cckdblk.stats_readaheadmisses );
+    MSGBUF( msgbuf, "  readaheads%9"PRId64" used.....%10"PRId64" wasted...%10"PRId64,
+                    cckdblk.stats_readaheads, cckdblk.stats_readaheadused,
+                    cckdblk.stats_readaheadmisses );
     WRMSG( HHC00347, "I", msgbuf );
 
     MSGBUF( msgbuf, "  switches.%10"PRId64" l2 reads.%10"PRId64" strs wrt.%10"PRId64,
@@ -6479,6 +8227,10 @@ void cckd_command_stats()
                     cckdblk.stats_cachehits, cckdblk.stats_cachemisses );
     WRMSG( HHC00347, "I", msgbuf );
 
+    MSGBUF( msgbuf, "  ghosthits%10"PRId64,
+                    cckdblk.stats_ghosthits );
+    WRMSG( HHC00347, "I", msgbuf );
+
     MSGBUF( msgbuf, "  l2 hits..%10"PRId64" misses...%10"PRId64,
                     cckdblk.stats_l2cachehits, cckdblk.stats_l2cachemisses );
     WRMSG( HHC00347, "I", msgbuf );
@@ -6487,6 +8239,18 @@ void cckd_command_stats()
                     cckdblk.stats_iowaits, cckdblk.stats_cachewaits );
     WRMSG( HHC00347, "I", msgbuf );
 
+    MSGBUF( msgbuf, "  wr batches%9"PRId64" tracks...%10"PRId64,
+                    cckdblk.stats_wrbatches, cckdblk.stats_wrtrks );
+    WRMSG( HHC00347, "I", msgbuf );
+
+    MSGBUF( msgbuf, "  wr usecs.........   compress.%10"PRId64" write....%10"PRId64,
+                    cckdblk.stats_compusecs, cckdblk.stats_wrusecs );
+    WRMSG( HHC00347, "I", msgbuf );
+
+    MSGBUF( msgbuf, "  wr queue.........   pending..%10d max......%10"PRId64,
+                    cckdblk.wrpending, cckdblk.stats_wrqmax );
+    WRMSG( HHC00347, "I", msgbuf );
+
     MSGBUF( msgbuf, "  garbage collector   moves....%10"PRId64" Kbytes...%10"PRId64,
                     cckdblk.stats_gcolmoves, cckdblk.stats_gcolbytes >> SHIFT_1K );
     WRMSG( HHC00347, "I", msgbuf );
@@ -6593,6 +8357,38 @@ int   rc;
         /* If rc == 1 && c == 0, then "keyword=value" syntax */
         /* Please keep the below tests in alphabetical order! */
 
+        // Batched file I/O using io_uring
+        else if (CMD( kw, AIO, 3 ))
+        {
+            if (val < 0 || val > 1)
+            {
+                // "CCKD file: value %d invalid for %s"
+                WRMSG( HHC00348, "E", val, kw );
+                return -1;
+            }
+            else
+            {
+                cckdblk.aio = val;
+                opts = 1;
+            }
+        }
+        // Track cache replacement policy
+        else if (CMD( kw, CACHE2Q, 7 ))
+        {
+            if (val < 0 || val > 1)
+            {
+                // "CCKD file: value %d invalid for %s"
+                WRMSG( HHC00348, "E", val, kw );
+                return -1;
+            }
+            else
+            {
+                cckdblk.cache2q = val;
+                cache_setpolicy( CACHE_DEVBUF, val ? CACHE_POLICY_2Q
+                                                   : CACHE_POLICY_LRU );
+                opts = 1;
+            }
+        }
         // Compression to be used
         else if (CMD( kw, COMP, 4 ))
         {
@@ -6608,6 +8404,8 @@ int   rc;
             case CCKD_COMPRESS_NONE:
             case CCKD_COMPRESS_ZLIB:
             case CCKD_COMPRESS_BZIP2:
+            case CCKD_COMPRESS_ZSTD:
+            case CCKD_COMPRESS_LZ4:
                 cckdblk.comp = val < 0 ? 0xff : val;
                 opts = 1;
                 break;
@@ -6620,7 +8418,7 @@ int   rc;
         // Compression parameter to be used
         else if (CMD( kw, COMPPARM, 8 ))
         {
-            if (val < -1 || val > 9)
+            if (val < -1 || val > 22)
             {
                 // "CCKD file: value %d invalid for %s"
                 WRMSG( HHC00348, "E", val, kw );
@@ -6776,6 +8574,36 @@ int   rc;
                 opts = 1;
             }
         }
+        // Garbage collector I/O budget
+        else if (CMD( kw, GCRATE, 6 ))
+        {
+            if (val < 0 || val > CCKD_MAX_GCRATE)
+            {
+                // "CCKD file: value %d invalid for %s"
+                WRMSG( HHC00348, "E", val, kw );
+                return -1;
+            }
+            else
+            {
+                cckdblk.gcrate = val;
+                opts = 1;
+            }
+        }
+        // Garbage collector slice time
+        else if (CMD( kw, GCSLICE, 7 ))
+        {
+            if (val < 0 || val > CCKD_MAX_GCSLICE)
+            {
+                // "CCKD file: value %d invalid for %s"
+                WRMSG( HHC00348, "E", val, kw );
+                return -1;
+            }
+            else
+            {
+                cckdblk.gcslice = val;
+                opts = 1;
+            }
+        }
         // Start garbage collector
         else if (CMD( kw, GCSTART, 7 ))
         {
@@ -6880,7 +8708,19 @@ int   rc;
             }
             else
             {
+                DEVBLK   *dev;
+                CCKD_EXT *cckd;
+
                 cckdblk.readaheads = val;
+
+                /* Restart each device's readahead depth from here */
+                cckd_lock_devchain(0);
+                for (dev = cckdblk.dev1st; dev; dev = cckd->devnext)
+                {
+                    cckd = dev->cckd_ext;
+                    cckd->radepth = val;
+                }
+                cckd_unlock_devchain();
                 opts = 1;
             }
         }
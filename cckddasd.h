@@ -59,6 +59,13 @@ int     cckd_close (DEVBLK *dev, int sfx);
 int     cckd_read (DEVBLK *dev, int sfx, off_t off, void *buf, unsigned int len);
 int     cckd_write (DEVBLK *dev, int sfx, off_t off, void *buf, unsigned int len);
 int     cckd_ftruncate(DEVBLK *dev, int sfx, off_t off);
+void    cckd_iostat( CCKD_IOSTATS* st, int write, int n, struct timeval* beg );
+CCKD_AIO *cckd_aio_init( BYTE* fixbuf, size_t fixlen );
+void    cckd_aio_term( CCKD_AIO* aio );
+void    cckd_aio_update( CCKD_AIO** aio, BYTE* fixbuf, size_t fixlen );
+void    cckd_aio_queue( CCKD_AIO* aio, DEVBLK* dev, int sfx, U64 off,
+                        void* buf, unsigned int len, int write, int* rc );
+void    cckd_aio_submit( CCKD_AIO* aio );
 /*-------------------------------------------------------------------*/
 int     cckd64_open (DEVBLK *dev, int sfx, int flags, mode_t mode);
 int     cckd64_close (DEVBLK *dev, int sfx);
@@ -92,8 +99,11 @@ int     cfba64_write_block(DEVBLK *dev, int blkgrp, int off,
 int     cfba64_used(DEVBLK *dev);
 /*-------------------------------------------------------------------*/
 int     cckd_read_trk(DEVBLK *dev, int trk, int ra, BYTE *unitstat);
-void    cckd_readahead(DEVBLK *dev, int trk);
+BYTE   *cckd_read_trk_entry(DEVBLK *dev, int lru, int trk, int ra, int maxlen);
+void    cckd_readahead_trks(DEVBLK *dev, int *trks, int n, int ra, CCKD_AIO *aio);
+void    cckd_readahead(DEVBLK *dev, int trk, int used);
 int     cckd_readahead_scan(int *answer, int ix, int i, void *data);
+void    cckd_readahead_wasted(DEVBLK *dev, U16 devnum);
 void*   cckd_ra(void* arg);
 void    cckd_flush_cache(DEVBLK *dev);
 int     cckd_flush_cache_scan(int *answer, int ix, int i, void *data);
@@ -102,12 +112,16 @@ void    cckd_purge_cache(DEVBLK *dev);
 int     cckd_purge_cache_scan(int *answer, int ix, int i, void *data);
 void*   cckd_writer(void *arg);
 int     cckd_writer_scan(int *o, int ix, int i, void *data);
-void    cckd_writer_write( int writer, int o );
+void    cckd_writer_batch( int writer, CCKD_WRBATCH* batch, BYTE* bufs );
+int     cckd_writer_comp( int writer, int o, BYTE* buf2, BYTE** bufp );
+void    cckd_writer_write( int writer, CCKD_WRBATCH* batch, int beg, int end );
 off_t   cckd_get_space(DEVBLK *dev, int *size, int flags);
 void    cckd_rel_space(DEVBLK *dev, off_t pos, int len, int size);
 void    cckd_flush_space(DEVBLK *dev);
 int     cckd_read_chdr(DEVBLK *dev);
 int     cckd_write_chdr(DEVBLK *dev);
+int     cckd_read_dict(DEVBLK *dev);
+int     cckd_write_dict(DEVBLK *dev, BYTE *buf);
 int     cckd_read_l1(DEVBLK *dev);
 int     cckd_write_l1(DEVBLK *dev);
 int     cckd_write_l1ent(DEVBLK *dev, int L1idx);
@@ -123,7 +137,10 @@ int     cckd_write_l2(DEVBLK *dev);
 int     cckd_read_l2ent(DEVBLK *dev, CCKD_L2ENT *l2, int trk);
 int     cckd_write_l2ent(DEVBLK *dev,   CCKD_L2ENT *l2, int trk);
 int     cckd_read_trkimg(DEVBLK *dev, BYTE *buf, int trk, BYTE *unitstat);
+void    cckd_read_trkimgs(DEVBLK *dev, BYTE **bufs, int *trks, int *lens,
+                          int n, CCKD_AIO *aio);
 int     cckd_write_trkimg(DEVBLK *dev, BYTE *buf, int len, int trk, int flags);
+void    cckd_write_trkimg_done(DEVBLK *dev, CCKD_WRBATCH *batch);
 int     cckd_harden(DEVBLK *dev);
 int     cckd_trklen(DEVBLK *dev, BYTE *buf);
 int     cckd_null_trk(DEVBLK *dev, BYTE *buf, int trk, int nullfmt);
@@ -144,10 +161,14 @@ void    cckd_gcol_dev( DEVBLK* dev, struct timeval* tv_now );
 int     cckd_gc_state( DEVBLK* dev );
 void    cckd_gc_rpt_state( DEVBLK* dev );
 int     cckd_gc_percolate( DEVBLK* dev, U64 size );
+void    cckd_gc_yield( DEVBLK* dev, U64 moved, struct timeval* beg );
+bool    cckd_gc_slice_done( struct timeval* beg );
 int     cckd_gc_l2(DEVBLK *dev, BYTE *buf);
 DEVBLK *cckd_find_device_by_devnum (U16 devnum);
 /*-------------------------------------------------------------------*/
 int     cckd64_read_trk(DEVBLK *dev, int trk, int ra, BYTE *unitstat);
+BYTE   *cckd64_read_trk_entry(DEVBLK *dev, int lru, int trk, int ra, int maxlen);
+void    cckd64_readahead_trks(DEVBLK *dev, int *trks, int n, int ra, CCKD_AIO *aio);
 //id    cckd64_readahead(DEVBLK *dev, int trk);
 //t     cckd64_readahead_scan(int *answer, int ix, int i, void *data);
 //id*   cckd64_ra(void* arg);
@@ -158,12 +179,15 @@ void    cckd64_purge_cache(DEVBLK *dev);
 int     cckd64_purge_cache_scan(int *answer, int ix, int i, void *data);
 //id*   cckd64_writer(void *arg);
 //t     cckd64_writer_scan(int *o, int ix, int i, void *data);
-void    cckd64_writer_write( int writer, int o );
+int     cckd64_writer_comp( int writer, int o, BYTE* buf2, BYTE** bufp );
+void    cckd64_writer_write( int writer, CCKD_WRBATCH* batch, int beg, int end );
 S64     cckd64_get_space(DEVBLK *dev, int *size, int flags);
 void    cckd64_rel_space(DEVBLK *dev, U64 pos, int len, int size);
 void    cckd64_flush_space(DEVBLK *dev);
 int     cckd64_read_chdr(DEVBLK *dev);
 int     cckd64_write_chdr(DEVBLK *dev);
+int     cckd64_read_dict(DEVBLK *dev);
+int     cckd64_write_dict(DEVBLK *dev, BYTE *buf);
 int     cckd64_read_l1(DEVBLK *dev);
 int     cckd64_write_l1(DEVBLK *dev);
 int     cckd64_write_l1ent(DEVBLK *dev, int L1idx);
@@ -179,7 +203,10 @@ int     cckd64_write_l2(DEVBLK *dev);
 int     cckd64_read_l2ent(DEVBLK *dev, CCKD64_L2ENT *l2, int trk);
 int     cckd64_write_l2ent(DEVBLK *dev,   CCKD64_L2ENT *l2, int trk);
 int     cckd64_read_trkimg(DEVBLK *dev, BYTE *buf, int trk, BYTE *unitstat);
+void    cckd64_read_trkimgs(DEVBLK *dev, BYTE **bufs, int *trks, int *lens,
+                            int n, CCKD_AIO *aio);
 int     cckd64_write_trkimg(DEVBLK *dev, BYTE *buf, int len, int trk, int flags);
+void    cckd64_write_trkimg_done(DEVBLK *dev, CCKD_WRBATCH *batch);
 int     cckd64_harden(DEVBLK *dev);
 //t     cckd64_trklen(DEVBLK *dev, BYTE *buf);
 int     cckd64_null_trk(DEVBLK *dev, BYTE *buf, int trk, int nullfmt);
@@ -204,10 +231,24 @@ int     cckd64_gc_l2(DEVBLK *dev, BYTE *buf);
 BYTE   *cckd_uncompress(DEVBLK *dev, BYTE *from, int len, int maxlen, int trk);
 int     cckd_uncompress_zlib(DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen);
 int     cckd_uncompress_bzip2(DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen);
+int     cckd_uncompress_zstd(DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen);
+int     cckd_uncompress_lz4(DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen);
 int     cckd_compress(DEVBLK *dev, BYTE **to, BYTE *from, int len, int comp, int parm);
 int     cckd_compress_none(DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm);
 int     cckd_compress_zlib(DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm);
 int     cckd_compress_bzip2(DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm);
+int     cckd_compress_zstd(DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm);
+int     cckd_compress_lz4(DEVBLK *dev, BYTE **to, BYTE *from, int len, int parm);
+int     cckd_dict_init(CCKD_DICT *dict, BYTE *buf, U32 len, int algo, int level);
+void    cckd_dict_free(CCKD_DICT *dict);
+U32     cckd_dict_id(int comp, BYTE *from, int len);
+CCKD_DICT *cckd_dict_find(DEVBLK *dev, int comp, U32 id);
+CCKD_DICT *cckd_dict_active(DEVBLK *dev, int comp);
+int     cckd_dict_compress(CCKD_DICT *dict, BYTE *to, BYTE *from, int len, int parm);
+int     cckd_dict_uncompress(CCKD_DICT *dict, BYTE *to, BYTE *from, int len, int maxlen);
+int     cckd_dict_train(BYTE *dict, int size, BYTE *samples, size_t *sizes, int n, int comp);
+CCKD_DICT *cckd64_dict_find(DEVBLK *dev, int comp, U32 id);
+CCKD_DICT *cckd64_dict_active(DEVBLK *dev, int comp);
 /*-------------------------------------------------------------------*/
 BYTE   *cckd64_uncompress(DEVBLK *dev, BYTE *from, int len, int maxlen, int trk);
 //t     cckd64_uncompress_zlib(DEVBLK *dev, BYTE *to, BYTE *from, int len, int maxlen);
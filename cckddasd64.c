@@ -67,6 +67,8 @@ char         buf[32];                   /* Work buffer                      */
     {
         cckd->L1idx = cckd->sfx = cckd->L2_active = -1;
         dev->cache = cckd->free_idx1st = -1;
+        cckd->ralast = -1;
+        cckd->radepth = cckdblk.readaheads;
         cckd->fd[0] = dev->fd;
         fdflags = get_file_accmode_flags( dev->fd );
         cckd->open[0] = (fdflags & O_RDWR) ? CCKD_OPEN_RW : CCKD_OPEN_RO;
@@ -211,9 +213,12 @@ int             rc, i;                  /* Return code, Loop index   */
             cckd->open[i] = 0;
         }
 
-        /* free the level 1 tables */
+        /* free the level 1 tables and dictionaries */
         for (i = 0; i <= cckd->sfn; i++)
+        {
             cckd->L1tab[i] = cckd_free (dev, "l1", cckd->L1tab[i]);
+            cckd_dict_free (&cckd->dict[i]);
+        }
 
         /* reset the device handler */
         if (cckd->ckddasd)
@@ -444,6 +449,8 @@ int             rc = 0;                 /* Return code               */
     cckd->fd[sfx] = -1;
     if (sfx == 0) dev->fd = -1;
 
+    cckd_dict_free (&cckd->dict[sfx]);
+
     return rc;
 
 } /* end function cckd64_close */
@@ -455,12 +462,15 @@ int cckd64_read( DEVBLK* dev, int sfx, U64 off, void* buf, unsigned int len )
 {
 CCKD64_EXT     *cckd;                   /* -> cckd extension         */
 int             rc;                     /* Return code               */
+struct timeval  beg;                    /* Start time                */
 
     cckd = dev->cckd_ext;
 
     CCKD_TRACE( "file[%d] fd[%d] read, off 0x%16.16"PRIx64" len %d",
                 sfx, cckd->fd[ sfx ], off, len );
 
+    gettimeofday( &beg, NULL );
+
     /* Seek to specified offset */
     if (lseek( cckd->fd[ sfx ], off, SEEK_SET ) < 0)
     {
@@ -473,6 +483,7 @@ int             rc;                     /* Return code               */
 
     /* Read the data */
     rc = read( cckd->fd[ sfx ], buf, len );
+    cckd_iostat( &cckd->iostats, 0, 1, &beg );
     if (rc < (int)len)
     {
         if (rc < 0)
@@ -502,12 +513,15 @@ int cckd64_write( DEVBLK* dev, int sfx, U64 off, void* buf, unsigned int len )
 {
 CCKD64_EXT     *cckd;                   /* -> cckd extension         */
 int             rc = 0;                 /* Return code               */
+struct timeval  beg;                    /* Start time                */
 
     cckd = dev->cckd_ext;
 
     CCKD_TRACE( "file[%d] fd[%d] write, off 0x%16.16"PRIx64" len %d",
                 sfx, cckd->fd[ sfx ], off, len );
 
+    gettimeofday( &beg, NULL );
+
     /* Seek to specified offset */
     if (lseek( cckd->fd[ sfx ], off, SEEK_SET ) < 0)
     {
@@ -520,6 +534,7 @@ int             rc = 0;                 /* Return code               */
 
     /* Write the data */
     rc = write( cckd->fd[ sfx ], buf, len );
+    cckd_iostat( &cckd->iostats, 1, 1, &beg );
     if (rc < (int)len)
     {
         if (rc < 0)
@@ -784,7 +799,7 @@ int             maxlen;                 /* Size for cache entry      */
         if ((cbuf[0] & CCKD_COMPRESS_MASK) != 0
          && (cbuf[0] & dev->comps) == 0)
         {
-            len = cache_getval(CACHE_DEVBUF, dev->cache) + CKD_TRKHDR_SIZE;
+            len = cache_getval(CACHE_DEVBUF, dev->cache);
             newbuf = cckd64_uncompress (dev, cbuf, len, maxlen, blkgrp);
             if (newbuf == NULL) {
                 dev->sense[0] = SENSE_EC;
@@ -825,10 +840,14 @@ int             maxlen;                 /* Size for cache entry      */
     dev->bufoff   = 0;
     dev->bufoffhi = CFBA_BLKGRP_SIZE;
     dev->buflen   = CFBA_BLKGRP_SIZE;
-    cache_setval  (CACHE_DEVBUF, dev->cache, dev->buflen);
     dev->bufsize  = cache_getlen (CACHE_DEVBUF, dev->cache);
     dev->comp     = cbuf[0] & CCKD_COMPRESS_MASK;
 
+    /* Keep the image length from cckd_read_trk while the image is
+       still compressed; the decompressors need the exact length */
+    if (dev->comp == 0 || (dev->comp & dev->comps) != 0)
+        cache_setval (CACHE_DEVBUF, dev->cache, dev->buflen);
+
     /* If the image is compressed then call ourself recursively
        to cause the image to get uncompressed.  This is because
       `bufcur' will match blkgrp and `comps' won't match `comp' */
@@ -941,9 +960,7 @@ int             fnd;                    /* Cache index for hit       */
 int             lru;                    /* Oldest unused cache index */
 int             len;                    /* Length of track image     */
 int             maxlen;                 /* Length for buffer         */
-int             curtrk = -1;            /* Current track (at entry)  */
-U16             devnum;                 /* Device number             */
-U32             oldtrk;                 /* Stolen track number       */
+int             used = 0;               /* 1=Hit a track read ahead  */
 U32             flag;                   /* Cache flag                */
 BYTE           *buf;                    /* Read buffer               */
 
@@ -964,7 +981,6 @@ BYTE           *buf;                    /* Read buffer               */
     /* Inactivate the old entry */
     if (!ra)
     {
-        curtrk = dev->bufcur;
         if (dev->cache >= 0)
             cache_setflag(CACHE_DEVBUF, dev->cache, ~CCKD_CACHE_ACTIVE, 0);
         dev->bufcur = dev->cache = -1;
@@ -983,6 +999,15 @@ cckd_read_trk_retry:
             return fnd;
         }
 
+        /* A track read before (not just read ahead) is promoted */
+        if (cache_getflag(CACHE_DEVBUF, fnd) & CCKD_CACHE_USED)
+            cache_promote(CACHE_DEVBUF, fnd);
+        else
+        {
+            cckdblk.stats_readaheadused++; cckd->raused++;
+            used = 1;
+        }
+
         /* Mark the new entry active */
         cache_setflag(CACHE_DEVBUF, fnd, ~0, CCKD_CACHE_ACTIVE | CCKD_CACHE_USED);
         cache_setage(CACHE_DEVBUF, fnd);
@@ -1024,8 +1049,7 @@ cckd_read_trk_retry:
         release_lock (&cckd->cckdiolock);
 
         /* Asynchrously schedule readaheads */
-        if (curtrk > 0 && trk > curtrk && trk <= curtrk + 2)
-            cckd_readahead (dev, trk);
+        cckd_readahead (dev, trk, used);
 
         return fnd;
 
@@ -1056,42 +1080,15 @@ cckd_read_trk_retry:
         goto cckd_read_trk_retry;
     }
 
-    CCKD_CACHE_GETKEY(lru, devnum, oldtrk);
-    if (devnum != 0)
-    {
-        CCKD_TRACE( "%d rdtrk[%d] %d dropping %4.4X:%d from cache",
-                    ra, lru, trk, devnum, oldtrk);
-        if (!(cache_getflag(CACHE_DEVBUF, lru) & CCKD_CACHE_USED))
-        {
-            cckdblk.stats_readaheadmisses++;  cckd->misses++;
-        }
-    }
-
-    /* Initialize the entry */
-    cache_setkey(CACHE_DEVBUF, lru, CCKD_CACHE_SETKEY(dev->devnum, trk));
-    cache_setflag(CACHE_DEVBUF, lru, 0, CCKD_CACHE_READING);
-    cache_setage(CACHE_DEVBUF, lru);
-    cache_setval(CACHE_DEVBUF, lru, 0);
-    if (!ra)
-    {
-        cckdblk.stats_switches++; cckd->switches++;
-        cckdblk.stats_cachemisses++;
-        cache_setflag(CACHE_DEVBUF, lru, ~0, CCKD_CACHE_ACTIVE|CCKD_CACHE_USED);
-    }
-    cache_setflag(CACHE_DEVBUF, lru, ~CACHE_TYPE,
-                  cckd->ckddasd ? DEVBUF_TYPE_CCKD : DEVBUF_TYPE_CFBA);
-    buf = cache_getbuf(CACHE_DEVBUF, lru, maxlen);
-
-    CCKD_TRACE( "%d rdtrk[%d] %d buf %p len %d",
-                ra, lru, trk, buf, cache_getlen(CACHE_DEVBUF, lru));
+    buf = cckd64_read_trk_entry (dev, lru, trk, ra, maxlen);
 
     cache_unlock (CACHE_DEVBUF);
 
     if (!ra) release_lock (&cckd->cckdiolock);
 
     /* Asynchronously schedule readaheads */
-    if (!ra && curtrk > 0 && trk > curtrk && trk <= curtrk + 2)
-        cckd_readahead (dev, trk);
+    if (!ra)
+        cckd_readahead (dev, trk, 0);
 
     /* Clear the buffer if batch mode */
     if (dev->batch) memset(buf, 0, maxlen);
@@ -1135,6 +1132,161 @@ cckd_read_trk_retry:
 
 } /* end function cckd64_read_trk */
 
+/*-------------------------------------------------------------------*/
+/* Initialize the stolen cache entry `lru' for reading a track       */
+/*                                                                   */
+/* Called with the cache lock held.  Returns the entry's buffer.     */
+/*-------------------------------------------------------------------*/
+BYTE* cckd64_read_trk_entry (DEVBLK *dev, int lru, int trk, int ra, int maxlen)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+U16             devnum;                 /* Device number             */
+U32             oldtrk;                 /* Stolen track number       */
+BYTE           *buf;                    /* Read buffer               */
+
+    cckd = dev->cckd_ext;
+
+    CCKD_CACHE_GETKEY(lru, devnum, oldtrk);
+    if (devnum != 0)
+    {
+        CCKD_TRACE( "%d rdtrk[%d] %d dropping %4.4X:%d from cache",
+                    ra, lru, trk, devnum, oldtrk);
+        if (!(cache_getflag(CACHE_DEVBUF, lru) & CCKD_CACHE_USED))
+            cckd_readahead_wasted (dev, devnum);
+    }
+
+    /* Initialize the entry */
+    cache_setkey(CACHE_DEVBUF, lru, CCKD_CACHE_SETKEY(dev->devnum, trk));
+    if (cache_protected(CACHE_DEVBUF, lru))
+    {
+        cckdblk.stats_ghosthits++; cckd->ghosthits++;
+    }
+    cache_setflag(CACHE_DEVBUF, lru, 0, CCKD_CACHE_READING);
+    cache_setage(CACHE_DEVBUF, lru);
+    cache_setval(CACHE_DEVBUF, lru, 0);
+    if (!ra)
+    {
+        cckdblk.stats_switches++; cckd->switches++;
+        cckdblk.stats_cachemisses++;
+        cache_setflag(CACHE_DEVBUF, lru, ~0, CCKD_CACHE_ACTIVE|CCKD_CACHE_USED);
+    }
+    cache_setflag(CACHE_DEVBUF, lru, ~CACHE_TYPE,
+                  cckd->ckddasd ? DEVBUF_TYPE_CCKD : DEVBUF_TYPE_CFBA);
+    buf = cache_getbuf(CACHE_DEVBUF, lru, maxlen);
+
+    CCKD_TRACE( "%d rdtrk[%d] %d buf %p len %d",
+                ra, lru, trk, buf, cache_getlen(CACHE_DEVBUF, lru));
+
+    return buf;
+
+} /* end function cckd64_read_trk_entry */
+
+/*-------------------------------------------------------------------*/
+/* Read ahead several tracks with one submission                     */
+/*                                                                   */
+/* Like cckd64_read_trk (with `ra' nonzero) for each of the `n' tracks */
+/* except that the track images are read together using `aio'.       */
+/*-------------------------------------------------------------------*/
+void cckd64_readahead_trks (DEVBLK *dev, int *trks, int n, int ra, CCKD_AIO *aio)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+int             fnd;                    /* Cache index for hit       */
+int             lru;                    /* Oldest unused cache index */
+int             maxlen;                 /* Length for buffer         */
+int             i, k, j;                /* Indexes                   */
+int             o[CCKD_AIO_DEPTH];      /* Cache entries             */
+int             t[CCKD_AIO_DEPTH];      /* Tracks being read         */
+int             lens[CCKD_AIO_DEPTH];   /* Track image lengths       */
+BYTE           *bufs[CCKD_AIO_DEPTH];   /* Read buffers              */
+U32             flag;                   /* Cache flag                */
+int             signal = 0;             /* 1=Signal read complete    */
+
+    if (!dev->cckd64)
+    {
+        cckd_readahead_trks( dev, trks, n, ra, aio );
+        return;
+    }
+
+    cckd = dev->cckd_ext;
+
+    maxlen = cckd->ckddasd ? dev->ckdtrksz
+                           : CFBA_BLKGRP_SIZE + CKD_TRKHDR_SIZE;
+
+    /* Get cache entries for the tracks not already cached */
+    cache_lock (CACHE_DEVBUF);
+    for (i = k = 0; i < n && k < CCKD_AIO_DEPTH; i++)
+    {
+        CCKD_TRACE( "%d rdtrk     %d", ra, trks[i]);
+
+        fnd = cache_lookup (CACHE_DEVBUF, CCKD_CACHE_SETKEY(dev->devnum, trks[i]), &lru);
+        if (fnd >= 0)
+            continue;
+
+        /* The rest are read by cckd_read_trk, which waits for entries */
+        if (lru < 0)
+            break;
+
+        CCKD_TRACE( "%d rdtrk[%d] %d cache miss", ra, lru, trks[i]);
+
+        t[k] = trks[i];
+        o[k] = lru;
+        bufs[k] = cckd64_read_trk_entry (dev, lru, trks[i], ra, maxlen);
+        k++;
+    }
+    cache_unlock (CACHE_DEVBUF);
+
+    /* Read the track images */
+    if (k)
+    {
+        /* Clear the buffers if batch mode */
+        if (dev->batch)
+            for (j = 0; j < k; j++)
+                memset(bufs[j], 0, maxlen);
+
+        obtain_lock( &cckd->filelock );
+        {
+            cckd64_read_trkimgs (dev, bufs, t, lens, k, aio);
+        }
+        release_lock( &cckd->filelock );
+    }
+
+    obtain_lock (&cckd->cckdiolock);
+    {
+        for (j = 0; j < k; j++)
+        {
+            cache_setval (CACHE_DEVBUF, o[j], lens[j]);
+
+            /* Turn off the READING bit */
+            cache_lock (CACHE_DEVBUF);
+            flag = cache_setflag(CACHE_DEVBUF, o[j], ~CCKD_CACHE_READING, 0);
+            cache_unlock (CACHE_DEVBUF);
+
+            if (cckd->cckdwaiters && (flag & CCKD_CACHE_IOWAIT))
+            {   CCKD_TRACE( "%d rdtrk[%d] %d signalling read complete",
+                            ra, o[j], t[j]);
+                signal = 1;
+            }
+
+            cckdblk.stats_readaheads++; cckd->readaheads++;
+
+            CCKD_TRACE( "%d rdtrk[%d] %d complete buf %p:%2.2x%2.2x%2.2x%2.2x%2.2x",
+                        ra, o[j], t[j], bufs[j], bufs[j][0], bufs[j][1],
+                        bufs[j][2], bufs[j][3], bufs[j][4]);
+        }
+
+        /* Wakeup other threads waiting for these reads */
+        if (signal)
+            broadcast_condition (&cckd->cckdiocond);
+    }
+    release_lock (&cckd->cckdiolock);
+
+    for (; i < n; i++)
+        cckd64_read_trk (dev, trks[i], ra, NULL);
+
+    if (cache_busy_percent(CACHE_DEVBUF) > 80) cckd64_flush_cache_all();
+
+} /* end function cckd64_readahead_trks */
+
 /*-------------------------------------------------------------------*/
 /* Flush updated cache entries for a device                          */
 /*                                                                   */
@@ -1270,33 +1422,25 @@ DEVBLK         *dev = data;             /* -> device block           */
 }
 
 /*-------------------------------------------------------------------*/
-/* cckd writer thread helper:   write the cached track image         */
+/* cckd writer thread helper:   compress the cached track image      */
 /*-------------------------------------------------------------------*/
-void cckd64_writer_write( int writer, int o )
+int cckd64_writer_comp( int writer, int o, BYTE* buf2, BYTE** bufp )
 {
-TID             tid;                    /* Writer thead id           */
 CCKD64_EXT*     cckd;                   /* -> cckd extension         */
 DEVBLK*         dev;                    /* Device block              */
 U16             devnum;                 /* Device number             */
-int             rc;                     /* (work) return code        */
 int             trk;                    /* Track number              */
 BYTE*           buf;                    /* Buffer                    */
-BYTE*           bufp;                   /* Buffer to be written      */
 int             len, bufl;              /* Buffer lengths            */
 int             comp;                   /* Compression algorithm     */
 int             parm;                   /* Compression parameter     */
-U32             flag;                   /* Cache flag                */
-BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
 
     /* Prepare to compress */
     CCKD_CACHE_GETKEY( o, devnum, trk );
     dev = cckd_find_device_by_devnum( devnum );
 
     if (!dev->cckd64)
-    {
-        cckd_writer_write( writer, o );
-        return;
-    }
+        return cckd_writer_comp( writer, o, buf2, bufp );
 
     cckd = dev->cckd_ext;
     buf  = cache_getbuf( CACHE_DEVBUF, o, 0 );
@@ -1337,18 +1481,47 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
         CCKD_TRACE( "%d wrtrk[%d] %d comp %s parm %d",
                     writer, o, trk, compname[ comp ], parm );
 
-        bufp = (BYTE*) &buf2;
-        bufl = cckd_compress( dev, &bufp, buf, len, comp, parm );
+        *bufp = buf2;
+        bufl = cckd_compress( dev, bufp, buf, len, comp, parm );
 
         CCKD_TRACE( "%d wrtrk[%d] %d compressed length %d",
                     writer, o, trk, bufl );
     }
     else
     {
-        bufp = buf;
+        *bufp = buf;
         bufl = len;
     }
 
+    return bufl;
+} /* end function cckd64_writer_comp */
+
+/*-------------------------------------------------------------------*/
+/* cckd writer thread helper:   write a device's compressed images   */
+/*-------------------------------------------------------------------*/
+void cckd64_writer_write( int writer, CCKD_WRBATCH* batch, int beg, int end )
+{
+TID             tid;                    /* Writer thead id           */
+CCKD64_EXT*     cckd;                   /* -> cckd extension         */
+DEVBLK*         dev;                    /* Device block              */
+U16             devnum;                 /* Device number             */
+int             rc;                     /* (work) return code        */
+int             trk;                    /* Track number              */
+U32             flag;                   /* Cache flag                */
+int             i, o;                   /* Batch index, cache entry  */
+int             signal = 0;             /* 1=Signal write complete   */
+
+    CCKD_CACHE_GETKEY( batch->o[ beg ], devnum, trk );
+    dev = cckd_find_device_by_devnum( devnum );
+
+    if (!dev->cckd64)
+    {
+        cckd_writer_write( writer, batch, beg, end );
+        return;
+    }
+
+    cckd = dev->cckd_ext;
+
     obtain_lock( &cckd->filelock );
     {
         /* Turn on read-write header bits if not already on */
@@ -1358,8 +1531,20 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
             cckd64_write_chdr( dev );
         }
 
-        /* Write the track image */
-        cckd64_write_trkimg( dev, bufp, bufl, trk, CCKD_SIZE_ANY );
+        /* Write the track images */
+        cckd->wrbatch = batch->aio ? batch : NULL;
+        batch->ndefer = 0;
+        for (i = beg; i < end; i++)
+        {
+            CCKD_CACHE_GETKEY( batch->o[i], devnum, trk );
+            cckd64_write_trkimg( dev, batch->bufp[i], batch->bufl[i], trk, CCKD_SIZE_ANY );
+        }
+        if (cckd->wrbatch)
+        {
+            cckd_aio_submit( batch->aio );
+            cckd64_write_trkimg_done( dev, batch );
+        }
+        cckd->wrbatch = NULL;
     }
     release_lock( &cckd->filelock );
 
@@ -1398,32 +1583,40 @@ BYTE            buf2[ 64*1024 ];        /* 64K Compress buffer       */
 
     obtain_lock( &cckd->cckdiolock );
     {
-        cache_lock( CACHE_DEVBUF );
+        for (i = beg; i < end; i++)
         {
-            flag = cache_setflag( CACHE_DEVBUF, o, ~CCKD_CACHE_WRITING, 0 );
-        }
-        cache_unlock( CACHE_DEVBUF );
+            o = batch->o[i];
+            CCKD_CACHE_GETKEY( o, devnum, trk );
 
-        cckd->wrpending--;
+            cache_lock( CACHE_DEVBUF );
+            {
+                flag = cache_setflag( CACHE_DEVBUF, o, ~CCKD_CACHE_WRITING, 0 );
+            }
+            cache_unlock( CACHE_DEVBUF );
 
-        if (1
-            && cckd->cckdwaiters
-            && (0
-                || (flag & CCKD_CACHE_IOWAIT)
-                || !cckd->wrpending
-               )
-        )
-        {   CCKD_TRACE( "writer[%d] cache[%2.2d] %d signalling write complete",
-                        writer, o, trk );
+            cckd->wrpending--;
 
-            broadcast_condition( &cckd->cckdiocond );
+            if (1
+                && cckd->cckdwaiters
+                && (0
+                    || (flag & CCKD_CACHE_IOWAIT)
+                    || !cckd->wrpending
+                   )
+            )
+            {   CCKD_TRACE( "writer[%d] cache[%2.2d] %d signalling write complete",
+                            writer, o, trk );
+                signal = 1;
+            }
+
+            CCKD_TRACE( "%d wrtrk[%2.2d] %d complete flags:%8.8x",
+                        writer, o, trk, cache_getflag( CACHE_DEVBUF, o ));
         }
+
+        if (signal)
+            broadcast_condition( &cckd->cckdiocond );
     }
     release_lock( &cckd->cckdiolock );
 
-    CCKD_TRACE( "%d wrtrk[%2.2d] %d complete flags:%8.8x",
-                writer, o, trk, cache_getflag( CACHE_DEVBUF, o ));
-
 } /* end function cckd64_writer_write */
 
 #if defined( DEBUG_FREESPACE )
@@ -1965,6 +2158,130 @@ int             sfx;                    /* File index                */
 
 } /* end function cckd64_write_chdr */
 
+/*-------------------------------------------------------------------*/
+/* Read the compression dictionary                                   */
+/*-------------------------------------------------------------------*/
+int cckd64_read_dict (DEVBLK *dev)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+int             sfx;                    /* File index                */
+BYTE           *buf;                    /* Dictionary buffer         */
+U32             len;                    /* Dictionary length         */
+
+    if (!dev->cckd64)
+        return cckd_read_dict( dev );
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+
+    cckd_dict_free (&cckd->dict[sfx]);
+
+    len = cckd->cdevhdr[sfx].dict_len;
+    if (len == 0)
+        return 0;
+
+    CCKD_TRACE( "file[%d] read_dict off 0x%"PRIx64" len %u",
+                sfx, cckd->cdevhdr[sfx].dict_off, len );
+
+    if ((buf = cckd_malloc (dev, "dict", len)) == NULL)
+        return -1;
+
+    if (cckd64_read (dev, sfx, cckd->cdevhdr[sfx].dict_off, buf, len) < 0)
+    {
+        cckd_free (dev, "dict", buf);
+        return -1;
+    }
+
+    if (cckd_dict_init (&cckd->dict[sfx], buf, len,
+                        cckd->cdevhdr[sfx].dict_algo,
+                        cckd->cdevhdr[sfx].cmp_parm) < 0)
+    {
+        // "%1d:%04X CCKD file[%d] %s: compression %s not supported"
+        WRMSG (HHC00344, "E", LCSS_DEVNUM, sfx, cckd_sf_name (dev, sfx),
+               "dictionary");
+        cckd_free (dev, "dict", buf);
+        return -1;
+    }
+
+    return 0;
+
+} /* end function cckd64_read_dict */
+
+/*-------------------------------------------------------------------*/
+/* Relocate the compression dictionary                               */
+/*-------------------------------------------------------------------*/
+int cckd64_write_dict (DEVBLK *dev, BYTE *buf)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+int             sfx;                    /* File index                */
+S64             off;                    /* New file offset           */
+U64             old_off;                /* Old file offset           */
+int             size;                   /* Dictionary length         */
+
+    if (!dev->cckd64)
+        return cckd_write_dict( dev, buf );
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+    size = (int)cckd->cdevhdr[sfx].dict_len;
+    old_off = cckd->cdevhdr[sfx].dict_off;
+
+    CCKD_TRACE( "file[%d] write_dict len %d", sfx, size );
+
+    if ((off = cckd64_get_space( dev, &size, CCKD_SIZE_EXACT )) < 0)
+        return -1;
+    if (cckd64_write( dev, sfx, (U64)off, buf, cckd->cdevhdr[sfx].dict_len ) < 0)
+        return -1;
+
+    cckd->cdevhdr[sfx].dict_off = (U64)off;
+    if (cckd64_write_chdr( dev ) < 0)
+        return -1;
+
+    cckd64_rel_space( dev, old_off, cckd->cdevhdr[sfx].dict_len,
+                                    cckd->cdevhdr[sfx].dict_len );
+    return 0;
+
+} /* end function cckd64_write_dict */
+
+/*-------------------------------------------------------------------*/
+/* Find a loaded dictionary by algorithm and id                      */
+/*-------------------------------------------------------------------*/
+CCKD_DICT *cckd64_dict_find (DEVBLK *dev, int comp, U32 id)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+int             i;                      /* File index                */
+
+    if (!dev->cckd64)
+        return cckd_dict_find( dev, comp, id );
+
+    if ((cckd = dev->cckd_ext) == NULL || id == 0)
+        return NULL;
+
+    for (i = cckd->sfn; i >= 0; i--)
+        if (cckd->dict[i].dict_buf
+         && cckd->dict[i].dict_algo == comp
+         && cckd->dict[i].dict_id == id)
+            return &cckd->dict[i];
+    return NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/* Return the dictionary new images are compressed with, if any      */
+/*-------------------------------------------------------------------*/
+CCKD_DICT *cckd64_dict_active (DEVBLK *dev, int comp)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+
+    if (!dev->cckd64)
+        return cckd_dict_active( dev, comp );
+
+    if ((cckd = dev->cckd_ext) == NULL
+     || cckd->dict[cckd->sfn].dict_buf == NULL
+     || cckd->dict[cckd->sfn].dict_algo != comp)
+        return NULL;
+    return &cckd->dict[cckd->sfn];
+}
+
 /*-------------------------------------------------------------------*/
 /* Read the level 1 table                                            */
 /*-------------------------------------------------------------------*/
@@ -2119,6 +2436,10 @@ int cckd64_read_init (DEVBLK *dev)
     if (cckd64_read_l1( dev ) < 0)
         return -1;
 
+    /* Load the compression dictionary; images that need it
+       will fail to uncompress if it can't be loaded */
+    cckd64_read_dict( dev );
+
     return 0;
 } /* end function cckd64_read_init */
 
@@ -2706,6 +3027,64 @@ cckd_read_trkimg_error:
 
 } /* end function cckd64_read_trkimg */
 
+/*-------------------------------------------------------------------*/
+/* Read several track images with one submission                     */
+/*                                                                   */
+/* Like cckd64_read_trkimg (without unitstat) for each of the `n'      */
+/* tracks, except that the image reads are queued on `aio' and then  */
+/* submitted together.  Called with the file lock held.  The image   */
+/* lengths are returned in `lens'.                                   */
+/*-------------------------------------------------------------------*/
+void cckd64_read_trkimgs (DEVBLK *dev, BYTE **bufs, int *trks, int *lens,
+                        int n, CCKD_AIO *aio)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+int             rc[CCKD_AIO_DEPTH];     /* Return codes              */
+int             sfx[CCKD_AIO_DEPTH];    /* File indexes              */
+CCKD64_L2ENT    l2;                     /* Level 2 entry             */
+int             i;                      /* Index                     */
+
+    cckd = dev->cckd_ext;
+
+    for (i = 0; i < n; i++)
+    {
+        CCKD_TRACE( "trk[%d] read_trkimg", trks[i]);
+
+        /* Queue the track image read or build a null track image */
+        if ((sfx[i] = cckd64_read_l2ent (dev, &l2, trks[i])) < 0)
+            rc[i] = -1;
+        else if (l2.L2_trkoff != 0)
+            cckd_aio_queue (aio, dev, sfx[i], l2.L2_trkoff,
+                            bufs[i], l2.L2_len, 0, &rc[i]);
+        else
+        {
+            rc[i] = cckd64_null_trk (dev, bufs[i], trks[i], l2.L2_len);
+            sfx[i] = -1;
+        }
+    }
+
+    cckd_aio_submit (aio);
+
+    for (i = 0; i < n; i++)
+    {
+        if (rc[i] >= 0 && sfx[i] >= 0)
+        {
+            cckd->reads[sfx[i]]++;
+            cckd->totreads++;
+            cckdblk.stats_reads++;
+            cckdblk.stats_readbytes += rc[i];
+            if (cckd->notnull == 0 && trks[i] > 1) cckd->notnull = 1;
+        }
+
+        /* Validate the track image */
+        if (rc[i] < 0 || cckd64_cchh (dev, bufs[i], trks[i]) < 0)
+            rc[i] = cckd64_null_trk (dev, bufs[i], trks[i], 0);
+
+        lens[i] = rc[i];
+    }
+
+} /* end function cckd64_read_trkimgs */
+
 /*-------------------------------------------------------------------*/
 /* Write a track image                                               */
 /*-------------------------------------------------------------------*/
@@ -2718,6 +3097,7 @@ CCKD64_L2ENT    l2, oldl2;              /* Level 2 entries           */
 int             sfx,L1idx,l2x;          /* Lookup table indices      */
 int             after = 0;              /* 1=New track after old     */
 int             size;                   /* Size of new track         */
+CCKD_WRDEFER   *d;                      /* -> Queued write           */
 
     if (!dev->cckd64)
         return cckd_write_trkimg( dev, buf, len, trk, flags );
@@ -2767,6 +3147,25 @@ int             size;                   /* Size of new track         */
         )
             after = 1;
 
+        /* Queue the write of the track image.  The level 2 entry is
+           only updated, and the previous space released, by
+           cckd64_write_trkimg_done once the write has completed */
+        if (cckd->wrbatch)
+        {
+            d = &cckd->wrbatch->defer[ cckd->wrbatch->ndefer++ ];
+            d->trk     = trk;
+            d->rc      = -1;
+            d->off     = (U64)off;
+            d->len     = len;
+            d->size    = size;
+            d->oldoff  = oldl2.L2_trkoff;
+            d->oldlen  = oldl2.L2_len;
+            d->oldsize = oldl2.L2_size;
+
+            cckd_aio_queue (cckd->wrbatch->aio, dev, sfx, d->off, buf, len, 1, &d->rc);
+            return after;
+        }
+
         /* Write the track image */
         if ((rc = cckd64_write (dev, sfx, off, buf, len)) < 0)
             return -1;
@@ -2794,6 +3193,69 @@ int             size;                   /* Size of new track         */
 
 } /* end function cckd64_write_trkimg */
 
+/*-------------------------------------------------------------------*/
+/* Complete the queued track image writes of a writer batch          */
+/*                                                                   */
+/* Called with the file lock held after the batch's I/O queue has    */
+/* been submitted.  A track whose image was written in full has its  */
+/* level 2 entry updated and its previous space released.  If the    */
+/* write failed (the error has been reported) the new space is       */
+/* released instead, so the level 2 entry still points to the old    */
+/* image, as it does when a synchronous write fails.                 */
+/*-------------------------------------------------------------------*/
+void cckd64_write_trkimg_done (DEVBLK *dev, CCKD_WRBATCH *batch)
+{
+CCKD64_EXT     *cckd;                   /* -> cckd extension         */
+CCKD_WRDEFER   *d;                      /* -> Queued write           */
+CCKD64_L2ENT    l2;                     /* Level 2 entry             */
+int             sfx;                    /* File index                */
+int             i;                      /* Index                     */
+
+    if (!dev->cckd64)
+    {
+        cckd_write_trkimg_done( dev, batch );
+        return;
+    }
+
+    cckd = dev->cckd_ext;
+    sfx = cckd->sfn;
+
+    for (i = 0; i < batch->ndefer; i++)
+    {
+        d = &batch->defer[i];
+
+        if (d->rc != d->len)
+        {
+            CCKD_TRACE( "file[%d] trk[%d] write_trkimg failed, rc %d",
+                        sfx, d->trk, d->rc);
+            cckd64_rel_space (dev, d->off, d->len, d->size);
+            continue;
+        }
+
+        cckd->writes[sfx]++;
+        cckd->totwrites++;
+        cckdblk.stats_writes++;
+        cckdblk.stats_writebytes += d->rc;
+
+        l2.L2_trkoff = d->off;
+        l2.L2_len    = (U16)d->len;
+        l2.L2_size   = (U16)d->size;
+
+        /* Update the level 2 entry */
+        if (0
+            || cckd64_read_l2 (dev, sfx, d->trk >> 8) < 0
+            || cckd64_write_l2ent (dev, &l2, d->trk) < 0
+        )
+            continue;
+
+        /* Release the previous space */
+        cckd64_rel_space (dev, d->oldoff, d->oldlen, d->oldsize);
+    }
+
+    batch->ndefer = 0;
+
+} /* end function cckd64_write_trkimg_done */
+
 /*-------------------------------------------------------------------*/
 /* Harden the file                                                   */
 /*-------------------------------------------------------------------*/
@@ -3323,6 +3785,12 @@ CKD_DEVHDR      devhdr;                 /* Device header             */
     cckd->cdevhdr[cckd->sfn+1].free_num =
     cckd->cdevhdr[cckd->sfn+1].free_imbed = 0;
 
+    /* Shadow files are written without a dictionary */
+    cckd->cdevhdr[cckd->sfn+1].dict_off = 0;
+    cckd->cdevhdr[cckd->sfn+1].dict_len = 0;
+    cckd->cdevhdr[cckd->sfn+1].dict_algo = 0;
+    cckd->cdevhdr[cckd->sfn+1].cdh_opts &= ~CCKD_OPT_DICT;
+
     /* Init the level 1 table */
     if ((cckd->L1tab[cckd->sfn+1] = cckd_malloc (dev, "l1", l1size)) == NULL)
         goto sf_new_error;
@@ -4001,7 +4469,7 @@ DLL_EXPORT void *cckd64_sf_stats (void *data)
 DEVBLK         *dev = data;             /* -> DEVBLK                 */
 CCKD64_EXT     *cckd;                   /* -> cckd extension         */
 struct stat     st = {0};               /* File information          */
-int             i;                      /* Index                     */
+int             i, n;                   /* Index, dictionary count   */
 char           *ost[] = {"  ", "ro", "rd", "rw"};
 U64             usize=0,ufree=0;        /* Total size, free space    */
 S64             free_count=0;           /* Total number free spaces  */
@@ -4055,8 +4523,8 @@ S64             free_count=0;           /* Total number free spaces  */
     // "%1d:%04X   32/64       size free  nbr st   reads  writes l2reads    hits switches"
     WRMSG (HHC00333, "I", LCSS_DEVNUM);
 
-    if (cckd->readaheads || cckd->misses)
-    // "%1d:%04X                                                      readaheads   misses"
+    if (cckd->readaheads || cckd->misses || cckd->ghosthits)
+    // "%1d:%04X                                             readaheads     used   wasted   ghosts"
     WRMSG (HHC00334, "I", LCSS_DEVNUM);
 
     // "%1d:%04X ------------------------------------------------------------------------"
@@ -4076,10 +4544,10 @@ S64             free_count=0;           /* Total number free spaces  */
         , cckd->switches
     );
 
-    if (cckd->readaheads || cckd->misses)
-    // "%1d:%04X                                                         %7.7d  %7.7d"
+    if (cckd->readaheads || cckd->misses || cckd->ghosthits)
+    // "%1d:%04X                                                %7.7d  %7.7d  %7.7d  %7.7d"
     WRMSG (HHC00337, "I", LCSS_DEVNUM,
-            cckd->readaheads, cckd->misses);
+            cckd->readaheads, cckd->raused, cckd->misses, cckd->ghosthits);
 
     /* base file statistics */
 
@@ -4118,6 +4586,40 @@ S64             free_count=0;           /* Total number free spaces  */
         );
     }
 
+    /* dictionary statistics */
+    for (i = 0, n = 0; i <= cckd->sfn; i++)
+    {
+        CCKD_DICT *dict = &cckd->dict[i];
+        if (dict->dict_buf == NULL)
+            continue;
+        // "%1d:%04X [%d] %s dictionary %u bytes: %u images compressed, %"PRId64"%% saved; %u uncompressed at %"PRIu64" MB/s"
+        WRMSG( HHC00395, "I", LCSS_DEVNUM, i, compname[dict->dict_algo],
+               dict->dict_len, (U32)dict->comps,
+               dict->cinbytes ? 100 - dict->coutbytes * 100 / dict->cinbytes : 0,
+               (U32)dict->decomps,
+               (U64)(dict->dusecs ? dict->dbytes / dict->dusecs : 0) );
+        n++;
+    }
+    if (n)
+        // "%1d:%04X [*] %u images uncompressed without dictionary at %"PRIu64" MB/s"
+        WRMSG( HHC00397, "I", LCSS_DEVNUM, (U32)cckd->decomps,
+               (U64)(cckd->dusecs ? cckd->dbytes / cckd->dusecs : 0) );
+
+    /* file I/O statistics */
+    if (cckd->iostats.ops)
+    {
+        CCKD_IOSTATS *st = &cckd->iostats;
+        // "%1d:%04X [*] %"PRIu64" file I/Os in %"PRIu64" submissions, %"PRIu64" by io_uring, max %u per submission"
+        WRMSG( HHC00463, "I", LCSS_DEVNUM, st->ops, st->subs, st->aioops, st->qdmax );
+        // "%1d:%04X [*] %-5s usecs <8 %u <32 %u <128 %u <512 %u <2K %u <8K %u <32K %u more %u"
+        WRMSG( HHC00464, "I", LCSS_DEVNUM, "read",
+               st->rdlat[0], st->rdlat[1], st->rdlat[2], st->rdlat[3],
+               st->rdlat[4], st->rdlat[5], st->rdlat[6], st->rdlat[7] );
+        WRMSG( HHC00464, "I", LCSS_DEVNUM, "write",
+               st->wrlat[0], st->wrlat[1], st->wrlat[2], st->wrlat[3],
+               st->wrlat[4], st->wrlat[5], st->wrlat[6], st->wrlat[7] );
+    }
+
     return NULL;
 } /* end function cckd64_sf_stats */
 
@@ -4430,6 +4932,7 @@ U64             flen, ulen, len;        /* Lengths                   */
 int             trk;                    /* Track number              */
 int             L1idx, l2x;             /* Table Indexes             */
 CCKD64_L2ENT    l2;                     /* Copied level 2 entry      */
+struct timeval  beg, slice;             /* Start of run, of slice    */
 BYTE            buf[256*1024];          /* Buffer                    */
 
     if (!dev->cckd64)
@@ -4475,10 +4978,15 @@ BYTE            buf[256*1024];          /* Buffer                    */
     if (!cckd->L2ok)
         cckd64_gc_l2(dev, buf);
 
+    gettimeofday( &beg, NULL );
+
     /* garbage collection cycle... */
     while (moved < size && after < 4)
     {
+        cckd_gc_yield( dev, moved, &beg );
+
         obtain_lock( &cckd->filelock );
+        gettimeofday( &slice, NULL );
         sfx = cckd->sfn;
 
         /* Exit if no more free space */
@@ -4575,6 +5083,10 @@ BYTE            buf[256*1024];          /* Buffer                    */
         if (ulen > flen + 65536) ulen = flen + 65536;
         if (ulen > sizeof(buf))  ulen = sizeof(buf);
 
+        /* A slice reads no more than the largest space it may move */
+        if (cckdblk.gcslice && ulen > CCKD_GC_SLICE_READ)
+            ulen = CCKD_GC_SLICE_READ;
+
         CCKD_TRACE( "gcperc selected space 0x%16.16"PRIx64" len %"PRId64, upos, ulen);
 
         if (cckd64_read (dev, (int) sfx, upos, buf, (unsigned int) ulen) < 0)
@@ -4584,6 +5096,10 @@ BYTE            buf[256*1024];          /* Buffer                    */
         flags = cckd->cdevhdr[sfx].free_num < 100 ? CCKD_SIZE_EXACT : CCKD_SIZE_ANY;
         for (i = a = 0; (U64)i + CKD_TRKHDR_SIZE <= ulen; i += len)
         {
+            /* End the slice when its time is up */
+            if (i && cckd_gc_slice_done( &slice ))
+                break;
+
             /* Check for level 2 table */
             for (j = 0; j < cckd->cdevhdr[sfx].num_L1tab; j++)
                 if (cckd->L1tab[sfx][j] == (upos + i)) break;
@@ -4612,6 +5128,18 @@ BYTE            buf[256*1024];          /* Buffer                    */
                 if (cckd64_write_l2 (dev) < 0)
                     return GC64_PERC_ERROR();
             }
+            else if (cckd->cdevhdr[sfx].dict_len
+                  && cckd->cdevhdr[sfx].dict_off == (upos + i))
+            {
+                /* Moving the dictionary */
+                len = cckd->cdevhdr[sfx].dict_len;
+                if (i + len > ulen) break;
+                CCKD_TRACE( "gcperc move dict at pos 0x%16.16"PRIx64" len %"PRId64,
+                            upos + i, len);
+
+                if (cckd64_write_dict (dev, buf + i) < 0)
+                    return GC64_PERC_ERROR();
+            }
             else
             {
                 /* Moving a track image */
@@ -4830,7 +5358,7 @@ CCKD64_EXT     *cckd;
 BYTE           *to = NULL;                /* Uncompressed buffer     */
 int             newlen;                   /* Uncompressed length     */
 BYTE            comp;                     /* Compression type        */
-static char    *compress[] = {"none", "zlib", "bzip2"};
+struct timeval  beg, end;                 /* Uncompress times        */
 
     cckd = dev->cckd_ext;
 
@@ -4849,6 +5377,7 @@ static char    *compress[] = {"none", "zlib", "bzip2"};
     }
 
     /* Uncompress the track image */
+    gettimeofday (&beg, NULL);
     switch (comp) {
 
     case CCKD_COMPRESS_NONE:
@@ -4863,11 +5392,30 @@ static char    *compress[] = {"none", "zlib", "bzip2"};
         to = cckd->newbuf;
         newlen = cckd_uncompress_bzip2 (dev, to, from, len, maxlen);
         break;
+    case CCKD_COMPRESS_ZSTD:
+        to = cckd->newbuf;
+        newlen = cckd_uncompress_zstd (dev, to, from, len, maxlen);
+        break;
+    case CCKD_COMPRESS_LZ4:
+        to = cckd->newbuf;
+        newlen = cckd_uncompress_lz4 (dev, to, from, len, maxlen);
+        break;
     default:
         newlen = -1;
         break;
     }
 
+    /* Dictionary images are timed by cckd_dict_uncompress */
+    if (comp != CCKD_COMPRESS_NONE && newlen > 0
+     && !cckd_dict_id (comp, from, len))
+    {
+        gettimeofday (&end, NULL);
+        atomic_update32( &cckd->decomps, 1 );
+        atomic_update64( &cckd->dbytes, newlen );
+        atomic_update64( &cckd->dusecs, (S64)(end.tv_sec - beg.tv_sec) * 1000000
+                                      + end.tv_usec - beg.tv_usec );
+    }
+
     /* Validate the uncompressed track image */
     newlen = cckd64_validate (dev, to, trk, newlen);
 
@@ -4920,12 +5468,34 @@ static char    *compress[] = {"none", "zlib", "bzip2"};
         return to;
     }
 
+    /* zstd compression */
+    to = cckd->newbuf;
+    newlen = cckd_uncompress_zstd  (dev, to, from, len, maxlen);
+    newlen = cckd64_validate       (dev, to, trk, newlen);
+    if (newlen > 0)
+    {
+        cckd->newbuf = from;
+        cckd->bufused = 1;
+        return to;
+    }
+
+    /* lz4 compression */
+    to = cckd->newbuf;
+    newlen = cckd_uncompress_lz4   (dev, to, from, len, maxlen);
+    newlen = cckd64_validate       (dev, to, trk, newlen);
+    if (newlen > 0)
+    {
+        cckd->newbuf = from;
+        cckd->bufused = 1;
+        return to;
+    }
+
     // "%1d:%04X CCKD file[%d] %s: uncompress error trk %d: %2.2x%2.2x%2.2x%2.2x%2.2x"
     WRMSG (HHC00343, "E",
             LCSS_DEVNUM, cckd->sfn, cckd_sf_name(dev, cckd->sfn), trk,
             from[0], from[1], from[2], from[3], from[4]);
     if (comp & ~cckdblk.comps)
         WRMSG (HHC00344, "E",
-                LCSS_DEVNUM, cckd->sfn, cckd_sf_name(dev, cckd->sfn), compress[comp]);
+                LCSS_DEVNUM, cckd->sfn, cckd_sf_name(dev, cckd->sfn), compname[comp]);
     return NULL;
 }
@@ -183,15 +183,18 @@ static int decomptrk
     char*  emsg                 /* addr of 81 byte msg buf or NULL   */
 )
 {
-#if defined( HAVE_ZLIB ) || defined( CCKD_BZIP2 )
+#if defined( HAVE_ZLIB ) || defined( CCKD_BZIP2 ) || defined( CCKD_LZ4 )
     int             rc;         /* Return code                       */
 #endif
     unsigned int    bufl;       /* Buffer length                     */
 #if defined( CCKD_BZIP2 )
     unsigned int    ubufl;      /* when U64 != unsigned int          */
 #endif
+#if defined( CCKD_ZSTD )
+    size_t          zbufl;      /* zstd decompressed length          */
+#endif
 
-#if !defined( HAVE_ZLIB ) && !defined( CCKD_BZIP2 )
+#if !defined( HAVE_ZLIB ) && !defined( CCKD_BZIP2 ) && !defined( CCKD_ZSTD ) && !defined( CCKD_LZ4 )
     UNREFERENCED(heads);
     UNREFERENCED(trk);
     UNREFERENCED(emsg);
@@ -264,6 +267,64 @@ static int decomptrk
         break;
 #endif
 
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+        memcpy(obuf, ibuf, CKD_TRKHDR_SIZE);
+        zbufl = ZSTD_decompress
+        (
+            &obuf[ CKD_TRKHDR_SIZE ],
+            obuflen - CKD_TRKHDR_SIZE,
+            &ibuf[ CKD_TRKHDR_SIZE ],
+            ibuflen - CKD_TRKHDR_SIZE
+        );
+        if (ZSTD_isError( zbufl ))
+        {
+            if (emsg)
+            {
+                char msg[81];
+
+                MSGBUF(msg, "%s %d decompress error, %s;"
+                         "%2.2x%2.2x%2.2x%2.2x%2.2x",
+                         heads >= 0 ? "trk" : "blk", trk, ZSTD_getErrorName( zbufl ),
+                         ibuf[0], ibuf[1], ibuf[2], ibuf[3], ibuf[4]);
+                memcpy(emsg, msg, 81);
+            }
+            return -1;
+        }
+        bufl = (unsigned int) zbufl;
+        bufl += CKD_TRKHDR_SIZE;
+        break;
+#endif
+
+#if defined( CCKD_LZ4 )
+    case CCKD_COMPRESS_LZ4:
+        memcpy(obuf, ibuf, CKD_TRKHDR_SIZE);
+        rc = LZ4_decompress_safe
+        (
+            (const char *)&ibuf[ CKD_TRKHDR_SIZE ],
+            (char *)&obuf[ CKD_TRKHDR_SIZE ],
+            ibuflen - CKD_TRKHDR_SIZE,
+            obuflen - CKD_TRKHDR_SIZE
+        );
+        if (rc < 0)
+        {
+            if (emsg)
+            {
+                char msg[81];
+
+                MSGBUF(msg, "%s %d decompress error, rc=%d;"
+                         "%2.2x%2.2x%2.2x%2.2x%2.2x",
+                         heads >= 0 ? "trk" : "blk", trk, rc,
+                         ibuf[0], ibuf[1], ibuf[2], ibuf[3], ibuf[4]);
+                memcpy(emsg, msg, 81);
+            }
+            return -1;
+        }
+        bufl = rc;
+        bufl += CKD_TRKHDR_SIZE;
+        break;
+#endif
+
     default:
         return -1;
 
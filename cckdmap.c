@@ -119,6 +119,10 @@ static void cdevhdr_to_64()
 
         cdevhdr.cmp_algo     = cdevhdr32.cmp_algo;
         cdevhdr.cmp_parm     = cdevhdr32.cmp_parm;
+
+        cdevhdr.dict_off     = cdevhdr32.dict_off;
+        cdevhdr.dict_len     = cdevhdr32.dict_len;
+        cdevhdr.dict_algo    = cdevhdr32.dict_algo;
     }
 }
 static void L1tab_to_64()
@@ -759,6 +763,7 @@ U16             devtype;                /* Device type (e.g. 0x3390) */
         // cdh_nullfmt:   %u               (%s)
         // cmp_algo:      %u               (%s)
         // cmp_parm:      %"PRId16"              %s(%s)
+        // dict_off:      0x%10.10"PRIX64"    (%u bytes, %s)
 
         WRMSG( HHC03024, "I"
             , (U32) cdevhdr.cdh_vrm[0], (U32) cdevhdr.cdh_vrm[1], (U32) cdevhdr.cdh_vrm[2]
@@ -778,13 +783,19 @@ U16             devtype;                /* Device type (e.g. 0x3390) */
                                          cdevhdr.cdh_nullfmt == CKD_NULLTRK_FMT2 ? "linux" : "???"
             , (U32) cdevhdr.cmp_algo,   !cdevhdr.cmp_algo                        ? "none"  :
                                         (cdevhdr.cmp_algo & CCKD_COMPRESS_ZLIB)  ? "zlib"  :
-                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_BZIP2) ? "bzip2" : "INVALID"
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_BZIP2) ? "bzip2" :
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_ZSTD)  ? "zstd"  :
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_LZ4)   ? "lz4"   : "INVALID"
             , cdevhdr.cmp_parm
             , cdevhdr.cmp_parm <  0 ? ""        : " "
             , cdevhdr.cmp_parm <  0 ? "default" :
               cdevhdr.cmp_parm == 0 ? "none"    :
               cdevhdr.cmp_parm <= 3 ? "low"     :
               cdevhdr.cmp_parm <= 6 ? "medium"  : "high"
+            , cdevhdr.dict_off, cdevhdr.dict_len,
+                                        !cdevhdr.dict_len                         ? "none"  :
+                                        cdevhdr.dict_algo == CCKD_COMPRESS_ZLIB   ? "zlib"  :
+                                        cdevhdr.dict_algo == CCKD_COMPRESS_ZSTD   ? "zstd"  : "INVALID"
         );
     }
     else
@@ -804,6 +815,7 @@ U16             devtype;                /* Device type (e.g. 0x3390) */
         // cdh_nullfmt:   %u               (%s)
         // cmp_algo:      %u               (%s)
         // cmp_parm:      %"PRId16"              %s(%s)
+        // dict_off:      0x%10.10"PRIX64"    (%u bytes, %s)
 
         WRMSG( HHC03023, "I"
             , (U32) cdevhdr.cdh_vrm[0], (U32) cdevhdr.cdh_vrm[1], (U32) cdevhdr.cdh_vrm[2]
@@ -823,13 +835,19 @@ U16             devtype;                /* Device type (e.g. 0x3390) */
                                          cdevhdr.cdh_nullfmt == CKD_NULLTRK_FMT2 ? "linux" : "???"
             , (U32) cdevhdr.cmp_algo,   !cdevhdr.cmp_algo                        ? "none"  :
                                         (cdevhdr.cmp_algo & CCKD_COMPRESS_ZLIB)  ? "zlib"  :
-                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_BZIP2) ? "bzip2" : "INVALID"
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_BZIP2) ? "bzip2" :
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_ZSTD)  ? "zstd"  :
+                                        (cdevhdr.cmp_algo & CCKD_COMPRESS_LZ4)   ? "lz4"   : "INVALID"
             , cdevhdr.cmp_parm
             , cdevhdr.cmp_parm <  0 ? ""        : " "
             , cdevhdr.cmp_parm <  0 ? "default" :
               cdevhdr.cmp_parm == 0 ? "none"    :
               cdevhdr.cmp_parm <= 3 ? "low"     :
               cdevhdr.cmp_parm <= 6 ? "medium"  : "high"
+            , cdevhdr.dict_off, cdevhdr.dict_len,
+                                        !cdevhdr.dict_len                         ? "none"  :
+                                        cdevhdr.dict_algo == CCKD_COMPRESS_ZLIB   ? "zlib"  :
+                                        cdevhdr.dict_algo == CCKD_COMPRESS_ZSTD   ? "zstd"  : "INVALID"
         );
     }
 
@@ -19,6 +19,7 @@
 #include "hercules.h"
 #include "opcode.h"
 #include "dasdblks.h"
+#include "cckddasd.h"
 #include "ccwarn.h"
 
 /*-------------------------------------------------------------------*/
@@ -40,9 +41,15 @@ DLL_EXPORT const char* comp_to_str( BYTE comp )
 {
     static const char* comp_types[] =
     {
-        "none",
-        "zlib",
-        "bzip2"
+        "none",             //  CCKD_COMPRESS_NONE    0x00
+        "zlib",             //  CCKD_COMPRESS_ZLIB    0x01
+        "bzip2",            //  CCKD_COMPRESS_BZIP2   0x02
+        "?????",
+        "zstd",             //  CCKD_COMPRESS_ZSTD    0x04
+        "?????",
+        "?????",
+        "?????",
+        "lz4"               //  CCKD_COMPRESS_LZ4     0x08
     };
 
     return (comp < _countof( comp_types )) ?
@@ -69,6 +76,7 @@ DLL_EXPORT const char* spc_typ_to_str( BYTE spc_typ )
         "L2UPPER",          //  SPCTAB_L2UPPER   10
         "data",             //  SPCTAB_DATA      11
         "unknown",          //  SPCTAB_DATA      12
+        "dict",             //  SPCTAB_DICT      13
     };
 
     return (spc_typ < _countof( spc_types )) ?
@@ -353,6 +361,8 @@ DLL_EXPORT void cckd_swapend_chdr( CCKD_DEVHDR* cdevhdr )
     cdevhdr->free_num     = SWAP32( cdevhdr->free_num     );
     cdevhdr->free_imbed   = SWAP32( cdevhdr->free_imbed   );
     cdevhdr->cmp_parm     = SWAP16( cdevhdr->cmp_parm     );
+    cdevhdr->dict_off     = SWAP32( cdevhdr->dict_off     );
+    cdevhdr->dict_len     = SWAP32( cdevhdr->dict_len     );
 }
 
 /*-------------------------------------------------------------------*/
@@ -534,7 +544,7 @@ comp_restart:
     /*---------------------------------------------------------------
      * Build the space table
      *---------------------------------------------------------------*/
-    n = 1 + 1 + 1 + cdevhdr.num_L1tab + 1;
+    n = 1 + 1 + 1 + cdevhdr.num_L1tab + 1 + 1;
     for (i = 0; i < cdevhdr.num_L1tab; i++)
         if (l1[i] != CCKD_NOSIZE && l1[i] != CCKD_MAXSIZE)
             n += 256;
@@ -566,6 +576,15 @@ comp_restart:
     spctab[s].spc_len =
     spctab[s].spc_siz = 0;
     s++;
+    if (cdevhdr.dict_len)
+    {
+        spctab[s].spc_typ = SPCTAB_DICT;
+        spctab[s].spc_val = -1;
+        spctab[s].spc_off = cdevhdr.dict_off;
+        spctab[s].spc_len =
+        spctab[s].spc_siz = cdevhdr.dict_len;
+        s++;
+    }
 
     for (i = 0; i < cdevhdr.num_L1tab; i++)
         if (l1[i] != CCKD_NOSIZE && l1[i] != CCKD_MAXSIZE)
@@ -661,9 +680,10 @@ comp_restart:
     /* file will be updated */
     cdevhdr.cdh_opts |= CCKD_OPT_OPENRW;
 
-    /* calculate track size within the l2 area */
+    /* calculate track (and dictionary) size within the l2 area */
     for (i = rlen = 0; spctab[i].spc_off < l2area; i++)
-        if (spctab[i].spc_typ == SPCTAB_TRK)
+        if (spctab[i].spc_typ == SPCTAB_TRK
+         || spctab[i].spc_typ == SPCTAB_DICT)
             rlen += sizeof(spctab[i].spc_val) + sizeof(spctab[i].spc_len)
                  +  spctab[i].spc_len;
 
@@ -674,7 +694,8 @@ comp_restart:
             goto comp_malloc_error;
         for (i = 0, p = rbuf; spctab[i].spc_off < l2area; i++)
         {
-            if (spctab[i].spc_typ != SPCTAB_TRK) continue;
+            if (spctab[i].spc_typ != SPCTAB_TRK
+             && spctab[i].spc_typ != SPCTAB_DICT) continue;
             memcpy (p, &spctab[i].spc_val, sizeof(spctab[i].spc_val));
             p += sizeof(spctab[i].spc_val);
             memcpy (p, &spctab[i].spc_len, sizeof(spctab[i].spc_len));
@@ -775,10 +796,11 @@ comp_restart:
     p = rbuf;
     while (rlen)
     {
-        spctab[s].spc_typ = SPCTAB_TRK;
         spctab[s].spc_off = (U32)off;
         memcpy (&spctab[s].spc_val, p, sizeof(spctab[s].spc_val));
         p += sizeof(spctab[s].spc_val);
+        /* the dictionary is the only relocated space without a track */
+        spctab[s].spc_typ = spctab[s].spc_val < 0 ? SPCTAB_DICT : SPCTAB_TRK;
         memcpy (&spctab[s].spc_len, p, sizeof(spctab[s].spc_len));
         spctab[s].spc_siz = spctab[s].spc_len;
         p += sizeof(spctab[s].spc_len);
@@ -834,6 +856,8 @@ comp_restart:
             l2[l][j].L2_len  =
             l2[l][j].L2_size = spctab[i].spc_len;
         }
+        else if (spctab[i].spc_typ == SPCTAB_DICT)
+            cdevhdr.dict_off = spctab[i].spc_off;
 
     /*---------------------------------------------------------------
      * Write the cdevhdr, l1 table and l2 tables
@@ -1000,6 +1024,501 @@ const SPCTAB *x = a, *y = b;
     else                                return +1;
 }
 
+/*-------------------------------------------------------------------
+ * Uncompress an image for cckd_recomp()
+ *
+ * `dict' is the file's existing dictionary (its dict_buf is NULL if
+ * there isn't one).  Returns the uncompressed length or -1.
+ *-------------------------------------------------------------------*/
+static int recomp_uncompress (DEVBLK *dev, CCKD_DICT *dict, BYTE **ubufp,
+                      BYTE *ubuf, BYTE *buf, int len)
+{
+U32             id;                     /* Dictionary id             */
+
+    *ubufp = ubuf;
+    if ((id = cckd_dict_id (buf[0], buf, len)) != 0)
+    {
+        if (dict->dict_buf == NULL || dict->dict_algo != buf[0]
+         || dict->dict_id != id)
+            return -1;
+        return cckd_dict_uncompress (dict, ubuf, buf, len, 65536);
+    }
+
+    switch (buf[0])
+    {
+    case CCKD_COMPRESS_NONE:
+        *ubufp = buf;
+        return len;
+    case CCKD_COMPRESS_ZLIB:
+        return cckd_uncompress_zlib  (dev, ubuf, buf, len, 65536);
+    case CCKD_COMPRESS_BZIP2:
+        return cckd_uncompress_bzip2 (dev, ubuf, buf, len, 65536);
+    case CCKD_COMPRESS_ZSTD:
+        return cckd_uncompress_zstd  (dev, ubuf, buf, len, 65536);
+    case CCKD_COMPRESS_LZ4:
+        return cckd_uncompress_lz4   (dev, ubuf, buf, len, 65536);
+    default:
+        return -1;
+    }
+}
+
+/*-------------------------------------------------------------------
+ * Recompress all track images in a compressed ckd file
+ *
+ * Each image is uncompressed and compressed again using `comp' and
+ * `parm'.  Images that change are appended to the end of the file
+ * and their l2 entries updated; the space held by the old images is
+ * released by calling cckd_comp() afterwards.  Images already using
+ * `comp' are skipped unless a specific `parm' is requested.
+ *
+ * If `train' is set, a dictionary is first trained from a sample of
+ * the images and every image is compressed with it; the dictionary
+ * is appended to the file and referenced from the device header.
+ * Otherwise any existing dictionary is dropped and its images are
+ * compressed without one.
+ *-------------------------------------------------------------------*/
+DLL_EXPORT int cckd_recomp (DEVBLK *dev, int comp, int parm, int train)
+{
+CCKD_EXT       *cckd;                   /* -> cckd extension         */
+int             fd;                     /* File descriptor           */
+struct stat     fst;                    /* File status buffer        */
+int             rc;                     /* Return code               */
+off_t           off;                    /* File offset               */
+off_t           eof;                    /* Offset of next new image  */
+int             len;                    /* Length                    */
+int             i, j;                   /* Work variables            */
+int             n = 0;                  /* Images recompressed       */
+int             full = 0;               /* 1=file size limit reached */
+int             l2upd;                  /* 1=l2 table was updated    */
+U64             oldlen = 0;             /* Total old image lengths   */
+U64             newlen = 0;             /* Total new image lengths   */
+CKD_DEVHDR      devhdr;                 /* CKD device header         */
+CCKD_DEVHDR     cdevhdr;                /* CCKD device header        */
+CCKD_L1ENT     *l1=NULL;                /* ->L1tab table             */
+CCKD_L2ENT      l2[256];                /* L2tab table               */
+BYTE           *ubufp;                  /* -> uncompressed image     */
+BYTE           *cbufp;                  /* -> recompressed image     */
+int             ulen, clen;             /* Image lengths             */
+BYTE            buf[65536];             /* Image buffer              */
+BYTE            ubuf[65536];            /* Uncompressed image        */
+BYTE            cbuf[65536];            /* Recompressed image        */
+CCKD_DICT       odict;                  /* Existing dictionary       */
+CCKD_DICT       ndict;                  /* Trained dictionary        */
+BYTE           *dbuf=NULL;              /* Dictionary buffer         */
+int             dlen = 0;               /* Dictionary length         */
+BYTE           *samples=NULL;           /* Training samples          */
+size_t          sizes[CCKD_DICT_NSAMPLES]; /* Sample lengths         */
+int             ns = 0;                 /* Number of samples         */
+int             nimg = 0;               /* Number of images          */
+int             seq;                    /* Image sequence number     */
+int             pass;                   /* Sampling pass             */
+U32             id;                     /* Image dictionary id       */
+char            sfx[64];                /* Message suffix            */
+
+    if (dev->cckd64)
+        return cckd64_recomp( dev, comp, parm, train );
+
+    memset (&odict, 0, sizeof(odict));
+    memset (&ndict, 0, sizeof(ndict));
+
+    /*---------------------------------------------------------------
+     * Get fd
+     *---------------------------------------------------------------*/
+    cckd = dev->cckd_ext;
+    if (cckd == NULL)
+        fd = dev->fd;
+    else
+        fd = cckd->fd[cckd->sfn];
+
+    /*---------------------------------------------------------------
+     * Read device header
+     *---------------------------------------------------------------*/
+    off = 0;
+    if (lseek( fd, off, SEEK_SET ) < 0)
+        goto recomp_lseek_error;
+    len = CKD_DEVHDR_SIZE;
+    if ((rc = read( fd, &devhdr, len )) != len)
+        goto recomp_read_error;
+
+    dev->cckd64 = 0;
+    if (!(dh_devid_typ( devhdr.dh_devid ) & ANY32_CMP_OR_SF_TYP))
+    {
+        if (dh_devid_typ( devhdr.dh_devid ) & ANY64_CMP_OR_SF_TYP)
+        {
+            dev->cckd64 = 1;
+            return cckd64_recomp( dev, comp, parm, train );
+        }
+
+        // "%1d:%04X CCKD file %s: not a compressed dasd file"
+        if (dev->batch)
+            FWRMSG( stdout, HHC00356, "E", SSID_TO_LCSS( dev->ssid ),
+                dev->devnum, dev->filename );
+        else
+            WRMSG( HHC00356, "E", LCSS_DEVNUM, dev->filename );
+        goto recomp_error;
+    }
+
+recomp_restart:
+
+    /*---------------------------------------------------------------
+     * Read compressed device header
+     *---------------------------------------------------------------*/
+    off = CCKD_DEVHDR_POS;
+    if (lseek (fd, off, SEEK_SET) < 0)
+        goto recomp_lseek_error;
+    len = CCKD_DEVHDR_SIZE;
+    if ((rc = read (fd, &cdevhdr, len)) != len)
+        goto recomp_read_error;
+
+    /*---------------------------------------------------------------
+     * Check the endianness of the file
+     *---------------------------------------------------------------*/
+    if ((cdevhdr.cdh_opts & CCKD_OPT_BIGEND) != cckd_def_opt_bigend())
+    {
+        if(dev->batch)
+            // "%1d:%04X CCKD file %s: converting to %s"
+            FWRMSG( stdout, HHC00357, "I", LCSS_DEVNUM, dev->filename,
+                    (cdevhdr.cdh_opts & CCKD_OPT_BIGEND) ?
+                        "little-endian" : "big-endian" );
+        else
+            // "%1d:%04X CCKD file %s: converting to %s"
+            WRMSG( HHC00357, "I", LCSS_DEVNUM, dev->filename,
+                   (cdevhdr.cdh_opts & CCKD_OPT_BIGEND) ?
+                    "little-endian" : "big-endian" );
+
+        if (cckd_swapend (dev) < 0)
+            goto recomp_error;
+        else
+            goto recomp_restart;
+    }
+
+    /*---------------------------------------------------------------
+     * Read the l1 table
+     *---------------------------------------------------------------*/
+    len = cdevhdr.num_L1tab * CCKD_L1ENT_SIZE;
+    if ((l1 = malloc (len)) == NULL)
+        goto recomp_malloc_error;
+    off = CCKD_L1TAB_POS;
+    if (lseek (fd, off, SEEK_SET) < 0)
+        goto recomp_lseek_error;
+    if ((rc = read (fd, l1, len)) != len)
+        goto recomp_read_error;
+
+    /* New images are appended to the end of the file */
+    if (fstat (fd, &fst) < 0)
+        goto recomp_fstat_error;
+    eof = fst.st_size;
+
+    /*---------------------------------------------------------------
+     * Load the existing dictionary to uncompress images that use it
+     *---------------------------------------------------------------*/
+    if (cdevhdr.dict_len)
+    {
+        len = (int)cdevhdr.dict_len;
+        if ((dbuf = malloc (len)) == NULL)
+            goto recomp_malloc_error;
+        off = cdevhdr.dict_off;
+        if (lseek (fd, off, SEEK_SET) < 0)
+            goto recomp_lseek_error;
+        if ((rc = read (fd, dbuf, len)) != len)
+            goto recomp_read_error;
+        if (cckd_dict_init (&odict, dbuf, len, cdevhdr.dict_algo,
+                            cdevhdr.cmp_parm) < 0)
+            free (dbuf);
+        dbuf = NULL;
+    }
+
+    /*---------------------------------------------------------------
+     * Train a new dictionary from a sample of the images
+     *---------------------------------------------------------------*/
+    if (train && (comp == CCKD_COMPRESS_ZLIB || comp == CCKD_COMPRESS_ZSTD))
+    {
+        len = CCKD_DICT_NSAMPLES * 65536;
+        if ((samples = malloc (len)) == NULL)
+            goto recomp_malloc_error;
+        len = CCKD_DICT_MAXSIZE;
+        if ((dbuf = malloc (len)) == NULL)
+            goto recomp_malloc_error;
+
+        /* Pass 1 counts the images, pass 2 takes every n'th one */
+        for (pass = 0; pass < 2; pass++)
+        {
+            for (i = 0, seq = 0; i < cdevhdr.num_L1tab && ns < CCKD_DICT_NSAMPLES; i++)
+            {
+                if (l1[i] == CCKD_NOSIZE || l1[i] == CCKD_MAXSIZE)
+                    continue;
+
+                off = (off_t)l1[i];
+                if (lseek (fd, off, SEEK_SET) < 0)
+                    goto recomp_lseek_error;
+                len = CCKD_L2TAB_SIZE;
+                if ((rc = read (fd, l2, len)) != len)
+                    goto recomp_read_error;
+
+                for (j = 0; j < 256 && ns < CCKD_DICT_NSAMPLES; j++)
+                {
+                    if (l2[j].L2_trkoff == CCKD_NOSIZE || l2[j].L2_trkoff == CCKD_MAXSIZE)
+                        continue;
+                    if (pass == 0 || seq++ % (nimg / CCKD_DICT_NSAMPLES + 1))
+                    {
+                        nimg += pass == 0;
+                        continue;
+                    }
+
+                    off = (off_t)l2[j].L2_trkoff;
+                    if (lseek (fd, off, SEEK_SET) < 0)
+                        goto recomp_lseek_error;
+                    len = l2[j].L2_len;
+                    if ((rc = read (fd, buf, len)) != len)
+                        goto recomp_read_error;
+
+                    ulen = recomp_uncompress (dev, &odict, &ubufp, ubuf, buf, len);
+                    if (ulen <= CKD_TRKHDR_SIZE)
+                        continue;
+
+                    /* The track header isn't compressed; leave it out */
+                    memcpy (samples + ns * 65536, ubufp + CKD_TRKHDR_SIZE,
+                            ulen - CKD_TRKHDR_SIZE);
+                    sizes[ns++] = ulen - CKD_TRKHDR_SIZE;
+                }
+            }
+        }
+
+        /* Pack the samples and train */
+        for (i = 0, len = 0; i < ns; len += (int)sizes[i++])
+            memmove (samples + len, samples + i * 65536, sizes[i]);
+        dlen = ns ? cckd_dict_train (dbuf, CCKD_DICT_MAXSIZE, samples, sizes, ns, comp) : -1;
+        free (samples);
+        samples = NULL;
+
+        if (dlen <= 0 || cckd_dict_init (&ndict, dbuf, dlen, comp, parm) < 0)
+        {
+            free (dbuf);
+            dlen = 0;
+        }
+        dbuf = NULL;
+    }
+
+    /*---------------------------------------------------------------
+     * Recompress the images referenced by each l2 table
+     *---------------------------------------------------------------*/
+    for (i = 0; i < cdevhdr.num_L1tab && !full; i++)
+    {
+        if (l1[i] == CCKD_NOSIZE || l1[i] == CCKD_MAXSIZE)
+            continue;
+
+        off = (off_t)l1[i];
+        if (lseek (fd, off, SEEK_SET) < 0)
+            goto recomp_lseek_error;
+        len = CCKD_L2TAB_SIZE;
+        if ((rc = read (fd, l2, len)) != len)
+            goto recomp_read_error;
+
+        for (j = 0, l2upd = 0; j < 256; j++)
+        {
+            if (l2[j].L2_trkoff == CCKD_NOSIZE || l2[j].L2_trkoff == CCKD_MAXSIZE)
+                continue;
+
+            /* Read the image */
+            off = (off_t)l2[j].L2_trkoff;
+            if (lseek (fd, off, SEEK_SET) < 0)
+                goto recomp_lseek_error;
+            len = l2[j].L2_len;
+            if ((rc = read (fd, buf, len)) != len)
+                goto recomp_read_error;
+
+            if (buf[0] & ~CCKD_COMPRESS_MASK)
+                continue;
+
+            /* Images using a dictionary always move to the new one */
+            id = cckd_dict_id (buf[0], buf, len);
+            if (buf[0] == comp && parm < 0 && !ndict.dict_buf && !id)
+                continue;
+
+            /* Uncompress the image */
+            ulen = recomp_uncompress (dev, &odict, &ubufp, ubuf, buf, len);
+            if (ulen <= CKD_TRKHDR_SIZE)
+                continue;
+
+            /* Compress it again */
+            cbufp = cbuf;
+            clen = -1;
+            if (ndict.dict_buf && ulen >= CCKD_COMPRESS_MIN)
+                clen = cckd_dict_compress (&ndict, cbuf, ubufp, ulen, parm);
+            if (clen < 0 || clen >= ulen)
+            {
+                cbufp = cbuf;
+                clen = cckd_compress (dev, &cbufp, ubufp, ulen,
+                                      ulen < CCKD_COMPRESS_MIN ?
+                                      CCKD_COMPRESS_NONE : comp, parm);
+            }
+            if (clen == len && memcmp (cbufp, buf, len) == 0)
+                continue;
+
+            /* Stop if the file would become too large */
+            if ((U64)eof + clen + dlen >= (U64)CCKD_MAXSIZE)
+            {
+                full = 1;
+                break;
+            }
+
+            /* Append the new image */
+            off = eof;
+            if (lseek (fd, off, SEEK_SET) < 0)
+                goto recomp_lseek_error;
+            if ((rc = write (fd, cbufp, clen)) != clen)
+                goto recomp_write_error;
+
+            oldlen += l2[j].L2_len;
+            newlen += clen;
+            cdevhdr.cdh_used += clen - l2[j].L2_len;
+
+            l2[j].L2_trkoff = (U32)eof;
+            l2[j].L2_len    =
+            l2[j].L2_size   = (U16)clen;
+            eof += clen;
+            l2upd = 1;
+            n++;
+        } /* for each l2 entry */
+
+        /* Write the updated l2 table */
+        if (l2upd)
+        {
+            off = (off_t)l1[i];
+            if (lseek (fd, off, SEEK_SET) < 0)
+                goto recomp_lseek_error;
+            len = CCKD_L2TAB_SIZE;
+            if ((rc = write (fd, l2, len)) != len)
+                goto recomp_write_error;
+        }
+    } /* for each l1 entry */
+
+    /*---------------------------------------------------------------
+     * Append the new dictionary; the old one's space is released
+     * unless images that still need it were left behind
+     *---------------------------------------------------------------*/
+    sfx[0] = 0;
+    if (!full || ndict.dict_buf)
+    {
+        cdevhdr.cdh_used -= cdevhdr.dict_len;
+        cdevhdr.dict_off  = cdevhdr.dict_len = 0;
+        cdevhdr.dict_algo = 0;
+    }
+    if (ndict.dict_buf)
+    {
+        off = eof;
+        if (lseek (fd, off, SEEK_SET) < 0)
+            goto recomp_lseek_error;
+        if ((rc = write (fd, ndict.dict_buf, dlen)) != dlen)
+            goto recomp_write_error;
+        cdevhdr.dict_off  = (U32)eof;
+        cdevhdr.dict_len  = (U32)dlen;
+        cdevhdr.dict_algo = (BYTE)comp;
+        cdevhdr.cdh_used += dlen;
+        eof += dlen;
+        MSGBUF (sfx, ", %d byte dictionary", dlen);
+    }
+
+    /*---------------------------------------------------------------
+     * Update the device header
+     *---------------------------------------------------------------*/
+    cdevhdr.cdh_size  = (U32)eof;
+    cdevhdr.cmp_algo  = (BYTE)comp;
+    cdevhdr.cmp_parm  = (S16)parm;
+    cdevhdr.cdh_opts |= CCKD_OPT_OPENRW;
+    if (cdevhdr.dict_len)
+        cdevhdr.cdh_opts |=  CCKD_OPT_DICT;
+    else
+        cdevhdr.cdh_opts &= ~CCKD_OPT_DICT;
+
+    off = CCKD_DEVHDR_POS;
+    if (lseek (fd, off, SEEK_SET) < 0)
+        goto recomp_lseek_error;
+    len = CCKD_DEVHDR_SIZE;
+    if ((rc = write (fd, &cdevhdr, len)) != len)
+        goto recomp_write_error;
+
+    // "%1d:%04X CCKD file %s: %d images recompressed using %s, %"PRIu64" bytes now %"PRIu64"%s"
+    if (dev->batch)
+        FWRMSG( stdout, HHC00394, "I", LCSS_DEVNUM, dev->filename,
+                n, comp_to_str( comp ), oldlen, newlen,
+                full ? ", file size limit reached" : sfx );
+    else
+        WRMSG( HHC00394, "I", LCSS_DEVNUM, dev->filename,
+               n, comp_to_str( comp ), oldlen, newlen,
+               full ? ", file size limit reached" : sfx );
+
+    rc = 0;
+
+recomp_return:
+
+    cckd_dict_free (&odict);
+    cckd_dict_free (&ndict);
+    if (dbuf) free (dbuf);
+    if (samples) free (samples);
+    if (l1) free (l1);
+    return rc;
+
+    /*---------------------------------------------------------------
+     * Error exits
+     *---------------------------------------------------------------*/
+
+recomp_fstat_error:
+    if(dev->batch)
+        FWRMSG( stdout, HHC00354, "E", LCSS_DEVNUM, dev->filename,
+                "fstat()", strerror( errno ));
+    else
+        WRMSG( HHC00354, "E", LCSS_DEVNUM, dev->filename,
+              "fstat()", strerror( errno ));
+    goto recomp_error;
+
+recomp_lseek_error:
+    if(dev->batch)
+        FWRMSG( stdout, HHC00355, "E", LCSS_DEVNUM, dev->filename,
+                "lseek()", (U64)off, strerror( errno ));
+    else
+        WRMSG( HHC00355, "E", LCSS_DEVNUM, dev->filename,
+              "lseek()", (U64)off, strerror( errno ));
+    goto recomp_error;
+
+recomp_read_error:
+    if(dev->batch)
+        FWRMSG( stdout, HHC00355, "E", LCSS_DEVNUM, dev->filename,
+                "read()", (U64)off, rc < 0 ? strerror( errno ) : "incomplete");
+    else
+        WRMSG( HHC00355, "E", LCSS_DEVNUM, dev->filename,
+              "read()", (U64)off, rc < 0 ? strerror( errno ) : "incomplete");
+    goto recomp_error;
+
+recomp_write_error:
+    if(dev->batch)
+        FWRMSG( stdout, HHC00355, "E", LCSS_DEVNUM, dev->filename,
+                "write()", (U64)off, rc < 0 ? strerror( errno ) : "incomplete");
+    else
+        WRMSG( HHC00355, "E", LCSS_DEVNUM, dev->filename,
+              "write()", (U64)off, rc < 0 ? strerror( errno ) : "incomplete");
+    goto recomp_error;
+
+recomp_malloc_error:
+    {
+        char buf[64];
+        MSGBUF( buf, "malloc(%d)", len);
+        if(dev->batch)
+            FWRMSG( stdout, HHC00354, "E", LCSS_DEVNUM, dev->filename,
+                    buf, strerror( errno ));
+        else
+            WRMSG( HHC00354, "E", LCSS_DEVNUM, dev->filename,
+                  buf, strerror( errno ));
+        goto recomp_error;
+    }
+
+recomp_error:
+
+    rc = -1;
+    goto recomp_return;
+
+} /* cckd_recomp() */
+
 /*-------------------------------------------------------------------
  * Perform check function on a compressed ckd file
  *
@@ -1046,6 +1565,7 @@ int             ckddasd=0;              /* 1=ckd                     */
 int             fbadasd=0;              /* 1= fba                    */
 int             shadow=0;               /* 0xff=shadow file          */
 int             hdrerr=0;               /* non-zero: header errors   */
+BYTE            dictopt;                /* CCKD_OPT_DICT or zero     */
 int             fsperr=0;               /* 1=rebuild free space      */
 int             comperrs=0;             /* 1=unsupported comp found  */
 int             recovery=0;             /* 1=perform track recovery  */
@@ -1068,8 +1588,13 @@ CCKD_L2ENT    **l2=NULL;                /* -> level 2 table array    */
 CCKD_L2ENT      empty_l2[256];          /* Empty l2 table            */
 CCKD_FREEBLK    freeblk;                /* free block                */
 CCKD_FREEBLK   *fsp=NULL;               /* free blocks (new format)  */
+CCKD_DICT       cdict;                  /* compression dictionary    */
+CCKD_DICT      *dict=NULL;              /* -> dictionary if loaded   */
+BYTE           *dbuf;                   /* dictionary buffer         */
 BYTE            buf[4*65536];           /* buffer                    */
 
+    memset (&cdict, 0, sizeof(cdict));
+
     /* Get fd */
     cckd = dev->cckd_ext;
     if (cckd == NULL)
@@ -1099,6 +1624,16 @@ BYTE            buf[4*65536];           /* buffer                    */
 #else
     compmask[CCKD_COMPRESS_BZIP2] = 2;
 #endif
+#if defined( CCKD_ZSTD )
+    compmask[CCKD_COMPRESS_ZSTD] = 0;
+#else
+    compmask[CCKD_COMPRESS_ZSTD] = 4;
+#endif
+#if defined( CCKD_LZ4 )
+    compmask[CCKD_COMPRESS_LZ4] = 0;
+#else
+    compmask[CCKD_COMPRESS_LZ4] = 8;
+#endif
 
     /*---------------------------------------------------------------
      * Header checks
@@ -1150,6 +1685,23 @@ BYTE            buf[4*65536];           /* buffer                    */
     if ((rc = read (fd, &cdevhdr, len)) != len)
         goto cdsk_read_error;
 
+    /* Options check; a newer level's options may mean file
+       contents this level would misread or reclaim */
+    if (cdevhdr.cdh_opts & ~CCKD_OPT_KNOWN)
+    {
+        if(dev->batch)
+            // "%1d:%04X CCKD file %s: bad %s %"PRId64", expecting %"PRId64
+            FWRMSG( stdout, HHC00362, "E", LCSS_DEVNUM, dev->filename,
+                    "options", (S64)cdevhdr.cdh_opts,
+                    (S64)(cdevhdr.cdh_opts & CCKD_OPT_KNOWN) );
+        else
+            // "%1d:%04X CCKD file %s: bad %s %"PRId64", expecting %"PRId64
+            WRMSG( HHC00362, "E", LCSS_DEVNUM, dev->filename,
+                   "options", (S64)cdevhdr.cdh_opts,
+                   (S64)(cdevhdr.cdh_opts & CCKD_OPT_KNOWN) );
+        goto cdsk_error;
+    }
+
     /* Endianess check */
     if ((cdevhdr.cdh_opts & CCKD_OPT_BIGEND) != cckd_def_opt_bigend())
     {
@@ -1313,6 +1865,7 @@ BYTE            buf[4*65536];           /* buffer                    */
     hdrerr |= cdevhdr.free_num == 0 && cdevhdr.free_total  != cdevhdr.free_imbed             ? 0x0080 : 0;
     hdrerr |= cdevhdr.free_num != 0 && cdevhdr.free_total  <= cdevhdr.free_imbed             ? 0x0100 : 0;
     hdrerr |= cdevhdr.free_imbed    >  cdevhdr.free_total                                    ? 0x0200 : 0;
+    hdrerr |= !cdevhdr.dict_len    != !(cdevhdr.cdh_opts & CCKD_OPT_DICT)                    ? 0x0400 : 0;
 
     /* Additional checking if header errors */
     if (hdrerr != 0)
@@ -1391,6 +1944,7 @@ BYTE            buf[4*65536];           /* buffer                    */
       + n                            // l2tabs
       + (n * 256)                    // trk/blk images
       + (1 + n + (n * 256) + 1)      // max possible free spaces
+      + 1                            // dictionary
       + 1;                           // end-of-file
 
     /* obtain the space table */
@@ -1434,6 +1988,30 @@ BYTE            buf[4*65536];           /* buffer                    */
         spctab[s].spc_siz = CCKD_L2TAB_SIZE;
         s++;
     }
+    /* dictionary */
+    if (cdevhdr.dict_len)
+    {
+        spctab[s].spc_typ = SPCTAB_DICT;
+        spctab[s].spc_val = -1;
+        spctab[s].spc_off = cdevhdr.dict_off;
+        spctab[s].spc_len =
+        spctab[s].spc_siz = cdevhdr.dict_len;
+        s++;
+
+        /* Load it; images that need it won't validate without it */
+        if (cdevhdr.dict_len <= CCKD_DICT_MAXSIZE
+         && (off_t)cdevhdr.dict_off + cdevhdr.dict_len <= fst.st_size
+         && (dbuf = malloc (cdevhdr.dict_len)) != NULL)
+        {
+            if (lseek (fd, (off_t)cdevhdr.dict_off, SEEK_SET) >= 0
+             && read (fd, dbuf, cdevhdr.dict_len) == (int)cdevhdr.dict_len
+             && cckd_dict_init (&cdict, dbuf, cdevhdr.dict_len,
+                                cdevhdr.dict_algo, cdevhdr.cmp_parm) == 0)
+                dict = &cdict;
+            else
+                free (dbuf);
+        }
+    }
     /* end-of-file */
     spctab[s].spc_typ = SPCTAB_EOF;
     spctab[s].spc_val = -1;
@@ -1619,6 +2197,8 @@ BYTE            buf[4*65536];           /* buffer                    */
             }
             else if (spctab[i].spc_typ == trktyp)
                 rcvtab[spctab[i].spc_val] = 1;
+            else if (spctab[i].spc_typ == SPCTAB_DICT)
+                spctab[i].spc_val = -2;
 
             if (spctab[i+1].spc_typ == SPCTAB_L2 && valid)
             {
@@ -1627,6 +2207,8 @@ BYTE            buf[4*65536];           /* buffer                    */
             }
             else if (spctab[i+1].spc_typ == trktyp && valid)
                 rcvtab[spctab[i+1].spc_val] = 1;
+            else if (spctab[i+1].spc_typ == SPCTAB_DICT && valid)
+                spctab[i+1].spc_val = -2;
 
         } /* if overlap or out of bounds */
 
@@ -1658,6 +2240,15 @@ BYTE            buf[4*65536];           /* buffer                    */
         if ((spctab[i].spc_typ == SPCTAB_L2 && l2errs[spctab[i].spc_val])
          || (spctab[i].spc_typ == trktyp    && rcvtab[spctab[i].spc_val]))
             spctab[i].spc_typ = SPCTAB_NONE;
+        else if (spctab[i].spc_typ == SPCTAB_DICT && spctab[i].spc_val == -2)
+        {
+            /* a damaged dictionary is dropped with its images */
+            spctab[i].spc_typ = SPCTAB_NONE;
+            cckd_dict_free (&cdict);
+            dict = NULL;
+            cdevhdr.dict_off  = cdevhdr.dict_len = 0;
+            cdevhdr.dict_algo = 0;
+        }
 
     /* overlaps are serious */
     if (recovery && level < 3)
@@ -1855,7 +2446,7 @@ cdsk_space_check:
             /* Validate the space if check level 3 */
             if (level > 2)
             {
-                if (!cdsk_valid_trk (trk, buf, heads, len))
+                if (!cdsk_valid_trk (trk, buf, heads, len, dict))
                 {
                     if(dev->batch)
                         // "%1d:%04X CCKD file %s: %s[%d] offset 0x%16.16"PRIX64" len %"PRId64" validation error"
@@ -1973,6 +2564,11 @@ cdsk_recovery:
                     else if (comp == CCKD_COMPRESS_BZIP2
                      && (buf[i+5] != 'B' || buf[i+6] != 'Z'))
                         continue;
+
+                    /* Quick validation for zstd */
+                    else if (comp == CCKD_COMPRESS_ZSTD
+                     && fetch_fw(buf + i + 5) != 0x28B52FFD)
+                        continue;
                     /*
                      * If we are in `borrowed space' then start over
                      * with the current position at the beginning
@@ -1984,7 +2580,7 @@ cdsk_recovery:
                     if (comp == CCKD_COMPRESS_NONE)
                     {
                         l = len - i;
-                        if ((l = cdsk_valid_trk (trk, buf+i, heads, -l)))
+                        if ((l = cdsk_valid_trk (trk, buf+i, heads, -l, dict)))
                             goto cdsk_ckd_recover;
                         else
                              continue;
@@ -1993,9 +2589,9 @@ cdsk_recovery:
                     /* Check short `length' */
                     if (flen == (U32)len && (l = len - i) <= 1024)
                     {
-                        if (cdsk_valid_trk (trk, buf+i, heads, l))
+                        if (cdsk_valid_trk (trk, buf+i, heads, l, dict))
                         {
-                            while (cdsk_valid_trk (trk, buf+i, heads, --l));
+                            while (cdsk_valid_trk (trk, buf+i, heads, --l, dict));
                             l++;
                             goto cdsk_ckd_recover;
                         }
@@ -2028,13 +2624,17 @@ cdsk_recovery:
                         else if (buf[j] == CCKD_COMPRESS_BZIP2
                          && (buf[j+5] != 'B' || buf[j+6] != 'Z'))
                                 continue;
+                        /* check zstd compressed header */
+                        else if (buf[j] == CCKD_COMPRESS_ZSTD
+                         && fetch_fw(buf + j + 5) != 0x28B52FFD)
+                                continue;
 
                         /* check to possible trkhdr */
                         l = j - i;
-                        if (cdsk_valid_trk (trk, buf+i, heads, l))
+                        if (cdsk_valid_trk (trk, buf+i, heads, l, dict))
                         {
 #if 0
-                            while (cdsk_valid_trk (trk, buf+i, heads, --l));
+                            while (cdsk_valid_trk (trk, buf+i, heads, --l, dict));
                             l++;
 #endif
                             goto cdsk_ckd_recover;
@@ -2045,9 +2645,9 @@ cdsk_recovery:
                     /* Check `length' */
                     if (flen == (U32)len && (l = len - i) <= (int)trksz)
                     {
-                        if (cdsk_valid_trk (trk, buf+i, heads, l))
+                        if (cdsk_valid_trk (trk, buf+i, heads, l, dict))
                         {
-                            while (cdsk_valid_trk (trk, buf+i, heads, --l));
+                            while (cdsk_valid_trk (trk, buf+i, heads, --l, dict));
                             l++;
                             goto cdsk_ckd_recover;
                         }
@@ -2058,7 +2658,7 @@ cdsk_recovery:
                     {
                         if (l > (int)trksz)
                             break;
-                        if (cdsk_valid_trk (trk, buf+i, heads, l))
+                        if (cdsk_valid_trk (trk, buf+i, heads, l, dict))
                             goto cdsk_ckd_recover;
                     } /* for all lengths */
 
@@ -2197,6 +2797,11 @@ cdsk_ckd_recover:
                     else if (comp == CCKD_COMPRESS_BZIP2
                      && (buf[i+5] != 'B' || buf[i+6] != 'Z'))
                         continue;
+
+                    /* Quick validation for zstd */
+                    else if (comp == CCKD_COMPRESS_ZSTD
+                     && fetch_fw(buf + i + 5) != 0x28B52FFD)
+                        continue;
                     /*
                      * If we are in `borrowed space' then start over
                      * with the current position at the beginning
@@ -2229,9 +2834,9 @@ cdsk_ckd_recover:
                     /* Check short `length' */
                     if (flen == (U32)len && (l = len - i) <= 1024)
                     {
-                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l))
+                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l, dict))
                         {
-                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l));
+                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l, dict));
                             l++;
                             goto cdsk_fba_recover;
                         }
@@ -2257,13 +2862,17 @@ cdsk_ckd_recover:
                         else if (buf[j] == CCKD_COMPRESS_BZIP2
                          && (buf[j+5] != 'B' || buf[j+6] != 'Z'))
                                 continue;
+                        /* check zstd compressed header */
+                        else if (buf[j] == CCKD_COMPRESS_ZSTD
+                         && fetch_fw(buf + j + 5) != 0x28B52FFD)
+                                continue;
 
                         /* check to possible trkhdr */
                         l = j - i;
-                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l))
+                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l, dict))
                         {
 #if 0
-                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l));
+                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l, dict));
                             l++;
 #endif
                             goto cdsk_fba_recover;
@@ -2275,9 +2884,9 @@ cdsk_ckd_recover:
                     l = len - i;
                     if (flen == (U32)len && l <= (int)blkgrpsz)
                     {
-                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l))
+                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l, dict))
                         {
-                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l));
+                            while (cdsk_valid_trk (blkgrp, buf+i, heads, --l, dict));
                             l++;
                             goto cdsk_fba_recover;
                         }
@@ -2288,7 +2897,7 @@ cdsk_ckd_recover:
                     {
                         if (l > (int)blkgrpsz)
                             break;
-                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l))
+                        if (cdsk_valid_trk (blkgrp, buf+i, heads, l, dict))
                             goto cdsk_fba_recover;
                     } /* for all lengths */
 
@@ -2759,9 +3368,14 @@ cdsk_return_ok:
 
     rc = recovery ? 2 : fsperr ? 1 : 0;
 
-    if (!ro && (cdevhdr.cdh_opts & (CCKD_OPT_OPENRW | CCKD_OPT_OPENED | CCKD_OPT_SPERRS)))
+    /* The dictionary option follows the dictionary */
+    dictopt = cdevhdr.dict_len ? CCKD_OPT_DICT : 0;
+
+    if (!ro && ((cdevhdr.cdh_opts & (CCKD_OPT_OPENRW | CCKD_OPT_OPENED | CCKD_OPT_SPERRS))
+             || (cdevhdr.cdh_opts & CCKD_OPT_DICT) != dictopt))
     {
-        cdevhdr.cdh_opts &= ~(CCKD_OPT_OPENED | CCKD_OPT_SPERRS);
+        cdevhdr.cdh_opts &= ~(CCKD_OPT_OPENED | CCKD_OPT_SPERRS | CCKD_OPT_DICT);
+        cdevhdr.cdh_opts |= dictopt;
 
         /* Set version.release.modlvl */
         cdevhdr.cdh_vrm[0] = CCKD_VERSION;
@@ -2779,6 +3393,7 @@ cdsk_return:
     gui_fprintf (stderr, "POS=%"PRIu64"\n", (U64) lseek( fd, 0, SEEK_CUR ));
 
     /* free all space */
+    cckd_dict_free (&cdict);
     if (l1)     free (l1);
     if (spctab) free (spctab);
     if (l2errs) free (l2errs);
@@ -2912,8 +3527,9 @@ int i;
 /* If 'len' is negative and compression is CCKD_COMPRESS_NONE then   */
 /* 'len' indicates a buffer size containing the track image and the  */
 /* value returned is the actual track length. Returns 0 on error.    */
+/* 'dict' is the file's compression dictionary, or NULL if none.     */
 /*-------------------------------------------------------------------*/
-int cdsk_valid_trk( int trk, BYTE* buf, int heads, int len )
+int cdsk_valid_trk( int trk, BYTE* buf, int heads, int len, CCKD_DICT* dict )
 {
 CKD_TRKHDR      ha;                     /* Home Address              */
 CKD_RECHDR      rn;                     /* Record-n (r0, r1 ... rn)  */
@@ -2928,8 +3544,13 @@ uLongf          zlen;
 #if defined( CCKD_BZIP2 )
 unsigned int    bz2len;
 #endif
-#if defined( HAVE_ZLIB ) || defined( CCKD_BZIP2 )
+#if defined( CCKD_ZSTD )
+size_t          zslen;
+#endif
+#if defined( HAVE_ZLIB ) || defined( CCKD_BZIP2 ) || defined( CCKD_LZ4 )
 int             rc;                     /* Return code               */
+#endif
+#if defined( HAVE_ZLIB ) || defined( CCKD_BZIP2 ) || defined( CCKD_ZSTD ) || defined( CCKD_LZ4 )
 BYTE            buf2[64*1024];          /* Uncompressed buffer       */
 #endif
 
@@ -2943,6 +3564,23 @@ BYTE            buf2[64*1024];          /* Uncompressed buffer       */
     memcpy( &ha, buf, CKD_TRKHDR_SIZE );
     cmp = ha.bin;
 
+#if defined( HAVE_ZLIB ) || defined( CCKD_ZSTD )
+    /* Images compressed with a dictionary need that dictionary */
+    if (len > 0 && (cmp == CCKD_COMPRESS_ZLIB || cmp == CCKD_COMPRESS_ZSTD)
+     && (i = (int) cckd_dict_id( cmp, buf, len )) != 0)
+    {
+        if (!dict || dict->dict_algo != cmp || dict->dict_id != (U32) i)
+            return 0; // (error: dictionary missing!)
+        bufp = (BYTE*) buf2;
+        if ((bufl = cckd_dict_uncompress( dict, buf2, buf, len,
+                                          (int) sizeof( buf2 ))) < 0)
+            return 0;
+    }
+    else
+#else
+    UNREFERENCED( dict );
+#endif
+
     /* Uncompress (inflate or expand) the track/block image... */
     switch (cmp) {
 
@@ -2977,6 +3615,31 @@ BYTE            buf2[64*1024];          /* Uncompressed buffer       */
         break;
 #endif
 
+#if defined( CCKD_ZSTD )
+    case CCKD_COMPRESS_ZSTD:
+        if (len < 0) return 0;
+        bufp = (BYTE*) buf2;
+        memcpy( buf2, &ha,      CKD_TRKHDR_SIZE );
+        zslen = ZSTD_decompress( buf2 + CKD_TRKHDR_SIZE, sizeof( buf2 ) - CKD_TRKHDR_SIZE,
+                                 buf  + CKD_TRKHDR_SIZE, len - CKD_TRKHDR_SIZE );
+        if (ZSTD_isError( zslen )) return 0;
+        bufl =     (int) zslen + CKD_TRKHDR_SIZE;
+        break;
+#endif
+
+#if defined( CCKD_LZ4 )
+    case CCKD_COMPRESS_LZ4:
+        if (len < 0) return 0;
+        bufp = (BYTE*) buf2;
+        memcpy( buf2, &ha,      CKD_TRKHDR_SIZE );
+        rc = LZ4_decompress_safe( (const char*) buf  + CKD_TRKHDR_SIZE,
+                                  (char*)       buf2 + CKD_TRKHDR_SIZE,
+                                  len - CKD_TRKHDR_SIZE,
+                                  (int) sizeof( buf2 ) - CKD_TRKHDR_SIZE ); if (rc < 0) return 0;
+        bufl =                rc + CKD_TRKHDR_SIZE;
+        break;
+#endif
+
     default:
         return 0; // (error: unsupported compression algorithm!)
 
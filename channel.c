@@ -111,6 +111,7 @@ static BYTE is_ch9oflow( DEVBLK* dev, BYTE chanstat, BYTE unitstat )
 /*-------------------------------------------------------------------*/
 void                call_execute_ccw_chain (int arch_mode, void* pDevBlk);
 DLL_EXPORT  void*   device_thread (void *arg);
+static bool         unlink_ioq (DEVBLK* dev);
 static int          schedule_ioq (const REGS* regs, DEVBLK* dev);
 static INLINE void  subchannel_interrupt_queue_cleanup (DEVBLK*);
 int                 test_subchan_locked (REGS*, DEVBLK*, IRB*, IOINT**, SCSW**);
@@ -331,6 +332,25 @@ typedef struct PREFETCH PREFETCH;
 
 #endif /* PREFETCH_STRUCT */
 
+/*--------------------------------------------------------------------*/
+/* Resolved IDAW list (scatter-gather vector) data structure          */
+/*--------------------------------------------------------------------*/
+#ifndef IDASEG_STRUCT
+#define IDASEG_STRUCT
+
+/* A CCW count of at most 64K-1 bytes can span no more than 34 IDAWs
+   with the smallest (2K) IDA page size */
+#define MAX_IDASEGS     ((65535 / 2048) + 2)
+
+struct IDASEG                           /* Resolved IDAW             */
+{
+    RADR    addr;                       /* Data address              */
+    U16     len;                        /* Data length               */
+};
+typedef struct IDASEG IDASEG;
+
+#endif /* IDASEG_STRUCT */
+
 /*--------------------------------------------------------------------*/
 /* IODELAY - kludge                                                   */
 /*--------------------------------------------------------------------*/
@@ -477,20 +497,29 @@ AIPSX (const SCSW* scsw)
 
 
 /*--------------------------------------------------------------------*/
-/*  Queue I/O interrupt and update status (locked)                    */
+/*  Queue I/O interrupt and update status (device locked)             */
+/*                                                                    */
+/*  When the caller also holds sysblk.intlock the CPUs' I/O pending   */
+/*  state is updated and any CPU needing it is woken right away.      */
+/*  Otherwise the pending state is posted lock-free and the waiting   */
+/*  CPUs which must still be woken are returned to the caller, who    */
+/*  passes them to WAKEUP_IOPENDING_CPUS once dev->lock is released.  */
 /*                                                                    */
 /*  Locks Held on Entry                                               */
-/*    sysblk.intlock                                                  */
 /*    dev->lock                                                       */
+/*    sysblk.intlock  (only if intlocked is true)                     */
 /*  Locks Held on Return                                              */
-/*    sysblk.intlock                                                  */
 /*    dev->lock                                                       */
+/*    sysblk.intlock  (only if intlocked is true)                     */
 /*  Locks Used                                                        */
 /*    sysblk.iointqlk                                                 */
 /*--------------------------------------------------------------------*/
-static INLINE void
-queue_io_interrupt_and_update_status_locked( DEVBLK* dev, int clrbsy, BYTE qdioact )
+static INLINE CPU_BITMAP
+queue_io_interrupt_and_update_status_devlocked( DEVBLK* dev, int clrbsy,
+                                                BYTE qdioact, bool intlocked )
 {
+    CPU_BITMAP  wake = 0;               /* Waiting CPUs to be woken  */
+
     OBTAIN_IOINTQLK();
     {
         /* Ensure the interrupt is queued/dequeued per pending flag */
@@ -504,7 +533,12 @@ queue_io_interrupt_and_update_status_locked( DEVBLK* dev, int clrbsy, BYTE qdioa
 
         /* Update interrupts */
         if (!qdioact)
-            UPDATE_IC_IOPENDING_QLOCKED();
+        {
+            if (intlocked)
+                UPDATE_IC_IOPENDING_QLOCKED();
+            else
+                wake = POST_IC_IOPENDING_QLOCKED();
+        }
     }
     RELEASE_IOINTQLK();
 
@@ -520,34 +554,57 @@ queue_io_interrupt_and_update_status_locked( DEVBLK* dev, int clrbsy, BYTE qdioa
             signal_condition( &dev->shiocond );
     }
 #endif // defined( OPTION_SHARED_DEVICES )
+
+    return wake;
+}
+
+/*--------------------------------------------------------------------*/
+/*  Queue I/O interrupt and update status (locked)                    */
+/*                                                                    */
+/*  Locks Held on Entry                                               */
+/*    sysblk.intlock                                                  */
+/*    dev->lock                                                       */
+/*  Locks Held on Return                                              */
+/*    sysblk.intlock                                                  */
+/*    dev->lock                                                       */
+/*  Locks Used                                                        */
+/*    sysblk.iointqlk                                                 */
+/*--------------------------------------------------------------------*/
+static INLINE void
+queue_io_interrupt_and_update_status_locked( DEVBLK* dev, int clrbsy, BYTE qdioact )
+{
+    queue_io_interrupt_and_update_status_devlocked( dev, clrbsy, qdioact, true );
 }
 
 /*--------------------------------------------------------------------*/
 /*  Queue I/O interrupt and update status                             */
 /*                                                                    */
+/*  Called by device threads once the channel program has ended.      */
+/*  sysblk.intlock is only obtained if a waiting CPU must be woken.   */
+/*                                                                    */
 /*  Locks Held on Entry                                               */
 /*    None                                                            */
 /*  Locks Held on Return                                              */
 /*    None                                                            */
 /*  Locks Used                                                        */
 /*    dev->lock                                                       */
-/*    sysblk.intlock                                                  */
 /*    sysblk.iointqlk                                                 */
+/*    sysblk.intlock  (only to wake a waiting CPU)                    */
 /*--------------------------------------------------------------------*/
 static INLINE void
 queue_io_interrupt_and_update_status(DEVBLK* dev, int clrbsy)
 {
+    CPU_BITMAP  wake;                   /* Waiting CPUs to be woken  */
+
     if (likely(dev->scsw.flag3 & SCSW3_SC_PEND))
     {
-        OBTAIN_INTLOCK( NULL );
+        OBTAIN_DEVLOCK( dev );
         {
-            OBTAIN_DEVLOCK( dev );
-            {
-                queue_io_interrupt_and_update_status_locked( dev, clrbsy, FALSE );
-            }
-            RELEASE_DEVLOCK( dev );
+            wake = queue_io_interrupt_and_update_status_devlocked( dev, clrbsy, FALSE, false );
         }
-        RELEASE_INTLOCK( NULL );
+        RELEASE_DEVLOCK( dev );
+
+        WAKEUP_IOPENDING_CPUS( wake );
     }
 #if defined( OPTION_SHARED_DEVICES )
     else    /* No interrupt pending */
@@ -1606,37 +1663,13 @@ int     cc;                             /* Condition code            */
         {
             cc = 1;
 
-            OBTAIN_IOQLOCK();
+            obtain_lock( &sysblk.ioq[ dev->ioqn ].lock );
             {
-                if(sysblk.ioq != NULL)
-                {
-                DEVBLK *tmp;
-
-                    /* special case for head of queue */
-                    if(sysblk.ioq == dev)
-                    {
-                        /* Remove device from the i/o queue */
-                        sysblk.ioq = dev->nextioq;
-                        cc = 0;
-                    }
-                    else
-                    {
-                        /* Search for device on i/o queue */
-                        for(tmp = sysblk.ioq;
-                            tmp->nextioq != NULL && tmp->nextioq != dev;
-                            tmp = tmp->nextioq);
-
-                        /* Remove from queue if found */
-                        if(tmp->nextioq == dev)
-                        {
-                            tmp->nextioq = tmp->nextioq->nextioq;
-                            sysblk.devtunavail = MAX(0, sysblk.devtunavail - 1);
-                            cc = 0;
-                        }
-                    }
-                }
+                /* Remove device from the i/o queue if found */
+                if (unlink_ioq( dev ))
+                    cc = 0;
             }
-            RELEASE_IOQLOCK();
+            release_lock( &sysblk.ioq[ dev->ioqn ].lock );
 
             /* Reset the device */
             if(!cc)
@@ -2408,33 +2441,16 @@ int halt_subchan( REGS* regs, DEVBLK* dev)
              * lock required before test to keep from entering queue and
              * becoming active prior to queue manipulation.
              */
-            OBTAIN_IOQLOCK();
+            obtain_lock( &sysblk.ioq[ dev->ioqn ].lock );
             {
                 if (dev->startpending)
                 {
-                    /* If 1st entry in ioq is this device, remove it */
-                    if (sysblk.ioq == dev)
-                        sysblk.ioq = dev->nextioq;
-                    /* Otherwise search queued I/Os if there are any */
-                    else if (sysblk.ioq)
-                    {
-                        DEVBLK* tmp;
-                        /* Look for ioq entry for this device */
-                        for (tmp = sysblk.ioq;
-                             tmp->nextioq && tmp->nextioq != dev;
-                             tmp = tmp->nextioq) { };
-                        /* Is an I/O queued for this device? */
-                        if (tmp->nextioq == dev)
-                        {
-                            /* Remove this device's ioq entry */
-                            tmp->nextioq = tmp->nextioq->nextioq;
-                            sysblk.devtunavail = MAX( 0, sysblk.devtunavail - 1 );
-                        }
-                    }
+                    /* Remove this device's ioq entry if queued */
+                    unlink_ioq( dev );
                     dev->startpending = 0;
                 }
             }
-            RELEASE_IOQLOCK();
+            release_lock( &sysblk.ioq[ dev->ioqn ].lock );
         }
     }
 
@@ -2672,62 +2688,254 @@ int i;
 } /* end function io_reset */
 
 
+/*-------------------------------------------------------------------*/
+/* Return the current time of day in microseconds                    */
+/*-------------------------------------------------------------------*/
+static INLINE U64 ioq_usecs()
+{
+struct timeval  now;
+
+    gettimeofday( &now, NULL );
+    return ((U64) now.tv_sec * 1000000) + now.tv_usec;
+}
+
+
 /*-------------------------------------------------------------------*/
 /* Create a device thread                                            */
 /*-------------------------------------------------------------------*/
 /*                                                                   */
+/* The new thread's home queue is ioq 'n'.  The thread is counted    */
+/* as waiting on its home queue until it starts running.             */
+/*                                                                   */
 /* Locks:                                                            */
 /*                                                                   */
-/* sysblk->ioqlock must be held.                                     */
+/* sysblk.ioq[n].lock must be held.                                  */
+/* sysblk.ioqlock is obtained (and must not already be held).        */
 /*                                                                   */
 /*-------------------------------------------------------------------*/
 static int
-create_device_thread ()
+create_device_thread( int n )
 {
-int     rc;                             /* Return code               */
+int     rc = 0;                         /* Return code               */
 TID     tid;                            /* Thread ID                 */
 
-    /* Ensure correct number of ioq entries tracked */
+    OBTAIN_IOQLOCK();
     {
-        register int i;
-        register DEVBLK  *ioq;
+        /* If permitted, create another device thread */
+        if (sysblk.devtmax <= 0 || sysblk.devtnbr < sysblk.devtmax)
+        {
+            rc = create_thread( &tid, DETACHED, device_thread,
+                                (void*)(uintptr_t) n, "idle device thread" );
+            if (rc)
+            {
+                WRMSG( HHC00102, "E", strerror( rc ));
+                rc = 2;
+            }
+            else
+            {
+                /* Update counters */
+                sysblk.devtnbr++;
+                if (sysblk.devtnbr > sysblk.devthwm)
+                    sysblk.devthwm = sysblk.devtnbr;
+                sysblk.ioq[n].waiting++;
+            }
+        }
+    }
+    RELEASE_IOQLOCK();
 
-        for (ioq = sysblk.ioq, i = 0;
-             ioq;
-             ioq = ioq->nextioq, i++);
-        sysblk.devtunavail = i;
+    return rc;
+}
 
-        /* If no additional work, return */
-        if (!i)
-            return 0;
 
+/*-------------------------------------------------------------------*/
+/* Signal all device threads (e.g. to check for termination)         */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void signal_device_threads()
+{
+int     n;                              /* I/O queue index           */
+
+    for (n=0; n < MAX_IOQS; n++)
+    {
+        obtain_lock( &sysblk.ioq[n].lock );
+        broadcast_condition( &sysblk.ioq[n].cond );
+        release_lock( &sysblk.ioq[n].lock );
     }
+}
 
-    /* If work is waiting and permitted, schedule another device     */
-    /* thread to handle                                              */
-    if ((sysblk.devtunavail > sysblk.devtwait &&
-         (sysblk.devtmax == 0 || sysblk.devtnbr < sysblk.devtmax)) ||
-        sysblk.devtmax < 0)
+
+/*-------------------------------------------------------------------*/
+/* Start device threads for queued work after devtmax is changed     */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void reschedule_device_threads()
+{
+int     n;                              /* I/O queue index           */
+
+    /* Create a new device thread for each queue with queued I/O
+       requests but no idle thread, if more threads can be created */
+    for (n=0; n < MAX_IOQS; n++)
     {
-        rc = create_thread (&tid, DETACHED, device_thread, NULL,
-                            "idle device thread");
-        if (rc)
+        obtain_lock( &sysblk.ioq[n].lock );
         {
-            WRMSG (HHC00102, "E", strerror(rc));
-            return 2;
+            if (sysblk.ioq[n].head && !sysblk.ioq[n].waiting)
+                create_device_thread( n );
         }
+        release_lock( &sysblk.ioq[n].lock );
+    }
+
+    /* Wakeup threads in case they need to terminate */
+    signal_device_threads();
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Return the total number of queued I/O requests                    */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int queued_io_requests()
+{
+int     n, count = 0;                   /* I/O queue index, count    */
+
+    for (n=0; n < MAX_IOQS; n++)
+        count += sysblk.ioq[n].depth;
+
+    return count;
+}
+
 
-        /* Update counters */
-        sysblk.devtnbr++;
-        sysblk.devtwait++;
-        if (sysblk.devtnbr > sysblk.devthwm)
-            sysblk.devthwm = sysblk.devtnbr;
+/*-------------------------------------------------------------------*/
+/* Return the number of idle device threads                          */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT int idle_device_threads()
+{
+int     n, count = 0;                   /* I/O queue index, count    */
+
+    for (n=0; n < MAX_IOQS; n++)
+        count += sysblk.ioq[n].waiting;
+
+    return count;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Remove a device from its I/O queue                                */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/* Locks:                                                            */
+/*                                                                   */
+/* sysblk.ioq[dev->ioqn].lock must be held.                          */
+/*                                                                   */
+/* Returns true if the device was queued and has been removed.       */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+static bool
+unlink_ioq( DEVBLK* dev )
+{
+IOQ*    ioq = &sysblk.ioq[ dev->ioqn ]; /* -> Device's I/O queue     */
+DEVBLK* tmp;                            /* Queue entry               */
+
+    if (!ioq->head)
+        return false;
+
+    /* Special case for head of queue */
+    if (ioq->head == dev)
+        ioq->head = dev->nextioq;
+    else
+    {
+        /* Search for device on i/o queue */
+        for (tmp = ioq->head;
+             tmp->nextioq && tmp->nextioq != dev;
+             tmp = tmp->nextioq) { };
+
+        if (tmp->nextioq != dev)
+            return false;
+
+        tmp->nextioq = dev->nextioq;
     }
 
-    /* Signal possible waiting I/O threads */
-    signal_condition(&sysblk.ioqcond);
+    dev->nextioq = NULL;
+    ioq->depth = MAX( 0, ioq->depth - 1 );
+    return true;
+}
 
-    return 0;
+
+/*-------------------------------------------------------------------*/
+/* Dequeue the next I/O request for a device thread                  */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/* The thread's home queue is tried first.  If it is empty, work is  */
+/* stolen from the other queues in turn so that a burst of I/O on    */
+/* one group of channel paths can be served by any idle thread.      */
+/* The queue heads are peeked at without the lock; a request missed  */
+/* because of the race is found on the next pass.                    */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+static DEVBLK*
+dequeue_io_request( int home )
+{
+DEVBLK* dev;                            /* -> Dequeued device        */
+IOQ*    ioq;                            /* -> I/O queue              */
+U64     usecs;                          /* Time spent queued         */
+int     i, n;                           /* Indexes                   */
+
+    for (i=0; i < MAX_IOQS; i++)
+    {
+        n = (home + i) % MAX_IOQS;
+        ioq = &sysblk.ioq[n];
+
+        if (!ioq->head)
+            continue;
+
+        obtain_lock( &ioq->lock );
+        {
+            if ((dev = ioq->head) != NULL)
+            {
+                /* Set next IOQ entry and zero pointer in current DEVBLK */
+                ioq->head = dev->nextioq;
+                dev->nextioq = NULL;
+                ioq->depth = MAX( 0, ioq->depth - 1 );
+
+                /* Update queue latency statistics */
+                usecs = ioq_usecs() - dev->ioqusecs;
+                ioq->waitusecs += usecs;
+                if (usecs > ioq->maxusecs)
+                    ioq->maxusecs = usecs;
+                if (i)
+                    ioq->stolen++;
+
+                /* Create another device thread if pending work */
+                if (ioq->head && !ioq->waiting)
+                    create_device_thread( n );
+
+                release_lock( &ioq->lock );
+                return dev;
+            }
+        }
+        release_lock( &ioq->lock );
+    }
+
+    return NULL;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Spin briefly waiting for an I/O request before parking            */
+/*-------------------------------------------------------------------*/
+static bool
+spin_for_io_request( int usecs )
+{
+U64     end = ioq_usecs() + usecs;      /* End of spin               */
+int     n;                              /* I/O queue index           */
+
+    do
+    {
+        for (n=0; n < MAX_IOQS; n++)
+            if (sysblk.ioq[n].head)
+                return true;
+
+        sched_yield();
+    }
+    while (ioq_usecs() < end && !sysblk.shutdown);
+
+    return false;
 }
 
 
@@ -2737,12 +2945,13 @@ TID     tid;                            /* Thread ID                 */
 DLL_EXPORT void* device_thread( void* arg )
 {
 DEVBLK* dev;
+IOQ*    ioq;                            /* -> Home I/O queue         */
+int     home = (int)(uintptr_t) arg;    /* Home I/O queue index      */
 int     current_priority;               /* Current thread priority   */
-int     rc = 0;                         /* Return code               */
+int     rc;                             /* Return code               */
+bool    counted = true;                 /* Thread still in devtnbr   */
 u_int   waitcount = 0;                  /* Wait counter              */
 
-    UNREFERENCED( arg );
-
     /* Automatically adjust to priority change if needed */
 
     current_priority = get_thread_priority();
@@ -2753,109 +2962,117 @@ u_int   waitcount = 0;                  /* Wait counter              */
         current_priority = sysblk.devprio;
     }
 
-    OBTAIN_IOQLOCK();
-    {
-        sysblk.devtwait = MAX( 0, sysblk.devtwait - 1 );
+    /* No longer waiting to be started */
+    ioq = &sysblk.ioq[ home ];
+    obtain_lock( &ioq->lock );
+    ioq->waiting = MAX( 0, ioq->waiting - 1 );
+    release_lock( &ioq->lock );
 
-        while (1)
+    while (!sysblk.shutdown)
+    {
+        if ((dev = dequeue_io_request( home )) != NULL)
         {
-            while ((dev=sysblk.ioq)  && !sysblk.shutdown)
-            {
-                /* Reset local wait count */
-                waitcount = 0;
+            /* Reset local wait count */
+            waitcount = 0;
 
-                /* Set next IOQ entry and zero pointer in current DEVBLK */
-                sysblk.ioq = dev->nextioq;
-                dev->nextioq = 0;
-
-                /* Decrement waiting IOQ count */
-                sysblk.devtunavail = MAX( 0, sysblk.devtunavail - 1 );
-
-                /* Create another device thread if pending work */
-                create_device_thread();
-
-                /* Set thread id */
-                dev->tid = thread_id();
+            /* Set thread id */
+            dev->tid = thread_id();
 
-                /* Set thread name */
-                {
-                    char thread_name[16];
-                    MSGBUF( thread_name, "dev %4.4X thrd", dev->devnum );
-                    SET_THREAD_NAME( thread_name );
-                }
-
-                RELEASE_IOQLOCK();
-                {
-                    /* Set priority to requested device priority; should not */
-                    /* have any Hercules locks held                          */
-                    if (dev->devprio != current_priority)
-                    {
-                        SET_THREAD_PRIORITY( dev->devprio, sysblk.qos_user_initiated );
-                        current_priority = dev->devprio;
-                    }
+            /* Set thread name */
+            {
+                char thread_name[16];
+                MSGBUF( thread_name, "dev %4.4X thrd", dev->devnum );
+                SET_THREAD_NAME( thread_name );
+            }
 
-                    /* Execute requested CCW chain */
-                    call_execute_ccw_chain( sysblk.arch_mode, dev );
+            /* Set priority to requested device priority; should not */
+            /* have any Hercules locks held                          */
+            if (dev->devprio != current_priority)
+            {
+                SET_THREAD_PRIORITY( dev->devprio, sysblk.qos_user_initiated );
+                current_priority = dev->devprio;
+            }
 
-                    /* Reset priority back to device default priority */
-                    if (current_priority != sysblk.devprio)
-                    {
-                        SET_THREAD_PRIORITY( sysblk.devprio, sysblk.qos_user_initiated );
-                        current_priority = sysblk.devprio;
-                    }
-                }
-                OBTAIN_IOQLOCK();
+            /* Execute requested CCW chain */
+            call_execute_ccw_chain( sysblk.arch_mode, dev );
 
-                dev->tid = 0;
+            /* Reset priority back to device default priority */
+            if (current_priority != sysblk.devprio)
+            {
+                SET_THREAD_PRIORITY( sysblk.devprio, sysblk.qos_user_initiated );
+                current_priority = sysblk.devprio;
             }
-            // end while ((dev=sysblk.ioq)  && !sysblk.shutdown)
 
-            /* Shutdown thread on request, if idle for more than two     */
-            /* seconds, or more than four idle threads                   */
+            dev->tid = 0;
+            continue;
+        }
+
+        /* Shutdown thread if a one-time thread, if there are too    */
+        /* many threads, or if idle for more than two seconds while  */
+        /* more than three other threads are also idle               */
+        OBTAIN_IOQLOCK();
+        {
             if (0
                 || (1
                     && sysblk.devtmax == 0
                     && waitcount >= 20
-                    && sysblk.devtwait > 3
+                    && idle_device_threads() > 3
                    )
                 || (sysblk.devtmax > 0 && sysblk.devtnbr > sysblk.devtmax)
                 ||  sysblk.devtmax < 0
-                ||  sysblk.shutdown
             )
-                break;
+            {
+                /* Decrement total number of device threads */
+                sysblk.devtnbr = MAX( 0, sysblk.devtnbr - 1 );
+                counted = false;
+            }
+        }
+        RELEASE_IOQLOCK();
 
-            /* Show thread as idle */
-            waitcount++;
-            sysblk.devtwait++;
-            SET_THREAD_NAME( "idle dev thrd" );
-
-            /* Wait for work to arrive */
-            rc = timed_wait_condition_relative_usecs
-                 (
-                     &sysblk.ioqcond,
-                     &sysblk.ioqlock,
-                     100000, // 100 ms
-                     NULL
-                 );
-
-            /* Decrement thread waiting count */
-            sysblk.devtwait = MAX( 0, sysblk.devtwait - 1 );
-
-            /* If shutdown requested, terminate the thread
-               after signaling next I/O thread to shutdown.
-            */
-            if (sysblk.shutdown)
+        if (!counted)
+            break;
+
+        /* Spin for new work first if requested */
+        if (sysblk.ioqspin && spin_for_io_request( sysblk.ioqspin ))
+            continue;
+
+        /* Show thread as idle */
+        waitcount++;
+        SET_THREAD_NAME( "idle dev thrd" );
+
+        /* Wait for work to arrive on our home queue */
+        obtain_lock( &ioq->lock );
+        {
+            if (!ioq->head && !sysblk.shutdown)
             {
-                signal_condition( &sysblk.ioqcond );
-                break;
+                ioq->waiting++;
+
+                timed_wait_condition_relative_usecs
+                (
+                    &ioq->cond,
+                    &ioq->lock,
+                    100000, // 100 ms
+                    NULL
+                );
+
+                ioq->waiting = MAX( 0, ioq->waiting - 1 );
             }
         }
-        // end while (1)
+        release_lock( &ioq->lock );
+    }
+    // end while (!sysblk.shutdown)
 
+    if (counted)
+    {
         /* Decrement total number of device threads */
+        OBTAIN_IOQLOCK();
         sysblk.devtnbr = MAX( 0, sysblk.devtnbr - 1 );
+        RELEASE_IOQLOCK();
     }
-    RELEASE_IOQLOCK();
+
+    /* If shutdown requested, signal the other threads to shutdown */
+    if (sysblk.shutdown)
+        signal_device_threads();
 
     return ( NULL );
 
@@ -2866,16 +3083,17 @@ u_int   waitcount = 0;                  /* Wait counter              */
 /* Schedule I/O Request (second half of Schedule IOQ)                */
 /*-------------------------------------------------------------------*/
 /*                                                                   */
-/* Note: Queue is actually split, by priority, with resume requests  */
-/*       first for each priority, followed by start requests for     */
-/*       the priority.  The code within the locked section MUST be   */
-/*       minimized.                                                  */
+/* Note: Each group of channel paths has its own I/O queue, chosen   */
+/*       by the device's first CHPID.  Each queue is split, by       */
+/*       priority, with resume requests first for each priority,     */
+/*       followed by start requests for the priority.  The code      */
+/*       within the locked section MUST be minimized.                */
 /*                                                                   */
 /* Locks held:                                                       */
 /*   dev->lock                                                       */
 /*                                                                   */
 /* Locks used:                                                       */
-/*   sysblk.ioqlock                                                  */
+/*   sysblk.ioq[n].lock                                              */
 /*                                                                   */
 /*  Returns:                                                         */
 /*                                                                   */
@@ -2886,18 +3104,25 @@ u_int   waitcount = 0;                  /* Wait counter              */
 static int
 ScheduleIORequest ( DEVBLK *dev )
 {
+    IOQ    *q;                          /* -> Device's I/O queue     */
     DEVBLK *ioq, *previoq, *nextioq;    /* Device I/O queue pointers */
     int     count;                      /* I/O queue length          */
+    int     n;                          /* I/O queue index           */
     int     rc = 0;                     /* Return Code               */
+    bool    idle = false;               /* Idle thread was signaled  */
     U8      device_resume;              /* Resume I/O flag - Device  */
 
     /* Determine if the device is resuming */
     device_resume = (dev->scsw.flag2 & SCSW2_AC_RESUM);
 
-    OBTAIN_IOQLOCK();
+    /* Select the I/O queue for the device's channel path */
+    dev->ioqn = dev->pmcw.chpid[0] % MAX( 1, sysblk.numioq );
+    q = &sysblk.ioq[ dev->ioqn ];
+
+    obtain_lock( &q->lock );
     {
         /* Insert this I/O request into the appropriate I/O queue slot */
-        for (ioq = sysblk.ioq, previoq = NULL, count = 0;
+        for (ioq = q->head, previoq = NULL, count = 0;
             ioq;
             ++count, previoq = ioq, ioq = ioq->nextioq)
         {
@@ -2950,21 +3175,56 @@ ScheduleIORequest ( DEVBLK *dev )
                 if (previoq != NULL)
                     previoq->nextioq = dev;
                 else
-                    sysblk.ioq = dev;
+                    q->head = dev;
 
-                /* Update device thread unavailable count. It will be
-                 * decremented once a thread grabs this request.
-                 */
-                sysblk.devtunavail = count;
+                /* Update queue statistics */
+                dev->ioqusecs = ioq_usecs();
+                q->depth = count;
+                if (count > q->hwm)
+                    q->hwm = count;
+                q->queued++;
 
-                /* Create another device thread, if needed, to service this
-                 * I/O
-                 */
-                rc = create_device_thread();
+                /* Wake an idle thread of this queue if there is one */
+                if (q->waiting)
+                {
+                    signal_condition( &q->cond );
+                    idle = true;
+                }
             }
         }
     }
-    RELEASE_IOQLOCK();
+    release_lock( &q->lock );
+
+    if (rc || idle)
+        return rc;
+
+    /* Otherwise wake an idle thread of another queue to steal it */
+    for (n=0; n < MAX_IOQS; n++)
+    {
+        if (n == dev->ioqn || !sysblk.ioq[n].waiting)
+            continue;
+
+        obtain_lock( &sysblk.ioq[n].lock );
+        {
+            if (sysblk.ioq[n].waiting)
+            {
+                signal_condition( &sysblk.ioq[n].cond );
+                idle = true;
+            }
+        }
+        release_lock( &sysblk.ioq[n].lock );
+
+        if (idle)
+            return 0;
+    }
+
+    /* Create another device thread, if needed, to service this I/O */
+    obtain_lock( &q->lock );
+    {
+        if (q->head && !q->waiting)
+            rc = create_device_thread( dev->ioqn );
+    }
+    release_lock( &q->lock );
 
     /* Return condition code */
     return rc;
@@ -3011,7 +3271,7 @@ schedule_ioq (const REGS *regs, DEVBLK *dev)
      */
     if (sysblk.shutdown)
     {
-        signal_condition(&sysblk.ioqcond);
+        signal_device_threads();
         return (result);
     }
 
@@ -3161,43 +3421,44 @@ ARCH_DEP(raise_pci) (DEVBLK *dev,       /* -> Device block           */
                      BYTE ccwfmt,       /* CCW format (0 or 1)       */
                      U32 ccwaddr)       /* Main storage addr of CCW  */
 {
+CPU_BITMAP  wake;                       /* Waiting CPUs to be woken  */
+
 #if !defined(FEATURE_CHANNEL_SUBSYSTEM)
     UNREFERENCED(ccwfmt);
 #endif
 
     IODELAY( dev );
 
-    OBTAIN_INTLOCK( NULL );
+    OBTAIN_DEVLOCK( dev );
     {
-        OBTAIN_DEVLOCK( dev );
+        /* Save the PCI SCSW replacing any previous pending PCI; always
+         * track the channel in channel subsystem mode
+         */
+        dev->pciscsw.flag0 = ccwkey & SCSW0_KEY;
+        dev->pciscsw.flag1 = (ccwfmt == 1 ? SCSW1_F : 0);
+        dev->pciscsw.flag2 = SCSW2_FC_START;
+        dev->pciscsw.flag3 = SCSW3_AC_SCHAC | SCSW3_AC_DEVAC
+                           | SCSW3_SC_INTER | SCSW3_SC_PEND;
+        STORE_FW(dev->pciscsw.ccwaddr,ccwaddr);
+        dev->pciscsw.unitstat = 0;
+        dev->pciscsw.chanstat = CSW_PCI;
+        store_hw (dev->pciscsw.count, 0);
+
+        /* Queue the PCI pending interrupt */
+        OBTAIN_IOINTQLK();
         {
-            /* Save the PCI SCSW replacing any previous pending PCI; always
-             * track the channel in channel subsystem mode
-             */
-            dev->pciscsw.flag0 = ccwkey & SCSW0_KEY;
-            dev->pciscsw.flag1 = (ccwfmt == 1 ? SCSW1_F : 0);
-            dev->pciscsw.flag2 = SCSW2_FC_START;
-            dev->pciscsw.flag3 = SCSW3_AC_SCHAC | SCSW3_AC_DEVAC
-                               | SCSW3_SC_INTER | SCSW3_SC_PEND;
-            STORE_FW(dev->pciscsw.ccwaddr,ccwaddr);
-            dev->pciscsw.unitstat = 0;
-            dev->pciscsw.chanstat = CSW_PCI;
-            store_hw (dev->pciscsw.count, 0);
-
-            /* Queue the PCI pending interrupt */
-            OBTAIN_IOINTQLK();
-            {
-                QUEUE_IO_INTERRUPT_QLOCKED( &dev->pciioint, FALSE );
+            QUEUE_IO_INTERRUPT_QLOCKED( &dev->pciioint, FALSE );
 
-                /* Update interrupt status */
-                subchannel_interrupt_queue_cleanup( dev );
-                UPDATE_IC_IOPENDING_QLOCKED();
-            }
-            RELEASE_IOINTQLK();
+            /* Post interrupt status (lock-free) */
+            subchannel_interrupt_queue_cleanup( dev );
+            wake = POST_IC_IOPENDING_QLOCKED();
         }
-        RELEASE_DEVLOCK( dev );
+        RELEASE_IOINTQLK();
     }
-    RELEASE_INTLOCK( NULL );
+    RELEASE_DEVLOCK( dev );
+
+    /* Wake a waiting CPU, if any, to take the interrupt */
+    WAKEUP_IOPENDING_CPUS( wake );
 
 } /* end function raise_pci */
 
@@ -3279,6 +3540,8 @@ ARCH_DEP(fetch_idaw) (DEVBLK *dev,      /* -> Device block           */
                       U16 idapmask,     /* IDA page size - 1         */
                       int idaseq,       /* 0=1st IDAW                */
                       U32 idawaddr,     /* Main storage addr of IDAW */
+                      RADR *keypage,    /* Key page already checked, */
+                                        /* or NULL to always check   */
                       RADR *addr,       /* Returned IDAW content     */
                       U16 *len,         /* Returned IDA data length  */
                       BYTE *chanstat)   /* Returned channel status   */
@@ -3307,17 +3570,24 @@ BYTE    storkey;                        /* Storage key               */
         return;
     }
 
-    /* Channel protection check if IDAW is fetch protected */
-    storkey = ARCH_DEP( get_dev_storage_key )( dev, idawaddr );
-    if (ccwkey != 0 && (storkey & STORKEY_FETCH)
-        && (storkey & STORKEY_KEY) != ccwkey)
+    /* Channel protection check if IDAW is fetch protected, unless
+       an earlier IDAW in the same storage key page was checked */
+    if (!keypage || *keypage != (idawaddr & STORAGE_KEY_PAGEMASK))
     {
-        *chanstat = CSW_PROTC;
-        return;
-    }
+        storkey = ARCH_DEP( get_dev_storage_key )( dev, idawaddr );
+        if (ccwkey != 0 && (storkey & STORKEY_FETCH)
+            && (storkey & STORKEY_KEY) != ccwkey)
+        {
+            *chanstat = CSW_PROTC;
+            return;
+        }
 
-    /* Set the main storage reference bit for the IDAW location */
-    ARCH_DEP( or_dev_storage_key )( dev, idawaddr, STORKEY_REF );
+        /* Set the main storage reference bit for the IDAW location */
+        ARCH_DEP( or_dev_storage_key )( dev, idawaddr, STORKEY_REF );
+
+        if (keypage)
+            *keypage = idawaddr & STORAGE_KEY_PAGEMASK;
+    }
 
     /* Fetch IDAW from main storage */
     if (idawfmt == PF_IDAW2)
@@ -3400,6 +3670,81 @@ BYTE    storkey;                        /* Storage key               */
 } /* end function fetch_idaw */
 
 
+/*-------------------------------------------------------------------*/
+/* RESOLVE THE ENTIRE IDAW LIST OF A CCW INTO A SCATTER-GATHER LIST  */
+/*-------------------------------------------------------------------*/
+/* Each IDAW is validated exactly as fetch_idaw does, but the        */
+/* storage key of the IDAW list and of the data areas is checked     */
+/* only once per storage key page.  Returns the number of IDAWs      */
+/* resolved; if the list could not be resolved completely, the       */
+/* status for the first IDAW in error is returned in chanstat and    */
+/* the IDAWs before it must still be transferred.                    */
+/*-------------------------------------------------------------------*/
+static int
+ARCH_DEP(resolve_idaws) (DEVBLK *dev,   /* -> Device block           */
+                         BYTE code,     /* CCW operation code        */
+                         BYTE ccwkey,   /* Bits 0-3=key, 4-7=zeroes  */
+                         BYTE idawfmt,  /* IDAW format (1 or 2)      */
+                         U16 idapmask,  /* IDA page size - 1         */
+                         U32 idawaddr,  /* Main storage addr of IDAW */
+                         U16 count,     /* CCW data count            */
+                         BYTE to_memory,/* 1=READ, SENSE, or RDBACK  */
+                         IDASEG *seg,   /* Returned IDAW list        */
+                         BYTE *chanstat)/* Returned channel status   */
+{
+int     n;                              /* Number of IDAWs resolved  */
+int     idasize;                        /* IDAW Size                 */
+RADR    idawpage = (RADR) -1;           /* IDAW key page checked     */
+RADR    datapage = (RADR) -1;           /* Data key page checked     */
+RADR    idadata;                        /* IDA data address          */
+U16     idalen;                         /* IDA data length           */
+BYTE    storkey;                        /* Storage key               */
+
+    *chanstat = 0;
+    idasize = (idawfmt == PF_IDAW1) ? 4 : 8;
+
+    for (n = 0; count > 0 && n < MAX_IDASEGS; n++, idawaddr += idasize)
+    {
+        ARCH_DEP( fetch_idaw )( dev, code, ccwkey, idawfmt, idapmask,
+                                n, idawaddr, &idawpage,
+                                &idadata, &idalen, chanstat );
+        if (*chanstat != 0)
+            break;
+
+        /* Channel protection check if IDAW data location is
+           fetch protected, or if location is store protected
+           and command is READ, READ BACKWARD, or SENSE */
+        if ((idadata & STORAGE_KEY_PAGEMASK) != datapage)
+        {
+            storkey = ARCH_DEP( get_dev_storage_key )( dev, idadata );
+
+            if (1
+                && ccwkey != 0
+                && (storkey & STORKEY_KEY) != ccwkey
+                && ((storkey & STORKEY_FETCH) || to_memory)
+            )
+            {
+                *chanstat = CSW_PROTC;
+                break;
+            }
+
+            datapage = idadata & STORAGE_KEY_PAGEMASK;
+        }
+
+        /* Reduce length if less than one page remaining */
+        if (idalen > count)
+            idalen = count;
+
+        seg[n].addr = idadata;
+        seg[n].len  = idalen;
+        count -= idalen;
+    }
+
+    return n;
+
+} /* end function resolve_idaws */
+
+
 #if defined(FEATURE_MIDAW_FACILITY)
 /*-------------------------------------------------------------------*/
 /* FETCH A MODIFIED INDIRECT DATA ADDRESS WORD FROM MAIN STORAGE     */
@@ -3410,6 +3755,7 @@ ARCH_DEP(fetch_midaw) (DEVBLK *dev,     /* -> Device block           */
                        BYTE ccwkey,     /* Bits 0-3=key, 4-7=zeroes  */
                        int midawseq,    /* 0=1st MIDAW               */
                        U32 midawadr,    /* Main storage addr of MIDAW*/
+                       RADR *keypage,   /* Key page already checked  */
                        RADR *addr,      /* Returned MIDAW content    */
                        U16 *len,        /* Returned MIDAW data length*/
                        BYTE *flags,     /* Returned MIDAW flags      */
@@ -3440,17 +3786,26 @@ U16     maxlen;                         /* Maximum allowable length  */
         return;
     }
 
-    /* Channel protection check if MIDAW is fetch protected */
-    storkey = ARCH_DEP( get_dev_storage_key )( dev, midawadr );
-    if (ccwkey != 0 && (storkey & STORKEY_FETCH)
-        && (storkey & STORKEY_KEY) != ccwkey)
+    /* Channel protection check if MIDAW is fetch protected. The
+       key is checked, and the reference bit set, whenever the MIDAW
+       is in a different storage key page than the last one checked
+       (*keypage); later MIDAWs in the same key page are not checked
+       again */
+    if (*keypage != (midawadr & STORAGE_KEY_PAGEMASK))
     {
-        *chanstat = CSW_PROTC;
-        return;
-    }
+        storkey = ARCH_DEP( get_dev_storage_key )( dev, midawadr );
+        if (ccwkey != 0 && (storkey & STORKEY_FETCH)
+            && (storkey & STORKEY_KEY) != ccwkey)
+        {
+            *chanstat = CSW_PROTC;
+            return;
+        }
+
+        /* Set the main storage reference bit for the MIDAW location */
+        ARCH_DEP( or_dev_storage_key )( dev, midawadr, STORKEY_REF );
 
-    /* Set the main storage reference bit for the MIDAW location */
-    ARCH_DEP( or_dev_storage_key )( dev, midawadr, STORKEY_REF );
+        *keypage = midawadr & STORAGE_KEY_PAGEMASK;
+    }
 
     /* Fetch MIDAW from main storage (MIDAW is quadword
        aligned and so cannot cross a page boundary) */
@@ -3553,6 +3908,7 @@ U16     midawrem;                       /* CCW bytes remaining       */
 U16     midawlen=0;                     /* MIDAW data length         */
 RADR    midawdat=0;                     /* MIDAW data area addr      */
 BYTE    midawflg;                       /* MIDAW flags               */
+RADR    midawpage = (RADR) -1;          /* MIDAW list key page       */
 #endif /*defined(FEATURE_MIDAW_FACILITY)*/
 
 #if !defined(set_chanstat)
@@ -3649,7 +4005,7 @@ do {                                                                   \
 
             /* Fetch MIDAW and set data address, length, flags */
             ARCH_DEP(fetch_midaw) (dev, code, ccwkey,
-                    midawseq, midawptr,
+                    midawseq, midawptr, &midawpage,
                     &midawdat, &midawlen, &midawflg, chanstat);
 
             /* Exit if fetch_midaw detected channel program check */
@@ -3684,9 +4040,10 @@ do {                                                                   \
                    MIDAW */
                 if ((midawflg & MIDAW_SKIP) ==0)
                 {
-                    /* Note: MIDAW data area cannot cross a page
-                       boundary. The fetch_midaw function enforces this
-                       restriction */
+                    /* Note: unless skipping, fetch_midaw has verified
+                       that the MIDAW data area does not cross a page
+                       boundary, so the key of its first byte is checked
+                       for every MIDAW and covers the whole area */
 
                     /* Channel protection check if MIDAW data location
                        is fetch protected, or if location is store
@@ -3813,6 +4170,67 @@ do {                                                                   \
     } /* end if(CCW_FLAGS_MIDAW) */
     else
 #endif /*defined(FEATURE_MIDAW_FACILITY)*/
+    /* Move data using the resolved IDAW list when not prefetching
+       or tracing and the whole count fits in the I/O buffer. Any
+       other case (including channel data checks) is handled by the
+       IDAW-at-a-time loop further below. */
+    if (1
+        && (flags & CCW_FLAGS_IDA)
+        && !prefetch->seq
+        && !dev->ccwtrace
+        && !readbackwards
+        && (iobuf + count) <= (iobufend + 1)
+    )
+    {
+        IDASEG  seg[ MAX_IDASEGS ];     /* Resolved IDAW list        */
+        BYTE    idastat;                /* Status of IDAW in error   */
+        int     nseg, i;                /* Number of IDAWs, index    */
+        RADR    keypage = (RADR) -1;    /* Last key page referenced  */
+        RADR    runaddr = 0;            /* Contiguous run address    */
+        U32     runlen = 0;             /* Contiguous run length     */
+        BYTE*   runbuf = iobuf;         /* Contiguous run buffer     */
+
+        nseg = ARCH_DEP( resolve_idaws )( dev, code, ccwkey, idawfmt,
+                                          idapmask, addr, (U16) count,
+                                          to_memory, seg, &idastat );
+        for (i = 0; i <= nseg; i++)
+        {
+            /* Copy the previous run of contiguous data areas when
+               this IDAW does not continue it (or at end of list) */
+            if (runlen && (i == nseg || seg[i].addr != runaddr + runlen))
+            {
+                if (to_iobuf)
+                    memcpy( runbuf, dev->mainstor + runaddr, runlen );
+                else
+                    memcpy( dev->mainstor + runaddr, runbuf, runlen );
+
+                runbuf += runlen;
+                prefetch->pos += runlen;
+                runlen = 0;
+            }
+
+            if (i == nseg)
+                break;
+
+            /* Set the main storage reference and change bits */
+            if ((seg[i].addr & STORAGE_KEY_PAGEMASK) != keypage)
+            {
+                keypage = seg[i].addr & STORAGE_KEY_PAGEMASK;
+
+                if (to_memory)
+                    ARCH_DEP( or_dev_storage_key )( dev, seg[i].addr, (STORKEY_REF | STORKEY_CHANGE) );
+                else
+                    ARCH_DEP( or_dev_storage_key )( dev, seg[i].addr, STORKEY_REF );
+            }
+
+            if (!runlen)
+                runaddr = seg[i].addr;
+            runlen += seg[i].len;
+        }
+
+        *chanstat = idastat;
+    }
+    else
     /* Move data when indirect data addressing is used */
     if (flags & CCW_FLAGS_IDA)
     {
@@ -3840,7 +4258,7 @@ do {                                                                   \
 
             /* Fetch the IDAW and set IDA pointer and length */
             ARCH_DEP( fetch_idaw )( dev, code, ccwkey, idawfmt,
-                        idapmask, idaseq, idawaddr,
+                        idapmask, idaseq, idawaddr, NULL,
                         &idadata, &idalen, chanstat );
 
             /* Exit if fetch_idaw detected channel program check */
@@ -4572,6 +4990,8 @@ bool    did_ccw_trace = false;          /* true = CCW traced         */
 BYTE    firstccw = 1;                   /* 1=First CCW               */
 BYTE    area[64];                       /* Message area              */
 u_int   bufpos = 0;                     /* Position in I/O buffer    */
+BYTE   *zcdata;                         /* Read data returned in     */
+                                        /* place by device handler   */
 u_int   skip_ccws = 0;                  /* Skip ccws                 */
 int     cmdretry = 255;                 /* Limit command retry       */
 U32     prevccwaddr = 1;                /* Previous CCW address      */
@@ -5562,6 +5982,18 @@ prefetch:
             residual = count;
             more = bufpos = unitstat = chanstat = 0;
 
+            /* Let the device handler return read data in place,
+               without copying it to the I/O buffer, unless the data
+               may be needed by a data chained CCW or for tracing */
+            dev->iobuf.zerocopy = (1
+                && IS_CCW_READ( dev->code )
+                && !(flags & (CCW_FLAGS_CD | CCW_FLAGS_SKIP))
+                && !prefetch.seq
+                && !dev->ccwtrace
+                && !tracethis
+            );
+            dev->iobuf.zcdata = NULL;
+
             /* Pass the CCW to the device handler for execution */
             dev->iobuf.length = iobuf->size;
             dev->iobuf.data = iobuf->data;
@@ -5572,6 +6004,10 @@ prefetch:
             dev->iobuf.length = 0;
             dev->iobuf.data   = 0;
 
+            zcdata = dev->iobuf.zerocopy ? dev->iobuf.zcdata : NULL;
+            dev->iobuf.zerocopy = false;
+            dev->iobuf.zcdata   = NULL;
+
             /* Check for Command Retry (suggested by Jim Pierson) */
             if ( --cmdretry && unitstat == ( CSW_CE | CSW_DE | CSW_UC | CSW_SM ) )
             {
@@ -5676,13 +6112,22 @@ prefetch:
                    )
             )
             {
-                /* Copy data from I/O buffer to main storage */
-                ARCH_DEP(copy_iobuf) ( &did_ccw_trace, dev, ccw, dev->code, flags, addr,
-                                      count - residual, ccwkey,
-                                      idawfmt, idapmask,
-                                      iobuf->data,
-                                      iobuf->start, iobuf->end,
-                                      &chanstat, &residual, &prefetch);
+                /* Copy data from I/O buffer to main storage, or
+                   directly from where the device handler returned it */
+                if (zcdata && count > residual)
+                    ARCH_DEP(copy_iobuf) ( &did_ccw_trace, dev, ccw, dev->code, flags, addr,
+                                          count - residual, ccwkey,
+                                          idawfmt, idapmask,
+                                          zcdata,
+                                          zcdata, zcdata + (count - residual) - 1,
+                                          &chanstat, &residual, &prefetch);
+                else
+                    ARCH_DEP(copy_iobuf) ( &did_ccw_trace, dev, ccw, dev->code, flags, addr,
+                                          count - residual, ccwkey,
+                                          idawfmt, idapmask,
+                                          iobuf->data,
+                                          iobuf->start, iobuf->end,
+                                          &chanstat, &residual, &prefetch);
 
                 /* Update number of bytes in channel buffer */
                 bufpos = prefetch.pos;
@@ -6870,4 +7315,44 @@ DLL_EXPORT void Update_IC_IOPENDING_QLocked()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*  Lock-free variant of the above for device threads which hold     */
+/*  sysblk.iointqlk but NOT sysblk.intlock. The CPUs' I/O pending    */
+/*  state is updated atomically; the waiting CPUs which need to be   */
+/*  woken are returned so that the caller can pass them to           */
+/*  Wakeup_IOPENDING_CPUs once sysblk.iointqlk has been released.    */
+/*-------------------------------------------------------------------*/
+
+DLL_EXPORT CPU_BITMAP Post_IC_IOPENDING_QLocked()
+{
+    if (!sysblk.iointq)
+    {
+        OFF_IC_IOPENDING;
+        return 0;
+    }
+
+    /* (set_ic_iopending's atomic updates order this load after them) */
+    return set_ic_iopending() & sysblk.waiting_mask;
+}
+
+/*-------------------------------------------------------------------*/
+/*  Wake CPUs that were found waiting by Post_IC_IOPENDING_QLocked.  */
+/*  A waiting CPU holds sysblk.intlock from the moment it sets its   */
+/*  waiting_mask bit until it is inside its condition wait, so the   */
+/*  intlock must be obtained for the signal not to be lost. This is  */
+/*  the only time the lock-free posting path needs sysblk.intlock.   */
+/*-------------------------------------------------------------------*/
+
+DLL_EXPORT void Wakeup_IOPENDING_CPUs( CPU_BITMAP wake )
+{
+    if (wake)
+    {
+        OBTAIN_INTLOCK( NULL );
+        {
+            WAKEUP_CPU_MASK( wake & sysblk.waiting_mask );
+        }
+        RELEASE_INTLOCK( NULL );
+    }
+}
+
 #endif /*!defined(_GEN_ARCH)*/
@@ -280,6 +280,7 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     sfxchar = *sfxptr;
 
     /* process the remaining arguments */
+    dev->ckdmmap = 0;
     for (i = 1; i < argc; i++)
     {
         if (strcasecmp ("lazywrite", argv[i]) == 0)
@@ -327,6 +328,11 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
             dev->ckdfakewr = 1;
             continue;
         }
+        if (strcasecmp ("mmap", argv[i]) == 0)
+        {
+            dev->ckdmmap = 1;
+            continue;
+        }
         if (strlen (argv[i]) > 3 &&
             memcmp ("sf=", argv[i], 3) == 0)
         {
@@ -631,6 +637,17 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     /* Restore the last character of the file name */
     *sfxptr = sfxchar;
 
+    /* Map the image files if requested (normal CKD files only) */
+    if (dev->ckdmmap && (cckd || dev->dasdcopy))
+        dev->ckdmmap = 0;
+    for (i = 0; dev->ckdmmap && i < dev->ckdnumfd; i++)
+    {
+        trks = dev->ckdhitrk[i] - (i ? dev->ckdhitrk[i-1] : 0);
+        if (!dasd_mmap( dev, i, dev->ckdfd[i], CKD_DEVHDR_SIZE +
+                        (U64) trks * dev->ckdtrksz, CKDTYP( cckd, 0 )))
+            dasd_munmap( dev );
+    }
+
     /* Locate the CKD dasd table entry */
     dev->ckdtab = dasd_lookup (DASD_CKDDEV, NULL, dev->devtype, dev->ckdcyls);
     if (dev->ckdtab == NULL)
@@ -710,22 +727,24 @@ void ckd_dasd_query_device (DEVBLK *dev, char **devclass,
     {
         if ( dev->ckdnumfd > 1)
         {
-            snprintf( buffer, buflen, "%s%s %s%s[%d cyls] [%d segs] IO[%"PRIu64"]",
+            snprintf( buffer, buflen, "%s%s %s%s%s[%d cyls] [%d segs] IO[%"PRIu64"]",
                       dev->cckd64 ? "*64* " : "",
                       filename,
                       dev->ckdrdonly ? "ro " : "",
                       dev->ckdfakewr ? "fw " : "",
+                      dev->ckdmmap   ? "mmap " : "",
                       dev->ckdcyls,
                       dev->ckdnumfd,
                       dev->excps );
         }
         else
         {
-            snprintf( buffer, buflen, "%s%s %s%s[%d cyls] IO[%"PRIu64"]",
+            snprintf( buffer, buflen, "%s%s %s%s%s[%d cyls] IO[%"PRIu64"]",
                       dev->cckd64 ? "*64* " : "",
                       filename,
                       dev->ckdrdonly ? "ro " : "",
                       dev->ckdfakewr ? "fw " : "",
+                      dev->ckdmmap   ? "mmap " : "",
                       dev->ckdcyls,
                       dev->excps );
         }
@@ -785,7 +804,8 @@ BYTE    unitstat;                       /* Unit Status               */
             WRMSG( HHC00417, "I", LCSS_DEVNUM,
                    dev->filename, dev->cachehits, dev->cachemisses, dev->cachewaits );
 
-    /* Close all of the CKD image files */
+    /* Unmap and close all of the CKD image files */
+    dasd_munmap( dev );
     for (i = 0; i < dev->ckdnumfd; i++)
         if (dev->ckdfd[i] > 2)
             close (dev->ckdfd[i]);
@@ -836,6 +856,70 @@ int ckd_trklen (DEVBLK *dev, BYTE *buf)
     return sz;
 }
 
+/*-------------------------------------------------------------------*/
+/* Read a track image from the mapped image files                    */
+/*-------------------------------------------------------------------*/
+/* The track image is used in place: no cache entry is allocated and */
+/* updates are made directly to the mapped file, leaving the host    */
+/* page cache to write them back (they are msync'ed at close).       */
+/*-------------------------------------------------------------------*/
+static
+int ckd_dasd_read_mapped_track (DEVBLK *dev, int trk, int cyl, int head,
+                                BYTE *unitstat)
+{
+int             f;                      /* File index                */
+CKD_TRKHDR     *trkhdr;                 /* -> Track header           */
+
+    /* The previous track image, if modified, was updated in place */
+    dev->bufupd = 0;
+    dev->bufupdlo = dev->bufupdhi = 0;
+    dev->bufcur = dev->cache = -1;
+
+    /* Return on special case when called by the close handler */
+    if (trk < 0)
+        return 0;
+
+    /* Locate the file and the track offset within it */
+    for (f = 0; f < dev->ckdnumfd; f++)
+        if (trk < dev->ckdhitrk[f]) break;
+    dev->fd = dev->ckdfd[f];
+    dev->ckdtrkoff = (U64)(CKD_DEVHDR_SIZE +
+         ((U64)(trk - (f ? dev->ckdhitrk[f-1] : 0))) * dev->ckdtrksz);
+
+    // "Thread "TIDPAT" %1d:%04X CKD file %s: read trk %d reading file %d offset %"PRId64" len %d"
+    if (dev->ccwtrace && sysblk.traceFILE)
+        tf_0429( dev, trk, f+1 );
+    else
+        LOGDEVTR( HHC00429, "I", dev->filename, trk, f+1, dev->ckdtrkoff, dev->ckdtrksz );
+
+    /* Validate the track header */
+    trkhdr = (CKD_TRKHDR*)(dev->ckdmap[f] + dev->ckdtrkoff);
+    if (0
+        || trkhdr->bin              != 0
+        || fetch_hw( trkhdr->cyl  ) != cyl
+        || fetch_hw( trkhdr->head ) != head
+    )
+    {
+        // "%1d:%04X CKD file %s: invalid track header for cyl %d head %d %02X %02X%02X %02X%02X"
+        WRMSG( HHC00418, "E", LCSS_DEVNUM,
+               dev->filename, cyl, head, trkhdr->bin,
+               trkhdr->cyl[0], trkhdr->cyl[1],
+               trkhdr->head[0], trkhdr->head[1] );
+        ckd_build_sense( dev, 0, SENSE1_ITF, 0, 0, 0 );
+        *unitstat = CSW_CE | CSW_DE | CSW_UC;
+        return -1;
+    }
+
+    dev->buf = (BYTE*)trkhdr;
+    dev->bufcur = trk;
+    dev->bufoff = 0;
+    dev->bufoffhi = dev->ckdtrksz;
+    dev->buflen = ckd_trklen (dev, dev->buf);
+    dev->bufsize = dev->ckdtrksz;
+
+    return 0;
+} /* end function ckd_dasd_read_mapped_track */
+
 /*-------------------------------------------------------------------*/
 /* Read a track image                                                */
 /*-------------------------------------------------------------------*/
@@ -870,6 +954,10 @@ CKD_TRKHDR     *trkhdr;                 /* -> New track header       */
     if (trk >= 0 && trk == dev->bufcur)
         return 0;
 
+    /* Use the track image directly if the image files are mapped */
+    if (dev->ckdmmap)
+        return ckd_dasd_read_mapped_track (dev, trk, cyl, head, unitstat);
+
     /* Write the previous track image if modified */
     if (dev->bufupd)
     {
@@ -946,6 +1034,7 @@ ckd_read_track_retry:
     {
         cache_setflag(CACHE_DEVBUF, i, ~0, CKD_CACHE_ACTIVE);
         cache_setage(CACHE_DEVBUF, i);
+        cache_promote(CACHE_DEVBUF, i);
         cache_unlock(CACHE_DEVBUF);
 
         // "Thread "TIDPAT" %1d:%04X CKD file %s: read trk %d cache hit, using cache[%d]"
@@ -1977,7 +2066,8 @@ CKD_RECHDR      rechdr;                 /* CKD record header         */
             return -1;
         }
 
-        memcpy (buf, &dev->buf[dev->bufoff], dev->ckdcurkl);
+        if (buf)
+            memcpy (buf, &dev->buf[dev->bufoff], dev->ckdcurkl);
         dev->bufoff += dev->ckdcurkl;
     }
 
@@ -2031,7 +2121,8 @@ CKD_RECHDR      rechdr;                 /* Record header             */
             *unitstat = CSW_CE | CSW_DE | CSW_UC;
             return -1;
         }
-        memcpy (buf, &dev->buf[dev->bufoff], dev->ckdcurdl);
+        if (buf)
+            memcpy (buf, &dev->buf[dev->bufoff], dev->ckdcurdl);
         dev->bufoff += dev->ckdcurdl;
     }
 
@@ -2043,6 +2134,38 @@ CKD_RECHDR      rechdr;                 /* Record header             */
 } /* end function ckd_read_data */
 
 
+/*-------------------------------------------------------------------*/
+/* Check whether a record can be transferred in place (zero copy)    */
+/*-------------------------------------------------------------------*/
+/* Called by READ TRACK and READ MULTIPLE CKD after reading a count  */
+/* field.  'zc' points to the records so far left in place in the    */
+/* track image and 'size' is their length.  Returns the (new) start  */
+/* of the in-place records if this record follows them directly, or  */
+/* NULL if the records must be copied to the I/O buffer instead, in  */
+/* which case those left in place so far are copied first.           */
+/*-------------------------------------------------------------------*/
+static BYTE* ckd_zero_copy ( DEVBLK *dev, BYTE *zc,
+                BYTE *iobuf, int size )
+{
+BYTE           *rec;                    /* -> Count field in image   */
+
+    rec = &dev->buf[ dev->bufoff - CKD_RECHDR_SIZE ];
+
+    /* First record: transfer in place if the channel permits it */
+    if (!size)
+        return dev->iobuf.zerocopy ? rec : NULL;
+
+    /* Continue in place while the records are contiguous */
+    if (!zc || zc + size == rec)
+        return zc;
+
+    /* Otherwise revert to copying the records */
+    memcpy (iobuf, zc, size);
+    return NULL;
+
+} /* end function ckd_zero_copy */
+
+
 /*-------------------------------------------------------------------*/
 /* Erase remainder of track                                          */
 /*-------------------------------------------------------------------*/
@@ -2380,6 +2503,7 @@ U16             head;                   /* Head number               */
 BYTE            cchhr[5];               /* Search argument           */
 BYTE            sector;                 /* Sector number             */
 BYTE            key[256];               /* Key for search operations */
+BYTE           *zc;                     /* -> Records left in place  */
 BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
 
 #define RMID    0X4E                    /* Dasd READ MESSAGE ID CCW  */
@@ -2731,9 +2855,19 @@ BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
         if (count < size) *more = 1;
         offset = 0;
 
-        /* Read data field */
-        rc = ckd_read_data (dev, code, iobuf, unitstat);
-        if (rc < 0) break;
+        /* Read data field, returning it in place if permitted
+           and the record does not overflow onto the next track */
+        if (dev->iobuf.zerocopy && !dev->ckdtrkof)
+        {
+            rc = ckd_read_data (dev, code, NULL, unitstat);
+            if (rc < 0) break;
+            dev->iobuf.zcdata = &dev->buf[dev->bufoff - dev->ckdcurdl];
+        }
+        else
+        {
+            rc = ckd_read_data (dev, code, iobuf, unitstat);
+            if (rc < 0) break;
+        }
 
         /* If track overflow, keep reading */
         while (dev->ckdtrkof)
@@ -3412,8 +3546,9 @@ BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
             break;
         }
 
-        /* Read records into the I/O buffer until end of track */
-        for (size = 0; ; )
+        /* Read records into the I/O buffer until end of track,
+           or leave them in place in the track image if possible */
+        for (zc = NULL, size = 0; ; )
         {
             /* Read next count field */
             rc = ckd_read_count (dev, code, &rechdr, unitstat);
@@ -3424,25 +3559,29 @@ BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
                 break;
 
             /* Copy count field to I/O buffer */
-            memcpy (iobuf + size, &rechdr, CKD_RECHDR_SIZE);
+            zc = ckd_zero_copy (dev, zc, iobuf, size);
+            if (!zc)
+                memcpy (iobuf + size, &rechdr, CKD_RECHDR_SIZE);
             size += CKD_RECHDR_SIZE;
 
             /* Turn off track overflow flag */
-            if(dev->ckdcyls < 32768)
+            if(!zc && dev->ckdcyls < 32768)
                 *(iobuf + size) &= 0x7F;
 
             /* Read key field */
-            rc = ckd_read_key (dev, code, iobuf + size, unitstat);
+            rc = ckd_read_key (dev, code, zc ? NULL : iobuf + size, unitstat);
             if (rc < 0) break;
             size += dev->ckdcurkl;
 
             /* Read data field */
-            rc = ckd_read_data (dev, code, iobuf + size, unitstat);
+            rc = ckd_read_data (dev, code, zc ? NULL : iobuf + size, unitstat);
             if (rc < 0) break;
             size += dev->ckdcurdl;
 
         } /* end for(size) */
 
+        dev->iobuf.zcdata = zc;
+
         /* Set the residual count */
         num = (count < size) ? count : size;
         *residual = count - num;
@@ -3509,19 +3648,22 @@ BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
         /* Shift read track set mask left a bit */
         dev->ckdlmask <<= 1;
 
-        /* Read each record on the track into the I/O buffer */
-        for (size = 0; ; )
+        /* Read each record on the track into the I/O buffer,
+           or leave them in place in the track image if possible */
+        for (zc = NULL, size = 0; ; )
         {
             /* Read next count field */
             rc = ckd_read_count (dev, code, &rechdr, unitstat);
             if (rc < 0) break;
 
             /* Copy count field to I/O buffer */
-            memcpy (iobuf + size, &rechdr, CKD_RECHDR_SIZE);
+            zc = ckd_zero_copy (dev, zc, iobuf, size);
+            if (!zc)
+                memcpy (iobuf + size, &rechdr, CKD_RECHDR_SIZE);
             size += CKD_RECHDR_SIZE;
 
             /* Turn off track overflow flag */
-            if(dev->ckdcyls < 32768)
+            if(!zc && dev->ckdcyls < 32768)
                 *(iobuf+size) &= 0x7F;
 
             /* Exit if end of track marker was read */
@@ -3529,17 +3671,19 @@ BYTE            trk_ovfl;               /* == 1 if track ovfl write  */
                 break;
 
             /* Read key field */
-            rc = ckd_read_key (dev, code, iobuf + size, unitstat);
+            rc = ckd_read_key (dev, code, zc ? NULL : iobuf + size, unitstat);
             if (rc < 0) break;
             size += dev->ckdcurkl;
 
             /* Read data field */
-            rc = ckd_read_data (dev, code, iobuf + size, unitstat);
+            rc = ckd_read_data (dev, code, zc ? NULL : iobuf + size, unitstat);
             if (rc < 0) break;
             size += dev->ckdcurdl;
 
         } /* end for(size) */
 
+        dev->iobuf.zcdata = zc;
+
         /* Set the residual count */
         num = (count < size) ? count : size;
         *residual = count - num;
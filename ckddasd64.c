@@ -125,6 +125,7 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     sfxchar = *sfxptr;
 
     /* process the remaining arguments */
+    dev->ckdmmap = 0;
     for (i = 1; i < argc; i++)
     {
         if (strcasecmp ("lazywrite", argv[i]) == 0)
@@ -172,6 +173,11 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
             dev->ckdfakewr = 1;
             continue;
         }
+        if (strcasecmp ("mmap", argv[i]) == 0)
+        {
+            dev->ckdmmap = 1;
+            continue;
+        }
         if (strlen (argv[i]) > 3 &&
             memcmp ("sf=", argv[i], 3) == 0)
         {
@@ -455,6 +461,17 @@ BYTE            serial[12+1] = {0};     /* Dasd serial number        */
     /* Restore the last character of the file name */
     *sfxptr = sfxchar;
 
+    /* Map the image files if requested (normal CKD files only) */
+    if (dev->ckdmmap && (cckd || dev->dasdcopy))
+        dev->ckdmmap = 0;
+    for (i = 0; dev->ckdmmap && i < dev->ckdnumfd; i++)
+    {
+        trks = dev->ckdhitrk[i] - (i ? dev->ckdhitrk[i-1] : 0);
+        if (!dasd_mmap( dev, i, dev->ckdfd[i], CKD_DEVHDR_SIZE +
+                        (U64) trks * dev->ckdtrksz, CKDTYP( cckd, 1 )))
+            dasd_munmap( dev );
+    }
+
     /* Locate the CKD dasd table entry */
     dev->ckdtab = dasd_lookup (DASD_CKDDEV, NULL, dev->devtype, dev->ckdcyls);
     if (dev->ckdtab == NULL)
@@ -117,6 +117,7 @@ static  CMDTAB   cmdtab[]  = {              /* (COMMAND table)       */
 /* Externally defined commands are defined/routed here               */
 /*-------------------------------------------------------------------*/
 
+  CALL_EXTCMD ( cachequota_cmd )            /* (lives in cache.c)    */
   CALL_EXTCMD ( cachestats_cmd )            /* (lives in cache.c)    */
   CALL_EXTCMD ( shrd_cmd       )            /* (lives in shared.c)   */
   CALL_EXTCMD ( ptt_cmd        )            /* (lives in pttrace.c)  */
@@ -202,7 +202,49 @@
   "should be set to. Enter the command without any operand to just display\n"   \
   "the current value of the BEAR register.\n"
 
+#define bbcache_cmd_desc        "Display or set basic-block cache options"
+#define bbcache_cmd_help        \
+                                \
+  "Format: \"bbcache  [ ON | OFF | nnnn | STATS | RESET ]\"\n"                  \
+  "\n"                                                                          \
+  "Enables or disables each CPU's basic-block cache. When enabled, each\n"      \
+  "CPU remembers the resolved instruction functions of short straight-line\n"   \
+  "runs of instructions it has recently executed (keyed by host address)\n"     \
+  "so they can be called directly without going through the opcode tables\n"   \
+  "again. Every instruction's opcode is re-verified before it is executed\n"    \
+  "so self-modifying programs are handled correctly.\n"                         \
+  "\n"                                                                          \
+  "ON enables the cache using the default number of blocks per CPU, and\n"      \
+  "nnnn enables it using the specified number of blocks, which must be a\n"    \
+  "power of 2 from " QSTR( MIN_BBCACHE_BLOCKS ) " to " QSTR( MAX_BBCACHE_BLOCKS ) ". OFF disables it (the default).\n"  \
+  "STATS displays each online CPU's hit, miss and invalidation counts and\n"   \
+  "RESET resets them. Enter the command without any arguments to display\n"    \
+  "the current setting.\n"
+
+#define cachequota_cmd_desc     "Display/Set device buffer cache quotas"
+#define cachequota_cmd_help     \
+                                \
+  "Format: \"cachequota [ccuu[-ccuu] | type=xxxx  min  max]\"\n"              \
+  "        \"cachequota reset\"\n"                                           \
+  "\n"                                                                          \
+  "Guarantees a group of devices at least 'min' and at most 'max' percent\n"   \
+  "of the device buffer cache shared by all ckd, fba, cckd and cfba\n"         \
+  "devices. The group is either a range of device numbers or all devices\n"    \
+  "of a device type, e.g. 'type=3390'. A device belongs to the first\n"        \
+  "matching quota. Shares are enforced when an entry is chosen to be\n"        \
+  "replaced; if no entry satisfies them the oldest one is used anyway.\n"      \
+  "'reset' removes all quotas. Without arguments the quotas are listed.\n"     \
+  "Use 'cachestats dev' to display each device's share and hit ratio.\n"
+
 #define cachestats_cmd_desc     "Cache stats command"
+#define cachestats_cmd_help     \
+                                \
+  "Format: \"cachestats [dev | all]\"\n"                                      \
+  "\n"                                                                          \
+  "Displays the statistics of each cache. 'dev' instead displays the\n"       \
+  "number of entries, share, hits, misses and hit ratio of each device\n"     \
+  "and the occupancy of each quota (see 'cachequota'). Any other argument\n"  \
+  "also displays every cache entry.\n"
 
 #define cckd_cmd_desc           "Compressed CKD command"
 #define cckd_cmd_help           \
@@ -218,8 +260,10 @@
   "                    single comma and no intervening blanks. The list of\n"   \
   "                    supported cckd options are:\n"                           \
                                                                          "\n"   \
-  "  comp=n        Override compression                  (-1,0,1,2)\n"          \
-  "  compparm=n    Override compression parm             (-1 ... 9)\n"          \
+  "  aio=n         Batch file I/O using io_uring           (0 or 1)\n"          \
+  "  cache2q=n     Scan resistant 2Q track cache           (0 or 1)\n"          \
+  "  comp=n        Override compression              (-1,0,1,2,4,8)\n"          \
+  "  compparm=n    Override compression parm            (-1 ... 22)\n"          \
   "  debug=n       Enable CCW tracing debug messages       (0 or 1)\n"          \
   "  dhint=n       Set Dasd Hardener interval (sec)     (0 ... 999)\n"          \
   "  dhstart=n     Start Dasd Hardener                     (0 or 1)\n"          \
@@ -229,6 +273,8 @@
   "  gcint=n       Set garbage collector interval (sec)  ( 0 .. 60)\n"          \
   "  gcmsgs=n      Display garbage collector messages      (0 or 1)\n"          \
   "  gcparm=n      Set garbage collector parameter       (-8 ... 8)\n"          \
+  "  gcrate=n      Max garbage collector KB/sec     (0 ... 1048576)\n"          \
+  "  gcslice=n     Max garbage collector msecs/slice   (0 ... 1000)\n"          \
   "  gcstart=n     Start garbage collector                 (0 or 1)\n"          \
   "  linuxnull=n   Check for null linux tracks             (0 or 1)\n"          \
   "  nosfd=n       Disable stats report at close           (0 or 1)\n"          \
@@ -237,7 +283,7 @@
   "  raq=n         Set readahead queue size              ( 0 .. 16)\n"          \
   "  rat=n         Set number tracks to read ahead       ( 0 .. 16)\n"          \
   "  trace=n       Set trace table size              (0 ... 200000)\n"          \
-  "  wr=n          Set number writer threads             ( 1 ... 9)\n"          \
+  "  wr=n          Set number writer threads             ( 1 .. 32)\n"          \
                                                                          "\n"   \
   "Refer to the Hercules CCKD documentation web page for more information.\n"
 
@@ -739,6 +785,27 @@
   "machine because we may present an I/O interrupt sooner than a\n"             \
   "real machine.\n"
 
+#define ioqueues_cmd_desc       "Display or set device I/O request queues"
+#define ioqueues_cmd_help       \
+                                \
+  "Format:  \"ioqueues  [ n | SPIN usecs | STATS | RESET ]\"\n\n"                \
+  "Specifies the number of I/O request queues device threads are\n"           \
+  "scheduled from. Each device is assigned to a queue by its first\n"          \
+  "CHPID, and each device thread has a home queue which it services\n"         \
+  "first, stealing work from the other queues only when its own queue\n"       \
+  "is empty. The default is 1, a single queue shared by all devices.\n"        \
+  "\n"                                                                          \
+  "SPIN specifies the number of microseconds an idle device thread\n"          \
+  "keeps polling the queues before waiting to be signalled (0 to 1000,\n"      \
+  "default 0). Spinning reduces I/O start latency at the cost of host\n"       \
+  "CPU time.\n"                                                                 \
+  "\n"                                                                          \
+  "STATS displays, for each queue, the number of requests queued, the\n"       \
+  "current and maximum queue depth, the number of requests stolen by\n"        \
+  "threads homed on other queues, and the average and maximum time in\n"       \
+  "microseconds a request waited before being started. RESET clears\n"         \
+  "the statistics.\n"
+
 #define ipending_cmd_desc       "Display pending interrupts"
 #define ipl_cmd_desc            "IPL from device or file"
 #define ipl_cmd_help            \
@@ -1117,6 +1184,25 @@
   "to display the current value. Use the'cpu' command beforehand to choose\n"   \
   "which processor's prefix register should be displayed or altered.\n"
 
+#define profile_cmd_desc        "Sampling instruction profiler"
+#define profile_cmd_help        \
+                                \
+  "Format: \"profile  [ ON [usecs] | OFF | RESET | TOP [n] | DUMP file [cpu] ]\"\n" \
+  "\n"                                                                          \
+  "Controls the sampling instruction profiler. When active, the timer thread\n" \
+  "samples each started CPU's current instruction every 'usecs' microseconds\n" \
+  "(default " QSTR( DEF_PROFILE_USECS ) ") and charges the host time elapsed since the previous\n" \
+  "sample to that instruction, its address and the CPU's state. The CPUs\n"     \
+  "themselves do no extra work, so the profiler may be left on if desired.\n"  \
+  "\n"                                                                          \
+  "ON starts sampling and OFF stops it, keeping the samples collected so far.\n" \
+  "RESET discards all samples. TOP displays the 'n' (default 20) instruction\n"  \
+  "functions that were charged the most host time over all CPUs. DUMP writes\n"  \
+  "the samples of all CPUs, or only of the specified (hex) CPU, to 'file' in\n"  \
+  "\"folded stack\" format (\"CPnn;state;function;mnemonic@address usecs\")\n"  \
+  "suitable for flame graph tools such as flamegraph.pl or speedscope.\n"      \
+  "Enter the command without any arguments to display the current setting.\n"
+
 #define psw_cmd_desc            "Display or alter program status word"
 #define psw_cmd_help            \
                                 \
@@ -1210,7 +1296,8 @@
 #define qeth_cmd_help           \
                                 \
   "Format:  \"QETH  DEBUG {ON|OFF}  [ [<devnum>|ALL] [mask ...] ]\"\n"          \
-  "         \"QETH  ADDR              [<devnum>|ALL]\"\n\n"                     \
+  "         \"QETH  ADDR              [<devnum>|ALL]\"\n"                       \
+  "         \"QETH  STATS             [<devnum>|ALL]\"\n\n"                     \
   "Enables/disables debug tracing for the QETH (OSA) device groups iden-\n"     \
   "tified by <devnum>, or for all QETH (OSA) device groups if <devnum> is\n"    \
   "not specified or specified as 'ALL', or displays all MAC addresses\n"        \
@@ -1218,7 +1305,9 @@
   "device groups if <devnum> is not specified or specified as 'ALL'.  The\n"    \
   "optional 'mask' value may be specified more than once. Mask values are\n"    \
   "'Ccw', 'DAta', 'DRopped', 'Expand', 'Interupts', 'Packet', 'Queues',\n"      \
-  "'SBale', 'SIga', 'Updown' or 0xhhhhhhhh hexadecimal value.\n"
+  "'SBale', 'SIga', 'Updown' or 0xhhhhhhhh hexadecimal value. 'STATS'\n"        \
+  "displays the packets received, sent and dropped on each TUNTAP queue\n"      \
+  "('mq' option) of the group(s), with the rates since the last display.\n"
 
 #define qpfkeys_cmd_desc        "Display the current PF Key settings"
 #define qpid_cmd_desc           "Display Process ID of Hercules"
@@ -1853,7 +1942,28 @@
   "in relationship to the actual process priority (nice value) of the\n"        \
   "Hercules process itself.\n"
 
-#define tlb_cmd_desc            "Display TLB tables"
+#define tlb_cmd_desc            "Display TLB tables or statistics"
+#define tlb_cmd_help            \
+                                \
+  "Format: \"tlb  [ STATS | RESET ]\"\n"                                       \
+  "\n"                                                                          \
+  "Enter the command without any arguments to display the current CPU's\n"     \
+  "TLB entries. STATS displays each online CPU's TLB hit and miss counts,\n"    \
+  "how many misses were satisfied from another way of a set-associative\n"     \
+  "TLB, how many times the entire TLB and how many times individual\n"         \
+  "entries were purged, and how many misses were satisfied from an EDAT\n"     \
+  "large-frame entry without a table walk. Hits are only counted when\n"      \
+  "Hercules is built with OPTION_TLB_HIT_COUNT.\n"                            \
+  "\n"                                                                          \
+  "It also displays how many other CPUs' TLBs each CPU's IPTE and IESBE\n"    \
+  "instructions had to purge of the invalidated entry, and how many they\n"   \
+  "left alone because their TLB could not hold it (purges avoided).\n"        \
+  "Purged CPUs whose shootdown filter was over half full have their\n"        \
+  "entire TLB purged (full filter flushes). RESET resets these statistics.\n" \
+  "\n"                                                                          \
+  "The TLB size and associativity are determined at build time by the\n"      \
+  "TLB_SETBITS and TLB_WAYS #defines, and the size of the shootdown filter\n" \
+  "by TLB_FILTER_BITS (see featall.h).\n"
 #define toddrag_cmd_desc        "Display or set TOD clock drag factor"
 #define traceopt_cmd_desc       "Instruction and/or CCW trace display option"
 #define traceopt_cmd_help       \
@@ -1991,8 +2101,10 @@ COMMAND( "b",                       trace_cmd,              SYSCMDNOPER,
 COMMAND( "b?",                      trace_cmd,              SYSCMDNOPER,        bquest_cmd_desc,        NULL                )
 COMMAND( "b+",                      trace_cmd,              SYSCMDNOPER,        bplus_cmd_desc,         NULL                )
 
+COMMAND( "bbcache",                 bbcache_cmd,            SYSCMDNOPER,        bbcache_cmd_desc,       bbcache_cmd_help    )
 COMMAND( "bear",                    bear_cmd,               SYSCMDNOPER,        bear_cmd_desc,          bear_cmd_help       )
-COMMAND( "cachestats",              EXTCMD(cachestats_cmd), SYSCMDNOPER,        cachestats_cmd_desc,    NULL                )
+COMMAND( "cachequota",              EXTCMD(cachequota_cmd), SYSCMDNOPER,        cachequota_cmd_desc,    cachequota_cmd_help )
+COMMAND( "cachestats",              EXTCMD(cachestats_cmd), SYSCMDNOPER,        cachestats_cmd_desc,    cachestats_cmd_help )
 COMMAND( "clocks",                  clocks_cmd,             SYSCMDNOPER,        clocks_cmd_desc,        NULL                )
 COMMAND( "codepage",                codepage_cmd,           SYSCMDNOPER,        codepage_cmd_desc,      codepage_cmd_help   )
 COMMAND( "conkpalv",                conkpalv_cmd,           SYSCMDNOPER,        conkpalv_cmd_desc,      conkpalv_cmd_help   )
@@ -2020,6 +2132,7 @@ COMMAND( "osa",                     qeth_cmd,               SYSCMDNOPER,
 COMMAND( "ostailor",                ostailor_cmd,           SYSCMDNOPER,        ostailor_cmd_desc,      ostailor_cmd_help   )
 COMMAND( "pgmtrace",                pgmtrace_cmd,           SYSCMDNOPER,        pgmtrace_cmd_desc,      pgmtrace_cmd_help   )
 COMMAND( "pr",                      pr_cmd,                 SYSCMDNOPER,        pr_cmd_desc,            pr_cmd_help         )
+COMMAND( "profile",                 profile_cmd,            SYSCMDNOPER,        profile_cmd_desc,       profile_cmd_help    )
 COMMAND( "psw",                     psw_cmd,                SYSCMDNOPER,        psw_cmd_desc,           psw_cmd_help        )
 COMMAND( "ptp",                     ptp_cmd,                SYSCMDNOPER,        ptp_cmd_desc,           ptp_cmd_help        )
 COMMAND( "ptt",                     EXTCMD( ptt_cmd ),      SYSCMDNOPER,        ptt_cmd_desc,           ptt_cmd_help        )
@@ -2050,7 +2163,7 @@ COMMAND( "txf",                     txf_cmd,                SYSCMDNOPER,
 #endif
 COMMAND( "t+-",                     auto_trace_cmd,         SYSCMDNOPER,        auto_trace_desc,        auto_trace_help     )
 COMMAND( "timerint",                timerint_cmd,           SYSCMDNOPER,        timerint_cmd_desc,      timerint_cmd_help   )
-COMMAND( "tlb",                     tlb_cmd,                SYSCMDNOPER,        tlb_cmd_desc,           NULL                )
+COMMAND( "tlb",                     tlb_cmd,                SYSCMDNOPER,        tlb_cmd_desc,           tlb_cmd_help        )
 COMMAND( "toddrag",                 toddrag_cmd,            SYSCMDNOPER,        toddrag_cmd_desc,       NULL                )
 COMMAND( "traceopt",                traceopt_cmd,           SYSCMDNOPER,        traceopt_cmd_desc,      traceopt_cmd_help   )
 COMMAND( "u",                       u_cmd,                  SYSCMDNOPER,        u_cmd_desc,             u_cmd_help          )
@@ -2200,6 +2313,7 @@ COMMAND( "icount",                  icount_cmd,             SYSCMDNOPER,
 #if defined( OPTION_IODELAY_KLUDGE )
 COMMAND( "iodelay",                 iodelay_cmd,            SYSCMDNOPER,        iodelay_cmd_desc,       iodelay_cmd_help    )
 #endif
+COMMAND( "ioqueues",                ioqueues_cmd,           SYSCONFIG,          ioqueues_cmd_desc,      ioqueues_cmd_help   )
 COMMAND( "pgmprdos",                pgmprdos_cmd,           SYSCFGNDIAG8,       pgmprdos_cmd_desc,      pgmprdos_cmd_help   )
 COMMAND( "maxrates",                maxrates_cmd,           SYSCMD,             maxrates_cmd_desc,      maxrates_cmd_help   )
 #if defined( OPTION_SCSI_TAPE )
@@ -905,12 +905,7 @@ int     cpu;
         }
 
     /* Terminate device threads */
-    OBTAIN_IOQLOCK();
-    {
-        sysblk.devtwait = 0;
-        broadcast_condition( &sysblk.ioqcond );
-    }
-    RELEASE_IOQLOCK();
+    signal_device_threads();
 
     /* release storage          */
     sysblk.lock_mainstor = 0;
@@ -3739,6 +3739,7 @@ int     rc;                             /* return code from load_psw */
 
     /* Now INVALIDATE ALL TLB ENTRIES in our working copy.. */
     memset( &newregs.tlb.vaddr, 0, TLBN * sizeof(DW) );
+    memset( &newregs.tlb.lfid,  0, sizeof( newregs.tlb.lfid ));
     newregs.tlbID = 1;
 
     /* Set the breaking event address register in the copy */
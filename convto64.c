@@ -150,6 +150,10 @@ static void cdevhdr_to_64()
 
         icdevhdr.cmp_algo     = icdevhdr32.cmp_algo;
         icdevhdr.cmp_parm     = icdevhdr32.cmp_parm;
+
+        icdevhdr.dict_off     = icdevhdr32.dict_off;
+        icdevhdr.dict_len     = icdevhdr32.dict_len;
+        icdevhdr.dict_algo    = icdevhdr32.dict_algo;
     }
 }
 static void L1tab_to_64()
@@ -716,6 +720,38 @@ CKD_DEVHDR      devhdr;                 /* Device header             */
     // "%"PRIu32" tracks copied"
     WRMSG( HHC02957, "I", tracks_copied );
 
+    /* Copy the compression dictionary too, if there is one,
+       since images compressed with it can't be read without it */
+    if (icdevhdr.dict_len && icdevhdr.dict_len <= sizeof( trkbuf ))
+    {
+        if (0
+            || (ocdevhdr.dict_off = lseek( ofd, 0, SEEK_CUR )) == (U64) -1
+            || lseek( ifd, icdevhdr.dict_off, SEEK_SET ) < 0
+        )
+        {
+            // "Error in function %s: %s"
+            FWRMSG( stderr, HHC02958, "E", "lseek()", strerror( errno ));
+            return -1;
+        }
+        size = icdevhdr.dict_len;
+        if ((rc = read( ifd, trkbuf, size )) < (int) size)
+        {
+            // "Error in function %s: %s"
+            FWRMSG( stderr, HHC02958, "E", "read()", strerror( errno ));
+            return -1;
+        }
+        if ((rc = write( ofd, trkbuf, size )) < (int) size)
+        {
+            // "Error in function %s: %s"
+            FWRMSG( stderr, HHC02958, "E", "write()", strerror( errno ));
+            return -1;
+        }
+        ocdevhdr.dict_len  = icdevhdr.dict_len;
+        ocdevhdr.dict_algo = icdevhdr.dict_algo;
+    }
+    else
+        ocdevhdr.cdh_opts &= ~CCKD_OPT_DICT;
+
     /* Now that all of the output file's data has been written,
        save the current file position as the output file's size.
     */
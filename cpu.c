@@ -1692,12 +1692,44 @@ RADR    fsta;                           /* Failing storage address   */
 /*-------------------------------------------------------------------*/
 void (ATTR_REGPARM(1) ARCH_DEP(process_interrupt))(REGS *regs)
 {
+    bool io_open = false;
+
     /* Process PER program interrupts */
     if( OPEN_IC_PER(regs) )
         regs->program_interrupt (regs, PGM_PER_EVENT);
 
-    /* Obtain the interrupt lock */
-    OBTAIN_INTLOCK(regs);
+    /* Fast path: an I/O interrupt is the only thing pending for a
+       running, enabled CPU. I/O pending is posted by the device
+       threads without IC_INTERRUPT (see ON_IC_IOPENDING), so this
+       can be checked without the interrupt lock, but the interrupt
+       is still presented holding it: TSCH, TPI and the other CPUs
+       presenting I/O interrupts are serialized by it. If nothing
+       can be presented we carry on with the normal path, which
+       then already holds the lock. */
+    if (1
+        && regs->cpustate == CPUSTATE_STARTED
+        && (regs->ints_state & regs->ints_mask) == BIT( IC_IO )
+        && !IS_IC_INTERRUPT( regs )
+        && !WAITSTATE( &regs->psw )
+        && !regs->invalidate
+        && !SIE_MODE( regs )
+#if defined( FEATURE_073_TRANSACT_EXEC_FACILITY )
+        && !regs->txf_tnd
+#endif
+        && IS_IC_IOPENDING
+    )
+    {
+        OBTAIN_INTLOCK(regs);
+        regs->breakortrace = (sysblk.instbreak || (sysblk.insttrace && regs->insttrace));
+        INVALIDATE_AIA(regs);
+        PERFORM_SERIALIZATION( regs );
+        PERFORM_CHKPT_SYNC( regs );
+        ARCH_DEP( perform_io_interrupt )( regs );
+    }
+    else
+        /* Obtain the interrupt lock */
+        OBTAIN_INTLOCK(regs);
+
     OFF_IC_INTERRUPT(regs);
     regs->breakortrace = (sysblk.instbreak || (sysblk.insttrace && regs->insttrace));
 
@@ -1737,6 +1769,7 @@ void (ATTR_REGPARM(1) ARCH_DEP(process_interrupt))(REGS *regs)
         }
 
         /* Process I/O interrupt */
+        io_open = OPEN_IC_IOPENDING( regs );
         if (IS_IC_IOPENDING)
         {
             if (1
@@ -1835,7 +1868,12 @@ cpustate_stopping:
         CPU_Wait(regs);
 
         sysblk.started_mask |= regs->cpubit;
-        regs->ints_state |= sysblk.ints_state;
+
+        /* I/O pending may be posted without the interrupt lock: make
+           our started bit visible before picking up sysblk's state
+           (see set_ic_iopending) so that one of us sees the other */
+        atomic_fence();
+        IC_STATE_ON( &regs->ints_state, sysblk.ints_state );
         set_cpu_timer(regs,saved_timer);
 
         ON_IC_INTERRUPT(regs);
@@ -1888,9 +1926,13 @@ cpustate_stopping:
             longjmp( regs->progjmp, SIE_NO_INTERCEPT );
         }
 
-        /* Indicate waiting and invoke CPU wait */
+        /* Indicate waiting and invoke CPU wait. I/O pending may have
+           been posted without the interrupt lock since we last looked,
+           in which case the poster may have missed our waiting bit. */
         sysblk.waiting_mask |= regs->cpubit;
-        CPU_Wait(regs);
+        atomic_fence();
+        if (io_open || !OPEN_IC_IOPENDING( regs ))
+            CPU_Wait(regs);
 
         /* Turn off the waiting bit .
          *
@@ -1919,6 +1961,131 @@ cpustate_stopping:
 
 } /* process_interrupt */
 
+/*-------------------------------------------------------------------*/
+/* Basic-block cache: (re)allocate or flush this CPU's cache         */
+/*-------------------------------------------------------------------*/
+/* Called whenever regs->bbcgen no longer matches sysblk.bbcgen, as  */
+/* happens when the BBCACHE setting is changed or when an opcode is  */
+/* replaced, as well as whenever run_cpu is (re)entered, such as is  */
+/* done following an architecture mode switch.                       */
+/*-------------------------------------------------------------------*/
+static void ARCH_DEP( bbcache_reset )( REGS* regs )
+{
+    U32  blocks  = sysblk.bbcache;
+
+    regs->bbcgen = sysblk.bbcgen;
+
+    /* Discard the existing cache if disabled or its size changed */
+    if (regs->bbcblk && (!blocks || (regs->bbcmask + 1) != blocks))
+    {
+        free_aligned( regs->bbcblk );
+        regs->bbcblk  = NULL;
+        regs->bbcmask = 0;
+    }
+
+    if (!blocks)
+        return;
+
+    if (regs->bbcblk)
+    {
+        memset( regs->bbcblk, 0, blocks * sizeof( BBCBLK ));
+        return;
+    }
+
+    if (!(regs->bbcblk = calloc_aligned( blocks * sizeof( BBCBLK ), 64 )))
+    {
+        char buf[40];
+        MSGBUF( buf, "calloc(%d)", (int)(blocks * sizeof( BBCBLK )));
+        // "Processor %s%02X: error in function %s: %s"
+        WRMSG( HHC00813, "E", PTYPSTR( regs->cpuad ), regs->cpuad, buf, strerror( errno ));
+        return;
+    }
+
+    regs->bbcmask = blocks - 1;
+}
+
+/*-------------------------------------------------------------------*/
+/* Basic-block cache: decode a new block starting at 'ip'            */
+/*-------------------------------------------------------------------*/
+/* Resolves each instruction's final instruction function up front,  */
+/* thereby avoiding both the primary and secondary opcode table jump */
+/* each time the block is subsequently executed. Decoding stops at   */
+/* the end of the current instruction page (regs->aie).              */
+/*-------------------------------------------------------------------*/
+static void ARCH_DEP( bbcache_build )( REGS* regs, BBCBLK* blk, BYTE* ip )
+{
+    BBCINST*  bi;
+    int       n;
+
+    for (n=0, bi = blk->inst; n < BBC_MAX_INSTR && ip < regs->aie; n++, bi++)
+    {
+        bi->func    = ARCH_DEP( resolve_opcode )( regs, ip, &bi->xop );
+        bi->opcode  = fetch_hw( ip );
+        bi->xopcode = ip[5];
+        bi->ilc     = ILC( ip[0] );
+        ip += bi->ilc;
+    }
+
+    blk->count = n;
+}
+
+/*-------------------------------------------------------------------*/
+/* Basic-block cache: execute the block starting at regs->ip         */
+/*-------------------------------------------------------------------*/
+/* Returns false if regs->ip is outside the current instruction page */
+/* (i.e. the same condition which ends the UNROLLED_EXECUTE loop),   */
+/* true otherwise. The number of instructions actually executed is   */
+/* accumulated in regs->bbcexecd. Each instruction's opcode is again */
+/* compared before it is executed so that instructions modified by   */
+/* the program (or by I/O) are never executed from a stale block.    */
+/*-------------------------------------------------------------------*/
+static INLINE bool ARCH_DEP( bbcache_execute )( REGS* regs )
+{
+    BYTE*     ip  = regs->ip;
+    BBCBLK*   blk;
+    BBCINST*  bi;
+    int       n;
+
+    if (ip >= regs->aie)
+        return false;
+
+    blk = &regs->bbcblk[ ((uintptr_t) ip >> 1) & regs->bbcmask ];
+
+    if (likely( blk->ip == ip ))
+        regs->bbchits++;
+    else
+    {
+        regs->bbcmisses++;
+        ARCH_DEP( bbcache_build )( regs, blk, ip );
+        blk->ip = ip;
+    }
+
+    for (n=0, bi = blk->inst; n < blk->count; n++, bi++)
+    {
+        /* Leave block if branch taken or instruction page changed */
+        if (n && (regs->ip != ip || ip >= regs->aie))
+            break;
+
+        if (unlikely( fetch_hw( ip ) != bi->opcode ||
+                     (bi->xop && ip[5] != bi->xopcode) ))
+        {
+            blk->ip = NULL;
+            regs->bbcinvals++;
+            break;
+        }
+
+        FOOTPRINT( ip, regs );
+        BEG_COUNT_INSTR( ip, regs );
+        bi->func( ip, regs );
+        END_COUNT_INSTR( ip, regs );
+
+        regs->bbcexecd++;
+        ip += bi->ilc;
+    }
+
+    return true;
+}
+
 /*-------------------------------------------------------------------*/
 /* Run CPU                                                           */
 /*-------------------------------------------------------------------*/
@@ -1982,7 +2149,8 @@ int     aswitch;
     regs->program_interrupt = &ARCH_DEP(program_interrupt);
 
     regs->breakortrace = (sysblk.instbreak || (sysblk.insttrace && regs->insttrace));
-    regs->ints_state |= sysblk.ints_state;
+    atomic_fence();
+    IC_STATE_ON( &regs->ints_state, sysblk.ints_state );
 
     /* Establish longjmp destination for cpu thread exit */
     if (setjmp(regs->exitjmp))
@@ -2023,6 +2191,9 @@ int     aswitch;
     /* Initialize Transactional-Execution Facility */
     TXF_ALLOCMAP( regs );
 
+    /* Initialize Basic-block cache */
+    ARCH_DEP( bbcache_reset )( regs );
+
     /* Get pointer to primary opcode table */
     current_opcode_table = regs->ARCH_DEP( runtime_opcode_xxxx );
 
@@ -2042,8 +2213,9 @@ int     aswitch;
            to here, thereby causing the instruction counter to not be
            properly updated. Thus, we need to update it here instead.
        */
-        regs->instcount   +=     (i * 2);
-        UPDATE_SYSBLK_INSTCOUNT( (i * 2) );
+        regs->instcount   +=     (i * 2) + regs->bbcexecd;
+        UPDATE_SYSBLK_INSTCOUNT( (i * 2) + regs->bbcexecd );
+        regs->bbcexecd = 0;
 
         /* Perform automatic instruction tracing if it's enabled */
         DO_AUTOMATIC_TRACING();
@@ -2089,6 +2261,9 @@ fastest_no_txf_loop:
     if (INTERRUPT_PENDING( regs ))
         ARCH_DEP( process_interrupt )( regs );
 
+    if (unlikely( regs->bbcgen != sysblk.bbcgen ))
+        ARCH_DEP( bbcache_reset )( regs );
+
 enter_fastest_no_txf_loop:
 
     ip = INSTRUCTION_FETCH( regs, 0 );
@@ -2097,13 +2272,26 @@ enter_fastest_no_txf_loop:
     regs->instcount++;
     UPDATE_SYSBLK_INSTCOUNT( 1 );
 
-    for (i=0; i < MAX_CPU_LOOPS/2; i++)
+    if (regs->bbcblk)
     {
-        UNROLLED_EXECUTE( current_opcode_table, regs );
-        UNROLLED_EXECUTE( current_opcode_table, regs );
+        /* Use the basic-block cache instead of the opcode table */
+        i = 0;
+        while (regs->bbcexecd < MAX_CPU_LOOPS
+            && ARCH_DEP( bbcache_execute )( regs ));
+        regs->instcount   +=     regs->bbcexecd;
+        UPDATE_SYSBLK_INSTCOUNT( regs->bbcexecd );
+        regs->bbcexecd = 0;
+    }
+    else
+    {
+        for (i=0; i < MAX_CPU_LOOPS/2; i++)
+        {
+            UNROLLED_EXECUTE( current_opcode_table, regs );
+            UNROLLED_EXECUTE( current_opcode_table, regs );
+        }
+        regs->instcount   +=     (i * 2);
+        UPDATE_SYSBLK_INSTCOUNT( (i * 2) );
     }
-    regs->instcount   +=     (i * 2);
-    UPDATE_SYSBLK_INSTCOUNT( (i * 2) );
 
     /* Perform automatic instruction tracing if it's enabled */
     DO_AUTOMATIC_TRACING();
@@ -2583,6 +2771,8 @@ static void *cpu_uninit (int cpu, REGS *regs)
 
     /* Free the REGS structure */
     TXF_FREEMAP( regs );
+    if (regs->bbcblk)
+        free_aligned( regs->bbcblk );
     free_aligned( regs );
 
     return NULL;
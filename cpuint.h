@@ -276,18 +276,23 @@
 /*
  * State bits indicate what interrupts are possibly pending
  * for a CPU.  These bits can be set by any thread and therefore
- * are serialized by the `intlock'.
+ * are always updated atomically: most updates are additionally
+ * serialized by the `intlock', but I/O pending is posted by the
+ * device threads while holding only `iointqlk' (see channel.c).
  * For PER, the state bits are set when CR9 is loaded and the mask
  * bits are set when a PER event occurs
  */
 
+#define IC_STATE_ON(  _p, _bits )   atomic_or32(  (_p),  (U32)(_bits) )
+#define IC_STATE_OFF( _p, _bits )   atomic_and32( (_p), ~(U32)(_bits) )
+
 #define SET_IC_TRACE \
  do { \
    int i; \
    CPU_BITMAP mask = sysblk.started_mask; \
    for (i = 0; mask; i++) { \
      if (mask & 1) \
-       sysblk.regs[i]->ints_state |= BIT(IC_INTERRUPT); \
+       IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_INTERRUPT) ); \
      mask >>= 1; \
    } \
  } while (0)
@@ -299,8 +304,9 @@
 */
 #define SET_IC_PER(_regs) \
  do { \
-  (_regs)->ints_state &= (~IC_PER_MASK); \
-  (_regs)->ints_state |= (((_regs)->CR(9) >> IC_CR9_SHIFT) & IC_PER_MASK); \
+  U32 per = ((_regs)->CR(9) >> IC_CR9_SHIFT) & IC_PER_MASK; \
+  IC_STATE_OFF( &(_regs)->ints_state, IC_PER_MASK & ~per ); \
+  IC_STATE_ON( &(_regs)->ints_state, per ); \
   (_regs)->ints_mask  &= (~IC_PER_MASK | (_regs)->ints_state); \
  } while (0)
 
@@ -310,57 +316,41 @@
 
 #define ON_IC_INTERRUPT(_regs) \
  do { \
-   (_regs)->ints_state |=  BIT(IC_INTERRUPT); \
+   IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) ); \
  } while (0)
 
 #define ON_IC_RESTART(_regs) \
  do { \
-   (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_RESTART); \
+   IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_RESTART) ); \
  } while (0)
 
 #define ON_IC_STORSTAT(_regs) \
  do { \
-   (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_STORSTAT); \
+   IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_STORSTAT) ); \
  } while (0)
 
+/* I/O pending is signalled through IC_IO alone, which is part of the
+   mask of every CPU enabled for I/O interrupts, so that a CPU can tell
+   an I/O interrupt (which it may take without the interrupt lock)
+   apart from an IC_INTERRUPT request to come and look (SIGP, sync,
+   tracing) which must be handled under the interrupt lock. */
 #define ON_IC_IOPENDING \
  do { \
-   REGS *regs; \
-   CPU_BITMAP mask = sysblk.started_mask; \
-   CPU_BITMAP wake; \
-   int i; \
-   if ( !(sysblk.ints_state & BIT(IC_IO)) ) \
-   { \
-     sysblk.ints_state |= BIT(IC_IO); \
-     wake = mask; \
-     for (i = 0; mask; mask >>= 1, ++i) \
-     { \
-       if (mask & 1) \
-       { \
-         regs = sysblk.regs[i]; \
-         if ( regs->ints_mask & BIT(IC_IO) ) \
-           regs->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_IO); \
-         else \
-           regs->ints_state |= BIT(IC_IO), \
-           wake ^= regs->cpubit; \
-       } \
-     } \
-     WAKEUP_CPU_MASK(wake); \
-   } \
+   WAKEUP_CPU_MASK( set_ic_iopending() ); \
  } while (0)
 
 #define ON_IC_CHANRPT \
  do { \
    int i; CPU_BITMAP mask; \
    if ( !(sysblk.ints_state & BIT(IC_CHANRPT)) ) { \
-     sysblk.ints_state |=  BIT(IC_CHANRPT); \
+     IC_STATE_ON( &sysblk.ints_state, BIT(IC_CHANRPT) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) { \
          if ( sysblk.regs[i]->ints_mask & BIT(IC_CHANRPT) ) \
-           sysblk.regs[i]->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_CHANRPT); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_INTERRUPT) | BIT(IC_CHANRPT) ); \
          else \
-           sysblk.regs[i]->ints_state |= BIT(IC_CHANRPT); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_CHANRPT) ); \
        } \
        mask >>= 1; \
      } \
@@ -371,14 +361,14 @@
  do { \
    int i; CPU_BITMAP mask; \
    if ( !(sysblk.ints_state & BIT(IC_INTKEY)) ) { \
-     sysblk.ints_state |= BIT(IC_INTKEY); \
+     IC_STATE_ON( &sysblk.ints_state, BIT(IC_INTKEY) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) { \
          if ( sysblk.regs[i]->ints_mask & BIT(IC_INTKEY) ) \
-           sysblk.regs[i]->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_INTKEY); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_INTERRUPT) | BIT(IC_INTKEY) ); \
          else \
-           sysblk.regs[i]->ints_state |=  BIT(IC_INTKEY); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_INTKEY) ); \
        } \
        mask >>= 1; \
      } \
@@ -389,14 +379,14 @@
  do { \
    int i; CPU_BITMAP mask; \
    if ( !(sysblk.ints_state & BIT(IC_SERVSIG)) ) { \
-     sysblk.ints_state |= BIT(IC_SERVSIG); \
+     IC_STATE_ON( &sysblk.ints_state, BIT(IC_SERVSIG) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) { \
          if ( sysblk.regs[i]->ints_mask & BIT(IC_SERVSIG) ) \
-           sysblk.regs[i]->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_SERVSIG); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_INTERRUPT) | BIT(IC_SERVSIG) ); \
          else \
-           sysblk.regs[i]->ints_state |= BIT(IC_SERVSIG); \
+           IC_STATE_ON( &sysblk.regs[i]->ints_state, BIT(IC_SERVSIG) ); \
          } \
        mask >>= 1; \
      } \
@@ -406,57 +396,57 @@
 #define ON_IC_ITIMER(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_ITIMER) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_ITIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_ITIMER) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_ITIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_ITIMER) ); \
  } while (0)
 
 #define ON_IC_PTIMER(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_PTIMER) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_PTIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_PTIMER) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_PTIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_PTIMER) ); \
  } while (0)
 
 #define ON_IC_ECPSVTIMER(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_ECPSVTIMER) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_ECPSVTIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_ECPSVTIMER) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_ECPSVTIMER); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_ECPSVTIMER) ); \
  } while (0)
 
 #define ON_IC_CLKC(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_CLKC) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_CLKC); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_CLKC) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_CLKC); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_CLKC) ); \
  } while (0)
 
 #define ON_IC_EXTCALL(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_EXTCALL) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_EXTCALL); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_EXTCALL) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_EXTCALL); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_EXTCALL) ); \
  } while (0)
 
 #define ON_IC_MALFALT(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_MALFALT) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_MALFALT); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_MALFALT) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_MALFALT); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_MALFALT) ); \
  } while (0)
 
 #define ON_IC_EMERSIG(_regs) \
  do { \
    if ( (_regs)->ints_mask & BIT(IC_EMERSIG) ) \
-     (_regs)->ints_state |= BIT(IC_INTERRUPT) | BIT(IC_EMERSIG); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_INTERRUPT) | BIT(IC_EMERSIG) ); \
    else \
-     (_regs)->ints_state |= BIT(IC_EMERSIG); \
+     IC_STATE_ON( &(_regs)->ints_state, BIT(IC_EMERSIG) ); \
  } while (0)
 
     /*
@@ -517,28 +507,28 @@
 
 #define OFF_IC_INTERRUPT(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_INTERRUPT); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_INTERRUPT) ); \
  } while (0)
 
 #define OFF_IC_RESTART(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_RESTART); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_RESTART) ); \
  } while (0)
 
 #define OFF_IC_STORSTAT(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_STORSTAT); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_STORSTAT) ); \
  } while (0)
 
 #define OFF_IC_IOPENDING \
  do { \
    int i; CPU_BITMAP mask; \
    if ( sysblk.ints_state & BIT(IC_IO) ) { \
-     sysblk.ints_state &= ~BIT(IC_IO); \
+     IC_STATE_OFF( &sysblk.ints_state, BIT(IC_IO) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) \
-         sysblk.regs[i]->ints_state &= ~BIT(IC_IO); \
+         IC_STATE_OFF( &sysblk.regs[i]->ints_state, BIT(IC_IO) ); \
        mask >>= 1; \
      } \
    } \
@@ -548,11 +538,11 @@
  do { \
    int i; CPU_BITMAP mask; \
    if ( sysblk.ints_state & BIT(IC_CHANRPT) ) { \
-     sysblk.ints_state &= ~BIT(IC_CHANRPT); \
+     IC_STATE_OFF( &sysblk.ints_state, BIT(IC_CHANRPT) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) \
-         sysblk.regs[i]->ints_state &= ~BIT(IC_CHANRPT); \
+         IC_STATE_OFF( &sysblk.regs[i]->ints_state, BIT(IC_CHANRPT) ); \
        mask >>= 1; \
      } \
    } \
@@ -562,11 +552,11 @@
  do { \
    int i; CPU_BITMAP mask; \
    if ( sysblk.ints_state & BIT(IC_INTKEY) ) { \
-     sysblk.ints_state &= ~BIT(IC_INTKEY); \
+     IC_STATE_OFF( &sysblk.ints_state, BIT(IC_INTKEY) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) \
-         sysblk.regs[i]->ints_state &= ~BIT(IC_INTKEY); \
+         IC_STATE_OFF( &sysblk.regs[i]->ints_state, BIT(IC_INTKEY) ); \
        mask >>= 1; \
      } \
    } \
@@ -576,11 +566,11 @@
  do { \
    int i; CPU_BITMAP mask; \
    if ( sysblk.ints_state & BIT(IC_SERVSIG) ) { \
-     sysblk.ints_state &= ~BIT(IC_SERVSIG); \
+     IC_STATE_OFF( &sysblk.ints_state, BIT(IC_SERVSIG) ); \
      mask = sysblk.started_mask; \
      for (i = 0; mask; i++) { \
        if (mask & 1) \
-         sysblk.regs[i]->ints_state &= ~BIT(IC_SERVSIG); \
+         IC_STATE_OFF( &sysblk.regs[i]->ints_state, BIT(IC_SERVSIG) ); \
        mask >>= 1; \
      } \
    } \
@@ -588,37 +578,37 @@
 
 #define OFF_IC_ITIMER(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_ITIMER); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_ITIMER) ); \
  } while (0)
 
 #define OFF_IC_PTIMER(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_PTIMER); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_PTIMER) ); \
  } while (0)
 
 #define OFF_IC_ECPSVTIMER(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_ECPSVTIMER); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_ECPSVTIMER) ); \
  } while (0)
 
 #define OFF_IC_CLKC(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_CLKC); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_CLKC) ); \
  } while (0)
 
 #define OFF_IC_EXTCALL(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_EXTCALL); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_EXTCALL) ); \
  } while (0)
 
 #define OFF_IC_MALFALT(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_MALFALT); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_MALFALT) ); \
  } while (0)
 
 #define OFF_IC_EMERSIG(_regs) \
  do { \
-   (_regs)->ints_state &= ~BIT(IC_EMERSIG); \
+   IC_STATE_OFF( &(_regs)->ints_state, BIT(IC_EMERSIG) ); \
  } while (0)
 
 #define OFF_IC_PER(_regs) \
@@ -555,7 +555,10 @@ DUT_DLL_IMPORT bool valid_dsname( const char* dsname );
 
 DUT_DLL_IMPORT int ckd_tracklen( DEVBLK* dev, BYTE* buf );
 
-int cdsk_valid_trk( int trk, BYTE* buf, int heads, int len );
+DUT_DLL_IMPORT bool dasd_mmap( DEVBLK* dev, int f, int fd, U64 len, const char* typ );
+DUT_DLL_IMPORT void dasd_munmap( DEVBLK* dev );
+
+int cdsk_valid_trk( int trk, BYTE* buf, int heads, int len, CCKD_DICT* dict );
 
 #define DEFAULT_FBA_TYPE    0x3370
 
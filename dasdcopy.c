@@ -122,6 +122,14 @@ char            pathname[MAX_PATH];     /* file path in host format  */
 #ifdef CCKD_COMPRESS_BZIP2
         else if (strcmp(argv[0], "-bz2") == 0)
             comp = CCKD_COMPRESS_BZIP2;
+#endif
+#if defined( CCKD_ZSTD )
+        else if (strcmp(argv[0], "-zstd") == 0)
+            comp = CCKD_COMPRESS_ZSTD;
+#endif
+#if defined( CCKD_LZ4 )
+        else if (strcmp(argv[0], "-lz4") == 0)
+            comp = CCKD_COMPRESS_LZ4;
 #endif
         else if (strcmp(argv[0], "-0") == 0)
             comp = CCKD_COMPRESS_NONE;
@@ -610,14 +618,20 @@ int syntax( const char* pgm, const char* msgfmt, ... )
 {
     int zlib  = 0;
     int bzip2 = 0;
+    int zstd  = 0;
+    int lz4   = 0;
     int lfs   = 0;
 
     char zbuf  [80];
     char bzbuf [80];
+    char zsbuf [80];
+    char lzbuf [80];
     char lfsbuf[80];
 
     zbuf  [0] = 0;
     bzbuf [0] = 0;
+    zsbuf [0] = 0;
+    lzbuf [0] = 0;
     lfsbuf[0] = 0;
 
     /* Show them their syntax error... */
@@ -655,6 +669,14 @@ int syntax( const char* pgm, const char* msgfmt, ... )
     bzip2 = 1;
 #endif
 
+#if defined( CCKD_ZSTD )
+    zstd = 1;
+#endif
+
+#if defined( CCKD_LZ4 )
+    lz4 = 1;
+#endif
+
     if (sizeof(off_t) > 4)
         lfs = 1;
 
@@ -666,6 +688,8 @@ int syntax( const char* pgm, const char* msgfmt, ... )
 
 #define Z_HELP     "  -z       compress using zlib [default]"
 #define BZ_HELP    "  -bz2     compress using bzip2"
+#define ZS_HELP    "  -zstd    compress using zstd"
+#define LZ_HELP    "  -lz4     compress using lz4"
 #define LFS_HELP   "  -lfs     create single large output file"
 
     /* Display help information... */
@@ -673,7 +697,9 @@ int syntax( const char* pgm, const char* msgfmt, ... )
     {
         if (zlib)  MSGBUF(  zbuf, "%s%s\n", HHC02435I,  Z_HELP );
         if (bzip2) MSGBUF( bzbuf, "%s%s\n", HHC02435I, BZ_HELP );
-        WRMSG(                              HHC02435, "I", zbuf, bzbuf );
+        if (zstd)  MSGBUF( zsbuf, "%s%s\n", HHC02435I, ZS_HELP );
+        if (lz4)   MSGBUF( lzbuf, "%s%s\n", HHC02435I, LZ_HELP );
+        WRMSG(                              HHC02435, "I", zbuf, bzbuf, zsbuf, lzbuf );
     }
     else if (strcasecmp( pgm,             "cckd2ckd"     ) == 0)
     {
@@ -684,7 +710,9 @@ int syntax( const char* pgm, const char* msgfmt, ... )
     {
         if (zlib)  MSGBUF(  zbuf, "%s%s\n", HHC02437I,  Z_HELP );
         if (bzip2) MSGBUF( bzbuf, "%s%s\n", HHC02437I, BZ_HELP );
-        WRMSG(                              HHC02437, "I", zbuf, bzbuf );
+        if (zstd)  MSGBUF( zsbuf, "%s%s\n", HHC02437I, ZS_HELP );
+        if (lz4)   MSGBUF( lzbuf, "%s%s\n", HHC02437I, LZ_HELP );
+        WRMSG(                              HHC02437, "I", zbuf, bzbuf, zsbuf, lzbuf );
     }
     else if (strcasecmp( pgm,             "cfba2fba"     ) == 0)
     {
@@ -695,8 +723,10 @@ int syntax( const char* pgm, const char* msgfmt, ... )
     {
         if (zlib)  MSGBUF(   zbuf, "%s%s\n", HHC02439I,   Z_HELP );
         if (bzip2) MSGBUF(  bzbuf, "%s%s\n", HHC02439I,  BZ_HELP );
+        if (zstd)  MSGBUF(  zsbuf, "%s%s\n", HHC02439I,  ZS_HELP );
+        if (lz4)   MSGBUF(  lzbuf, "%s%s\n", HHC02439I,  LZ_HELP );
         if (lfs)   MSGBUF( lfsbuf, "%s%s\n", HHC02439I, LFS_HELP );
-        WRMSG(                               HHC02439, "I", pgm, zbuf, bzbuf, lfsbuf,
+        WRMSG(                               HHC02439, "I", pgm, zbuf, bzbuf, zsbuf, lzbuf, lfsbuf,
             "CKD, CCKD, FBA, CFBA" );
     }
 
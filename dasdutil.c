@@ -2513,6 +2513,76 @@ CKD_RECHDR*  rechdr;                    /* Pointer to record header  */
     return sz;
 }
 
+/*-------------------------------------------------------------------*/
+/* Map a normal (uncompressed) dasd image file into storage          */
+/*-------------------------------------------------------------------*/
+/* The file is mapped shared, read/write if it was opened read/write */
+/* and read-only otherwise, so track or block group reads can be     */
+/* served directly from the host page cache and updates made in      */
+/* place.  Issues a warning and returns false if the file could not  */
+/* be mapped; the caller should then unmap any files already mapped  */
+/* and fall back to normal cached I/O.                               */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT bool dasd_mmap( DEVBLK* dev, int f, int fd, U64 len, const char* typ )
+{
+#if !defined( _MSVC_ )
+int          prot = PROT_READ;          /* Mapping protection        */
+void*        map;                       /* -> Mapped file            */
+
+    if ((fcntl( fd, F_GETFL ) & O_ACCMODE) == O_RDWR)
+    {
+        prot |= PROT_WRITE;
+        dev->ckdmaprw = 1;
+    }
+    else
+        dev->ckdmaprw = 0;
+
+    if (len != (U64)(size_t) len)
+        errno = EFBIG;
+    else if ((map = mmap( NULL, (size_t) len, prot, MAP_SHARED, fd, 0 )) != MAP_FAILED)
+    {
+        dev->ckdmap[f]   = map;
+        dev->ckdmapsz[f] = len;
+        return true;
+    }
+
+    // "%1d:%04X %s file %s: mmap not possible: %s; using cached I/O"
+    WRMSG( HHC00444, "W", LCSS_DEVNUM, typ, dev->filename, strerror( errno ));
+#else
+    UNREFERENCED( f );
+    UNREFERENCED( fd );
+    UNREFERENCED( len );
+
+    // "%1d:%04X %s file %s: mmap not possible: %s; using cached I/O"
+    WRMSG( HHC00444, "W", LCSS_DEVNUM, typ, dev->filename, "not supported" );
+#endif
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/* Flush and unmap all mapped dasd image files                       */
+/*-------------------------------------------------------------------*/
+DLL_EXPORT void dasd_munmap( DEVBLK* dev )
+{
+#if !defined( _MSVC_ )
+int          f;                         /* File index                */
+
+    for (f = 0; f < CKD_MAXFILES; f++)
+    {
+        if (!dev->ckdmap[f])
+            continue;
+
+        if (dev->ckdmaprw)
+            msync( dev->ckdmap[f], (size_t) dev->ckdmapsz[f], MS_SYNC );
+
+        munmap( dev->ckdmap[f], (size_t) dev->ckdmapsz[f] );
+        dev->ckdmap[f]   = NULL;
+        dev->ckdmapsz[f] = 0;
+    }
+#endif
+    dev->ckdmmap = dev->ckdmaprw = 0;
+}
+
 /*-------------------------------------------------------------------*/
 /*  Return the devid string to be placed into the device header      */
 /*-------------------------------------------------------------------*/
@@ -51,6 +51,7 @@
 extern inline void ARCH_DEP( purge_tlb )( REGS* regs );
 extern inline void ARCH_DEP( purge_tlb_all )( REGS* regs, U16 cpuad );
 extern inline void ARCH_DEP( purge_tlbe_all )( REGS* regs, RADR pfra, U16 cpuad );
+extern inline void ARCH_DEP( purge_tlbe_mask )( REGS* regs, RADR pfra, CPU_BITMAP mask );
 
 #if defined( FEATURE_ACCESS_REGISTERS )
 extern inline void ARCH_DEP( purge_alb )( REGS* regs );
@@ -173,6 +174,21 @@ void ARCH_DEP( set_guest_aea_mode )( REGS* regs )
     }
 }
 
+/*-------------------------------------------------------------------*/
+/* Record a Page Table Entry fetch in the TLB shootdown filter       */
+/*-------------------------------------------------------------------*/
+static INLINE void ARCH_DEP( tlb_filter_set )( REGS* regs, RADR pteabs )
+{
+    int  ix  = TLB_FILTER_IX( pteabs );
+    U64  bit = 1ULL << (ix & 63);
+
+    if (!(regs->tlbfilter[ ix >> 6 ] & bit))
+    {
+        regs->tlbfilter[ ix >> 6 ] |= bit;
+        regs->tlbfpop++;
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*                      do_purge_tlb                                 */
 /*-------------------------------------------------------------------*/
@@ -180,11 +196,21 @@ void ARCH_DEP( do_purge_tlb )( REGS* regs )
 {
     INVALIDATE_AIA( regs );
 
+    regs->tlbpurges++;
+
     if (((++regs->tlbID) & TLBID_BYTEMASK) == 0)
     {
         memset( &regs->tlb.vaddr, 0, TLBN * sizeof( DW ));
+        memset( &regs->tlb.lfid,  0, sizeof( regs->tlb.lfid ));
         regs->tlbID = 1;
     }
+
+    /* Nothing is cached any more, so no IPTE need shoot us down */
+    if (regs->tlbfpop)
+    {
+        memset( regs->tlbfilter, 0, sizeof( regs->tlbfilter ));
+        regs->tlbfpop = 0;
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -831,6 +857,82 @@ U16     eax;                            /* Authorization index       */
 } /* end function load_address_space_designator */
 
 
+/*-------------------------------------------------------------------*/
+/*                      select_tlb_way                               */
+/*-------------------------------------------------------------------*/
+/* Only way 0 of each TLB set is examined by maddr_l and by the TLB  */
+/* lookup in translate_addr, so way 0 must always contain the set's  */
+/* most recently used entry. If way 0 doesn't match, the set's other */
+/* ways are searched, and if the entry is found there, it is moved   */
+/* to way 0 (the ways in between each move down one). Otherwise the  */
+/* set's least recently used entry is moved to way 0 instead (which  */
+/* moves all others down one), where it will then be replaced by the */
+/* new translation that the caller is about to make.                 */
+/*-------------------------------------------------------------------*/
+static INLINE void ARCH_DEP( select_tlb_way )( REGS* regs, VADR vaddr, int tlbix, RADR asd )
+{
+#if TLB_WAYS > 1
+TLB    *tlb = &regs->tlb;               /* -> TLB                    */
+VADR    tag;                            /* TLB_VADDR being sought    */
+int     way;                            /* Way number                */
+int     ix;                             /* TLB entry index           */
+
+#define TLB_WAY_MATCH( _ix )                                          \
+    (1                                                                \
+     && tlb->TLB_VADDR( _ix ) == tag                                  \
+     && (tlb->common[ _ix ] || asd == tlb->TLB_ASD( _ix ))            \
+     && !(tlb->common[ _ix ] && regs->dat.pvtaddr)                    \
+    )
+
+#define TLB_WAY_SWAP( _type, _fld )                                   \
+    do {                                                              \
+        _type  t  =  tlb->_fld[ ix ];                                 \
+        tlb->_fld[ ix ]            = tlb->_fld[ ix - TLB_SETS ];      \
+        tlb->_fld[ ix - TLB_SETS ] = t;                               \
+    } while (0)
+
+    tag = (vaddr & TLBID_PAGEMASK) | regs->tlbID;
+
+    if (TLB_WAY_MATCH( tlbix ))
+        return;
+
+    for (way=1, ix = tlbix + TLB_SETS; way < TLB_WAYS; way++, ix += TLB_SETS)
+        if (TLB_WAY_MATCH( ix ))
+            break;
+
+    if (way < TLB_WAYS)
+        regs->tlbwayhits++;
+    else
+    {
+        way = TLB_WAYS - 1;
+        ix -= TLB_SETS;
+    }
+
+    /* Rotate the chosen entry into way 0 */
+    for (; way > 0; way--, ix -= TLB_SETS)
+    {
+        TLB_WAY_SWAP( DW,    asd     );
+        TLB_WAY_SWAP( DW,    vaddr   );
+        TLB_WAY_SWAP( DW,    pte     );
+        TLB_WAY_SWAP( BYTE*, main    );
+        TLB_WAY_SWAP( BYTE*, storkey );
+        TLB_WAY_SWAP( BYTE,  skey    );
+        TLB_WAY_SWAP( BYTE,  common  );
+        TLB_WAY_SWAP( BYTE,  protect );
+        TLB_WAY_SWAP( BYTE,  acc     );
+    }
+
+#undef TLB_WAY_SWAP
+#undef TLB_WAY_MATCH
+
+#else
+    UNREFERENCED( regs  );
+    UNREFERENCED( vaddr );
+    UNREFERENCED( tlbix );
+    UNREFERENCED( asd   );
+#endif
+}
+
 /*-------------------------------------------------------------------*/
 /*                        translate_addr                             */
 /*           PRIMARY DYNAMIC ADDRESS TRANSLATION LOGIC               */
@@ -961,6 +1063,9 @@ U32     ptl;                            /* Page table length         */
        goto tran_spec_excp;
 
     /* Look up the address in the TLB */
+    if (!(acctype & ACC_NOTLB))
+        ARCH_DEP( select_tlb_way )( regs, vaddr, tlbix, regs->dat.asd );
+
     if (   ((vaddr & TLBID_PAGEMASK) | regs->tlbID) == regs->tlb.TLB_VADDR(tlbix)
         && (regs->tlb.common[tlbix] || regs->dat.asd == regs->tlb.TLB_ASD(tlbix))
         && !(regs->tlb.common[tlbix] && regs->dat.pvtaddr)
@@ -1036,6 +1141,7 @@ U32     ptl;                            /* Page table length         */
         /* Fetch the page table entry from real storage.  All bytes
            must be fetched concurrently as observed by other CPUs */
         pto = APPLY_PREFIXING (pto, regs->PX);
+        ARCH_DEP( tlb_filter_set )( regs, pto );
         pte = ARCH_DEP(fetch_halfword_absolute) (pto, regs);
 
         /* Generate page translation exception if page invalid */
@@ -1070,6 +1176,8 @@ U32     ptl;                            /* Page table length         */
             /* Set adjacent TLB entry if 4K page sizes */
             if ((regs->CR(0) & CR0_PAGE_SIZE) == CR0_PAGE_SZ_4K)
             {
+                ARCH_DEP( select_tlb_way )( regs, vaddr ^ 0x800, tlbix^1, regs->dat.asd );
+
                 regs->tlb.TLB_ASD(tlbix^1)   = regs->tlb.TLB_ASD(tlbix);
                 regs->tlb.TLB_VADDR(tlbix^1) = (vaddr & TLBID_PAGEMASK) | regs->tlbID;
                 regs->tlb.TLB_PTE(tlbix^1)   = regs->tlb.TLB_PTE(tlbix);
@@ -1116,6 +1224,9 @@ U32     ptl;                            /* Page table length         */
     regs->dat.pvtaddr = ((regs->dat.asd & STD_PRIVATE) != 0);
 
     /* [3.11.4] Look up the address in the TLB */
+    if (!(acctype & ACC_NOTLB))
+        ARCH_DEP( select_tlb_way )( regs, vaddr, tlbix, regs->dat.asd );
+
     if (   ((vaddr & TLBID_PAGEMASK) | regs->tlbID) == regs->tlb.TLB_VADDR(tlbix)
         && (regs->tlb.common[tlbix] || regs->dat.asd == regs->tlb.TLB_ASD(tlbix))
         && !(regs->tlb.common[tlbix] && regs->dat.pvtaddr)
@@ -1180,6 +1291,7 @@ U32     ptl;                            /* Page table length         */
         /* Fetch the page table entry from real storage.  All bytes
            must be fetched concurrently as observed by other CPUs */
         pto = APPLY_PREFIXING (pto, regs->PX);
+        ARCH_DEP( tlb_filter_set )( regs, pto );
         pte = ARCH_DEP(fetch_fullword_absolute) (pto, regs);
 
         /* Generate page translation exception if page invalid */
@@ -1236,6 +1348,9 @@ U16     rfx, rsx, rtx;                  /* Region first/second/third
                                            index + 3 low-order zeros */
 U16     sx, px;                         /* Segment and page index,
                                            + 3 low-order zero bits   */
+#if defined( FEATURE_008_ENHANCED_DAT_FACILITY_1 )
+int     lfix;                           /* Large-frame TLB index     */
+#endif
 
     regs->dat.pvtaddr = regs->dat.protect = 0;
 
@@ -1249,6 +1364,9 @@ U16     sx, px;                         /* Segment and page index,
 //  LOGMSG("asce=%16.16"PRIX64"\n",regs->dat.asd);
 
     /* [3.11.4] Look up the address in the TLB */
+    if (!(acctype & ACC_NOTLB))
+        ARCH_DEP( select_tlb_way )( regs, vaddr, tlbix, regs->dat.asd );
+
     if (   ((vaddr & TLBID_PAGEMASK) | regs->tlbID) == regs->tlb.TLB_VADDR(tlbix)
         && (regs->tlb.common[tlbix] || regs->dat.asd == regs->tlb.TLB_ASD(tlbix))
         && !(regs->tlb.common[tlbix] && regs->dat.pvtaddr)
@@ -1278,6 +1396,32 @@ U16     sx, px;                         /* Segment and page index,
         }
         else
         {
+#if defined( FEATURE_008_ENHANCED_DAT_FACILITY_1 )
+            /* Look up the segment in the large-frame TLB. A hit means
+               the address lies within a 1M frame that was translated
+               before, so only the 4K entry needs to be rebuilt */
+            if (!(acctype & (ACC_NOTLB | ACC_LPTEA | ACC_PTE))
+              && FACILITY_ENABLED( 008_EDAT_1, regs )
+              && (regs->CR_L(0) & CR0_ED))
+            {
+                lfix = TLB_LFIX( vaddr );
+
+                if (   regs->tlb.lfid[lfix] == regs->tlbID
+                    && regs->tlb.lfvaddr[lfix] == (vaddr & ZSEGTAB_SFAA)
+                    && ((regs->tlb.lfste[lfix] & SEGTAB_COMMON)
+                        || regs->dat.asd == regs->tlb.lfasd[lfix])
+                    && !((regs->tlb.lfste[lfix] & SEGTAB_COMMON)
+                        && regs->dat.pvtaddr) )
+                {
+                    regs->tlblfhits++;
+                    ste = regs->tlb.lfste[lfix];
+                    if (regs->tlb.lfprotect[lfix])
+                        regs->dat.protect = regs->tlb.lfprotect[lfix];
+                    goto large_frame;
+                }
+            }
+#endif /* defined( FEATURE_008_ENHANCED_DAT_FACILITY_1 ) */
+
             /* Extract the table origin, type, and length from the ASCE,
                and set the table offset to zero */
             rto = regs->dat.asd & ASCE_TO;
@@ -1530,6 +1674,18 @@ U16     sx, px;                         /* Segment and page index,
                     return cc;
                 } /* end if(ACCTYPE_LPTEA) */
 
+                /* Remember the whole frame in the large-frame TLB */
+                if (!(acctype & (ACC_NOTLB | ACC_PTE)))
+                {
+                    lfix = TLB_LFIX( vaddr );
+                    regs->tlb.lfvaddr[lfix]   = vaddr & ZSEGTAB_SFAA;
+                    regs->tlb.lfasd[lfix]     = regs->dat.asd;
+                    regs->tlb.lfste[lfix]     = ste;
+                    regs->tlb.lfprotect[lfix] = regs->dat.protect;
+                    regs->tlb.lfid[lfix]      = regs->tlbID;
+                }
+
+large_frame:
                 /* Combine the page frame real address with the byte index
                    of the virtual address to form the real address */
                 regs->dat.raddr = (ste & ZSEGTAB_SFAA) | (vaddr & ~ZSEGTAB_SFAA);
@@ -1588,6 +1744,7 @@ U16     sx, px;                         /* Segment and page index,
 
             /* Fetch the page table entry from absolute storage.  All bytes
                must be fetched concurrently as observed by other CPUs */
+            ARCH_DEP( tlb_filter_set )( regs, pto );
             pte = ARCH_DEP(fetch_doubleword_absolute) (pto, regs);
 //          LOGMSG("pte:%16.16"PRIX64"=>%16.16"PRIX64"\n",pto,pte);
 
@@ -1900,9 +2057,20 @@ int  i;
 
     INVALIDATE_AIA( regs );
 
+    regs->tlbepurges++;
+
     for (i=0; i < TLBN; i++)
         if (ARCH_DEP( is_tlbe_match )( regs, host_regs, pfra, i ))
             regs->tlb.TLB_VADDR(i) &= TLBID_PAGEMASK;
+
+#if defined( FEATURE_008_ENHANCED_DAT_FACILITY_1 )
+    /* Also drop any large-frame entry whose frame contains the page.
+       For an SIE guest the page is a host frame which cannot be
+       related to a guest segment frame, so drop them all instead. */
+    for (i=0; i < TLB_LFN; i++)
+        if (host_regs || (regs->tlb.lfste[i] & ZSEGTAB_SFAA) == (pfra & ZSEGTAB_SFAA))
+            regs->tlb.lfid[i] = 0;
+#endif
 }
 
 /*-------------------------------------------------------------------*/
@@ -2045,7 +2213,7 @@ void ARCH_DEP( do_invalidate_tlbe )( REGS* regs, BYTE* main )
 
     for (i=0; i < TLBN; i++)
     {
-        if (MAINADDR( regs->tlb.main[i], (regs->tlb.TLB_VADDR(i) | (i << shift)) ) == mainwid)
+        if (MAINADDR( regs->tlb.main[i], (regs->tlb.TLB_VADDR(i) | ((i & TLB_MASK) << shift)) ) == mainwid)
         {
             regs->tlb.acc[i] = 0;
 
@@ -2115,6 +2283,128 @@ void ARCH_DEP( invalidate_tlbe )( REGS* regs, BYTE* main )
 } /* end function invalidate_tlbe */
 
 
+/*-------------------------------------------------------------------*/
+/*                   Targeted TLB purge                              */
+/*-------------------------------------------------------------------*/
+/*                                                                   */
+/*  Every CPU records the absolute address of each Page Table Entry  */
+/*  it fetches during translation in its tlbfilter, which is cleared */
+/*  whenever its entire TLB is purged. A CPU whose filter does not   */
+/*  have the bit for a PTE cannot hold a TLB entry formed from it,   */
+/*  so invalidate_pte need not purge its TLB.                        */
+/*                                                                   */
+/*  ESA/390 and S/370 translation prefix the PTE address with the    */
+/*  translating CPU's own prefix, so the real address is prefixed    */
+/*  with each target's prefix before its filter is examined. ESAME   */
+/*  translation fetches the PTE from absolute storage unprefixed,    */
+/*  so both the real address and the address our own prefixing      */
+/*  yields for it are checked.                                       */
+/*                                                                   */
+/*  The caller has synchronized all CPUs, so no other CPU can be in  */
+/*  the middle of a translation using the PTE while the filters are  */
+/*  examined and the TLBs purged.                                    */
+/*                                                                   */
+/*  A target whose filter has become more than half full has its     */
+/*  entire TLB purged to keep the filter from saturating.            */
+/*                                                                   */
+/*  Input:                                                           */
+/*      regs    CPU register context                                 */
+/*      raddr   Real address of the invalidated PTE                  */
+/*                                                                   */
+/*  Returns the CPUs (including ourselves) whose TLB still needs     */
+/*  to be purged of the page.                                        */
+/*                                                                   */
+/*  This function expects INTLOCK to be held                         */
+/*  and SYNCHRONIZE_CPUS to be called beforehand!                    */
+/*                                                                   */
+/*-------------------------------------------------------------------*/
+static CPU_BITMAP ARCH_DEP( tlb_shootdown )( REGS* regs, RADR raddr )
+{
+CPU_BITMAP  mask;                       /* CPUs to be purged         */
+CPU_BITMAP  full = 0;                   /* Targets to purge entirely */
+REGS*       tregs;                      /* Target CPU registers      */
+int         ix;                         /* Filter bit index for PTE  */
+int         ix2;                        /* Alternate filter bit index*/
+int         cpu;
+
+#define TLB_FILTER_TEST( _regs, _ix ) \
+    ((_regs)->tlbfilter[ (_ix) >> 6 ] & (1ULL << ((_ix) & 63)))
+
+#if defined( _FEATURE_SIE )
+    /* A guest's PTE address is not a host absolute address */
+    if (SIE_MODE( regs ))
+        return sysblk.started_mask;
+#endif
+
+#if defined( FEATURE_001_ZARCH_INSTALLED_FACILITY )
+    ix  = TLB_FILTER_IX( APPLY_PREFIXING( raddr, regs->PX ));
+    ix2 = TLB_FILTER_IX( raddr );
+#endif
+
+    mask = CPU_BIT( regs->cpuad );
+
+    for (cpu=0; cpu < sysblk.maxcpu; cpu++)
+    {
+        if (0
+            || !IS_CPU_ONLINE( cpu )
+            || !(sysblk.regs[ cpu ]->cpubit & sysblk.started_mask)
+            || cpu == regs->cpuad
+        )
+            continue;
+
+        tregs = sysblk.regs[ cpu ];
+
+#if !defined( FEATURE_001_ZARCH_INSTALLED_FACILITY )
+        ix  = TLB_FILTER_IX( APPLY_PREFIXING( raddr, tregs->PX ));
+        ix2 = ix;
+#endif
+
+        if (1
+            && !TLB_FILTER_TEST( tregs, ix  )
+            && !TLB_FILTER_TEST( tregs, ix2 )
+#if defined( _FEATURE_SIE )
+            && !(tregs->guestregs && TLB_FILTER_TEST( tregs->guestregs, ix  ))
+            && !(tregs->guestregs && TLB_FILTER_TEST( tregs->guestregs, ix2 ))
+#endif
+        )
+        {
+            regs->tlbsdavoided++;
+            continue;
+        }
+
+        regs->tlbsdtargeted++;
+        mask |= tregs->cpubit;
+
+        if (tregs->tlbfpop > TLB_FILTER_N / 2)
+            full |= tregs->cpubit;
+    }
+
+    /* Purge the TLBs whose filters were nearly full */
+    for (cpu=0; full; cpu++)
+    {
+        if (!(full & CPU_BIT( cpu )))
+            continue;
+
+        full &= ~CPU_BIT( cpu );
+        mask &= ~CPU_BIT( cpu );
+        regs->tlbsdflushes++;
+
+        switch (sysblk.regs[ cpu ]->arch_mode)
+        {
+        case ARCH_370_IDX: s370_purge_tlb( sysblk.regs[ cpu ]); break;
+        case ARCH_390_IDX: s390_purge_tlb( sysblk.regs[ cpu ]); break;
+        case ARCH_900_IDX: z900_purge_tlb( sysblk.regs[ cpu ]); break;
+        default: CRASH();
+        }
+    }
+
+    return mask;
+
+#undef TLB_FILTER_TEST
+
+} /* end function tlb_shootdown */
+
+
 /*-------------------------------------------------------------------*/
 /*                Invalidate Page Table Entry                        */
 /*-------------------------------------------------------------------*/
@@ -2141,6 +2431,8 @@ void ARCH_DEP( invalidate_tlbe )( REGS* regs, BYTE* main )
 /*                                                                   */
 /*           This function expects INTLOCK to be held                */
 /*         and SYNCHRONIZE_CPUS to be called beforehand!             */
+/*      Only the CPUs whose TLB might hold the entry are purged      */
+/*      (see tlb_shootdown).                                         */
 /*                                                                   */
 /*-------------------------------------------------------------------*/
 void ARCH_DEP( invalidate_pte )( BYTE ibyte, RADR pto, VADR vaddr, REGS* regs, bool local )
@@ -2148,6 +2440,7 @@ void ARCH_DEP( invalidate_pte )( BYTE ibyte, RADR pto, VADR vaddr, REGS* regs, b
 RADR    raddr;                          /* Addr of Page Table Entry  */
 RADR    pte;                            /* Page Table Entry itself   */
 RADR    pfra;                           /* Page Frame Real Address   */
+CPU_BITMAP mask;                        /* CPUs to be purged         */
 
     UNREFERENCED_370( ibyte );
 
@@ -2288,8 +2581,14 @@ RADR    pfra;                           /* Page Frame Real Address   */
     }
 #endif /* defined( FEATURE_001_ZARCH_INSTALLED_FACILITY ) */
 
+    /* Find the CPUs which might have the entry in their TLB */
+    if (local)
+        mask = CPU_BIT( regs->cpuad );
+    else
+        mask = ARCH_DEP( tlb_shootdown )( regs, raddr );
+
     /* Invalidate all TLB entries for this Page Frame Real Address */
-    ARCH_DEP( purge_tlbe_all )( regs, pfra, local ? regs->cpuad : 0xFFFF );
+    ARCH_DEP( purge_tlbe_mask )( regs, pfra, mask );
 
 } /* end function invalidate_pte */
 
@@ -2385,6 +2684,7 @@ int     ix = TLBIX(addr);               /* TLB index                 */
         regs->dat.rpfra = addr & PAGEFRAME_PAGEMASK;
 
         /* Setup `real' TLB entry (for MADDR) */
+        ARCH_DEP( select_tlb_way )( regs, addr, ix, TLB_REAL_ASD );
         regs->tlb.TLB_ASD(ix)   = TLB_REAL_ASD;
         regs->tlb.TLB_VADDR(ix) = (addr & TLBID_PAGEMASK) | regs->tlbID;
         regs->tlb.TLB_PTE(ix)   = addr & TLBID_PAGEMASK;
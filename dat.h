@@ -96,24 +96,21 @@ inline void ARCH_DEP( purge_tlb_all )( REGS* regs, U16 cpuad )
 
 
 /*-------------------------------------------------------------------*/
-/* Purge specific translation lookaside buffer entry from all CPUs   */
+/* Purge specific translation lookaside buffer entry from some CPUs  */
 /*-------------------------------------------------------------------*/
-inline void ARCH_DEP( purge_tlbe_all )( REGS* regs, RADR pfra, U16 cpuad )
+inline void ARCH_DEP( purge_tlbe_mask )( REGS* regs, RADR pfra, CPU_BITMAP mask )
 {
     int  cpu;
 
-    if (0xFFFF == cpuad && !IS_INTLOCK_HELD( regs ))  // (sanity check)
-        CRASH();                                      // (logic error!)
+    if (mask != CPU_BIT( regs->cpuad ) && !IS_INTLOCK_HELD( regs )) // (sanity check)
+        CRASH();                                                    // (logic error!)
 
     for (cpu=0; cpu < sysblk.maxcpu; cpu++)
     {
         if (1
             && IS_CPU_ONLINE(cpu)
             && (sysblk.regs[ cpu ]->cpubit & sysblk.started_mask)
-            && (0
-                || 0xFFFF == cpuad
-                || sysblk.regs[ cpu ]->cpuad == cpuad
-               )
+            && (sysblk.regs[ cpu ]->cpubit & mask)
         )
         {
             switch (sysblk.regs[ cpu ]->arch_mode)
@@ -128,6 +125,16 @@ inline void ARCH_DEP( purge_tlbe_all )( REGS* regs, RADR pfra, U16 cpuad )
 }
 
 
+/*-------------------------------------------------------------------*/
+/* Purge specific translation lookaside buffer entry from all CPUs   */
+/*-------------------------------------------------------------------*/
+inline void ARCH_DEP( purge_tlbe_all )( REGS* regs, RADR pfra, U16 cpuad )
+{
+    ARCH_DEP( purge_tlbe_mask )( regs, pfra, 0xFFFF == cpuad ?
+        sysblk.started_mask : CPU_BIT( cpuad ));
+}
+
+
 #if defined( FEATURE_ACCESS_REGISTERS )
 /*-------------------------------------------------------------------*/
 /* Purge the ART lookaside buffer for all CPUs                       */
@@ -357,6 +364,9 @@ inline BYTE* ARCH_DEP( maddr_l )
                             regs->dat.storkey = regs->tlb.storkey[ tlbix ];
 
                         maddr = MAINADDR( regs->tlb.main[tlbix], addr );
+#if defined( OPTION_TLB_HIT_COUNT )
+                        regs->tlbhits++;
+#endif
                     }
                 }
             }
@@ -367,7 +377,10 @@ inline BYTE* ARCH_DEP( maddr_l )
     /* TLB miss: do full address translation */
     /*---------------------------------------*/
     if (!maddr)
+    {
+        regs->tlbmisses++;
         maddr = ARCH_DEP( logical_to_main_l )( addr, arn, regs, acctype, akey, len );
+    }
 
 #if defined( FEATURE_073_TRANSACT_EXEC_FACILITY )
     if (FACILITY_ENABLED( 073_TRANSACT_EXEC, regs ))
@@ -257,14 +257,39 @@ typedef struct PSW  PSW;
 /*      main, storkey, skey, read and write,                         */
 /*      and are used for accelerated address lookup (formerly AEA).  */
 /*                                                                   */
+/*  The TLB is TLB_WAYS-way set associative, with TLB_SETS sets.     */
+/*  Way 'n' of set 's' is entry (n * TLB_SETS) + s, so way 0 of all  */
+/*  of the sets occupies the first TLB_SETS entries. Way 0 always    */
+/*  holds the set's most recently used entry and is the only entry   */
+/*  examined by the maddr_l fast path; the other ways are searched   */
+/*  by translate_addr (see select_tlb_way in dat.c).                 */
+/*                                                                   */
 /*-------------------------------------------------------------------*/
 
-#define TLBN            1024            /* Number TLB entries        */
-#define TLB_MASK        0x3FF           /* Mask for 1024 entries     */
+#define TLB_SETS        (1 << TLB_SETBITS)  /* Number of TLB sets    */
+#define TLBN            (TLB_SETS * TLB_WAYS) /* Number TLB entries  */
+#define TLB_MASK        (TLB_SETS - 1)  /* Mask for TLB set index    */
 #define TLB_REAL_ASD_L  0xFFFFFFFF      /* ASD values for real mode  */
 #define TLB_REAL_ASD_G  0xFFFFFFFFFFFFFFFFULL
 #define TLB_HOST_ASD    0x800           /* Host entry for XC guest   */
 
+/* EDAT large frames are additionally remembered as a single entry
+   per 1M segment frame, so that the 4K entries for the remaining
+   pages of the frame can be refilled without a table walk. These
+   entries are valid only while lfid matches the CPU's tlbID.       */
+#define TLB_LFBITS      5               /* Large-frame index bits    */
+#define TLB_LFN         (1 << TLB_LFBITS) /* Large-frame entries     */
+#define TLB_LFIX(_v)    ((int)(((_v) >> SHIFT_MEGABYTE) & (TLB_LFN - 1)))
+
+/*  Each CPU also keeps a filter of the absolute addresses of the    */
+/*  Page Table Entries it has fetched since its TLB was last purged  */
+/*  (see tlb_filter_set in dat.c), so that IPTE only needs to purge  */
+/*  the TLBs of CPUs that might hold an entry for the page.          */
+
+#define TLB_FILTER_N    (1 << TLB_FILTER_BITS) /* Filter size (bits) */
+#define TLB_FILTER_IX(_a) ((int)((((U64)(_a) >> 3) \
+                          * 0x9E3779B97F4A7C15ULL) >> (64 - TLB_FILTER_BITS)))
+
 struct  TLB {
     DW                  asd[TLBN];      /* Address space designator  */
 
@@ -287,6 +312,12 @@ struct  TLB {
     BYTE                common[TLBN];   /* 1=Page in common segment  */
     BYTE                protect[TLBN];  /* 1=Page in protected segmnt*/
     BYTE                acc[TLBN];      /* Access type flags         */
+
+    U64                 lfvaddr[TLB_LFN];   /* Frame virtual address */
+    U64                 lfasd[TLB_LFN];     /* Addr space designator */
+    U64                 lfste[TLB_LFN];     /* Segment table entry   */
+    unsigned int        lfid[TLB_LFN];      /* tlbID when loaded     */
+    BYTE                lfprotect[TLB_LFN]; /* Protection indicator  */
 };
 typedef struct TLB  TLB;
 
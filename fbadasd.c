@@ -129,6 +129,14 @@ char         filename[FILENAME_MAX+3];  /* work area for display     */
     else
         MSGBUF( filename, "'%s'", dev->filename );
 
+    /* An optional last argument 'mmap' maps the image file */
+    dev->ckdmmap = 0;
+    if (argc > 1 && strcasecmp( argv[argc-1], "mmap" ) == 0)
+    {
+        dev->ckdmmap = 1;
+        argc--;
+    }
+
 #if defined( OPTION_SHARED_DEVICES )
     /* Device is shareable */
     dev->shareable = 1;
@@ -371,6 +379,11 @@ char         filename[FILENAME_MAX+3];  /* work area for display     */
     dev->numdevchar = dasd_build_fba_devchar (dev->fbatab,
                                  (BYTE *)&dev->devchar,dev->fbanumblk);
 
+    /* Map the image file if requested (normal FBA files only) */
+    if (dev->ckdmmap && (cfba
+     || !dasd_mmap( dev, 0, dev->fd, dev->fbaend, FBATYP( cfba, 0 ))))
+        dasd_munmap( dev );
+
     /* Initialize current blkgrp and cache entry */
     dev->bufcur = dev->cache = -1;
 
@@ -399,10 +412,11 @@ void fba_dasd_query_device (DEVBLK *dev, char **devclass,
 
     if (!cckd)
     {
-        snprintf( buffer, buflen, "%s%s [%"PRId64",%d] IO[%"PRIu64"]",
+        snprintf( buffer, buflen, "%s%s [%"PRId64",%d] %sIO[%"PRIu64"]",
                   dev->cckd64 ? "*64* " : "",
                   filename,
                   dev->fbaorigin, dev->fbanumblk,
+                  dev->ckdmmap ? "mmap " : "",
                   dev->excps);
     }
     else
@@ -570,6 +584,36 @@ off_t           offset;                 /* File offsets              */
     if (blkgrp >= 0 && blkgrp == dev->bufcur)
         return 0;
 
+    /* Use the block group directly if the image file is mapped;
+       updates were made in place and are written back by the host */
+    if (dev->ckdmmap)
+    {
+        dev->bufupd = 0;
+        dev->bufupdlo = dev->bufupdhi = 0;
+        dev->bufcur = dev->cache = -1;
+
+        /* Return on special case when called by the close handler */
+        if (blkgrp < 0)
+            return 0;
+
+        offset = (off_t)((S64)blkgrp * CFBA_BLKGRP_SIZE);
+        len = fba_blkgrp_len (dev, blkgrp);
+
+        // "Thread "TIDPAT" %1d:%04X FBA file %s: read blkgrp %d offset %"PRId64" len %d"
+        if (dev->ccwtrace && sysblk.traceFILE)
+            tf_0519( dev, blkgrp, offset, len );
+        else
+            LOGDEVTR( HHC00519, "I", dev->filename, blkgrp, offset, len );
+
+        dev->buf = dev->ckdmap[0] + offset;
+        dev->bufcur = blkgrp;
+        dev->bufoff = 0;
+        dev->bufoffhi = len;
+        dev->buflen = len;
+        dev->bufsize = len;
+        return 0;
+    }
+
     /* Write the previous block group if modified */
     if (dev->bufupd)
     {
@@ -640,6 +684,7 @@ fba_read_blkgrp_retry:
     {
         cache_setflag(CACHE_DEVBUF, i, ~0, FBA_CACHE_ACTIVE);
         cache_setage(CACHE_DEVBUF, i);
+        cache_promote(CACHE_DEVBUF, i);
         cache_unlock(CACHE_DEVBUF);
 
         // "Thread "TIDPAT" %1d:%04X FBA file %s: read blkgrp %d cache hit, using cache[%d]"
@@ -762,6 +807,17 @@ int             rc;                     /* Return code               */
         }
     }
 
+    /* Error if the mapped image file is read-only */
+    if (dev->ckdmmap && !dev->ckdmaprw)
+    {
+        // "%1d:%04X FBA file %s: error in function %s: %s"
+        WRMSG( HHC00502, "E", LCSS_DEVNUM,
+               dev->filename, "write()", strerror( EBADF ));
+        dev->sense[0] = SENSE_EC;
+        *unitstat = CSW_CE | CSW_DE | CSW_UC;
+        return -1;
+    }
+
     /* Copy to the device buffer */
     if (buf) memcpy (dev->buf + off, buf, len);
 
@@ -824,7 +880,8 @@ BYTE            unitstat;
     cache_scan(CACHE_DEVBUF, fbadasd_purge_cache, dev);
     cache_unlock(CACHE_DEVBUF);
 
-    /* Close the device file */
+    /* Unmap and close the device file */
+    dasd_munmap( dev );
     close (dev->fd);
     dev->fd = -1;
 
@@ -63,6 +63,16 @@
 
 #define CKD_MAXFILES                 27 /* Max files per CKD volume  */
 
+#if !defined( TLB_SETBITS )
+#define TLB_SETBITS                  10 /* log2(#of TLB sets) 8-12   */
+#endif
+#if !defined( TLB_WAYS )
+#define TLB_WAYS                      2 /* TLB associativity 1,2,4   */
+#endif
+#if !defined( TLB_FILTER_BITS )
+#define TLB_FILTER_BITS              12 /* log2(#of IPTE filter bits)*/
+#endif
+
 #define PANEL_REFRESH_RATE_MIN    (1000 / CLK_TCK)  /* (likely 1ms!) */
 #define PANEL_REFRESH_RATE_MAX     5000 /* Arbitrary, but reasonable */
 #define PANEL_REFRESH_RATE_FAST      50 /* Fast refresh rate (msecs) */
@@ -76,6 +86,7 @@
 //efine OPTION_LONG_HOSTINFO            /* Detailed host & logo info */
 #undef  OPTION_FOOTPRINT_BUFFER /* 2048 ** Size must be a power of 2 */
 #undef  OPTION_INSTR_COUNT_AND_TIME     /* First use trace and count */
+#undef  OPTION_TLB_HIT_COUNT            /* Count maddr_l TLB hits    */
 #undef  MODEL_DEPENDENT_STCM            /* STCM, STCMH always store  */
 #define OPTION_NOP_MODEL158_DIAGNOSE    /* NOP mod 158 specific diags*/
 
@@ -105,6 +116,18 @@
   #error CKD_MAXFILES can not exceed design limit of 35
 #endif
 
+#if (TLB_SETBITS < 8 || TLB_SETBITS > 12)
+  #error TLB_SETBITS must be from 8 to 12
+#endif
+
+#if (TLB_WAYS != 1 && TLB_WAYS != 2 && TLB_WAYS != 4)
+  #error TLB_WAYS must be 1, 2 or 4
+#endif
+
+#if (TLB_FILTER_BITS < 8 || TLB_FILTER_BITS > 16)
+  #error TLB_FILTER_BITS must be from 8 to 16
+#endif
+
 #if defined( OPTION_SHARED_DEVICES ) && defined( OPTION_NO_SHARED_DEVICES )
   #error Either OPTION_SHARED_DEVICES or OPTION_NO_SHARED_DEVICES must be specified, not both
 #elif !defined( OPTION_SHARED_DEVICES ) && !defined( OPTION_NO_SHARED_DEVICES )
@@ -383,8 +383,8 @@
 #define TLB_PAGEMASK            0x00FFF800
 #define TLB_BYTEMASK            0x000007FF
 #define TLB_PAGESHIFT           11
-#define TLBID_PAGEMASK          0x00E00000
-#define TLBID_BYTEMASK          0x001FFFFF
+#define TLBID_BYTEMASK          ((1U << (TLB_PAGESHIFT + TLB_SETBITS)) - 1)
+#define TLBID_PAGEMASK          (0x00FFFFFF & ~TLBID_BYTEMASK)
 #define ASD_PRIVATE             SEGTAB_370_CMN
 #define CHANNEL_MASKS(_regs)    ((_regs)->CR(2))
 
@@ -493,8 +493,8 @@
 #define TLB_PAGEMASK            0x7FFFF000
 #define TLB_BYTEMASK            0x00000FFF
 #define TLB_PAGESHIFT           12
-#define TLBID_PAGEMASK          0x7FC00000
-#define TLBID_BYTEMASK          0x003FFFFF
+#define TLBID_BYTEMASK          ((1U << (TLB_PAGESHIFT + TLB_SETBITS)) - 1)
+#define TLBID_PAGEMASK          (0x7FFFFFFF & ~TLBID_BYTEMASK)
 #define ASD_PRIVATE             STD_PRIVATE
 #ifdef FEATURE_ACCESS_REGISTERS
  #define CHANNEL_MASKS(_regs)   0xFFFFFFFF
@@ -624,8 +624,8 @@
 #define TLB_PAGEMASK            0xFFFFFFFFFFFFF000ULL
 #define TLB_BYTEMASK            0x0000000000000FFFULL
 #define TLB_PAGESHIFT           12
-#define TLBID_PAGEMASK          0xFFFFFFFFFFC00000ULL
-#define TLBID_BYTEMASK          0x00000000003FFFFFULL
+#define TLBID_BYTEMASK          ((1ULL << (TLB_PAGESHIFT + TLB_SETBITS)) - 1)
+#define TLBID_PAGEMASK          (~TLBID_BYTEMASK)
 #define ASD_PRIVATE             (ASCE_P|ASCE_R)
 #ifdef FEATURE_ACCESS_REGISTERS
  #define CHANNEL_MASKS(_regs)   0xFFFFFFFF
@@ -295,14 +295,13 @@ BYTE   *dest;                           /* Pointer to target byte    */
 /*-------------------------------------------------------------------*/
 DEF_INST( and_character )
 {
-int     len, len2, len3;                /* Lengths to copy           */
+int     len;                            /* Length minus 1            */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1;                /* Virtual address           */
 VADR    effective_addr2;                /* Virtual address           */
-BYTE   *dest1, *dest2;                  /* Destination addresses     */
-BYTE   *source1, *source2;              /* Source addresses          */
-BYTE   *sk1, *sk2;                      /* Storage key addresses     */
-int     i;                              /* Loop counter              */
+OPWIN   w1, w2;                         /* Operand windows           */
+BYTE   *dest, *source;                  /* Mainstor addresses        */
+int     off, n;                         /* Offset and run length     */
 int     cc = 0;                         /* Condition code            */
 
     SS_L( inst, regs, len, b1, effective_addr1, b2, effective_addr2 );
@@ -316,141 +315,31 @@ int     cc = 0;                         /* Condition code            */
     /* Quick out for 1 byte (no boundary crossed) */
     if (unlikely( !len ))
     {
-        source1 = MADDR( effective_addr2, b2, regs, ACCTYPE_READ,  regs->psw.pkey );
-        dest1   = MADDR( effective_addr1, b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
-        *dest1 &= *source1;
-        regs->psw.cc = (*dest1 != 0);
+        source = MADDR( effective_addr2, b2, regs, ACCTYPE_READ,  regs->psw.pkey );
+        dest   = MADDR( effective_addr1, b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
+        *dest &= *source;
+        regs->psw.cc = (*dest != 0);
         ITIMER_UPDATE( effective_addr1, 0, regs );
         return;
     }
 
-    /* There are several scenarios (in optimal order):
-     * (1) dest boundary and source boundary not crossed
-     * (2) dest boundary not crossed and source boundary crossed
-     * (3) dest boundary crossed and source boundary not crossed
-     * (4) dest boundary and source boundary are crossed
-     *     (a) dest and source boundary cross at the same time
-     *     (b) dest boundary crossed first
-     *     (c) source boundary crossed first
-     */
-
-    /* Translate addresses of leftmost operand bytes */
-    dest1 = MADDRL( effective_addr1, len+1, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-    sk1 = regs->dat.storkey;
-    source1 = MADDRL( effective_addr2, len + 1, b2, regs, ACCTYPE_READ, regs->psw.pkey );
+    /* Translate both operands (and both pages of each if needed) */
+    ARCH_DEP( opwin )( &w1, effective_addr1, len, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
+    ARCH_DEP( opwin )( &w2, effective_addr2, len, b2, regs, ACCTYPE_READ,      regs->psw.pkey );
 
-    if (NOCROSSPAGE( effective_addr1,len ))
+    /* Process each run of bytes contiguous in both operands */
+    for (off=0; off <= len; off += n)
     {
-        if (NOCROSSPAGE( effective_addr2,len ))
-        {
-            /* (1) - No boundaries are crossed */
-            for (i=0; i <= len; i++)
-                if (*dest1++ &= *source1++)
-                    cc = 1;
-        }
-        else
-        {
-             /* (2) - Second operand crosses a boundary */
-             len2 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-             source2 = MADDRL( (effective_addr2 + len2) & ADDRESS_MAXWRAP( regs ),
-                 len + 1 - len2, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-             for (i=0; i < len2; i++)
-                 if (*dest1++ &= *source1++)
-                     cc = 1;
-
-             len2 = len - len2;
-
-             for (i=0; i <= len2; i++)
-                 if (*dest1++ &= *source2++)
-                     cc = 1;
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
+        n = opwin_run( &w1, &w2, off, &dest, &source );
+        if (opwin_bitop( dest, source, n, OPWIN_AND ))
+            cc = 1;
     }
-    else
-    {
-        /* First operand crosses a boundary */
-        len2 = PAGEFRAME_PAGESIZE - (effective_addr1 & PAGEFRAME_BYTEMASK);
-        dest2 = MADDRL( (effective_addr1 + len2) & ADDRESS_MAXWRAP( regs ),
-            len + 1 - len2, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-        sk2 = regs->dat.storkey;
-
-        if (NOCROSSPAGE( effective_addr2,len ))
-        {
-             /* (3) - First operand crosses a boundary */
-             for (i=0; i < len2; i++)
-                 if (*dest1++ &= *source1++)
-                     cc = 1;
-
-             len2 = len - len2;
-
-             for (i=0; i <= len2; i++)
-                 if (*dest2++ &= *source1++)
-                     cc = 1;
-        }
-        else
-        {
-            /* (4) - Both operands cross a boundary */
-            len3 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-            source2 = MADDRL( (effective_addr2 + len3) & ADDRESS_MAXWRAP( regs ),
-                len + 1 - len3, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-            if (len2 == len3)
-            {
-                /* (4a) - Both operands cross at the same time */
-                for (i=0; i < len2; i++)
-                    if (*dest1++ &= *source1++)
-                        cc = 1;
-
-                len2 = len - len2;
 
-                for (i=0; i <= len2; i++)
-                    if (*dest2++ &= *source2++)
-                        cc = 1;
-            }
-            else if (len2 < len3)
-            {
-                /* (4b) - First operand crosses first */
-                for (i=0; i < len2; i++)
-                    if (*dest1++ &= *source1++)
-                        cc = 1;
-
-                len2 = len3 - len2;
-
-                for (i=0; i < len2; i++)
-                    if (*dest2++ &= *source1++)
-                        cc = 1;
+    ARCH_DEP( opwin_changed )( &w1 );
 
-                len2 = len - len3;
-
-                for (i=0; i <= len2; i++)
-                    if (*dest2++ &= *source2++)
-                        cc = 1;
-            }
-            else
-            {
-                /* (4c) - Second operand crosses first */
-                for (i=0; i < len3; i++)
-                    if (*dest1++ &= *source1++)
-                        cc = 1;
-
-                len3 = len2 - len3;
-
-                for (i=0; i < len3; i++)
-                    if (*dest1++ &= *source2++)
-                        cc = 1;
-
-                len3 = len - len2;
+    regs->psw.cc = cc;
 
-                for (i=0; i <= len3; i++)
-                    if (*dest2++ &= *source2++)
-                        cc = 1;
-            }
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
-        ARCH_DEP( or_storage_key_by_ptr )( sk2, (STORKEY_REF | STORKEY_CHANGE) );
-    }
     ITIMER_UPDATE( effective_addr1, len, regs );
-
-    regs->psw.cc = cc;
 }
 
 
@@ -2876,8 +2765,18 @@ BYTE    rbyte[4],                       /* Register bytes            */
 /*-------------------------------------------------------------------*/
 static INLINE U32 memneq( const BYTE* m1, const BYTE* m2, U32 len )
 {
+    U64  v1, v2;
     U32  i;
-    for (i=0; i < len; i++)
+
+    /* Skip equal doublewords first, then locate the unequal byte */
+    for (i=0; i + 8 <= len; i += 8)
+    {
+        memcpy( &v1, m1 + i, 8 );
+        memcpy( &v2, m2 + i, 8 );
+        if (v1 != v2)
+            break;
+    }
+    for (; i < len; i++)
         if (m1[i] != m2[i])
             break;
     return i;
@@ -3561,7 +3460,7 @@ DEF_INST(compare_logical_character_long)
 /*-------------------------------------------------------------------*/
 
 #undef   MAX_CPU_AMT
-#define  MAX_CPU_AMT    (PAGEFRAME_PAGESIZE - 256)  // for (CC=3) and 0 <  MAX_CPU_AMT < pagesize)
+#define  MAX_CPU_AMT    (32 * 1024)     // (CC=3 after this many bytes)
 
 DEF_INST(compare_logical_long_extended)
 {
@@ -3574,6 +3473,7 @@ DEF_INST(compare_logical_long_extended)
 
     U64   unpadded_len;         // work (lesser of the two lengths)
     U64   padded_len;           // work (greater length minus lesser)
+    U64   rem;                  // work (amount remaining)
     U32   in_amt;               // Work (amount to be compared)
     U32   out_amt;              // Work (amount that was found equal)
     U64   total = 0;            // TOTAL amount compared so far
@@ -3620,37 +3520,48 @@ DEF_INST(compare_logical_long_extended)
         padded_len   = len1 - len2;
     }
 
-    // Compare the unpadded part first (up to Max_CPU_AMT)
-    in_amt = unpadded_len <  MAX_CPU_AMT
-            ? unpadded_len :  MAX_CPU_AMT;
+    // Compare the unpadded part first, a page span at a time
+    // (up to MAX_CPU_AMT)
 
-    rc = ARCH_DEP( mem_cmp )( regs, addr1, r1, addr2, r3, in_amt,
-                                                        &out_amt );
-    addr1 += out_amt;
-    addr1 &= ADDRESS_MAXWRAP( regs );
-    addr2 += out_amt;
-    addr2 &= ADDRESS_MAXWRAP( regs );
-    total += out_amt;
+    rem = unpadded_len;
 
-    // Update register values
+    while (rc == 0 && rem && total < MAX_CPU_AMT)
+    {
+        // Stop each span at operand-1's next page boundary
+        in_amt = PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK);
+        if (in_amt > rem)
+            in_amt = rem;
 
-    SET_GR_A( r1, regs, addr1 );
-    wlen1 = GR_A( r1+1, regs );
-    if ( wlen1 >= out_amt)
-            SET_GR_A( r1+1, regs, wlen1 - out_amt);
-    else SET_GR_A( r1+1, regs, 0);
+        rc = ARCH_DEP( mem_cmp )( regs, addr1, r1, addr2, r3, in_amt,
+                                                            &out_amt );
+        addr1 += out_amt;
+        addr1 &= ADDRESS_MAXWRAP( regs );
+        addr2 += out_amt;
+        addr2 &= ADDRESS_MAXWRAP( regs );
+        total += out_amt;
+        rem   -= out_amt;
 
-    SET_GR_A( r3, regs, addr2 );
-    wlen3 = GR_A( r3+1, regs );
-    if ( wlen3 >= out_amt)
-            SET_GR_A( r3+1, regs, wlen3 - out_amt);
-    else SET_GR_A( r3+1, regs, 0);
+        // Must update register values as we go in case
+        // the next compare causes an access interrupt
+
+        SET_GR_A( r1, regs, addr1 );
+        wlen1 = GR_A( r1+1, regs );
+        if ( wlen1 >= out_amt)
+                SET_GR_A( r1+1, regs, wlen1 - out_amt);
+        else SET_GR_A( r1+1, regs, 0);
+
+        SET_GR_A( r3, regs, addr2 );
+        wlen3 = GR_A( r3+1, regs );
+        if ( wlen3 >= out_amt)
+                SET_GR_A( r3+1, regs, wlen3 - out_amt);
+        else SET_GR_A( r3+1, regs, 0);
+    }
 
     // Now compare the padded part, if needed
 
     if (rc == 0 && padded_len && total < MAX_CPU_AMT)
     {
-        BYTE  padding[ MAX_CPU_AMT ];
+        BYTE  padding[ PAGEFRAME_PAGESIZE ];
         VADR  addr     =  (len1 > len2) ? addr1 : addr2;
         int   r        =  (len1 > len2) ? r1    : r3;
         bool  swap_rc  =  (len1 > len2) ? false : true;
@@ -3658,30 +3569,36 @@ DEF_INST(compare_logical_long_extended)
 
         memset( padding, pad, MIN( padded_len, sizeof( padding )));
 
-        // Compare the padded part (up to Max_CPU_AMT - total (padded part))
-        in_amt = padded_len < MAX_CPU_AMT - total
-                ? padded_len : MAX_CPU_AMT - total;
+        rem = padded_len;
 
-        rc = ARCH_DEP( mem_pad_cmp )( regs, addr, r, padding, in_amt,
-                                                            &out_amt );
-        addr  += out_amt;
-        addr  &= ADDRESS_MAXWRAP( regs );
-        total += out_amt;
+        while (rc == 0 && rem && total < MAX_CPU_AMT)
+        {
+            in_amt = PAGEFRAME_PAGESIZE - (addr & PAGEFRAME_BYTEMASK);
+            if (in_amt > rem)
+                in_amt = rem;
 
-        // Update register values
+            rc = ARCH_DEP( mem_pad_cmp )( regs, addr, r, padding, in_amt,
+                                                                &out_amt );
+            addr  += out_amt;
+            addr  &= ADDRESS_MAXWRAP( regs );
+            total += out_amt;
+            rem   -= out_amt;
 
-        SET_GR_A( r, regs, addr );
-        wlen = GR_A( r+1, regs );
-        if ( wlen >= out_amt)
-            SET_GR_A( r+1, regs, wlen - out_amt);
-        else SET_GR_A( r+1, regs, 0);
+            // Update register values
+
+            SET_GR_A( r, regs, addr );
+            wlen = GR_A( r+1, regs );
+            if ( wlen >= out_amt)
+                SET_GR_A( r+1, regs, wlen - out_amt);
+            else SET_GR_A( r+1, regs, 0);
+        }
 
         if (swap_rc)
             rc = -rc;
     }
 
     // Set the condition code and return
-    if (rc == 0 && total >= MAX_CPU_AMT )
+    if (rc == 0 && total < (unpadded_len + padded_len))
         regs->psw.cc = 3;
     else
         regs->psw.cc = (!rc ? 0 : (rc < 0 ? 1 : 2));
@@ -3698,7 +3615,7 @@ DEF_INST(compare_logical_long_extended)
 DEF_INST(compare_logical_string)
 {
 int     r1, r2;                         /* Values of R fields        */
-int     i;                              /* Loop counter              */
+int     i;                              /* Index of inequality       */
 int     dist1, dist2;                   /* length working distances  */
 int     usable;                         /* usable length to page end */
 int     cpu_length;                     /* CPU determined length     */
@@ -3722,171 +3639,97 @@ BYTE    termchar;                       /* Terminating character     */
     addr1 = regs->GR( r1 ) & ADDRESS_MAXWRAP( regs );
     addr2 = regs->GR( r2 ) & ADDRESS_MAXWRAP( regs );
 
-    /* Establish minimum CPU determined length per the specification */
-    cpu_length = 256;
+    /* Compute distance to the end of the page for each operand */
+    dist1 = PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK);
+    dist2 = PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK);
 
-    /* Should either operand cross a page boundary, we need to
-       break up the search into two parts (one part in each page)
-       to meet the minimum requirement of 256 CPU determined bytes.
+    /* Establish minimum CPU determined length per the specification.
+       Should either operand cross a page boundary within it, we need
+       to break up the search into two parts (one part in each page).
+       Otherwise extend the CPU determined length out to the nearest
+       end of page of either operand.
     */
-    if (unlikely( CROSSPAGEL( addr1, cpu_length ) ||
-                  CROSSPAGEL( addr2, cpu_length )))
-    {
-        /* Compute distance to the end of the page for each operand */
-        dist1 = PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK);
-        dist2 = PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK);
-
-        while (cpu_length)
-        {
-            usable = min( dist1, dist2 );
-            usable = min( usable, cpu_length );
-
-            main1 = MADDRL(addr1, usable, r1, regs, ACCTYPE_READ, regs->psw.pkey );
-            main2 = MADDRL(addr2, usable, r2, regs, ACCTYPE_READ, regs->psw.pkey );
-
-            for (i=0; i < usable; i++)
-            {
-                /* If both bytes are the terminating character, then
-                   the strings are equal, so return CC=0 and leave
-                   the R1 and R2 registers unchanged.
-                */
-                if (*main1 == termchar && *main2 == termchar)
-                {
-                    regs->psw.cc = 0;
-                    return;
-                }
-
-                /* If FIRST operand byte is the terminating character,
-                   -OR- if the first operand byte is LOWER than the
-                   second operand byte, then return condition code 1
-                */
-                if (0
-                    || *main1 == termchar
-                    || (1
-                        && (*main1 < *main2)
-                        && (*main2 != termchar)
-                       )
-                )
-                {
-                    regs->psw.cc = 1;
-                    SET_GR_A( r1, regs,addr1 );
-                    SET_GR_A( r2, regs,addr2 );
-                    return;
-                }
-
-                /* If SECOND operand byte is the terminating character,
-                   -OR- if the first operand byte is HIGHER than the
-                   second operand byte, then return condition code 2.
-                */
-                if (*main2 == termchar || *main1 > *main2)
-                {
-                    regs->psw.cc = 2;
-                    SET_GR_A( r1, regs,addr1 );
-                    SET_GR_A( r2, regs,addr2 );
-                    return;
-                }
-
-                /* Bump both operands to the next byte */
-                main1++;
-                main2++;
-
-                addr1++;
-                addr1 &= ADDRESS_MAXWRAP( regs );
-
-                addr2++;
-                addr2 &= ADDRESS_MAXWRAP( regs );
-
-            } /* end for(i) */
-
-            /* Adjust all counts by number of bytes scanned */
-            cpu_length -= usable;
-            dist1      -= usable;
-            dist2      -= usable;
-
-            /* If either operand dist value is 0, then we're at a page
-               boundary. Adjust the remaining distance to the remaining
-               CPU determined length.
-            */
-            if (!dist1) dist1 = cpu_length;
-            if (!dist2) dist2 = cpu_length;
-
-        } /* end while */
+    cpu_length = 256;
 
-        /* CPU determine number of bytes reached without finding any
-           inequality. Set CC=3 and exit with the current position
-           updated in the operand registers.
-        */
-        regs->psw.cc = 3;
-        SET_GR_A( r1, regs,addr1 );
-        SET_GR_A( r2, regs,addr2 );
-        return;
+    if (likely( !CROSSPAGEL( addr1, cpu_length ) &&
+                !CROSSPAGEL( addr2, cpu_length )))
+        cpu_length = min( dist1, dist2 ); /* (nearest end of page) */
 
-    } /* end if */
+    while (cpu_length)
+    {
+        usable = min( dist1, dist2 );
+        usable = min( usable, cpu_length );
 
-    /* Neither operand crosses a page boundary using the minimum
-       length, so extend the CPU determined length out to the
-       nearest end of page of either operand.
-    */
-    dist1 = PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK);
-    dist2 = PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK);
+        main1 = MADDRL(addr1, usable, r1, regs, ACCTYPE_READ, regs->psw.pkey );
+        main2 = MADDRL(addr2, usable, r2, regs, ACCTYPE_READ, regs->psw.pkey );
 
-    cpu_length = min( dist1, dist2 ); /* (nearest end of page) */
-    main1 = MADDRL(addr1, cpu_length, r1, regs, ACCTYPE_READ, regs->psw.pkey );
-    main2 = MADDRL(addr2, cpu_length, r2, regs, ACCTYPE_READ, regs->psw.pkey );
+        /* Locate the first inequality within this part */
+        i = memneq( main1, main2, usable );
 
-    for (i=0; i < cpu_length; i++)
-    {
-        /* If both bytes are the terminating character, then
-           the strings are equal, so return CC=0 and leave
-           the R1 and R2 registers unchanged.
+        /* If both bytes are the terminating character before any
+           inequality, then the strings are equal, so return CC=0
+           and leave the R1 and R2 registers unchanged.
         */
-        if (*main1 == termchar && *main2 == termchar)
+        if (memchr( main1, termchar, i ))
         {
             regs->psw.cc = 0;
             return;
         }
 
-        /* If FIRST operand byte is the terminating character,
-           -OR- if the first operand byte is LOWER than the
-           second operand byte, then return CC=1
-        */
-        if (0
-            || *main1 == termchar
-            || (1
-                && (*main1 < *main2)
-                && (*main2 != termchar)
-               )
-        )
+        if (i < usable)
         {
-            regs->psw.cc = 1;
-            SET_GR_A( r1, regs,addr1 );
-            SET_GR_A( r2, regs,addr2 );
-            return;
-        }
+            main1 += i;
+            main2 += i;
+
+            /* If FIRST operand byte is the terminating character,
+               -OR- if the first operand byte is LOWER than the
+               second operand byte, then return condition code 1.
+               If SECOND operand byte is the terminating character,
+               -OR- if the first operand byte is HIGHER than the
+               second operand byte, then return condition code 2.
+            */
+            if (0
+                || *main1 == termchar
+                || (1
+                    && (*main1 < *main2)
+                    && (*main2 != termchar)
+                   )
+            )
+                regs->psw.cc = 1;
+            else
+                regs->psw.cc = 2;
+
+            addr1 += i;
+            addr1 &= ADDRESS_MAXWRAP( regs );
+
+            addr2 += i;
+            addr2 &= ADDRESS_MAXWRAP( regs );
 
-        /* If SECOND operand byte is the terminating character,
-           -OR- if the first operand byte is HIGHER than the
-           second operand byte, then return CC=2.
-        */
-        if (*main2 == termchar || *main1 > *main2)
-        {
-            regs->psw.cc = 2;
             SET_GR_A( r1, regs,addr1 );
             SET_GR_A( r2, regs,addr2 );
             return;
         }
 
-        /* Bump both operands to the next byte */
-        main1++;
-        main2++;
-
-        addr1++;
+        /* Bump both operands past the part just compared */
+        addr1 += usable;
         addr1 &= ADDRESS_MAXWRAP( regs );
 
-        addr2++;
+        addr2 += usable;
         addr2 &= ADDRESS_MAXWRAP( regs );
 
-    } /* end for(i) */
+        /* Adjust all counts by number of bytes scanned */
+        cpu_length -= usable;
+        dist1      -= usable;
+        dist2      -= usable;
+
+        /* If either operand dist value is 0, then we're at a page
+           boundary. Adjust the remaining distance to the remaining
+           CPU determined length.
+        */
+        if (!dist1) dist1 = cpu_length;
+        if (!dist2) dist2 = cpu_length;
+
+    } /* end while */
 
     /* CPU determine number of bytes reached without finding any
        inequality. Set CC=3 and exit with the current position
@@ -5547,14 +5390,13 @@ BYTE   *dest;                           /* Pointer to target byte    */
 /*-------------------------------------------------------------------*/
 DEF_INST(exclusive_or_character)
 {
-int     len, len2, len3;                /* Lengths to copy           */
+int     len;                            /* Length minus 1            */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1;                /* Virtual address           */
 VADR    effective_addr2;                /* Virtual address           */
-BYTE   *dest1, *dest2;                  /* Destination addresses     */
-BYTE   *source1, *source2;              /* Source addresses          */
-BYTE   *sk1, *sk2;                      /* Storage key addresses     */
-int     i;                              /* Loop counter              */
+OPWIN   w1, w2;                         /* Operand windows           */
+BYTE   *dest, *source;                  /* Mainstor addresses        */
+int     off, n;                         /* Offset and run length     */
 int     cc = 0;                         /* Condition code            */
 
     SS_L( inst, regs, len, b1, effective_addr1, b2, effective_addr2 );
@@ -5568,150 +5410,32 @@ int     cc = 0;                         /* Condition code            */
     /* Quick out for 1 byte (no boundary crossed) */
     if (unlikely( !len ))
     {
-        source1 = MADDR( effective_addr2, b2, regs, ACCTYPE_READ,  regs->psw.pkey );
-        dest1   = MADDR( effective_addr1, b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
-        if (*dest1 ^= *source1)
+        source = MADDR( effective_addr2, b2, regs, ACCTYPE_READ,  regs->psw.pkey );
+        dest   = MADDR( effective_addr1, b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
+        if (*dest ^= *source)
             cc = 1;
         regs->psw.cc = cc;
         return;
     }
 
-    /* There are several scenarios (in optimal order):
-     * (1) dest boundary and source boundary not crossed
-     *     (a) dest and source are the same, set dest to zeroes
-     *     (b) dest and source are not the same
-     * (2) dest boundary not crossed and source boundary crossed
-     * (3) dest boundary crossed and source boundary not crossed
-     * (4) dest boundary and source boundary are crossed
-     *     (a) dest and source boundary cross at the same time
-     *     (b) dest boundary crossed first
-     *     (c) source boundary crossed first
-     */
+    /* Translate both operands (and both pages of each if needed) */
+    ARCH_DEP( opwin )( &w1, effective_addr1, len, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
+    ARCH_DEP( opwin )( &w2, effective_addr2, len, b2, regs, ACCTYPE_READ,      regs->psw.pkey );
 
-    /* Translate addresses of leftmost operand bytes */
-    dest1 = MADDRL( effective_addr1, len + 1, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-    sk1 = regs->dat.storkey;
-    source1 = MADDRL(effective_addr2, len + 1, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-
-    if (NOCROSSPAGE( effective_addr1, len ))
-    {
-        if (NOCROSSPAGE( effective_addr2, len ))
-        {
-            /* (1) - No boundaries are crossed */
-            if (dest1 == source1)
-            {
-               /* (1a) - Dest and source are the same */
-               memset( dest1, 0, len + 1 );
-            }
-            else
-            {
-               /* (1b) - Dest and source are not the sam */
-                for (i=0; i <= len; i++)
-                    if (*dest1++ ^= *source1++)
-                        cc = 1;
-            }
-        }
-        else
-        {
-             /* (2) - Second operand crosses a boundary */
-             len2 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-             source2 = MADDRL((effective_addr2 + len2) & ADDRESS_MAXWRAP( regs ),
-               len + 1 - len2, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-             for (i=0; i < len2; i++)
-                 if (*dest1++ ^= *source1++)
-                     cc = 1;
-
-             len2 = len - len2;
-
-             for (i=0; i <= len2; i++)
-                 if (*dest1++ ^= *source2++)
-                     cc = 1;
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
-    }
-    else
+    /* Process each run of bytes contiguous in both operands */
+    for (off=0; off <= len; off += n)
     {
-        /* First operand crosses a boundary */
-        len2 = PAGEFRAME_PAGESIZE - (effective_addr1 & PAGEFRAME_BYTEMASK);
-        dest2 = MADDRL((effective_addr1 + len2) & ADDRESS_MAXWRAP( regs ),
-         len + 1 - len2, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-        sk2 = regs->dat.storkey;
-
-        if (NOCROSSPAGE( effective_addr2, len ))
-        {
-             /* (3) - First operand crosses a boundary */
-             for (i=0; i < len2; i++)
-                 if (*dest1++ ^= *source1++)
-                     cc = 1;
+        n = opwin_run( &w1, &w2, off, &dest, &source );
 
-             len2 = len - len2;
-
-             for (i=0; i <= len2; i++)
-                 if (*dest2++ ^= *source1++)
-                     cc = 1;
-        }
-        else
-        {
-            /* (4) - Both operands cross a boundary */
-            len3 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-            source2 = MADDRL((effective_addr2 + len3) & ADDRESS_MAXWRAP( regs ),
-              len + 1 - len3, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-            if (len2 == len3)
-            {
-                /* (4a) - Both operands cross at the same time */
-                for (i=0; i < len2; i++)
-                    if (*dest1++ ^= *source1++)
-                        cc = 1;
-
-                len2 = len - len2;
-
-                for (i=0; i <= len2; i++)
-                    if (*dest2++ ^= *source2++)
-                        cc = 1;
-            }
-            else if (len2 < len3)
-            {
-                /* (4b) - First operand crosses first */
-                for (i=0; i < len2; i++)
-                    if (*dest1++ ^= *source1++)
-                        cc = 1;
-
-                len2 = len3 - len2;
-
-                for (i=0; i < len2; i++)
-                    if (*dest2++ ^= *source1++)
-                        cc = 1;
-
-                len2 = len - len3;
-
-                for (i=0; i <= len2; i++)
-                    if (*dest2++ ^= *source2++)
-                        cc = 1;
-            }
-            else
-            {
-                /* (4c) - Second operand crosses first */
-                for (i=0; i < len3; i++)
-                    if (*dest1++ ^= *source1++)
-                        cc = 1;
-
-                len3 = len2 - len3;
-
-                for (i=0; i < len3; i++)
-                    if (*dest1++ ^= *source2++)
-                        cc = 1;
-
-                len3 = len - len2;
-
-                for (i=0; i <= len3; i++)
-                    if (*dest2++ ^= *source2++)
-                        cc = 1;
-            }
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
-        ARCH_DEP( or_storage_key_by_ptr )( sk2, (STORKEY_REF | STORKEY_CHANGE) );
+        /* Same operand: the result is all zeroes */
+        if (dest == source)
+            memset( dest, 0, n );
+        else if (opwin_bitop( dest, source, n, OPWIN_XOR ))
+            cc = 1;
     }
 
+    ARCH_DEP( opwin_changed )( &w1 );
+
     regs->psw.cc = cc;
 
     ITIMER_UPDATE(effective_addr1,len,regs);
@@ -6905,6 +6629,9 @@ int     orglen1;                        /* Original dest length      */
 /*-------------------------------------------------------------------*/
 /* A8   MVCLE - Move Long Extended                            [RS-a] */
 /*-------------------------------------------------------------------*/
+#undef   MAX_CPU_AMT
+#define  MAX_CPU_AMT    (32 * 1024)     // (CC=3 after this many bytes)
+
 DEF_INST(move_long_extended)
 {
 int     r1, r3;                         /* Register numbers          */
@@ -6916,6 +6643,7 @@ GREG    len1, len2;                     /* Operand lengths           */
 BYTE    pad;                            /* Padding byte              */
 size_t  cpu_length;                     /* cpu determined length     */
 size_t  copylen;                        /* Length to copy            */
+size_t  total;                          /* Amount moved so far       */
 BYTE    *dest;                          /* Maint storage pointers    */
 size_t  dstlen,srclen;                  /* Page wide src/dst lengths */
 
@@ -6936,20 +6664,9 @@ size_t  dstlen,srclen;                  /* Page wide src/dst lengths */
     len1 = GR_A(r1+1, regs);
     len2 = GR_A(r3+1, regs);
 
-    /* set cpu_length as shortest distance to new page */
-    if ((addr1 & 0xFFF) > (addr2 & 0xFFF))
-        cpu_length = 0x1000 - (addr1 & 0xFFF);
-    else
-        cpu_length = 0x1000 - (addr2 & 0xFFF);
-
-    dstlen=MIN(cpu_length,len1);
-    srclen=MIN(cpu_length,len2);
-    copylen=MIN(dstlen,srclen);
-
     /* Set the condition code according to the lengths */
     cc = (len1 < len2) ? 1 : (len1 > len2) ? 2 : 0;
 
-    /* Obtain destination pointer */
     if(len1==0)
     {
         /* bail out if nothing to do */
@@ -6957,40 +6674,62 @@ size_t  dstlen,srclen;                  /* Page wide src/dst lengths */
         return;
     }
 
-    dest = MADDRL (addr1, len1, r1, regs, ACCTYPE_WRITE, regs->psw.pkey);
-    if(copylen!=0)
-    {
-        /* here if we need to copy data */
-        BYTE *source;
-        /* get source frame and copy concurrently */
-        source = MADDRL(addr2, copylen, r3, regs, ACCTYPE_READ, regs->psw.pkey);
-        concpy(regs,dest,source,(int)copylen);
-        /* Adjust operands */
-        addr2+=(int)copylen;
-        len2-=(int)copylen;
-        addr1+=(int)copylen;
-        len1-=(int)copylen;
-
-        /* Adjust length & pointers for this cycle */
-        dest+=copylen;
-        dstlen-=copylen;
-        srclen-=copylen;
-    }
-    if(srclen==0 && dstlen!=0)
+    /* Move one page span at a time until the CPU determined amount
+       is reached. The registers are updated after each span in case
+       the next one causes an access interrupt. */
+    for (total = 0; len1 && total < MAX_CPU_AMT; )
     {
-        /* here if we need to pad the destination */
-        memset(dest,pad,dstlen);
+        /* set cpu_length as shortest distance to new page */
+        if ((addr1 & 0xFFF) > (addr2 & 0xFFF))
+            cpu_length = 0x1000 - (addr1 & 0xFFF);
+        else
+            cpu_length = 0x1000 - (addr2 & 0xFFF);
+
+        dstlen=MIN(cpu_length,len1);
+        srclen=MIN(cpu_length,len2);
+        copylen=MIN(dstlen,srclen);
+        total+=dstlen;
+
+        /* Obtain destination pointer */
+        dest = MADDRL (addr1, dstlen, r1, regs, ACCTYPE_WRITE, regs->psw.pkey);
+        if(copylen!=0)
+        {
+            /* here if we need to copy data */
+            BYTE *source;
+            /* get source frame and copy concurrently */
+            source = MADDRL(addr2, copylen, r3, regs, ACCTYPE_READ, regs->psw.pkey);
+            concpy(regs,dest,source,(int)copylen);
+            /* Adjust operands */
+            addr2+=(int)copylen;
+            addr2&=ADDRESS_MAXWRAP(regs);
+            len2-=(int)copylen;
+            addr1+=(int)copylen;
+            addr1&=ADDRESS_MAXWRAP(regs);
+            len1-=(int)copylen;
+
+            /* Adjust length & pointers for this cycle */
+            dest+=copylen;
+            dstlen-=copylen;
+            srclen-=copylen;
+        }
+        if(srclen==0 && dstlen!=0)
+        {
+            /* here if we need to pad the destination */
+            memset(dest,pad,dstlen);
+
+            /* Adjust destination operands */
+            addr1+=(int)dstlen;
+            addr1&=ADDRESS_MAXWRAP(regs);
+            len1-=(int)dstlen;
+        }
 
-        /* Adjust destination operands */
-        addr1+=(int)dstlen;
-        len1-=(int)dstlen;
+        /* Update the registers */
+        SET_GR_A(r1, regs,addr1);
+        SET_GR_A(r1+1, regs,len1);
+        SET_GR_A(r3, regs,addr2);
+        SET_GR_A(r3+1, regs,len2);
     }
 
-    /* Update the registers */
-    SET_GR_A(r1, regs,addr1);
-    SET_GR_A(r1+1, regs,len1);
-    SET_GR_A(r3, regs,addr2);
-    SET_GR_A(r3+1, regs,len2);
     /* if len1 != 0 then set CC to 3 to indicate
        we have reached end of CPU dependent length */
     if(len1>0) cc=3;
@@ -7188,7 +6927,31 @@ BYTE    termchar;                       /* Terminating character     */
     main1 = MADDRL( addr1, cpu_length, r1, regs, ACCTYPE_WRITE, regs->psw.pkey );
     main2 = MADDRL( addr2, cpu_length, r2, regs, ACCTYPE_READ,  regs->psw.pkey );
 
-    for (i=0; i < cpu_length; i++)
+    /* When the operands do not overlap, locate the terminating
+       character first and move everything up to it in one go */
+    if (main1 + cpu_length <= main2 || main2 + cpu_length <= main1)
+    {
+        BYTE* term = memchr( main2, termchar, cpu_length );
+
+        i = term ? (int)(term - main2) + 1 : cpu_length;
+        memcpy( main1, main2, i );
+
+        if (term)
+        {
+            /* Set CC=1 and the R1 register to the location of the
+               just moved terminating character, leaving R2 unchanged */
+            regs->psw.cc = 1;
+            SET_GR_A( r1, regs, (addr1 + i - 1) & ADDRESS_MAXWRAP( regs ));
+            return;
+        }
+
+        addr1 += i;
+        addr1 &= ADDRESS_MAXWRAP( regs );
+
+        addr2 += i;
+        addr2 &= ADDRESS_MAXWRAP( regs );
+    }
+    else for (i=0; i < cpu_length; i++)
     {
         /* Move a single byte */
         *main1 = *main2;
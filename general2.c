@@ -124,14 +124,13 @@ BYTE   *dest;                           /* Pointer to target byte    */
 /*-------------------------------------------------------------------*/
 DEF_INST(or_character)
 {
-int     len, len2, len3;                /* Lengths to copy           */
+int     len;                            /* Length minus 1            */
 int     b1, b2;                         /* Base register numbers     */
 VADR    effective_addr1;                /* Virtual address           */
 VADR    effective_addr2;                /* Virtual address           */
-BYTE   *dest1, *dest2;                  /* Destination addresses     */
-BYTE   *source1, *source2;              /* Source addresses          */
-BYTE   *sk1, *sk2;                      /* Storage key addresses     */
-int     i;                              /* Loop counter              */
+OPWIN   w1, w2;                         /* Operand windows           */
+BYTE   *dest, *source;                  /* Mainstor addresses        */
+int     off, n;                         /* Offset and run length     */
 int     cc = 0;                         /* Condition code            */
 
     SS_L( inst, regs, len, b1, effective_addr1, b2, effective_addr2 );
@@ -145,139 +144,28 @@ int     cc = 0;                         /* Condition code            */
     /* Quick out for 1 byte (no boundary crossed) */
     if (unlikely( !len ))
     {
-        source1 = MADDR( effective_addr2,  b2, regs, ACCTYPE_READ,  regs->psw.pkey );
-        dest1   = MADDR( effective_addr1,  b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
-        *dest1 |= *source1;
-        regs->psw.cc = (*dest1 != 0);
+        source = MADDR( effective_addr2,  b2, regs, ACCTYPE_READ,  regs->psw.pkey );
+        dest   = MADDR( effective_addr1,  b1, regs, ACCTYPE_WRITE, regs->psw.pkey );
+        *dest |= *source;
+        regs->psw.cc = (*dest != 0);
         ITIMER_UPDATE( effective_addr1, len, regs );
         return;
     }
 
-    /* There are several scenarios (in optimal order):
-     * (1) dest boundary and source boundary not crossed
-     * (2) dest boundary not crossed and source boundary crossed
-     * (3) dest boundary crossed and source boundary not crossed
-     * (4) dest boundary and source boundary are crossed
-     *     (a) dest and source boundary cross at the same time
-     *     (b) dest boundary crossed first
-     *     (c) source boundary crossed first
-     */
-
-    /* Translate addresses of leftmost operand bytes */
-    dest1 = MADDRL( effective_addr1, len+1, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-    sk1 = regs->dat.storkey;
-    source1 = MADDRL( effective_addr2, len+1, b2, regs, ACCTYPE_READ, regs->psw.pkey );
-
-    if (NOCROSSPAGE( effective_addr1, len ))
-    {
-        if (NOCROSSPAGE( effective_addr2, len ))
-        {
-            /* (1) - No boundaries are crossed */
-            for (i=0; i <= len; i++)
-                if ((*dest1++ |= *source1++))
-                    cc = 1;
-        }
-        else
-        {
-             /* (2) - Second operand crosses a boundary */
-             len2 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-             source2 = MADDRL((effective_addr2 + len2) & ADDRESS_MAXWRAP( regs ),
-              len + 1 - len2,  b2, regs, ACCTYPE_READ, regs->psw.pkey );
-             for (i=0; i < len2; i++)
-                 if ( (*dest1++ |= *source1++) )
-                     cc = 1;
-
-             len2 = len - len2;
+    /* Translate both operands (and both pages of each if needed) */
+    ARCH_DEP( opwin )( &w1, effective_addr1, len, b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
+    ARCH_DEP( opwin )( &w2, effective_addr2, len, b2, regs, ACCTYPE_READ,      regs->psw.pkey );
 
-             for (i=0; i <= len2; i++)
-                 if ( (*dest1++ |= *source2++) )
-                     cc = 1;
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
-    }
-    else
+    /* Process each run of bytes contiguous in both operands */
+    for (off=0; off <= len; off += n)
     {
-        /* First operand crosses a boundary */
-        len2 = PAGEFRAME_PAGESIZE - (effective_addr1 & PAGEFRAME_BYTEMASK);
-        dest2 = MADDRL((effective_addr1 + len2) & ADDRESS_MAXWRAP( regs ),
-         len + 1 - len2,b1, regs, ACCTYPE_WRITE_SKP, regs->psw.pkey );
-        sk2 = regs->dat.storkey;
-
-        if (NOCROSSPAGE( effective_addr2, len ))
-        {
-             /* (3) - First operand crosses a boundary */
-             for (i=0; i < len2; i++)
-                 if ((*dest1++ |= *source1++))
-                     cc = 1;
-
-             len2 = len - len2;
-
-             for (i=0; i <= len2; i++)
-                 if ((*dest2++ |= *source1++))
-                     cc = 1;
-        }
-        else
-        {
-            /* (4) - Both operands cross a boundary */
-            len3 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
-            source2 = MADDRL((effective_addr2 + len3) & ADDRESS_MAXWRAP( regs ),
-             len + 1 - len3,  b2, regs, ACCTYPE_READ, regs->psw.pkey );
-            if (len2 == len3)
-            {
-                /* (4a) - Both operands cross at the same time */
-                for (i=0; i < len2; i++)
-                    if ((*dest1++ |= *source1++))
-                        cc = 1;
-
-                len2 = len - len2;
-
-                for (i=0; i <= len2; i++)
-                    if ((*dest2++ |= *source2++))
-                        cc = 1;
-            }
-            else if (len2 < len3)
-            {
-                /* (4b) - First operand crosses first */
-                for (i=0; i < len2; i++)
-                    if ((*dest1++ |= *source1++))
-                        cc = 1;
-
-                len2 = len3 - len2;
-
-                for (i=0; i < len2; i++)
-                    if ((*dest2++ |= *source1++))
-                        cc = 1;
-
-                len2 = len - len3;
-
-                for (i=0; i <= len2; i++)
-                    if ((*dest2++ |= *source2++))
-                        cc = 1;
-            }
-            else
-            {
-                /* (4c) - Second operand crosses first */
-                for ( i = 0; i < len3; i++)
-                    if ((*dest1++ |= *source1++))
-                        cc = 1;
-
-                len3 = len2 - len3;
-
-                for (i=0; i < len3; i++)
-                    if ((*dest1++ |= *source2++))
-                        cc = 1;
-
-                len3 = len - len2;
-
-                for (i=0; i <= len3; i++)
-                    if ((*dest2++ |= *source2++))
-                        cc = 1;
-            }
-        }
-        ARCH_DEP( or_storage_key_by_ptr )( sk1, (STORKEY_REF | STORKEY_CHANGE) );
-        ARCH_DEP( or_storage_key_by_ptr )( sk2, (STORKEY_REF | STORKEY_CHANGE) );
+        n = opwin_run( &w1, &w2, off, &dest, &source );
+        if (opwin_bitop( dest, source, n, OPWIN_OR ))
+            cc = 1;
     }
 
+    ARCH_DEP( opwin_changed )( &w1 );
+
     regs->psw.cc = cc;
 
     ITIMER_UPDATE( effective_addr1, len, regs );
@@ -536,13 +424,58 @@ VADR    effective_addr2,
 
 
 #if defined( FEATURE_STRING_INSTRUCTION )
+/*-------------------------------------------------------------------*/
+/* Search one page span of an SRST operand. Returns true if the      */
+/* instruction completed (CC=1 or CC=2 set), else advances addr2.    */
+/*-------------------------------------------------------------------*/
+static INLINE bool ARCH_DEP( srst_span )( REGS* regs, int r1, BYTE termchar,
+                                          BYTE* main2, VADR* addr1, VADR* addr2,
+                                          int len )
+{
+    BYTE*  term;
+    int    n = len;
+
+    /* NOTE: "When the address in general register R1 is less
+       than the address in general register R2, condition code
+       2 can be set only if the operand wraps around from the
+       top of storage to location 0."  Hence the end address can
+       only be reached within this span if it lies at or after
+       the current address. (A span never wraps: it ends at a page
+       boundary, and the wrap point is a page boundary too.)
+    */
+    if (*addr1 >= *addr2 && *addr1 - *addr2 < (VADR) len)
+        n = (int)(*addr1 - *addr2);
+
+    /* If the terminating character was found, return
+       CC=1 and load the address of the character in R1 */
+    if ((term = memchr( main2, termchar, n )))
+    {
+        SET_GR_A( r1, regs, (*addr2 + (term - main2)) & ADDRESS_MAXWRAP( regs ));
+        regs->psw.cc = 1;
+        return true;
+    }
+
+    /* If operand end address has been reached, return
+       CC=2 and leave the R1 and R2 registers unchanged
+    */
+    if (n < len)
+    {
+        regs->psw.cc = 2;
+        return true;
+    }
+
+    /* Bump operand-2 past the span */
+    *addr2 += len;
+    *addr2 &= ADDRESS_MAXWRAP( regs );
+    return false;
+}
+
 /*-------------------------------------------------------------------*/
 /* B25E SRST  - Search String                                  [RRE] */
 /*-------------------------------------------------------------------*/
 DEF_INST(search_string)
 {
 int     r1, r2;                         /* Values of R fields        */
-int     i;                              /* Loop counter              */
 int     dist;                           /* length working distance   */
 int     cpu_length;                     /* CPU determined length     */
 VADR    addr1, addr2;                   /* End/start addresses       */
@@ -595,38 +528,8 @@ BYTE    termchar;                       /* Terminating character     */
                 return;
             }
             main2 = MADDRL(addr2, cpu_length, r2, regs, ACCTYPE_READ, regs->psw.pkey );
-            for (i=0; i < dist; i++)
-            {
-                /* If operand end address has been reached, return
-                   CC=2 and leave the R1 and R2 registers unchanged
-                */
-                /* NOTE: "When the address in general register R1 is
-                   less than the address in general register R2, then
-                   condition code 2 can be set only when the operand
-                   wraps around from the top of storage to location 0."
-                   Thus the below == comparison is correct.
-                */
-                if (addr2 == addr1)
-                {
-                    regs->psw.cc = 2;
-                    return;
-                }
-
-                /* Set CC=1 if the terminating character was found,
-                   and load the address of that character into R1 */
-                if (*main2 == termchar)
-                {
-                    SET_GR_A( r1, regs, addr2 );
-                    regs->psw.cc = 1;
-                    return;
-                }
-
-                /* Bump operand-2 */
-                main2++;
-                addr2++;
-                addr2 &= ADDRESS_MAXWRAP( regs );
-
-            } /* end for(i) */
+            if (ARCH_DEP( srst_span )( regs, r1, termchar, main2, &addr1, &addr2, dist ))
+                return;
 
             cpu_length -= dist;
             dist = cpu_length;
@@ -662,38 +565,8 @@ BYTE    termchar;                       /* Terminating character     */
     }
 
     main2 = MADDRL(addr2, cpu_length, r2, regs, ACCTYPE_READ, regs->psw.pkey );
-    for (i=0; i < cpu_length; i++)
-    {
-        /* If operand end address has been reached, return
-           CC=2 and leave the R1 and R2 registers unchanged
-        */
-        /* NOTE: "When the address in general register R1 is less
-           than the address in general register R2, condition code
-           2 can be set only if the operand wraps around from the
-           top of storage to location 0."  The below comparison
-           for == is thus correct.
-        */
-        if (addr2 == addr1)
-        {
-            regs->psw.cc = 2;
-            return;
-        }
-
-        /* If the terminating character was found, return
-           CC=1 and load the address of the character in R1 */
-        if (*main2 == termchar)
-        {
-            SET_GR_A( r1, regs, addr2 );
-            regs->psw.cc = 1;
-            return;
-        }
-
-        /* Bump operand-2 */
-        main2++;
-        addr2++;
-        addr2 &= ADDRESS_MAXWRAP( regs );
-
-    } /* end for(i) */
+    if (ARCH_DEP( srst_span )( regs, r1, termchar, main2, &addr1, &addr2, cpu_length ))
+        return;
 
     /* The CPU determine number of bytes has been reached.
        Set R2 to point to next character of operand-2 and
@@ -1947,6 +1820,110 @@ U16     h2;                             /* 16-bit operand values     */
 #endif /* defined( FEATURE_IMMEDIATE_AND_RELATIVE ) */
 
 
+#ifndef TRANSLATE_KERNELS_DEFINED
+#define TRANSLATE_KERNELS_DEFINED
+/*-------------------------------------------------------------------*/
+/* Host kernels for the translate family, operating on one run of    */
+/* mainstor. Each handles eight bytes per iteration: the argument    */
+/* bytes are all fetched before any result byte is stored, which is  */
+/* what lets the host overlap the table lookups. Only valid when the */
+/* run does not overlap the table; callers check or use a copy.      */
+/*-------------------------------------------------------------------*/
+
+/* Translate n bytes at d in place through the 256-byte table tab */
+static INLINE void tr_kernel( BYTE* d, const BYTE* tab, int n )
+{
+    int  i = 0;
+
+    if (d + n <= tab || tab + 256 <= d)
+    {
+        for (; i + 8 <= n; i += 8)
+        {
+            BYTE t0 = tab[ d[i+0] ], t1 = tab[ d[i+1] ];
+            BYTE t2 = tab[ d[i+2] ], t3 = tab[ d[i+3] ];
+            BYTE t4 = tab[ d[i+4] ], t5 = tab[ d[i+5] ];
+            BYTE t6 = tab[ d[i+6] ], t7 = tab[ d[i+7] ];
+
+            d[i+0] = t0; d[i+1] = t1; d[i+2] = t2; d[i+3] = t3;
+            d[i+4] = t4; d[i+5] = t5; d[i+6] = t6; d[i+7] = t7;
+        }
+    }
+    for (; i < n; i++)
+        d[i] = tab[ d[i] ];
+}
+
+/* Index of the first of n bytes at s with a non-zero function byte,
+   or n if none. The function byte is returned in *fc (zero if none) */
+static INLINE int trt_kernel( const BYTE* s, const BYTE* tab, int n, BYTE* fc )
+{
+    int  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+        if (0
+            | tab[ s[i+0] ] | tab[ s[i+1] ] | tab[ s[i+2] ] | tab[ s[i+3] ]
+            | tab[ s[i+4] ] | tab[ s[i+5] ] | tab[ s[i+6] ] | tab[ s[i+7] ]
+        )
+            break;
+
+    for (; i < n; i++)
+        if ((*fc = tab[ s[i] ]))
+            return i;
+
+    *fc = 0;
+    return n;
+}
+
+/* Same as trt_kernel but scanning n bytes backwards from s, so the
+   byte examined k-th is s[-k]. Returns k of the hit or n if none.  */
+static INLINE int trtr_kernel( const BYTE* s, const BYTE* tab, int n, BYTE* fc )
+{
+    int  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+        if (0
+            | tab[ s[-i-0] ] | tab[ s[-i-1] ] | tab[ s[-i-2] ] | tab[ s[-i-3] ]
+            | tab[ s[-i-4] ] | tab[ s[-i-5] ] | tab[ s[-i-6] ] | tab[ s[-i-7] ]
+        )
+            break;
+
+    for (; i < n; i++)
+        if ((*fc = tab[ s[-i] ]))
+            return i;
+
+    *fc = 0;
+    return n;
+}
+
+/* Translate n bytes at d in place, stopping at the first byte equal
+   to tbyte. Returns the number of bytes translated. tab must not
+   overlap d (TRE always passes its private copy of the table).     */
+static INLINE int tre_kernel( BYTE* d, const BYTE* tab, int n, BYTE tbyte )
+{
+    U64  ones = 0x0101010101010101ULL;
+    U64  pat  = ones * tbyte;
+    U64  x;
+    int  i;
+
+    for (i=0; i + 8 <= n; i += 8)
+    {
+        /* Stop at any 8-byte group containing the test byte */
+        memcpy( &x, d + i, 8 );
+        x ^= pat;
+        if ((x - ones) & ~x & (ones << 7))
+            break;
+        tr_kernel( d + i, tab, 8 );
+    }
+    for (; i < n; i++)
+    {
+        if (d[i] == tbyte)
+            break;
+        d[i] = tab[ d[i] ];
+    }
+    return i;
+}
+#endif // TRANSLATE_KERNELS_DEFINED
+
+
 /*-------------------------------------------------------------------*/
 /* DC   TR    - Translate                                     [SS-a] */
 /*-------------------------------------------------------------------*/
@@ -1982,8 +1959,9 @@ BYTE   *dest, *dest2 = NULL, *tab, *tab2; /* Mainstor pointers       */
     {
         tab = MADDRL(effective_addr2, 256, b2, regs, ACCTYPE_READ, regs->psw.pkey );
         /* Perform translate function */
-        for (i=0; i <= len;  i++) dest [i] = tab[dest [i]];
-        for (i=0; i <= len2; i++) dest2[i] = tab[dest2[i]];
+        tr_kernel( dest, tab, len+1 );
+        if (dest2)
+            tr_kernel( dest2, tab, len2+1 );
     }
     else /* Translate table spans a boundary */
     {
@@ -2025,66 +2003,75 @@ BYTE   *dest, *dest2 = NULL, *tab, *tab2; /* Mainstor pointers       */
 /*-------------------------------------------------------------------*/
 DEF_INST(translate_and_test)
 {
-CACHE_ALIGN BYTE op1[256], op2[256];    /* Operand work areas        */
+BYTE   *op1, *tab = NULL, *tab2 = NULL; /* Mainstor pointers         */
 VADR    effective_addr1;                /* Effective address         */
 VADR    effective_addr2;                /* Effective address         */
 int     b1, b2;                         /* Base registers            */
 int     len;                            /* Length - 1                */
-int     i;                              /* work variable             */
+int     i, k, n, n2;                    /* work variables            */
 int     cc = 0;                         /* Condition code            */
 BYTE    dbyte, sbyte = 0;               /* Byte work areas           */
-bool    op1crosses, op2crosses;         /* Operand crosses Page Bdy  */
+bool    op2crosses;                     /* Operand crosses Page Bdy  */
 
     SS_L( inst, regs, len, b1, effective_addr1, b2, effective_addr2 );
     PER_ZEROADDR_XCHECK2( regs, b1, b2 );
 
     TXFC_INSTR_CHECK( regs );
 
-    /* Copy operand-1 data to work area if within same page */
-    if (!(op1crosses = CROSSPAGE( effective_addr1, len )))
-        ARCH_DEP( vfetchc )( op1, len, effective_addr1, b1, regs );
+    /* Bytes of the function code table on its first page */
+    op2crosses = CROSSPAGE( effective_addr2, 256-1 );
+    n2 = PAGEFRAME_PAGESIZE - (effective_addr2 & PAGEFRAME_BYTEMASK);
 
-    /* Copy operand-2 data to work area if within same page */
-    if (!(op2crosses = CROSSPAGE( effective_addr2, 256-1 )))
-        ARCH_DEP( vfetchc )( op2, 256-1, effective_addr2, b2, regs );
-
-    /* Process first operand from left to right */
-    if (unlikely( op1crosses ))
+    /* Process first operand from left to right, one page at a time */
+    for (i=0; i <= len; i += n)
     {
-        /* Operand-1 crosses a page boundary */
-        if (unlikely( op2crosses ))
+        n = len - i + 1;
+        if (CROSSPAGE( effective_addr1 + i, n-1 ))
+            n = PAGEFRAME_PAGESIZE - ((effective_addr1 + i) & PAGEFRAME_BYTEMASK);
+
+        op1 = MADDRL( (effective_addr1 + i) & ADDRESS_MAXWRAP( regs ),
+                      n, b1, regs, ACCTYPE_READ, regs->psw.pkey );
+
+        if (likely( !op2crosses ))
+        {
+            /* Table is within one page: use the fast kernel */
+            if (!tab)
+                tab = MADDRL( effective_addr2, 256, b2, regs, ACCTYPE_READ, regs->psw.pkey );
+
+            k = trt_kernel( op1, tab, n, &sbyte );
+        }
+        else
         {
-            /* WORST case: BOTH operands cross a page boundary */
-            for (i=0; i <= len; i++)
+            /* Table spans a boundary: each part of it is only
+               accessed once an argument byte actually refers to it */
+            for (k=0; k < n; k++)
             {
-                dbyte = ARCH_DEP( vfetchb )( effective_addr1+i, b1, regs );
-                if ((sbyte = ARCH_DEP( vfetchb )( effective_addr2+dbyte, b2, regs )))
+                dbyte = op1[k];
+                if (dbyte < n2)
+                {
+                    if (!tab)
+                        tab = MADDRL( effective_addr2, n2,
+                                      b2, regs, ACCTYPE_READ, regs->psw.pkey );
+                    sbyte = tab[ dbyte ];
+                }
+                else
+                {
+                    if (!tab2)
+                        tab2 = MADDRL( (effective_addr2 + n2) & ADDRESS_MAXWRAP( regs ),
+                                       256 - n2, b2, regs, ACCTYPE_READ, regs->psw.pkey );
+                    sbyte = tab2[ dbyte - n2 ];
+                }
+                if (sbyte)
                     break;
             }
         }
-        else /* Only operand-1 crosses a page boundary */
+
+        if (sbyte)
         {
-            for (i=0; i <= len; i++)
-                if ((sbyte = op2[ ARCH_DEP( vfetchb )( effective_addr1+i, b1, regs ) ]))
-                    break;
+            i += k;
+            break;
         }
     }
-    else /* Operand-1 does NOT cross a page boundary */
-    {
-       if (unlikely( op2crosses ))
-       {
-            /* But operand-2 DOES cross a page boundary */
-            for (i=0; i <= len; i++)
-                if ((sbyte = ARCH_DEP( vfetchb )( effective_addr2+op1[i], b2, regs )))
-                    break;
-       }
-       else /* BEST case: NEITHER operand crosses a page boundary */
-       {
-            for (i=0; i <= len; i++)
-                if ((sbyte = op2[ op1[i] ]))
-                    break;
-       }
-    }
 
     /* Test for non-zero function byte */
     if (sbyte != 0)
@@ -2130,7 +2117,6 @@ bool    op1crosses, op2crosses;         /* Operand crosses Page Bdy  */
 DEF_INST(translate_extended)
 {
 int     r1, r2;                     /* Values of R fields            */
-U64     i;                          /* Loop counter                  */
 int     cc = 0;                     /* Condition code                */
 VADR    addr1, addr2;               /* Operand addresses             */
 GREG    len1;                       /* Operand length                */
@@ -2195,22 +2181,11 @@ BYTE   *main1;                      /* Mainstor addresses            */
     /* Get operand 1 on page address */
     main1 = MADDRL( addr1, len, r1, regs, ACCTYPE_WRITE, regs->psw.pkey );
 
-    /* translate on page data */
-    for (i = 0; i < len; i++)
-    {
-        /* If equal to test byte, exit with condition code 1 */
-        if (*main1 == tbyte)
-        {
-            cc = 1;
-            break;
-        }
-
-        /* Load indicated byte from translate table */
-        *main1 = trtab[ *main1 ];
-
-        main1++;
-        translen++;
-    } /* end for(i) */
+    /* translate on page data, exit with condition code 1
+       if a byte equal to the test byte is found */
+    translen = tre_kernel( main1, trtab, (int) len, tbyte );
+    if (translen < (int) len)
+        cc = 1;
 
     /* Update the registers */
     addr1 += translen;
@@ -3256,7 +3231,7 @@ DEF_INST(translate_and_test_reverse)
     int cc = 0;                        // Condition code
     VADR effective_addr1;
     VADR effective_addr2;              // Effective addresses
-    int i;                             // Integer work areas
+    int i, k, n;                       // Integer work areas
     int len;                           // Length byte
     BYTE sbyte;                        // Byte work areas
 
@@ -3285,16 +3260,19 @@ DEF_INST(translate_and_test_reverse)
     m1 = MADDRL( effective_addr1, 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
     m1pg = MAINSTOR_PAGEBASE ( m1 );
 
-    /* Process first operand from right to left*/
-    for(i = 0; i <= len; i++)
+    /* Process first operand from right to left, one page at a time */
+    for (i = 0; i <= len; )
     {
-        /* Fetch argument byte from first operand */
-        // dbyte = ARCH_DEP(vfetchb)(effective_addr1, b1, regs);
+        /* Bytes remaining on this page going right to left */
+        n = (int)(m1 - m1pg) + 1;
+        if (n > len - i + 1)
+            n = len - i + 1;
 
-        /* Fetch function byte from second operand */
-        // sbyte = ARCH_DEP(vfetchb)((effective_addr2 + dbyte) & ADDRESS_MAXWRAP(regs), b2, regs);
+        k = trtr_kernel( m1, p_fct, n, &sbyte );
 
-        sbyte = p_fct[ *m1 ];
+        effective_addr1 -= k; /* Another difference with TRT */
+        effective_addr1 &= ADDRESS_MAXWRAP(regs);
+        i += k;
 
         /* Test for non-zero function byte */
         if(sbyte != 0)
@@ -3327,15 +3305,8 @@ DEF_INST(translate_and_test_reverse)
 
         } /* end if(sbyte) */
 
-        /* Decrement first operand address */
-        effective_addr1--; /* Another difference with TRT */
-        effective_addr1 &= ADDRESS_MAXWRAP(regs);
-
-        /* update mainstor address */
-        m1--;
-
-        /* check for page cross */
-        if ( MAINSTOR_PAGEBASE ( m1 ) != m1pg )
+        /* Continue at the last byte of the preceding page */
+        if (i <= len)
         {
             m1 = MADDRL(effective_addr1, 1, b1, regs, ACCTYPE_READ, regs->psw.pkey );
             m1pg = MAINSTOR_PAGEBASE ( m1 );
@@ -35,6 +35,33 @@
 
 #define MAX_CPU_LOOPS         256       /* UNROLLED_EXECUTE loops    */
 
+/*-------------------------------------------------------------------*/
+/*          Basic-block translation cache (BBCACHE)                  */
+/*-------------------------------------------------------------------*/
+
+#define BBC_MAX_INSTR           8       /* Max instructions/block    */
+#define MIN_BBCACHE_BLOCKS    256       /* Min blocks per CPU        */
+#define DEF_BBCACHE_BLOCKS   4096       /* Default blocks per CPU    */
+#define MAX_BBCACHE_BLOCKS  65536       /* Max blocks per CPU        */
+
+/*-------------------------------------------------------------------*/
+/*          Sampling instruction profiler (PROFILE)                  */
+/*-------------------------------------------------------------------*/
+
+#define PROF_ENTRIES         8192       /* Profile entries per CPU   */
+#define PROF_PROBES            16       /* Max entries probed/sample */
+#define MIN_PROFILE_USECS     100       /* Min sample interval       */
+#define DEF_PROFILE_USECS    1000       /* Default sample interval   */
+#define MAX_PROFILE_USECS 1000000       /* Max sample interval       */
+
+/*-------------------------------------------------------------------*/
+/*          Device I/O request queues (channel.c)                    */
+/*-------------------------------------------------------------------*/
+
+#define MAX_IOQS               64       /* Max I/O request queues    */
+#define DEF_IOQS                1       /* Default I/O request queues*/
+#define MAX_IOQ_SPIN_USECS   1000       /* Max idle thread spin time */
+
 /*-------------------------------------------------------------------*/
 /*               Some handy quantity definitions                     */
 /*-------------------------------------------------------------------*/
@@ -351,10 +351,12 @@ CCDU64_DLL_IMPORT void  cckd64_swapend_l1   ( CCKD64_L1ENT*, int );
 CCDU64_DLL_IMPORT void  cckd64_swapend_l2   ( CCKD64_L2ENT* );
 CCDU64_DLL_IMPORT void  cckd64_swapend_free ( CCKD64_FREEBLK* );
 CCDU64_DLL_IMPORT int   cckd64_comp (DEVBLK *);
+CCDU64_DLL_IMPORT int   cckd64_recomp (DEVBLK *, int, int, int);
 CCDU64_DLL_IMPORT int   cckd64_chkdsk (DEVBLK *, int);
 
 CCDU_DLL_IMPORT   int   cckd_def_opt_bigend ();
 CCDU_DLL_IMPORT   int   cckd_comp (DEVBLK *);
+CCDU_DLL_IMPORT   int   cckd_recomp (DEVBLK *, int, int, int);
 CCDU_DLL_IMPORT   int   cckd_chkdsk (DEVBLK *, int);
 
 /* Functions in module hscmisc.c */
@@ -442,6 +444,11 @@ GOP_DLL_IMPORT int   getopt_long ( int nargc, char * const *nargv, const char *o
 CHAN_DLL_IMPORT int  device_attention (DEVBLK *dev, BYTE unitstat);
 CHAN_DLL_IMPORT int  ARCH_DEP(device_attention) (DEVBLK *dev, BYTE unitstat);
 CHAN_DLL_IMPORT void default_sns( char* buf, size_t buflen, BYTE b0, BYTE b1 );
+CHAN_DLL_IMPORT void* device_thread( void* arg );
+CHAN_DLL_IMPORT void  signal_device_threads();
+CHAN_DLL_IMPORT void  reschedule_device_threads();
+CHAN_DLL_IMPORT int   queued_io_requests();
+CHAN_DLL_IMPORT int   idle_device_threads();
 
 CHAN_DLL_IMPORT void Queue_IO_Interrupt           (IOINT* io, U8 clrbsy, const char* location);
 CHAN_DLL_IMPORT void Queue_IO_Interrupt_QLocked   (IOINT* io, U8 clrbsy, const char* location);
@@ -449,6 +456,8 @@ CHAN_DLL_IMPORT int  Dequeue_IO_Interrupt         (IOINT* io,            const c
 CHAN_DLL_IMPORT int  Dequeue_IO_Interrupt_QLocked (IOINT* io,            const char* location);
 CHAN_DLL_IMPORT void Update_IC_IOPENDING          ();
 CHAN_DLL_IMPORT void Update_IC_IOPENDING_QLocked  ();
+CHAN_DLL_IMPORT CPU_BITMAP Post_IC_IOPENDING_QLocked ();
+CHAN_DLL_IMPORT void Wakeup_IOPENDING_CPUs        (CPU_BITMAP wake);
 
 #define QUEUE_IO_INTERRUPT( io, clrbsy )          (void)Queue_IO_Interrupt( (IOINT*)(io), (U8)(clrbsy), PTT_LOC )
 #define QUEUE_IO_INTERRUPT_QLOCKED( io, clrbsy )  (void)Queue_IO_Interrupt_QLocked( (IOINT*)(io), (U8)(clrbsy), PTT_LOC )
@@ -456,6 +465,8 @@ CHAN_DLL_IMPORT void Update_IC_IOPENDING_QLocked  ();
 #define DEQUEUE_IO_INTERRUPT_QLOCKED( io )        (int)Dequeue_IO_Interrupt_QLocked( (IOINT*)(io), PTT_LOC )
 #define UPDATE_IC_IOPENDING()                     (void)Update_IC_IOPENDING()
 #define UPDATE_IC_IOPENDING_QLOCKED()             (void)Update_IC_IOPENDING_QLocked()
+#define POST_IC_IOPENDING_QLOCKED()               (CPU_BITMAP)Post_IC_IOPENDING_QLocked()
+#define WAKEUP_IOPENDING_CPUS( wake )             (void)Wakeup_IOPENDING_CPUs( (CPU_BITMAP)(wake) )
 
 /* Functions in module dat.c */
 
@@ -189,6 +189,47 @@ static inline void store_scsw_as_csw( const REGS* regs, const SCSW* scsw )
     /* Update storage key for reference and change done by caller */
 }
 
+/*-------------------------------------------------------------------*/
+/*           Atomically set/reset bits in a 32-bit value             */
+/*-------------------------------------------------------------------*/
+/* Both are full memory barriers on hosts which support them, which  */
+/* the lock-free interrupt signalling in cpuint.h depends upon.      */
+/*-------------------------------------------------------------------*/
+static inline void atomic_or32( volatile U32* p, U32 bits )
+{
+#if defined( _MSVC_ )
+    InterlockedOr( (volatile LONG*) p, (LONG) bits );
+#else // GCC (and CLANG?)
+  #if defined( HAVE_SYNC_BUILTINS )
+    __sync_fetch_and_or( p, bits );
+  #else
+    *p |= bits;  /* (N.B. non-atomic!) */
+  #endif
+#endif
+}
+static inline void atomic_and32( volatile U32* p, U32 bits )
+{
+#if defined( _MSVC_ )
+    InterlockedAnd( (volatile LONG*) p, (LONG) bits );
+#else // GCC (and CLANG?)
+  #if defined( HAVE_SYNC_BUILTINS )
+    __sync_fetch_and_and( p, bits );
+  #else
+    *p &= bits;  /* (N.B. non-atomic!) */
+  #endif
+#endif
+}
+static inline void atomic_fence()
+{
+#if defined( _MSVC_ )
+    MemoryBarrier();
+#else // GCC (and CLANG?)
+  #if defined( HAVE_SYNC_BUILTINS )
+    __sync_synchronize();
+  #endif
+#endif
+}
+
 /*-------------------------------------------------------------------*/
 /* Synchronize CPUS                                                  */
 /*-------------------------------------------------------------------*/
@@ -437,6 +478,41 @@ static inline void atomic_update64( volatile S64* p, S64 count )
   WARNING( "Missing atomic 32/64 bit increment support!" )
 #endif
 
+/*-------------------------------------------------------------------*/
+/* Mark I/O interrupt pending on all started CPUs  (iointqlk held)   */
+/*-------------------------------------------------------------------*/
+/* Returns the started CPUs that are enabled for I/O interrupts, or  */
+/* zero when I/O was already pending. sysblk.intlock need not be     */
+/* held: the state bits are updated atomically, and sysblk.ints_state*/
+/* is updated before started_mask is examined so that a CPU being    */
+/* started concurrently picks up the new state (see cpu.c).          */
+/*-------------------------------------------------------------------*/
+static inline CPU_BITMAP set_ic_iopending()
+{
+    REGS*       regs;
+    CPU_BITMAP  mask;
+    CPU_BITMAP  wake = 0;
+    int         i;
+
+    if (sysblk.ints_state & BIT( IC_IO ))
+        return 0;
+
+    IC_STATE_ON( &sysblk.ints_state, BIT( IC_IO ));
+
+    for (mask = sysblk.started_mask, i=0; mask; mask >>= 1, ++i)
+    {
+        if (mask & 1)
+        {
+            regs = sysblk.regs[i];
+            IC_STATE_ON( &regs->ints_state, BIT( IC_IO ));
+
+            if (regs->ints_mask & BIT( IC_IO ))
+                wake |= regs->cpubit;
+        }
+    }
+    return wake;
+}
+
 /*-------------------------------------------------------------------*/
 /*           Atomically update SYSBLK Instruction Counter            */
 /*-------------------------------------------------------------------*/
@@ -2767,6 +2767,7 @@ int qeth_cmd( int argc, char *argv[], char *cmdline )
 
     // Format:  "QETH  DEBUG  {ON|OFF}  [ [<devnum>|ALL] [mask ...] ]"
     // Format:  "QETH  ADDR             [ [<devnum>|ALL]            ]"
+    // Format:  "QETH  STATS            [ [<devnum>|ALL]            ]"
 
     if ( argc >= 2 && CMD(argv[1],debug,5) )
     {
@@ -3106,6 +3107,95 @@ int qeth_cmd( int argc, char *argv[], char *cmdline )
         return 0;
     }
 
+    if ( CMD(argv[1],stats,4) )
+    {
+        U64   now;
+        U32   usecs;
+        int   q;
+
+        pDEVGRP = NULL;
+        if ( argc > 3 )
+        {
+            // "Invalid command usage. Type 'help %s' for assistance."
+            WRMSG( HHC02299, "E", argv[0] );
+            return -1;
+        }
+        if ( argc == 3 && !CMD(argv[2],all,3) )
+        {
+            if ( parse_single_devnum( argv[2], &lcss, &devnum) != 0 )
+            {
+                // "Invalid command usage. Type 'help %s' for assistance."
+                WRMSG( HHC02299, "E", argv[0] );
+                return -1;
+            }
+            if ( !(dev = find_device_by_devnum( lcss, devnum )) )
+            {
+                // "%1d:%04X device not found"
+                devnotfound_msg( lcss, devnum );
+                return -1;
+            }
+            if ( !dev->allocated ||
+                 dev->devtype != 0x1731 )
+            {
+                // "%1d:%04X device is not a '%s'"
+                WRMSG(HHC02209, "E", lcss, devnum, "QETH" );
+                return -1;
+            }
+            pDEVGRP = dev->group;
+        }
+
+        grp = NULL;
+        found = FALSE;
+        now = ETOD_high64_to_usecs( host_tod() );
+
+        for ( dev = sysblk.firstdev; dev; dev = dev->nextdev )
+        {
+            /* First device of each complete (selected) QETH group */
+            if ( !dev->allocated ||
+                 dev->devtype != 0x1731 ||
+                 (pDEVGRP && pDEVGRP != dev->group) ||
+                 grp == dev->group->grp_data ||
+                 dev->group->members != dev->group->acount )
+                continue;
+
+            grp = dev->group->grp_data;
+            found = TRUE;
+
+            /* Rates are per second since the previous display */
+            usecs = (U32) min( now - grp->ttqtod, 0xFFFFFFFFULL );
+            if (!usecs)
+                usecs = 1;
+
+            for ( q = 0; q < grp->ttmq; q++ )
+            {
+                OSA_TTQ* ttq = &grp->ttq[q];
+
+                // "%s device %1d:%04X group %s queue %d: rx %u (%u/s) tx %u (%u/s) dropped %u"
+                WRMSG( HHC02348, "I", dev->typname, LCSS_DEVNUM,
+                    grp->ttifname[0] ? grp->ttifname : "(none)", q,
+                    ttq->rxcnt,
+                    (U32)(((U64)(ttq->rxcnt - ttq->rxlast) * 1000000) / usecs),
+                    ttq->txcnt,
+                    (U32)(((U64)(ttq->txcnt - ttq->txlast) * 1000000) / usecs),
+                    ttq->dropcnt );
+
+                ttq->rxlast = ttq->rxcnt;
+                ttq->txlast = ttq->txcnt;
+            }
+            grp->ttqtod = now;
+
+        } /* end for (dev = ... */
+
+        if (!found)
+        {
+            // "No %s devices found"
+            WRMSG( HHC02347, "E", "QETH" );
+            return -1;
+        }
+
+        return 0;
+    }
+
     // "Invalid command usage. Type 'help %s' for assistance."
     WRMSG( HHC02299, "E", argv[0] );
     return -1;
@@ -7005,7 +7095,6 @@ char buf[4096];
     return 0;
 }
 
-void *device_thread(void *arg);
 /*-------------------------------------------------------------------*/
 /* devtmax command - display or set max device threads               */
 /*-------------------------------------------------------------------*/
@@ -7013,8 +7102,6 @@ int devtmax_cmd(int argc, char *argv[], char *cmdline)
 {
     int devtmax = -2;
 
-    TID tid;
-
     UNREFERENCED(cmdline);
     if ( argc > 2 )
     {
@@ -7033,32 +7120,135 @@ int devtmax_cmd(int argc, char *argv[], char *cmdline)
             return -1;
         }
 
-        /* Create a new device thread if the I/O queue is not NULL
-           and more threads can be created */
+        /* Create new device threads if there are queued I/O requests
+           and more threads can be created, and wakeup the idle ones
+           in case they need to terminate */
+        reschedule_device_threads();
+    }
+    else
+        WRMSG(HHC02242, "I",
+            sysblk.devtmax, sysblk.devtnbr, sysblk.devthwm,
+            idle_device_threads(), queued_io_requests() );
+
+    return 0;
+}
 
-        /* the IOQ lock is obtained in order to write to sysblk.devtwait */
-        OBTAIN_IOQLOCK();
+/*-------------------------------------------------------------------*/
+/* ioqueues command - display or set device I/O request queues       */
+/*-------------------------------------------------------------------*/
+int ioqueues_cmd( int argc, char* argv[], char* cmdline )
+{
+    char  buf[128];
+    int   n, num;
+    BYTE  c;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc == 1)
+    {
+        /* Display the current setting */
+        MSGBUF( buf, "%d queue%s, idle thread spin %d usecs",
+            sysblk.numioq, sysblk.numioq == 1 ? "" : "s", sysblk.ioqspin );
+
+        // "%-14s: %s"
+        WRMSG( HHC02203, "I", argv[0], buf );
+        return 0;
+    }
+
+    if (CMD( argv[1], STATS, 4 ) && argc == 2)
+    {
+        for (n=0; n < MAX_IOQS; n++)
         {
-            if (sysblk.ioq && (!sysblk.devtmax || sysblk.devtnbr < sysblk.devtmax))
-            {
-                int rc;
+            IOQ* ioq = &sysblk.ioq[n];
 
-                rc = create_thread( &tid, DETACHED, device_thread, NULL, "idle device thread" );
-                if (rc)
-                    WRMSG(HHC00102, "E", strerror(rc));
+            if (n >= sysblk.numioq && !ioq->queued)
+                continue;
+
+            MSGBUF( buf, "ioq %02d: queued %"PRIu64", depth %d, max %d"
+                ", stolen %"PRIu64", avg wait %"PRIu64" usecs, max %"PRIu64
+                ", idle threads %d",
+                n, ioq->queued, ioq->depth, ioq->hwm, ioq->stolen,
+                ioq->queued ? ioq->waitusecs / ioq->queued : 0,
+                ioq->maxusecs, ioq->waiting );
+
+            // "%s"
+            WRMSG( HHC02297, "I", buf );
+        }
+        return 0;
+    }
+
+    if (CMD( argv[1], RESET, 5 ) && argc == 2)
+    {
+        for (n=0; n < MAX_IOQS; n++)
+        {
+            IOQ* ioq = &sysblk.ioq[n];
+
+            obtain_lock( &ioq->lock );
+            {
+                ioq->queued    = ioq->stolen   = 0;
+                ioq->waitusecs = ioq->maxusecs = 0;
+                ioq->hwm       = ioq->depth;
             }
+            release_lock( &ioq->lock );
+        }
 
-            /* Wakeup threads in case they need to terminate */
-            sysblk.devtwait = 0;
-            broadcast_condition( &sysblk.ioqcond );
+        if (MLVL( VERBOSE ))
+        {
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "RESET" );
         }
-        RELEASE_IOQLOCK();
+        return 0;
+    }
+
+    if (CMD( argv[1], SPIN, 4 ) && argc == 3)
+    {
+        if (0
+            || sscanf( argv[2], "%d%c", &num, &c ) != 1
+            || num < 0
+            || num > MAX_IOQ_SPIN_USECS
+        )
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[2], ": must be 0 to "
+                QSTR( MAX_IOQ_SPIN_USECS ) );
+            return -1;
+        }
+
+        sysblk.ioqspin = num;
+    }
+    else if (argc == 2)
+    {
+        if (0
+            || sscanf( argv[1], "%d%c", &num, &c ) != 1
+            || num < 1
+            || num > MAX_IOQS
+        )
+        {
+            // "Invalid argument %s%s"
+            WRMSG( HHC02205, "E", argv[1], ": must be 'STATS', 'RESET', "
+                "'SPIN' or a number of queues from 1 to " QSTR( MAX_IOQS ) );
+            return -1;
+        }
+
+        sysblk.numioq = num;
     }
     else
-        WRMSG(HHC02242, "I",
-            sysblk.devtmax, sysblk.devtnbr, sysblk.devthwm,
-            sysblk.devtwait, sysblk.devtunavail );
+    {
+        // "Invalid command usage. Type 'help %s' for assistance."
+        WRMSG( HHC02299, "E", argv[0] );
+        return -1;
+    }
+
+    if (MLVL( VERBOSE ))
+    {
+        MSGBUF( buf, "%d queue%s, idle thread spin %d usecs",
+            sysblk.numioq, sysblk.numioq == 1 ? "" : "s", sysblk.ioqspin );
 
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], buf );
+    }
     return 0;
 }
 
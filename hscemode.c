@@ -391,6 +391,98 @@ DLL_EXPORT int aia_cmd( int argc, char* argv[], char* cmdline )
 }
 
 
+/*-------------------------------------------------------------------*/
+/* tlb stats - display or reset TLB statistics for all online CPUs   */
+/*-------------------------------------------------------------------*/
+static int tlb_stats_cmd( int argc, char *argv[] )
+{
+    int     cpu;                        /* CPU number                */
+#if defined( OPTION_TLB_HIT_COUNT )
+    U64     total;                      /* Total TLB lookups         */
+#endif
+    REGS   *regs;
+    char    buf[256];
+
+    if (argc != 2)
+    {
+        // "Invalid command usage. Type 'help %s' for assistance."
+        WRMSG( HHC02299, "E", argv[0] );
+        return -1;
+    }
+
+    if (CMD( argv[1], RESET, 5 ))
+    {
+        for (cpu = 0; cpu < sysblk.maxcpu; cpu++)
+        {
+            obtain_lock( &sysblk.cpulock[ cpu ]);
+            if (IS_CPU_ONLINE( cpu ))
+            {
+                regs = sysblk.regs[ cpu ];
+                regs->tlbhits    = 0;
+                regs->tlbmisses  = 0;
+                regs->tlbwayhits = 0;
+                regs->tlbpurges  = 0;
+                regs->tlbepurges = 0;
+                regs->tlblfhits  = 0;
+                regs->tlbsdtargeted = 0;
+                regs->tlbsdavoided  = 0;
+                regs->tlbsdflushes  = 0;
+            }
+            release_lock( &sysblk.cpulock[ cpu ]);
+        }
+        return 0;
+    }
+
+    if (!CMD( argv[1], STATS, 4 ))
+    {
+        // "Invalid argument %s%s"
+        WRMSG( HHC02205, "E", argv[1], ": must be 'STATS' or 'RESET'" );
+        return -1;
+    }
+
+    MSGBUF( buf, "%d sets, %d-way: %d entries per CPU, %d large-frame entries",
+        TLB_SETS, TLB_WAYS, TLBN, TLB_LFN );
+    WRMSG( HHC02284, "I", buf );
+
+    for (cpu = 0; cpu < sysblk.maxcpu; cpu++)
+    {
+        obtain_lock( &sysblk.cpulock[ cpu ]);
+        if (IS_CPU_ONLINE( cpu ))
+        {
+            regs  = sysblk.regs[ cpu ];
+#if defined( OPTION_TLB_HIT_COUNT )
+            total = regs->tlbhits + regs->tlbmisses;
+
+            MSGBUF( buf, "%s%02X: hits %"PRIu64" (%d%%), misses %"PRIu64
+                ", other way hits %"PRIu64", purges %"PRIu64
+                ", entry purges %"PRIu64", large-frame hits %"PRIu64,
+                PTYPSTR( cpu ), cpu,
+                regs->tlbhits, total ? (int)((regs->tlbhits * 100) / total) : 0,
+                regs->tlbmisses, regs->tlbwayhits,
+                regs->tlbpurges, regs->tlbepurges, regs->tlblfhits );
+#else
+            MSGBUF( buf, "%s%02X: misses %"PRIu64
+                ", other way hits %"PRIu64", purges %"PRIu64
+                ", entry purges %"PRIu64", large-frame hits %"PRIu64,
+                PTYPSTR( cpu ), cpu,
+                regs->tlbmisses, regs->tlbwayhits,
+                regs->tlbpurges, regs->tlbepurges, regs->tlblfhits );
+#endif
+            WRMSG( HHC02284, "I", buf );
+
+            MSGBUF( buf, "%s%02X: IPTE TLB purges %"PRIu64", purges avoided %"PRIu64
+                ", full filter flushes %"PRIu64", filter %d%% full",
+                PTYPSTR( cpu ), cpu,
+                regs->tlbsdtargeted, regs->tlbsdavoided, regs->tlbsdflushes,
+                (int)((regs->tlbfpop * 100) / TLB_FILTER_N) );
+            WRMSG( HHC02284, "I", buf );
+        }
+        release_lock( &sysblk.cpulock[ cpu ]);
+    }
+
+    return 0;
+}
+
 /*-------------------------------------------------------------------*/
 /* tlb - display tlb table                                           */
 /*-------------------------------------------------------------------*/
@@ -403,6 +495,13 @@ DLL_EXPORT int aia_cmd( int argc, char* argv[], char* cmdline )
 /*   hash of effective address. So MAINADDR() macro is used to remove*/
 /*   the hash before it's displayed.                                 */
 /*                                                                   */
+/*   With a set-associative TLB (TLB_WAYS > 1) each way's TLB_SETS   */
+/*   entries are displayed one after the other, so the effective     */
+/*   address bits come from the entry's set index (i & TLB_MASK).    */
+/*                                                                   */
+/*   "tlb stats" displays each online CPU's TLB statistics instead   */
+/*   and "tlb reset" resets them.                                    */
+/*                                                                   */
 int tlb_cmd(int argc, char *argv[], char *cmdline)
 {
     int     i;                          /* Index                     */
@@ -414,10 +513,11 @@ int tlb_cmd(int argc, char *argv[], char *cmdline)
     char    buf[128];
 
 
-    UNREFERENCED(argc);
-    UNREFERENCED(argv);
     UNREFERENCED(cmdline);
 
+    if (argc > 1)
+        return tlb_stats_cmd( argc, argv );
+
     obtain_lock(&sysblk.cpulock[sysblk.pcpu]);
 
     if (!IS_CPU_ONLINE(sysblk.pcpu))
@@ -428,10 +528,10 @@ int tlb_cmd(int argc, char *argv[], char *cmdline)
     }
     regs = sysblk.regs[sysblk.pcpu];
     shift = regs->arch_mode == ARCH_370_IDX ? 11 : 12;
-    bytemask = regs->arch_mode == ARCH_370_IDX ? 0x1FFFFF : 0x3FFFFF;
-    pagemask = regs->arch_mode == ARCH_370_IDX ? 0x00E00000 :
-               regs->arch_mode == ARCH_390_IDX ? 0x7FC00000 :
-                                     0xFFFFFFFFFFC00000ULL;
+    bytemask = (1 << (shift + TLB_SETBITS)) - 1;
+    pagemask = (regs->arch_mode == ARCH_370_IDX ? 0x00FFFFFF :
+                regs->arch_mode == ARCH_390_IDX ? 0x7FFFFFFF :
+                                      0xFFFFFFFFFFFFFFFFULL) & ~(U64)bytemask;
 
     MSGBUF( buf, "tlbID 0x%6.6X mainstor %p",regs->tlbID,regs->mainstor);
     WRMSG(HHC02284, "I", buf);
@@ -441,13 +541,13 @@ int tlb_cmd(int argc, char *argv[], char *cmdline)
         MSGBUF( buf, "%s%3.3X %16.16"PRIX64" %16.16"PRIX64" %16.16"PRIX64" %4.4X %1d %1d %1d %1d %2.2X %8.8X",
          ((regs->tlb.TLB_VADDR_G(i) & bytemask) == regs->tlbID ? "*" : " "),
          i,regs->tlb.TLB_ASD_G(i),
-         ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (i << shift)),
+         ((regs->tlb.TLB_VADDR_G(i) & pagemask) | ((i & TLB_MASK) << shift)),
          regs->tlb.TLB_PTE_G(i),(int)(regs->tlb.TLB_VADDR_G(i) & bytemask),
          regs->tlb.common[i],regs->tlb.protect[i],
          (regs->tlb.acc[i] & ACC_READ) != 0,(regs->tlb.acc[i] & ACC_WRITE) != 0,
          regs->tlb.skey[i],
          (unsigned int)(MAINADDR(regs->tlb.main[i],
-                  ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (unsigned int)(i << shift)))
+                  ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (unsigned int)((i & TLB_MASK) << shift)))
                   - regs->mainstor));
         matches += ((regs->tlb.TLB_VADDR(i) & bytemask) == regs->tlbID);
        WRMSG(HHC02284, "I", buf);
@@ -459,10 +559,10 @@ int tlb_cmd(int argc, char *argv[], char *cmdline)
     {
         regs = GUESTREGS;
         shift = GUESTREGS->arch_mode == ARCH_370_IDX ? 11 : 12;
-        bytemask = regs->arch_mode == ARCH_370_IDX ? 0x1FFFFF : 0x3FFFFF;
-        pagemask = regs->arch_mode == ARCH_370_IDX ? 0x00E00000 :
-                   regs->arch_mode == ARCH_390_IDX ? 0x7FC00000 :
-                                         0xFFFFFFFFFFC00000ULL;
+        bytemask = (1 << (shift + TLB_SETBITS)) - 1;
+        pagemask = (regs->arch_mode == ARCH_370_IDX ? 0x00FFFFFF :
+                    regs->arch_mode == ARCH_390_IDX ? 0x7FFFFFFF :
+                                          0xFFFFFFFFFFFFFFFFULL) & ~(U64)bytemask;
 
         MSGBUF( buf, "SIE: tlbID 0x%4.4x mainstor %p",regs->tlbID,regs->mainstor);
         WRMSG(HHC02284, "I", buf);
@@ -472,13 +572,13 @@ int tlb_cmd(int argc, char *argv[], char *cmdline)
             MSGBUF( buf, "%s%3.3X %16.16"PRIX64" %16.16"PRIX64" %16.16"PRIX64" %4.4X %1d %1d %1d %1d %2.2X %8.8X",
              ((regs->tlb.TLB_VADDR_G(i) & bytemask) == regs->tlbID ? "*" : " "),
              i,regs->tlb.TLB_ASD_G(i),
-             ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (i << shift)),
+             ((regs->tlb.TLB_VADDR_G(i) & pagemask) | ((i & TLB_MASK) << shift)),
              regs->tlb.TLB_PTE_G(i),(int)(regs->tlb.TLB_VADDR_G(i) & bytemask),
              regs->tlb.common[i],regs->tlb.protect[i],
              (regs->tlb.acc[i] & ACC_READ) != 0,(regs->tlb.acc[i] & ACC_WRITE) != 0,
              regs->tlb.skey[i],
              (unsigned int) (MAINADDR(regs->tlb.main[i],
-                     ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (unsigned int)(i << shift)))
+                     ((regs->tlb.TLB_VADDR_G(i) & pagemask) | (unsigned int)((i & TLB_MASK) << shift)))
                     - regs->mainstor));
             matches += ((regs->tlb.TLB_VADDR(i) & bytemask) == regs->tlbID);
            WRMSG(HHC02284, "I", buf);
@@ -3006,6 +3106,372 @@ int icount_cmd( int argc, char* argv[], char* cmdline )
 #endif /* defined( OPTION_INSTR_COUNT_AND_TIME ) */
 
 
+/*-------------------------------------------------------------------*/
+/* profile command helper: instruction mnemonic and function name    */
+/*-------------------------------------------------------------------*/
+static void profile_names( PROFENT* pe, char* mnem, size_t mnemsize,
+                                        char* func, size_t funcsize )
+{
+    char  buf[256];
+    char* p;
+
+    if (pe->state & PROF_WAIT)
+    {
+        strlcpy( mnem, "(wait)", mnemsize );
+        strlcpy( func, "(wait)", funcsize );
+        return;
+    }
+
+    if (!pe->inst[0] && !pe->inst[1])
+    {
+        strlcpy( mnem, "(unknown)", mnemsize );
+        strlcpy( func, "(unknown)", funcsize );
+        return;
+    }
+
+    /* "mnemonic operands    function" */
+    buf[0] = 0;
+    PRINT_INST( pe->arch_mode, pe->inst, buf );
+    RTRIM( buf );
+
+    strlcpy( mnem, buf, mnemsize );
+    if ((p = strchr( mnem, ' ' )))
+        *p = 0;
+
+    if ((p = strrchr( buf, ' ' )))
+        strlcpy( func, p+1, funcsize );
+    else
+        strlcpy( func, buf, funcsize );
+}
+
+/*-------------------------------------------------------------------*/
+/* profile command helper: state name                                */
+/*-------------------------------------------------------------------*/
+static const char* profile_state( PROFENT* pe )
+{
+    if (pe->state & PROF_WAIT)
+        return (pe->state & PROF_SIE) ? "sie;wait"    : "wait";
+    if (pe->state & PROF_PROB)
+        return (pe->state & PROF_SIE) ? "sie;problem" : "problem";
+    return     (pe->state & PROF_SIE) ? "sie;supervisor" : "supervisor";
+}
+
+/*-------------------------------------------------------------------*/
+/* profile command helper: snapshot one CPU's profile entries        */
+/*-------------------------------------------------------------------*/
+static PROFENT* profile_copy( int cpu )
+{
+    PROFENT* copy = NULL;
+
+    obtain_lock( &sysblk.proflock );
+    {
+        if (sysblk.profent[ cpu ]
+            && (copy = malloc( PROF_ENTRIES * sizeof( PROFENT ))))
+            memcpy( copy, sysblk.profent[ cpu ], PROF_ENTRIES * sizeof( PROFENT ));
+    }
+    release_lock( &sysblk.proflock );
+
+    return copy;
+}
+
+/*-------------------------------------------------------------------*/
+/* Instruction function totals for "profile top"                     */
+/*-------------------------------------------------------------------*/
+typedef struct PROFSUM
+{
+    char  name[64];        // Instruction function (mnemonic)
+    U64   count;           // Samples
+    U64   usecs;           // Host time
+} PROFSUM;
+
+static int profile_sum_sort( const void* x, const void* y )
+{
+    const PROFSUM* X = (const PROFSUM*) x;
+    const PROFSUM* Y = (const PROFSUM*) y;
+
+    return (X->usecs < Y->usecs) ? +1 : (X->usecs > Y->usecs) ? -1 : 0;
+}
+
+/*-------------------------------------------------------------------*/
+/* profile command - sampling instruction profiler                   */
+/*-------------------------------------------------------------------*/
+int profile_cmd( int argc, char* argv[], char* cmdline )
+{
+    char      buf[256];
+    char      mnem[16];
+    char      func[64];
+    int       cpu, i, n;
+    PROFENT*  pe;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc == 1)
+    {
+        U64 samples = 0, dropped = 0;
+
+        for (cpu=0; cpu < MAX_CPU_ENGS; cpu++)
+        {
+            samples += sysblk.profsamples[ cpu ];
+            dropped += sysblk.profdropped[ cpu ];
+        }
+
+        if (sysblk.profusecs)
+            MSGBUF( buf, "every %u usecs", sysblk.profusecs );
+        else
+            STRLCPY( buf, "OFF" );
+
+        // "%-14s: %s"
+        WRMSG( HHC02203, "I", argv[0], buf );
+
+        MSGBUF( buf, "%"PRIu64" samples, %"PRIu64" not recorded",
+            samples, dropped );
+
+        // "%s"
+        WRMSG( HHC02296, "I", buf );
+        return 0;
+    }
+
+    /* profile ON [usecs] */
+    if (CMD( argv[1], ON, 2 ))
+    {
+        U32 usecs = DEF_PROFILE_USECS; BYTE c;
+
+        if (0
+            || argc > 3
+            || (argc == 3 && (0
+                || sscanf( argv[2], "%u%c", &usecs, &c ) != 1
+                || usecs < MIN_PROFILE_USECS
+                || usecs > MAX_PROFILE_USECS
+               ))
+        )
+        {
+            // "Invalid argument '%s'%s"
+            WRMSG( HHC02205, "E", argc == 3 ? argv[2] : argv[3],
+                ": sample interval must be from "
+                QSTR( MIN_PROFILE_USECS ) " to "
+                QSTR( MAX_PROFILE_USECS ) " microseconds" );
+            return -1;
+        }
+
+        obtain_lock( &sysblk.proflock );
+        {
+            sysblk.proflast  = 0;
+            sysblk.profusecs = usecs;
+        }
+        release_lock( &sysblk.proflock );
+
+        if (MLVL( VERBOSE ))
+        {
+            MSGBUF( buf, "every %u usecs", usecs );
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], buf );
+        }
+        return 0;
+    }
+
+    /* profile OFF */
+    if (CMD( argv[1], OFF, 3 ) && argc == 2)
+    {
+        sysblk.profusecs = 0;
+
+        if (MLVL( VERBOSE ))
+        {
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "OFF" );
+        }
+        return 0;
+    }
+
+    /* profile RESET */
+    if (CMD( argv[1], RESET, 5 ) && argc == 2)
+    {
+        obtain_lock( &sysblk.proflock );
+        {
+            for (cpu=0; cpu < MAX_CPU_ENGS; cpu++)
+            {
+                if (sysblk.profent[ cpu ])
+                    memset( sysblk.profent[ cpu ], 0, PROF_ENTRIES * sizeof( PROFENT ));
+                sysblk.profsamples[ cpu ] = 0;
+                sysblk.profdropped[ cpu ] = 0;
+            }
+            sysblk.proflast = 0;
+        }
+        release_lock( &sysblk.proflock );
+
+        if (MLVL( VERBOSE ))
+        {
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "RESET" );
+        }
+        return 0;
+    }
+
+    /* profile TOP [n] */
+    if (CMD( argv[1], TOP, 3 ) && argc <= 3)
+    {
+        PROFSUM*  sum = NULL;
+        PROFSUM*  newsum;
+        int       nsum = 0, maxsum = 0, top = 20;
+        U64       total = 0;
+        BYTE      c;
+
+        if (argc == 3 && (sscanf( argv[2], "%d%c", &top, &c ) != 1 || top < 1))
+        {
+            // "Invalid argument '%s'%s"
+            WRMSG( HHC02205, "E", argv[2], "" );
+            return -1;
+        }
+
+        /* Total each instruction function's samples over all CPUs */
+        for (cpu=0; cpu < MAX_CPU_ENGS; cpu++)
+        {
+            if (!(pe = profile_copy( cpu )))
+                continue;
+
+            for (i=0; i < PROF_ENTRIES; i++)
+            {
+                if (!pe[i].count)
+                    continue;
+
+                profile_names( &pe[i], mnem, sizeof( mnem ), func, sizeof( func ));
+                if (strcmp( func, mnem ) == 0)
+                    STRLCPY( buf, func );
+                else
+                    MSGBUF( buf, "%s (%s)", func, mnem );
+
+                for (n=0; n < nsum; n++)
+                    if (strcmp( sum[n].name, buf ) == 0)
+                        break;
+
+                if (n >= nsum)
+                {
+                    if (nsum >= maxsum)
+                    {
+                        maxsum += 256;
+                        if (!(newsum = realloc( sum, maxsum * sizeof( PROFSUM ))))
+                        {
+                            // "Error in function %s: %s"
+                            WRMSG( HHC02219, "E", "realloc()", strerror( errno ));
+                            free( sum );
+                            free( pe );
+                            return -1;
+                        }
+                        sum = newsum;
+                    }
+                    n = nsum++;
+                    STRLCPY( sum[n].name, buf );
+                    sum[n].count = 0;
+                    sum[n].usecs = 0;
+                }
+
+                sum[n].count += pe[i].count;
+                sum[n].usecs += pe[i].usecs;
+                total        += pe[i].usecs;
+            }
+
+            free( pe );
+        }
+
+        if (!nsum)
+        {
+            // "%s"
+            WRMSG( HHC02296, "I", "No profile samples" );
+            return 0;
+        }
+
+        qsort( sum, nsum, sizeof( PROFSUM ), profile_sum_sort );
+
+        for (n=0; n < nsum && n < top; n++)
+        {
+            MSGBUF( buf, "%12"PRIu64" usecs (%3d%%) %10"PRIu64" samples  %s",
+                sum[n].usecs, (int)(sum[n].usecs * 100 / (total ? total : 1)),
+                sum[n].count, sum[n].name );
+
+            // "%s"
+            WRMSG( HHC02296, "I", buf );
+        }
+
+        free( sum );
+        return 0;
+    }
+
+    /* profile DUMP filename [cpu] */
+    if (CMD( argv[1], DUMP, 4 ) && (argc == 3 || argc == 4))
+    {
+        char   pathname[ MAX_PATH ];
+        FILE*  f;
+        int    only = -1;
+        U32    cpuad;
+        U64    lines = 0;
+        BYTE   c;
+
+        if (argc == 4)
+        {
+            if (0
+                || sscanf( argv[3], "%x%c", &cpuad, &c ) != 1
+                || cpuad >= MAX_CPU_ENGS
+            )
+            {
+                // "Invalid argument '%s'%s"
+                WRMSG( HHC02205, "E", argv[3], ": invalid CPU number" );
+                return -1;
+            }
+            only = (int) cpuad;
+        }
+
+        hostpath( pathname, argv[2], sizeof( pathname ));
+
+        if (!(f = fopen( pathname, "w" )))
+        {
+            // "Error in function %s: %s"
+            WRMSG( HHC02219, "E", "fopen()", strerror( errno ));
+            return -1;
+        }
+
+        /* One "folded stack" line per entry: the CPU, its state, the
+           instruction function and finally the instruction mnemonic
+           and address, followed by the host time charged to it. */
+        for (cpu=0; cpu < MAX_CPU_ENGS; cpu++)
+        {
+            if (only >= 0 && cpu != only)
+                continue;
+
+            if (!(pe = profile_copy( cpu )))
+                continue;
+
+            for (i=0; i < PROF_ENTRIES; i++)
+            {
+                if (!pe[i].count || !pe[i].usecs)
+                    continue;
+
+                profile_names( &pe[i], mnem, sizeof( mnem ), func, sizeof( func ));
+
+                fprintf( f, "%s%02X;%s;%s;%s@%"PRIX64" %"PRIu64"\n",
+                    PTYPSTR( cpu ), cpu, profile_state( &pe[i] ),
+                    func, mnem, pe[i].ia, pe[i].usecs );
+                lines++;
+            }
+
+            free( pe );
+        }
+
+        fclose( f );
+
+        MSGBUF( buf, "%"PRIu64" profile entries written to %s", lines, pathname );
+
+        // "%s"
+        WRMSG( HHC02296, "I", buf );
+        return 0;
+    }
+
+    // "Invalid command usage. Type 'help %s' for assistance."
+    WRMSG( HHC02299, "E", argv[0] );
+    return -1;
+}
+
+
 /*-------------------------------------------------------------------*/
 /* createCpuId  -  Create the requested CPU ID                       */
 /*-------------------------------------------------------------------*/
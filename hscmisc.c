@@ -1591,7 +1591,7 @@ static void do_shutdown_now()
         int  n;
         for (n=0; sysblk.devtnbr && n < 100; ++n)
         {
-            signal_condition( &sysblk.ioqcond );
+            signal_device_threads();
             USLEEP( 10000 );
         }
     }
@@ -2446,6 +2446,7 @@ DLL_EXPORT REGS* copy_regs( REGS* regs )
     /* Perform partial copy and clear the TLB */
     memcpy(  newregs, regs, sysblk.regs_copy_len );
     memset( &newregs->tlb.vaddr, 0, TLBN * sizeof( DW ));
+    memset( &newregs->tlb.lfid,  0, sizeof( newregs->tlb.lfid ));
 
     newregs->tlbID      = 1;
     newregs->ghostregs  = 1;      /* indicate these aren't real regs */
@@ -2460,6 +2461,7 @@ DLL_EXPORT REGS* copy_regs( REGS* regs )
 
         memcpy(  hostregs, HOSTREGS, sysblk.regs_copy_len );
         memset( &hostregs->tlb.vaddr, 0, TLBN * sizeof( DW ));
+        memset( &hostregs->tlb.lfid,  0, sizeof( hostregs->tlb.lfid ));
 
         hostregs->tlbID     = 1;
         hostregs->ghostregs = 1;  /* indicate these aren't real regs */
@@ -783,6 +783,118 @@ int timerint_cmd( int argc, char *argv[], char *cmdline )
 }
 
 
+/*-------------------------------------------------------------------*/
+/* bbcache command - display or set basic-block cache options        */
+/*-------------------------------------------------------------------*/
+int bbcache_cmd( int argc, char *argv[], char *cmdline )
+{
+    char  buf[128];
+    int   cpu;
+    REGS* regs;
+
+    UNREFERENCED( cmdline );
+
+    UPPER_ARGV_0( argv );
+
+    if (argc == 1)
+    {
+        /* Display the current setting */
+        if (sysblk.bbcache)
+            MSGBUF( buf, "%u blocks per CPU", sysblk.bbcache );
+        else
+            STRLCPY( buf, "OFF" );
+
+        // "%-14s: %s"
+        WRMSG( HHC02203, "I", argv[0], buf );
+        return 0;
+    }
+
+    if (argc != 2)
+    {
+        // "Invalid command usage. Type 'help %s' for assistance."
+        WRMSG( HHC02299, "E", argv[0] );
+        return -1;
+    }
+
+    if (CMD( argv[1], STATS, 4 ))
+    {
+        for (cpu=0; cpu < sysblk.maxcpu; cpu++)
+        {
+            if (!IS_CPU_ONLINE( cpu ))
+                continue;
+
+            regs = sysblk.regs[ cpu ];
+
+            MSGBUF( buf, "%s%02X: hits %"PRIu64", misses %"PRIu64
+                ", invalidations %"PRIu64", hit ratio %d%%",
+                PTYPSTR( cpu ), cpu, regs->bbchits, regs->bbcmisses,
+                regs->bbcinvals,
+                (regs->bbchits + regs->bbcmisses) ?
+                    (int)((regs->bbchits * 100) / (regs->bbchits + regs->bbcmisses)) : 0 );
+
+            // "%s"
+            WRMSG( HHC02295, "I", buf );
+        }
+        return 0;
+    }
+
+    if (CMD( argv[1], RESET, 5 ))
+    {
+        for (cpu=0; cpu < sysblk.maxcpu; cpu++)
+        {
+            if (!IS_CPU_ONLINE( cpu ))
+                continue;
+
+            regs = sysblk.regs[ cpu ];
+            regs->bbchits   = 0;
+            regs->bbcmisses = 0;
+            regs->bbcinvals = 0;
+        }
+
+        if (MLVL( VERBOSE ))
+        {
+            // "%-14s set to %s"
+            WRMSG( HHC02204, "I", argv[0], "RESET" );
+        }
+        return 0;
+    }
+
+    if (CMD( argv[1], OFF, 3 ))
+        sysblk.bbcache = 0;
+    else if (CMD( argv[1], ON, 2 ))
+        sysblk.bbcache = DEF_BBCACHE_BLOCKS;
+    else
+    {
+        U32 blocks = 0; BYTE c;
+
+        if (0
+            || sscanf( argv[1], "%u%c", &blocks, &c ) != 1
+            || blocks < MIN_BBCACHE_BLOCKS
+            || blocks > MAX_BBCACHE_BLOCKS
+            || (blocks & (blocks - 1))
+        )
+        {
+            // "Invalid argument '%s'%s"
+            WRMSG( HHC02205, "E", argv[1], ": must be 'ON', 'OFF' or a power of 2 n where "
+                QSTR( MIN_BBCACHE_BLOCKS ) " <= n <= "
+                QSTR( MAX_BBCACHE_BLOCKS ) );
+            return -1;
+        }
+        sysblk.bbcache = blocks;
+    }
+
+    /* Each CPU will resynchronize itself before its next cycle */
+    sysblk.bbcgen++;
+
+    if (MLVL( VERBOSE ))
+    {
+        // "%-14s set to %s"
+        WRMSG( HHC02204, "I", argv[0], argv[1] );
+    }
+    return 0;
+}
+
+
 /* format_tod - generate displayable date from TOD value */
 /* always uses epoch of 1900 */
 char * format_tod(char *buf, U64 tod, int flagdate)
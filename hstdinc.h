@@ -223,6 +223,19 @@
     #define HET_BZIP2
   #endif
 #endif
+#ifdef HAVE_ZSTD_H
+  #include <zstd.h>
+#endif
+#ifdef HAVE_ZDICT_H
+  #include <zdict.h>
+#endif
+#ifdef HAVE_LZ4_H
+  #include <lz4.h>
+#endif
+#ifdef HAVE_LINUX_IO_URING_H
+  #include <linux/io_uring.h>
+  #include <sys/syscall.h>
+#endif
 #ifdef HAVE_DIRENT_H
   #include <dirent.h>
 #endif
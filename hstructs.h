@@ -577,8 +577,28 @@ struct REGS {                           /* Processor registers       */
                             *z900_runtime_opcode_e3_0______xx;
 #endif
 
+     /* BBCACHE - Basic-block translation cache (see cpu.c)          */
+        BBCBLK *bbcblk;                 /* -> Cached blocks or NULL  */
+        U32     bbcmask;                /* Block index mask          */
+        U32     bbcgen;                 /* sysblk.bbcgen when synced */
+        U32     bbcexecd;               /* Instrs not yet counted    */
+        U64     bbchits;                /* Block lookup hits         */
+        U64     bbcmisses;              /* Block lookup misses       */
+        U64     bbcinvals;              /* Block invalidations       */
+
      /* TLB - Translation lookaside buffer                           */
         unsigned int tlbID;             /* Validation identifier     */
+        U64     tlbhits;                /* maddr_l TLB hits          */
+        U64     tlbmisses;              /* maddr_l TLB misses        */
+        U64     tlbwayhits;             /* Misses found in other way */
+        U64     tlbpurges;              /* Entire TLB purges         */
+        U64     tlbepurges;             /* Selective entry purges    */
+        U64     tlblfhits;              /* Large-frame entry hits    */
+        U64     tlbsdtargeted;          /* CPUs purged by IPTE       */
+        U64     tlbsdavoided;           /* CPUs IPTE did not purge   */
+        U64     tlbsdflushes;           /* Targets flushed when full */
+        U32     tlbfpop;                /* Shootdown filter bits set */
+        U64     tlbfilter[ TLB_FILTER_N / 64 ]; /* PTEs maybe in TLB */
         TLB     tlb;                    /* Translation lookaside buf */
 
         BLOCK_TRAILER;                  /* Name of block  END        */
@@ -599,6 +619,51 @@ struct VFREGS {                          /* Vector Facility Registers*/
 };
 #endif /* defined( _FEATURE_S370_S390_VECTOR_FACILITY ) */
 
+/*-------------------------------------------------------------------*/
+/* Basic-block translation cache entries                             */
+/*-------------------------------------------------------------------*/
+/* Each block describes a linear run of instructions starting at a   */
+/* given mainstor (absolute page + offset) address, together with    */
+/* the instruction function each one was resolved to. The opcode     */
+/* bytes are kept so the block can be revalidated before each of its */
+/* instructions is executed (self-modifying code, I/O into storage). */
+/*-------------------------------------------------------------------*/
+struct BBCINST {                        /* Pre-decoded instruction   */
+        INSTR_FUNC  func;               /* Resolved instruction func */
+        U16     opcode;                 /* First halfword of instr   */
+        BYTE    xopcode;                /* Extended opcode (byte 5)  */
+        BYTE    ilc;                    /* Instruction length        */
+        bool    xop;                    /* true = xopcode is valid   */
+};
+
+struct BBCBLK {                         /* Basic block               */
+        BYTE   *ip;                     /* Mainstor address or NULL  */
+        int     count;                  /* Number of instructions    */
+        BBCINST inst[ BBC_MAX_INSTR ];  /* Pre-decoded instructions  */
+};
+
+/*-------------------------------------------------------------------*/
+/* Sampling instruction profiler entries                             */
+/*-------------------------------------------------------------------*/
+/* The timer thread periodically samples each started CPU's current  */
+/* instruction and charges the host time that elapsed since the      */
+/* previous sample to it. Entries are kept in a small open-addressed */
+/* hash table per CPU keyed by instruction address, instruction and  */
+/* CPU state. Instructions are only decoded when reports are made.   */
+/*-------------------------------------------------------------------*/
+struct PROFENT {                        /* Profile entry             */
+        U64     ia;                     /* Instruction address       */
+        U64     usecs;                  /* Host time charged         */
+        U32     count;                  /* Samples (0 = unused)      */
+        BYTE    inst[6];                /* Instruction (0 = unknown) */
+        BYTE    arch_mode;              /* Architecture mode         */
+        BYTE    state;                  /* CPU state when sampled    */
+#define PROF_SUPV       0x00            /* Supervisor state          */
+#define PROF_PROB       0x01            /* Problem state             */
+#define PROF_WAIT       0x02            /* Enabled/disabled wait     */
+#define PROF_SIE        0x80            /* SIE guest (flag)          */
+};
+
 // #if defined(FEATURE_REGION_RELOCATE)
 /*-------------------------------------------------------------------*/
 /* Zone Parameter Block                                              */
@@ -650,6 +715,24 @@ enum OPERATION_MODE
     typedef unsigned qos_class_t;
 #endif
 
+/*-------------------------------------------------------------------*/
+/* Device I/O request queue    (one per group of channel paths)      */
+/*-------------------------------------------------------------------*/
+struct IOQ {                            /* I/O request queue         */
+        LOCK    lock;                   /* Queue lock                */
+        COND    cond;                   /* Work available condition  */
+        DEVBLK *head;                   /* -> first queued device    */
+        int     depth;                  /* #of requests now queued   */
+        int     hwm;                    /* Queue depth high water mark*/
+        int     waiting;                /* #of threads idle (or being
+                                           created) for this queue   */
+        U64     queued;                 /* #of requests queued       */
+        U64     stolen;                 /* #of requests run by a
+                                           thread of another queue   */
+        U64     waitusecs;              /* Total usecs spent queued  */
+        U64     maxusecs;               /* Longest usecs spent queued*/
+};
+
 /*-------------------------------------------------------------------*/
 /* System configuration block                                        */
 /*-------------------------------------------------------------------*/
@@ -940,6 +1023,14 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
 
         int     timerint;               /* microsecs timer interval  */
         int     cfg_timerint;           /* (value defined in config) */
+        U32     bbcache;                /* BBCACHE blocks (0 = off)  */
+        U32     bbcgen;                 /* BBCACHE resync generation */
+        U32     profusecs;              /* PROFILE interval (0 = off)*/
+        U64     proflast;               /* TOD of last profile sample*/
+        LOCK    proflock;               /* Lock for below fields     */
+        PROFENT *profent[ MAX_CPU_ENGS ];/* Profile entries per CPU  */
+        U64     profsamples[ MAX_CPU_ENGS ];/* Samples taken per CPU */
+        U64     profdropped[ MAX_CPU_ENGS ];/* Samples w/o an entry  */
         char   *pantitle;               /* Alt console panel title   */
 #if defined( OPTION_SCSI_TAPE )
         /* Access to all SCSI fields controlled by sysblk.stape_lock */
@@ -987,14 +1078,14 @@ atomic_update64( &sysblk.txf_stats[ contran ? 1 : 0 ].txf_ ## ctr, +1 )
         U32     crwcount;               /* #of entries queued        */
         U32     crwindex;               /* CRW queue index           */
         IOINT  *iointq;                 /* I/O interrupt queue       */
-        DEVBLK *ioq;                    /* I/O queue                 */
-        LOCK    ioqlock;                /* I/O queue lock            */
-        COND    ioqcond;                /* I/O queue condition       */
-        int     devtwait;               /* Device threads waiting    */
+        IOQ     ioq[MAX_IOQS];          /* I/O request queues        */
+        int     numioq;                 /* #of I/O queues in use     */
+        int     ioqspin;                /* Idle device thread spin
+                                           time in microseconds      */
+        LOCK    ioqlock;                /* Device thread count lock  */
         int     devtnbr;                /* Number of device threads  */
         int     devtmax;                /* Max device threads        */
         int     devthwm;                /* High water mark           */
-        int     devtunavail;            /* Count thread unavailable  */
         RADR    addrlimval;             /* Address limit value (SAL) */
 #if defined(_FEATURE_VM_BLOCKIO)
         U16     servcode;               /* External interrupt code   */
@@ -1421,6 +1512,8 @@ struct DEVBLK {                         /* Device configuration block*/
         TID     tid;                    /* Thread-id executing CCW   */
         int     priority;               /* I/O q scehduling priority */
         DEVBLK *nextioq;                /* -> next device in I/O q   */
+        int     ioqn;                   /* I/O queue index           */
+        U64     ioqusecs;               /* Time of day I/O queued    */
         IOINT   ioint;                  /* Normal i/o interrupt
                                                queue entry           */
         IOINT   pciioint;               /* PCI i/o interrupt
@@ -1455,6 +1548,9 @@ struct DEVBLK {                         /* Device configuration block*/
         struct {                        /* iobuf validation          */
             int length;
             BYTE *data;
+            BYTE *zcdata;               /* Read data returned in     */
+                                        /* place of the I/O buffer   */
+            bool  zerocopy;             /* Channel permits zcdata    */
         }       iobuf;
 
         DEVRCD  *rcd;                   /* Read Configuration Data   */
@@ -1891,6 +1987,9 @@ struct DEVBLK {                         /* Device configuration block*/
         int     ckdfd[CKD_MAXFILES];    /* CKD image file descriptors*/
         int     ckdhitrk[CKD_MAXFILES]; /* Highest track number
                                            in each CKD image file    */
+        BYTE   *ckdmap[CKD_MAXFILES];   /* -> Mapped CKD image files
+                                           (or FBA image), else NULL */
+        U64     ckdmapsz[CKD_MAXFILES]; /* Length of mapped files    */
         CKDDEV *ckdtab;                 /* Device table entry        */
         CKDCU  *ckdcu;                  /* Control unit entry        */
         U64     ckdtrkoff;              /* Track image file offset   */
@@ -1949,6 +2048,8 @@ struct DEVBLK {                         /* Device configuration block*/
         u_int   ckdssi:1;               /* 1=Set Special Intercept   */
         u_int   ckdnolazywr:1;          /* 1=Perform updates now     */
         u_int   ckdrdonly:1;            /* 1=Open read only          */
+        u_int   ckdmmap:1;              /* 1=Image files are mapped  */
+        u_int   ckdmaprw:1;             /* 1=Mapped read/write       */
         u_int   ckdwrha:1;              /* 1=Write Home Address      */
                                         /* Line above ISW20030819-1  */
         u_int   ckdfakewr:1;            /* 1=Fake successful write
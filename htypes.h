@@ -184,11 +184,16 @@ typedef  uint8_t    QWORD[16];  // unsigned quadword   (16 bytes)
 typedef struct SYSBLK    SYSBLK;    // System configuration block
 typedef struct REGS      REGS;      // CPU register context
 typedef struct VFREGS    VFREGS;    // Vector Facility Registers
+typedef struct BBCINST   BBCINST;   // Basic-block cache instruction
+typedef struct BBCBLK    BBCBLK;    // Basic-block cache block
+typedef struct PROFENT   PROFENT;   // Instruction profile entry
+typedef struct OPWIN     OPWIN;     // Storage operand window
 typedef struct ZPBLK     ZPBLK;     // Zone Parameter Block
 typedef struct TELNET    TELNET;    // Telnet Control Block
 typedef struct DEVBLK    DEVBLK;    // Device configuration block
 typedef struct CHPBLK    CHPBLK;    // Channel Path config block
 typedef struct IOINT     IOINT;     // I/O interrupt queue
+typedef struct IOQ       IOQ;       // Device I/O request queue
 
 typedef struct GSYSINFO  GSYSINFO;  // Ebcdic machine information
 
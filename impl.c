@@ -1222,12 +1222,23 @@ int     rc, maxprio, minprio;
     initialize_lock( &sysblk.crwlock  );
     initialize_lock( &sysblk.ioqlock  );
     initialize_lock( &sysblk.dasdcache_lock );
+    initialize_lock( &sysblk.proflock );
 #if defined( _FEATURE_073_TRANSACT_EXEC_FACILITY )
     initialize_lock( &sysblk.rublock );
 #endif
 
     initialize_condition( &sysblk.scrcond );
-    initialize_condition( &sysblk.ioqcond );
+
+    {
+        int i; char buf[32];
+        for (i=0; i < MAX_IOQS; i++)
+        {
+            MSGBUF( buf,    "&sysblk.ioq[%02d].lock", i );
+            initialize_lock( &sysblk.ioq[i].lock );
+            set_lock_name(   &sysblk.ioq[i].lock, buf );
+            initialize_condition( &sysblk.ioq[i].cond );
+        }
+    }
 
 #if defined( OPTION_SHARED_DEVICES )
     initialize_lock( &sysblk.shrdlock );
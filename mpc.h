@@ -503,6 +503,8 @@ typedef struct _MPC_IPA {
 #define IPA_QUERY_ARP_ASSIST    0x00040000L  /*     *                */
 #define IPA_INBOUND_TSO         0x00080000L  /*                      */
 #define IPA_OUTBOUND_TSO        0x00100000L  /*                      */
+#define IPA_INBOUND_CHECKSUM_V6 0x00400000L  /*                      */
+#define IPA_OUTBOUND_CHECKSUM_V6 0x00800000L /*                      */
                                              /*  |  |                */
                                              /*  |  A zPDT claims    */
                                              /*  |  ..to support     */
@@ -550,6 +552,27 @@ typedef struct _MPC_IPA {
                       )
 #endif /*defined(ENABLE_IPV6)*/
 
+/*  Below is the assists that Hercules additionally claims to        */
+/*  support when the TUNTAP interface accepts virtio-net headers,    */
+/*  allowing checksumming and TCP segmentation to be left to the     */
+/*  host. The capabilities reported for them by IPA_SAS_CMD_START    */
+/*  and IPA_SAS_CMD_ENABLE replies follow.                           */
+#define IPA_OFFL_IPv4 ( 0 \
+                      | IPA_INBOUND_CHECKSUM \
+                      | IPA_OUTBOUND_CHECKSUM \
+                      | IPA_OUTBOUND_TSO \
+                      )
+#define IPA_OFFL_IPv6 ( 0 \
+                      | IPA_INBOUND_CHECKSUM_V6 \
+                      | IPA_OUTBOUND_CHECKSUM_V6 \
+                      | IPA_OUTBOUND_TSO \
+                      )
+
+#define IPA_CSUM_IP_HDR         0x00000002L  /* IPv4 header checksum */
+#define IPA_CSUM_UDP            0x00000008L  /* UDP checksum         */
+#define IPA_CSUM_TCP            0x00000010L  /* TCP checksum         */
+#define IPA_LARGE_SEND_TCP      0x00000002L  /* TCP segmentation     */
+
 #define IPA_CMD_STARTLAN 0x01   /* Start LAN operations              */
 #define IPA_CMD_STOPLAN 0x02    /* Stop LAN operations               */
 #define IPA_CMD_SETVMAC 0x21    /* Set Layer-2 MAC address           */
@@ -763,6 +786,14 @@ typedef struct _MPC_IPA_SAS {
 /*00C*/ union {
             U32    flags_32;
             BYTE   ip[16];
+            struct {
+                FWORD  supported;   /* Supported capabilities        */
+                FWORD  enabled;     /* Enabled capabilities          */
+            } caps;
+            struct {
+                FWORD  mss;         /* Maximum large send size       */
+                FWORD  supported;   /* Supported large send types    */
+            } tso;
             /* There are other things that are part of the union. */
         } data;
     } MPC_IPA_SAS;
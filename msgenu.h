@@ -432,10 +432,10 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00331 "%1d:%04X CCKD file[%d] %s: shadow file check failed, sf command busy on device"
 #define HHC00332 "%1d:%04X CCKD file: display cckd statistics"
 #define HHC00333 "%1d:%04X   32/64       size free  nbr st   reads  writes l2reads    hits switches"
-#define HHC00334 "%1d:%04X                                                      readaheads   misses"
+#define HHC00334 "%1d:%04X                                             readaheads     used   wasted   ghosts"
 #define HHC00335 "%1d:%04X ------------------------------------------------------------------------"
 #define HHC00336 "%1d:%04X [*] %s %11.11"PRId64" %3.3"PRId64"%% %4.4"PRId64"    %7.7d %7.7d %7.7d %7.7d  %7.7d"
-#define HHC00337 "%1d:%04X                                                         %7.7d  %7.7d"
+#define HHC00337 "%1d:%04X                                                %7.7d  %7.7d  %7.7d  %7.7d"
 #define HHC00338 "%1d:%04X %s"
 #define HHC00339 "%1d:%04X [0] %s %11.11"PRId64" %3.3"PRId64"%% %4.4"PRId64" %s %7.7d %7.7d %7.7d"
 #define HHC00340 "%1d:%04X %s"
@@ -492,10 +492,10 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00391 "Starting CCKD Dasd Hardener pass..."
 #define HHC00392 "CCKD Dasd Hardener pass complete."
 #define HHC00393 "Thread '%s': sleeping for %d seconds at %s..."
-//efine HHC00394 (available)
-//efine HHC00395 (available)
+#define HHC00394 "%1d:%04X CCKD file %s: %d images recompressed using %s, %"PRIu64" bytes now %"PRIu64"%s"
+#define HHC00395 "%1d:%04X [%d] %s dictionary %u bytes: %u images compressed, %"PRId64"%% saved; %u uncompressed at %"PRIu64" MB/s"
 #define HHC00396 "%1d:%04X %s" // (cckd_trace)
-//efine HHC00397 (available)
+#define HHC00397 "%1d:%04X [*] %u images uncompressed without dictionary at %"PRIu64" MB/s"
 #define HHC00398 "%s" // (trace table)
 #define HHC00399 "CCKD file: internal cckd trace"
 
@@ -545,7 +545,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00441 "Thread "TIDPAT" %1d:%04X CKD file %s: updating cyl %d head %d record %d dl %d"
 #define HHC00442 "Thread "TIDPAT" %1d:%04X CKD file %s: set file mask %02X"
 #define HHC00443 "%1d:%04X CKD file: 'fakewrite' invalid without 'readonly'"
-//efine HHC00444 (available)
+#define HHC00444 "%1d:%04X %s file %s: mmap not possible: %s; using cached I/O"
 #define HHC00445 "%1d:%04X CKD file %s: updating cyl %d head %d"
 #define HHC00446 "%1d:%04X CKD file %s: write track error: stat %2.2X"
 #define HHC00447 "%1d:%04X CKD file %s: reading cyl %d head %d"
@@ -564,9 +564,9 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC00460 "%1d:%04X %s file %s: %u %s successfully written"
 #define HHC00461 "%1d:%04X CKD file %s: %s count %u is outside range %u-%u"
 #define HHC00462 "%1d:%04X CKD file %s: creating %4.4X volume %s: %u cyls, %u trks/cyl, %u bytes/track"
-//efine HHC00463 (available)
-//efine HHC00464 (available)
-//efine HHC00465 (available)
+#define HHC00463 "%1d:%04X [*] %"PRIu64" file I/Os in %"PRIu64" submissions, %"PRIu64" by io_uring, max %u per submission"
+#define HHC00464 "%1d:%04X [*] %-5s usecs <8 %u <32 %u <128 %u <512 %u <2K %u <8K %u <32K %u more %u"
+#define HHC00465 "CCKD file: io_uring not available: %s; using synchronous I/O"
 #define HHC00466 "Maximum of %u %s in %u 2GB file(s) is supported"
 #define HHC00467 "Maximum %s supported is %u"
 #define HHC00468 "For larger capacity DASD volumes, use %s"
@@ -1485,9 +1485,9 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02292 "%s" // icount_cmd
 #define HHC02293 "%s" // history.c: command history
 #define HHC02294 "%s" // cachestats_cmd
-//efine HHC02295 (available)
-//efine HHC02296 (available)
-//efine HHC02297 (available)
+#define HHC02295 "%s" // bbcache_cmd
+#define HHC02296 "%s" // profile_cmd
+#define HHC02297 "%s" // ioqueues_cmd
 #define HHC02298 "%1d:%04X drive is empty"
 #define HHC02299 "Invalid command usage. Type 'help %s' for assistance."
 #define HHC02300 "sm=%2.2X pk=%d cmwp=%X as=%s cc=%d pm=%X am=%s ia=%"PRIX64
@@ -1538,7 +1538,7 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
 #define HHC02345 "%s device %1d:%04X group has registered IP address %s"
 #define HHC02346 "%s device %1d:%04X group has no registered MAC or IP addresses"
 #define HHC02347 "No %s devices found"
-//efine HHC02348 (available)
+#define HHC02348 "%s device %1d:%04X group %s queue %d: rx %u (%u/s) tx %u (%u/s) dropped %u"
 //efine HHC02349 (available)
 //efine HHC02350 - HHC02359 (available)
 //efine HHC02360 - HHC02369 (available)
@@ -1664,6 +1664,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02435I   -r       replace the output file if it exists\n" \
        "%s" \
        "%s" \
+       "%s" \
+       "%s" \
        "HHC02435I   -0       don't compress track images\n" \
        "HHC02435I   -cyls n  size of output file\n" \
        "HHC02435I   -a       output file will have alt cyls"
@@ -1689,6 +1691,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02437I   -r       replace the output file if it exists\n" \
        "%s" \
        "%s" \
+       "%s" \
+       "%s" \
        "HHC02437I   -0       don't compress track images\n" \
        "HHC02437I   -blks n  size of output file"
 #define HHC02438 "Usage: cfba2fba [-options] ifile [sf=sfile] ofile\n" \
@@ -1713,6 +1717,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02439I   -r       replace the output file if it exists\n" \
        "%s" \
        "%s" \
+       "%s" \
+       "%s" \
        "HHC02439I   -0       don't compress output\n" \
        "HHC02439I   -blks n  size of output fba file\n" \
        "HHC02439I   -cyls n  size of output ckd file\n" \
@@ -1843,14 +1849,19 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC02496I\n" \
        "HHC02496I n        'n' is a digit 0 - 5 (default is 1) indicating output verbosity\n" \
        "HHC02496I max...   'maxdblk', etc, is maximum number of DBLK/TTR/DSCB entries or 0 for default"
-#define HHC02497 "Usage: %s [-f] [-level] file1 [file2 ... ]\n" \
+#define HHC02497 "Usage: %s [-f] [-level] [-comp [-dict] [-p n]] file1 [file2 ... ]\n" \
        "HHC02497I   file    name of CCKD file\n" \
        "HHC02497I Options:\n" \
        "HHC02497I   -f      force check even if OPENED bit is on\n" \
        "HHC02497I   -0      minimal checking (default)\n" \
        "HHC02497I   -1      normal  checking\n" \
        "HHC02497I   -2      intermediate checking\n" \
-       "HHC02497I   -3      maximal checking"
+       "HHC02497I   -3      maximal checking\n" \
+       "HHC02497I   -comp   recompress all images in place, where comp is\n" \
+       "HHC02497I           -none, -z (zlib), -bz2, -zstd or -lz4\n" \
+       "HHC02497I   -dict   train a dictionary from the images and compress\n" \
+       "HHC02497I           with it (-z or -zstd only)\n" \
+       "HHC02497I   -p n    compression parameter (zlib/bzip2 1-9, zstd 1-22)"
 //efine HHC02498 (available)
 #define HHC02499 "Hercules utility %s - version %s"
 
@@ -2344,7 +2355,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC03023I   free_imbed:    %"PRIu64                                 "\n" \
        "HHC03023I   cdh_nullfmt:   %u               (%s)"                   "\n" \
        "HHC03023I   cmp_algo:      %u               (%s)"                   "\n" \
-       "HHC03023I   cmp_parm:      %"PRId16"              %s(%s)"
+       "HHC03023I   cmp_parm:      %"PRId16"              %s(%s)"           "\n" \
+       "HHC03023I   dict_off:      0x%10.10"PRIX64"    (%u bytes, %s)"
 #define HHC03024                                                            "\n" \
        "HHC03024I   cdh_vrm:       %u.%u.%u"                                "\n" \
        "HHC03024I   cdh_opts:      0x%2.2X"                                 "\n" \
@@ -2360,7 +2372,8 @@ LOGM_DLL_IMPORT int  panel_command_capture( char* cmd, char** resp, bool quiet )
        "HHC03024I   free_imbed:    %"PRIu64                                 "\n" \
        "HHC03024I   cdh_nullfmt:   %u               (%s)"                   "\n" \
        "HHC03024I   cmp_algo:      %u               (%s)"                   "\n" \
-       "HHC03024I   cmp_parm:      %"PRId16"              %s(%s)"
+       "HHC03024I   cmp_parm:      %"PRId16"              %s(%s)"           "\n" \
+       "HHC03024I   dict_off:      0x%10.10"PRIX64"    (%u bytes, %s)"
 #define HHC03040 "         File offset    Size (hex)         Size  track(s)"
 #define HHC03041 "***********************************************************"
 #define HHC03042 "%-8s 0x%10.10"PRIX64"  0x%10.10"PRIX64" %11"PRIu64"%s"
@@ -1664,6 +1664,55 @@ DEF_INST( execute_opcode_ed________xx )
   regs->ARCH_DEP( runtime_opcode_ed________xx )[inst[5]](inst, regs);
 }
 
+/*-------------------------------------------------------------------*/
+/*                     resolve_opcode                                */
+/*-------------------------------------------------------------------*/
+/* Returns the function that will ultimately execute the instruction */
+/* by performing the same table lookups that the above "instruction" */
+/* jumpers would do. Used by the basic-block cache (see cpu.c) so it */
+/* can call the actual instruction directly. 'xop' is set to true if */
+/* the function also depends on the extended opcode in byte 5.       */
+/*-------------------------------------------------------------------*/
+INSTR_FUNC ARCH_DEP( resolve_opcode )( REGS* regs, BYTE inst[], bool* xop )
+{
+    INSTR_FUNC  func  = regs->ARCH_DEP( runtime_opcode_xxxx )[ fetch_hw( inst )];
+
+    *xop = true;
+
+    if (func == ARCH_DEP( execute_opcode_e3________xx ))
+        return regs->ARCH_DEP( runtime_opcode_e3________xx )[ inst[5] ];
+
+#if defined( OPTION_OPTINST ) && !defined( OPTION_NO_E3_OPTINST )
+    if (func == ARCH_DEP( E3_0 ))
+        return regs->ARCH_DEP( runtime_opcode_e3_0______xx )[ inst[5] ];
+#endif
+
+    if (func == ARCH_DEP( execute_opcode_e6xx______xx ))
+    {
+#if ARCH_900_IDX == ARCH_IDX
+        return regs->ARCH_DEP( runtime_opcode_e6xx______xx )[ inst[5] ];
+#else
+        *xop = false;
+        return regs->ARCH_DEP( runtime_opcode_e6xx______xx )[ inst[1] ];
+#endif
+    }
+
+    if (func == ARCH_DEP( execute_opcode_e7________xx ))
+        return regs->ARCH_DEP( runtime_opcode_e7________xx )[ inst[5] ];
+
+    if (func == ARCH_DEP( execute_opcode_eb________xx ))
+        return regs->ARCH_DEP( runtime_opcode_eb________xx )[ inst[5] ];
+
+    if (func == ARCH_DEP( execute_opcode_ec________xx ))
+        return regs->ARCH_DEP( runtime_opcode_ec________xx )[ inst[5] ];
+
+    if (func == ARCH_DEP( execute_opcode_ed________xx ))
+        return regs->ARCH_DEP( runtime_opcode_ed________xx )[ inst[5] ];
+
+    *xop = false;
+    return func;
+}
+
 /*-------------------------------------------------------------------*/
 /* 00   ???? - Operation Exception "instruction"              [????] */
 /*-------------------------------------------------------------------*/
@@ -7999,6 +8048,10 @@ static INSTR_FUNC replace_opcode_xx________xx( int arch, INSTR_FUNC inst, int op
 /*-------------------------------------------------------------------*/
 DLL_EXPORT void* the_real_replace_opcode( int arch, INSTR_FUNC inst, int opcode1, int opcode2 )
 {
+  /* Force the CPUs to discard any basic-block cache entries that
+     might still be pointing to the instruction being replaced */
+  sysblk.bbcgen++;
+
   switch(opcode1)
   {
     case 0x01:
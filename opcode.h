@@ -2823,6 +2823,7 @@ U32  get_next_channel_report_word( REGS * );
 /* Functions in module opcode.c */
 void init_runtime_opcode_tables();
 void init_regs_runtime_opcode_pointers( REGS* regs );
+INSTR_FUNC ARCH_DEP( resolve_opcode )( REGS* regs, BYTE inst[], bool* xop );
 
 
 /* Functions in module hscmisc.c */
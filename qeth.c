@@ -23,6 +23,7 @@
 /*                 ipaddr6 <IPv6 address and prefix length>          */
 /*                 mtu     <MTU>                                     */
 /*                 chpid   <channel path id>                         */
+/*                 mq      <number of TAP queues>  (Linux only)      */
 /*                 debug                                             */
 /*                                                                   */
 /* When using a bridged configuration no parameters are required     */
@@ -132,6 +133,18 @@ DISABLE_GCC_UNUSED_FUNCTION_WARNING;
 #define QETH_PTT_TRACING        // #define to enable PTT debug tracing
 #define QETH_DUMP_DATA          // #undef to suppress i/o buffers dump
 
+/* (move packets directly between TUNTAP and queue buffer storage) */
+#if !defined( OPTION_W32_CTCI ) && defined( HAVE_SYS_UIO_H )
+  #define QETH_SCATTER_GATHER   // #undef to always copy via dev->buf
+#elif defined( _MSVC_ )
+  struct iovec { void* iov_base; size_t iov_len; };   // (prototypes)
+#endif
+
+/* (leave checksumming and TCP segmentation to the host's TUNTAP) */
+#if defined( QETH_SCATTER_GATHER ) && defined( __linux__ )
+  #define QETH_VNET_HDR         // #undef to never use virtio-net headers
+#endif
+
 
 /*-------------------------------------------------------------------*/
 /* QETH Debugging                                                    */
@@ -1111,7 +1124,7 @@ static int qeth_disable_interface (DEVBLK *dev, OSA_GRP *grp)
 /*-------------------------------------------------------------------*/
 static int qeth_create_interface (DEVBLK *dev, OSA_GRP *grp)
 {
-    int i, rc;
+    int i, rc, internal;
     char buf[64];
 
     /* We should only ever be called ONCE */
@@ -1130,6 +1143,10 @@ static int qeth_create_interface (DEVBLK *dev, OSA_GRP *grp)
             | IFF_NO_PI
             | IFF_OSOCK
             | (grp->l3 ? IFF_TUN : IFF_TAP)
+            | (grp->ttmq > 1 ? IFF_MULTI_QUEUE : 0)
+#if defined( QETH_VNET_HDR )
+            | IFF_VNET_HDR
+#endif
         ,
         &grp->ttfd,
         grp->ttifname,
@@ -1142,6 +1159,67 @@ static int qeth_create_interface (DEVBLK *dev, OSA_GRP *grp)
     /* Update DEVBLK file descriptors */
     for (i=0; i < dev->group->acount; i++)
         dev->group->memdev[i]->fd = grp->ttfd;
+    grp->ttq[0].fd = grp->ttfd;
+
+#if defined( QETH_VNET_HDR )
+    /* Find out whether the interface accepted virtio-net headers, in
+       which case every packet/frame read or written has one. If the
+       host also agrees not to offload anything to us then offer the
+       guest the checksum and TCP segmentation offload assists, which
+       are passed on to the host in the virtio-net headers. */
+    {
+        struct ifreq ifr;
+        memset( &ifr, 0, sizeof( ifr ));
+        grp->ttvnet = 0;
+        grp->ttvoffl = 0;
+        if (1
+            && TUNTAP_IOCtl( grp->ttfd, TUNGETIFF, (char*) &ifr ) == 0
+            && (ifr.ifr_flags & IFF_VNET_HDR)
+        )
+            grp->ttvnet = 1;
+        if (grp->ttvnet && TUNTAP_IOCtl( grp->ttfd, TUNSETOFFLOAD, 0 ) == 0)
+        {
+            grp->ttvoffl = 1;
+            grp->ipas4 |= IPA_OFFL_IPv4;
+#if defined( ENABLE_IPV6 )
+            grp->ipas6 |= IPA_OFFL_IPv6;
+#endif
+        }
+    }
+#endif
+
+    /* Attach any additional queues to the interface just created */
+    for (i=1; i < grp->ttmq; i++)
+    {
+        if ((rc = TUNTAP_CreateInterface
+        (
+            grp->ttdev,
+            0
+                | IFF_NO_PI
+                | IFF_OSOCK
+                | (grp->l3 ? IFF_TUN : IFF_TAP)
+                | IFF_MULTI_QUEUE
+#if defined( QETH_VNET_HDR )
+                | IFF_VNET_HDR
+#endif
+            ,
+            &grp->ttq[i].fd,
+            grp->ttifname,
+            &internal
+
+        )) != 0)
+        {
+            MSGBUF( buf, "TUNTAP_CreateInterface() queue %d failed", i );
+            QERRMSG( dev, grp, errno, "W", buf );
+            grp->ttq[i].fd = -1;
+            grp->ttmq = i;
+            break;
+        }
+        if ((rc = socket_set_blocking_mode( grp->ttq[i].fd, 0 )) != 0)
+            QERRMSG( dev, grp, rc,
+                "W", "socket_set_blocking_mode() failed" );
+    }
+    grp->ttqtod = ETOD_high64_to_usecs( host_tod() );
 
     // HHC00901 "%1d:%04X %s: interface %s, type %s opened"
     WRMSG( HHC00901, "I", SSID_TO_LCSS(dev->ssid),
@@ -1965,6 +2043,27 @@ U16 offph;
                         STORE_HW(ipa->rc,IPA_RC_UNSUPPORTED_SUBCMD);
                     }
 
+                    /* The offload assists report their capabilities */
+                    if ((ano & (IPA_OFFL_IPv4 | IPA_OFFL_IPv6))
+                        && (cmd == IPA_SAS_CMD_START || cmd == IPA_SAS_CMD_ENABLE))
+                    {
+                        U32 caps = (ano == IPA_OUTBOUND_TSO) ? IPA_LARGE_SEND_TCP
+                                 : (IPA_CSUM_IP_HDR | IPA_CSUM_UDP | IPA_CSUM_TCP);
+                        if (ano == IPA_OUTBOUND_TSO && cmd == IPA_SAS_CMD_START)
+                        {
+                            /* (room for an Ethernet header with a tag) */
+                            STORE_FW(ipa_sas->data.tso.mss,dev->bufsize - sizeof(ETHFRM) - 4);
+                            STORE_FW(ipa_sas->data.tso.supported,caps);
+                        }
+                        else
+                        {
+                            STORE_FW(ipa_sas->data.caps.supported,caps);
+                            STORE_FW(ipa_sas->data.caps.enabled,caps);
+                        }
+                        len = sizeof(struct MPC_IPA_SAS_HDR) - 4 + 8;
+                        STORE_HW(ipa_sas->hdr.len,len);
+                    }
+
                     ipadatasize = (len + 4);
                 }
                 /* end case IPA_CMD_SETASSPARMS:  0xB3 */
@@ -2467,6 +2566,13 @@ U16 reqtype;
 #else
         grp->ipas6 = 0;
 #endif
+        if (grp->ttvoffl)
+        {
+            grp->ipas4 |= IPA_OFFL_IPv4;
+#if defined( ENABLE_IPV6 )
+            grp->ipas6 |= IPA_OFFL_IPv6;
+#endif
+        }
         grp->ipae0 = 0;
         grp->ipae4 = 0;
         grp->ipae6 = 0;
@@ -2519,56 +2625,42 @@ U16 reqtype;
 static void raise_adapter_interrupt( DEVBLK* dev )
 {
     OSA_GRP* grp = (OSA_GRP*) dev->group->grp_data;
+    CPU_BITMAP wake;
 
     /* Don't waste time queuing interrupts during power off sequence */
     if (sysblk.shutdown)
         return;
 
-    /* Keep trying to OBTAIN_INTLOCK until we either succeed
-       or we detect that a halt/clear subchannel was requested
-       (which would cause a deadlock if we just blindly tried
-       to obtain it).  Note that we test for the halt or clear
-       subchannel request WITHOUT first obtaining dev->lock to
-       prevent a deadlock that would occur for the same reason
-       (since channel.c holds BOTH during HSCH/CSCH processing).
+    /* Don't queue an interrupt if a halt/clear subchannel has been
+       requested.  Note that we test for the halt or clear subchannel
+       request WITHOUT first obtaining dev->lock since channel.c holds
+       it during HSCH/CSCH processing.  The interrupt lock is no longer
+       needed to post the interrupt: it is only briefly obtained below
+       (after all other locks are released) if a waiting CPU needs to
+       be woken up to present it.
     */
-    while (!(dev->scsw.flag2 & (SCSW2_FC_HALT | SCSW2_FC_CLEAR)))
-    {
-        /* Try to obtain the interrupt lock (OBTAIN_INTLOCK) */
-        if (TRY_OBTAIN_INTLOCK( NULL ) == 0)
-        {
-            /* Interrupt lock obtained; queue the interrupt */
-            OBTAIN_DEVLOCK( dev );
-            {
-                if (grp->debugmask & DBGQETHINTRUPT)
-                    DBGTRC( dev, "Adapter Interrupt" );
+    if (dev->scsw.flag2 & (SCSW2_FC_HALT | SCSW2_FC_CLEAR))
+        return;
 
-                dev->pciscsw.flag2 |= SCSW2_Q | SCSW2_FC_START;
-                dev->pciscsw.flag3 |= SCSW3_SC_INTER | SCSW3_SC_PEND;
-                dev->pciscsw.chanstat = CSW_PCI;
+    OBTAIN_DEVLOCK( dev );
+    {
+        if (grp->debugmask & DBGQETHINTRUPT)
+            DBGTRC( dev, "Adapter Interrupt" );
 
-                OBTAIN_IOINTQLK();
-                {
-                    QUEUE_IO_INTERRUPT_QLOCKED( &dev->pciioint, FALSE );
-                    UPDATE_IC_IOPENDING_QLOCKED();
-                }
-                RELEASE_IOINTQLK();
-            }
-            RELEASE_DEVLOCK( dev );
+        dev->pciscsw.flag2 |= SCSW2_Q | SCSW2_FC_START;
+        dev->pciscsw.flag3 |= SCSW3_SC_INTER | SCSW3_SC_PEND;
+        dev->pciscsw.chanstat = CSW_PCI;
 
-            RELEASE_INTLOCK( NULL );
-            return;
+        OBTAIN_IOINTQLK();
+        {
+            QUEUE_IO_INTERRUPT_QLOCKED( &dev->pciioint, FALSE );
+            wake = POST_IC_IOPENDING_QLOCKED();
         }
-
-        /* Yield to hopefully allow current intlock owner a chance
-           to finish using it and release it before we try again.
-        */
-        sched_yield();
+        RELEASE_IOINTQLK();
     }
+    RELEASE_DEVLOCK( dev );
 
-    /* Halt/Clear Subchannel was requested for device.
-       Return immediately without queuing any interrupt.
-    */
+    WAKEUP_IOPENDING_CPUS( wake );
 }
 
 
@@ -2795,26 +2887,60 @@ static inline int l3_cast_type_ipv6( BYTE* dest_addr, OSA_GRP* grp )
 /* Note: boolean function. Does not report errors. If the select     */
 /* call fails then this function simply returns 0 = false (EOF).     */
 /*-------------------------------------------------------------------*/
-static BYTE more_packets( DEVBLK* dev )
+static BYTE more_packets( DEVBLK* dev, OSA_GRP *grp )
 {
     fd_set readset;
     struct timeval tv = {0,0};
+    int fd = grp->ttq[ grp->ttrxq ].fd;
+    UNREFERENCED( dev );
     FD_ZERO( &readset );
-    FD_SET( dev->fd, &readset );
-    return (qeth_select( dev->fd+1, &readset, &tv ) > 0);
+    FD_SET( fd, &readset );
+    return (qeth_select( fd+1, &readset, &tv ) > 0);
 }
 
 
 /*-------------------------------------------------------------------*/
-/* Read one packet/frame from TUN/TAP device into dev->buf.          */
-/* dev->buflen updated with length of packet/frame just read.        */
+/* Read one packet/frame from the current TUN/TAP queue into either  */
+/* dev->buf or, if iovcnt is non-zero, directly into the queue       */
+/* buffer storage described by iov (see build_input_iovec).          */
+/* dev->buflen updated with length of packet/frame just read, and    */
+/* grp->ttvhdr with its virtio-net header if the interface has them. */
 /*-------------------------------------------------------------------*/
-static QRC read_packet( DEVBLK* dev, OSA_GRP *grp )
+static QRC read_packet( DEVBLK* dev, OSA_GRP *grp,
+                        struct iovec* iov, int iovcnt )
 {
+    OSA_TTQ* ttq = &grp->ttq[ grp->ttrxq ];
     int errnum;
 
-    PTT_QETH_TRACE( "rdpack entr", dev->bufsize, 0, 0 );
-    dev->buflen = TUNTAP_Read( dev->fd, dev->buf, dev->bufsize );
+    PTT_QETH_TRACE( "rdpack entr", dev->bufsize, iovcnt, 0 );
+#if defined( QETH_VNET_HDR )
+    if (grp->ttvnet)
+    {
+        struct iovec viov[ QMAXSTBK+1 ];
+        viov[0].iov_base = &grp->ttvhdr;
+        viov[0].iov_len  = sizeof( VNET_HDR );
+        if (iovcnt)
+            memcpy( &viov[1], iov, iovcnt * sizeof( struct iovec ));
+        else
+        {
+            viov[1].iov_base = dev->buf;
+            viov[1].iov_len  = dev->bufsize;
+            iovcnt = 1;
+        }
+        if ((dev->buflen = TUNTAP_Readv( ttq->fd, viov, iovcnt+1 )) >= 0)
+            dev->buflen = max( dev->buflen - (int)sizeof( VNET_HDR ), 0 );
+    }
+    else
+#endif
+#if defined( QETH_SCATTER_GATHER )
+    if (iovcnt)
+        dev->buflen = TUNTAP_Readv( ttq->fd, iov, iovcnt );
+    else
+#else
+    UNREFERENCED( iov );
+    UNREFERENCED( iovcnt );
+#endif
+        dev->buflen = TUNTAP_Read( ttq->fd, dev->buf, dev->bufsize );
     errnum = errno;
 
     if (unlikely(dev->buflen < 0))
@@ -2845,6 +2971,7 @@ static QRC read_packet( DEVBLK* dev, OSA_GRP *grp )
 
     /* Count packets received */
     dev->qdio.rxcnt++;
+    ttq->rxcnt++;
 
     PTT_QETH_TRACE( "rdpack exit", dev->bufsize, dev->buflen, QRC_SUCCESS );
     return QRC_SUCCESS;
@@ -2852,20 +2979,58 @@ static QRC read_packet( DEVBLK* dev, OSA_GRP *grp )
 
 
 /*-------------------------------------------------------------------*/
-/* Write one L2/L3 packet/frame to the TUN/TAP device.               */
+/* Write one L2/L3 packet/frame to the current TUN/TAP queue. When   */
+/* iovcnt is non-zero the packet/frame is gathered directly from the */
+/* queue buffer storage described by iov and pkt is ignored. If the  */
+/* interface has virtio-net headers, vnet (or when NULL an all zero  */
+/* header, i.e. nothing left for the host to do) is written first.   */
 /*-------------------------------------------------------------------*/
 static QRC write_packet( DEVBLK* dev, OSA_GRP *grp,
-                         BYTE* pkt, int pktlen )
+                         BYTE* pkt, int pktlen,
+                         struct iovec* iov, int iovcnt,
+                         VNET_HDR* vnet )
 {
+    OSA_TTQ* ttq = &grp->ttq[ grp->tttxq ];
     int wrote, errnum;
 
-    PTT_QETH_TRACE( "wrpack entr", 0, pktlen, 0 );
-    wrote = TUNTAP_Write( dev->fd, pkt, pktlen );
+    PTT_QETH_TRACE( "wrpack entr", iovcnt, pktlen, 0 );
+#if defined( QETH_VNET_HDR )
+    if (grp->ttvnet)
+    {
+        static VNET_HDR vnet0;          /* (all zero)                */
+        struct iovec viov[ QMAXSTBK+2 ];
+        viov[0].iov_base = vnet ? vnet : &vnet0;
+        viov[0].iov_len  = sizeof( VNET_HDR );
+        if (iovcnt)
+            memcpy( &viov[1], iov, iovcnt * sizeof( struct iovec ));
+        else
+        {
+            viov[1].iov_base = pkt;
+            viov[1].iov_len  = pktlen;
+            iovcnt = 1;
+        }
+        if ((wrote = TUNTAP_Writev( ttq->fd, viov, iovcnt+1 )) > 0)
+            wrote -= sizeof( VNET_HDR );
+    }
+    else
+#else
+    UNREFERENCED( vnet );
+#endif
+#if defined( QETH_SCATTER_GATHER )
+    if (iovcnt)
+        wrote = TUNTAP_Writev( ttq->fd, iov, iovcnt );
+    else
+#else
+    UNREFERENCED( iov );
+    UNREFERENCED( iovcnt );
+#endif
+        wrote = TUNTAP_Write( ttq->fd, pkt, pktlen );
     errnum = errno;
 
     if (likely(wrote == pktlen))
     {
         dev->qdio.txcnt++;
+        ttq->txcnt++;
         PTT_QETH_TRACE( "wrpack exit", 0, pktlen, QRC_SUCCESS );
         return QRC_SUCCESS;
     }
@@ -3040,15 +3205,17 @@ static QRC copy_storage_fragments( DEVBLK* dev, OSA_GRP *grp,
 /* dev->buflen should be set to the length of the packet/frame.      */
 /*-------------------------------------------------------------------*/
 /* sbal points to the Storage Block Address List for the buffer.     */
-/* sb is the Storage Block number to begin processing with.          */
+/* sb is a ptr to the Storage Block number to begin processing with */
+/* and is updated to the number of the last Storage Block used.      */
 /* sbalk is the associated protection key for the queue buffer.      */
 /* hdr points to pre-built OSA_HDR2/OSA_HDR3 and hdrlen is its size. */
 /*-------------------------------------------------------------------*/
 static QRC copy_packet_to_storage( DEVBLK* dev, OSA_GRP *grp,
-                                   QDIO_SBAL *sbal, int sb, BYTE sbalk,
+                                   QDIO_SBAL *sbal, int* psb, BYTE sbalk,
                                    BYTE* hdr, int hdrlen,
                                    BYTE* frm, int frmlen )
 {
+    int sb = *psb;                      /* Current Storage Block     */
     int ssb = sb;                       /* Starting Storage Block    */
     U32 sboff = 0;                      /* Storage Block offset      */
     U32 sbrem = 0;                      /* Storage Block remaining   */
@@ -3071,6 +3238,7 @@ static QRC copy_packet_to_storage( DEVBLK* dev, OSA_GRP *grp,
     STORE_FW( sbal->sbale[sb].length, sboff );
     STORE_FW( sbal->sbale[sb].flags,     0   );
     SET_SBALE_FRAG( sbal->sbale[sb].flags[0], frag0 );
+    *psb = sb;
 
     /* Dump the SBALE's we consumed */
     if (grp->debugmask & DBGQETHSBALE)
@@ -3089,6 +3257,529 @@ static QRC copy_packet_to_storage( DEVBLK* dev, OSA_GRP *grp,
 }
 
 
+#if defined( QETH_SCATTER_GATHER )
+/*-------------------------------------------------------------------*/
+/* Build the iovec used by read_packet to read a packet/frame        */
+/* directly into OSA queue buffer storage, leaving room for the OSA  */
+/* header at the start of Storage Block sb. Returns the number of    */
+/* iovec entries built, or zero when the packet/frame must instead   */
+/* be read into dev->buf and copied (packet tracing is active or the */
+/* valid Storage Blocks cannot hold a full size packet/frame).       */
+/*-------------------------------------------------------------------*/
+static int build_input_iovec( DEVBLK* dev, OSA_GRP *grp,
+                              QDIO_SBAL *sbal, BYTE sbalk, int sb,
+                              U32 hdrlen, struct iovec* iov )
+{
+    U64 sba;                            /* Storage Block Address     */
+    U32 sblen;                          /* Length of Storage Block   */
+    U32 room = 0;                       /* Room for the packet/frame */
+    int n;                              /* Number of iovec entries   */
+
+    if (grp->debugmask & DBGQETHPACKET)
+        return 0;
+
+    for (n=0; sb < QMAXSTBK; sb++, n++)
+    {
+        FETCH_DW( sba,   sbal->sbale[sb].addr   );
+        FETCH_FW( sblen, sbal->sbale[sb].length );
+        if (!sblen || STORCHK( sba, sblen-1, sbalk, STORKEY_CHANGE, dev ))
+            break;
+
+        /* The OSA header and the start of the packet/frame (which
+           read_L2_packets and read_L3_packets need to look at) must
+           both be contained within the first Storage Block */
+        if (!n)
+        {
+            if (sblen < hdrlen + sizeof( IP6FRM ))
+                return 0;
+            sba   += hdrlen;
+            sblen -= hdrlen;
+        }
+
+        iov[n].iov_base = dev->mainstor + sba;
+        iov[n].iov_len  = sblen;
+        room += sblen;
+    }
+
+    /* (allow for an Ethernet header with an 802.1Q tag) */
+    if (room < (U32)grp->uMTU + sizeof( ETHFRM ) + 4)
+        return 0;
+
+    return n;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Complete a packet/frame which read_packet placed directly into    */
+/* OSA queue buffer storage: store the OSA header in front of it and */
+/* set the SBALE lengths and fragment flags the same way as          */
+/* copy_packet_to_storage would have. dev->buflen should be set to   */
+/* the length of the packet/frame.                                   */
+/*-------------------------------------------------------------------*/
+/* sbal points to the Storage Block Address List for the buffer.     */
+/* sb is a ptr to the Storage Block number the packet started in and */
+/* is updated to the number of the last Storage Block used.          */
+/* sbalk is the associated protection key for the queue buffer.      */
+/* hdr points to pre-built OSA_HDR2/OSA_HDR3 and hdrlen is its size. */
+/*-------------------------------------------------------------------*/
+static QRC finish_packet_in_storage( DEVBLK* dev, OSA_GRP *grp,
+                                     QDIO_SBAL *sbal, int* psb, BYTE sbalk,
+                                     BYTE* hdr, int hdrlen )
+{
+    int sb = *psb;                      /* Current Storage Block     */
+    int ssb = sb;                       /* Starting Storage Block    */
+    U64 sba;                            /* Storage Block Address     */
+    U32 sblen;                          /* Length of Storage Block   */
+    U32 rem;                            /* Bytes remaining           */
+    BYTE frag0;                         /* SBALE fragment flag       */
+
+    /* The header goes at the start of the first Storage Block */
+    FETCH_DW( sba, sbal->sbale[sb].addr );
+    memcpy( dev->mainstor + sba, hdr, hdrlen );
+
+    /* Mark each Storage Block the packet/frame occupies */
+    frag0 = SBALE_FLAG0_FRAG_FIRST;
+    rem = hdrlen + dev->buflen;
+    for (;;)
+    {
+        FETCH_FW( sblen, sbal->sbale[sb].length );
+        if (rem <= sblen)
+            break;
+
+        STORE_FW( sbal->sbale[sb].flags, 0 );
+        SET_SBALE_FRAG( sbal->sbale[sb].flags[0], frag0 );
+        rem -= sblen;
+
+        /* (packet/frame was truncated if we run out of blocks) */
+        if (sb >= (QMAXSTBK-1))
+            return SBALE_ERROR( QRC_ENOSPC, dev,sbal,sbalk,sb);
+        sb++;
+        frag0 = SBALE_FLAG0_FRAG_MIDDLE;
+    }
+
+    /* Mark last fragment */
+    frag0 = SBALE_FLAG0_FRAG_LAST;
+    STORE_FW( sbal->sbale[sb].length, rem );
+    STORE_FW( sbal->sbale[sb].flags,   0  );
+    SET_SBALE_FRAG( sbal->sbale[sb].flags[0], frag0 );
+    *psb = sb;
+
+    /* Dump the SBALE's we consumed */
+    if (grp->debugmask & DBGQETHSBALE)
+    {
+        int  i;
+        for (i=ssb; i <= sb; i++)
+        {
+            FETCH_FW( rem, sbal->sbale[i].length );
+            frag0 = sbal->sbale[i].flags[0];
+            DBGTRC( dev, "Input SBALE(%d): flag: %02X Len: %04X (%d)",
+                i, frag0, rem, rem );
+        }
+    }
+
+    return QRC_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Build the iovec describing an output packet/frame that is held in */
+/* one or more OSA queue storage buffers so that it can be written   */
+/* to the TUN/TAP device without first being copied into dev->buf.   */
+/* Performs exactly the same checks as copy_storage_fragments, with  */
+/* the same arguments, and leaves dev->buflen and dev->bufres set as */
+/* if the packet/frame had been copied.                              */
+/*-------------------------------------------------------------------*/
+static QRC gather_storage_fragments( DEVBLK* dev, OSA_GRP *grp,
+                                     QDIO_SBAL *sbal, BYTE sbalk,
+                                     int* sb, BYTE* sbsrc, U32 sblen,
+                                     struct iovec* iov, int* iovcnt )
+{
+    U64 sba;                            /* Storage Block Address     */
+    U32 len;                            /* Fragment length           */
+
+    *iovcnt = 0;
+
+    while (dev->bufres > 0)
+    {
+        /* End of current storage block? */
+        if (!sblen)
+        {
+            /* Is this the last storage block? */
+            if (WR_LOGICALLY_LAST_SBALE( sbal->sbale[*sb].flags[0] ))
+                return SBALE_ERROR( QRC_EPKSBLEN, dev,sbal,sbalk,*sb);
+
+            /* Request interrupt if needed */
+            if (sbal->sbale[*sb].flags[3] & SBALE_FLAG3_PCI_REQ)
+            {
+                SET_DSCI(dev,DSCI_IOCOMP);
+                grp->oqPCI = TRUE;
+            }
+
+            /* Retrieve the next storage block entry */
+            if (*sb >= (QMAXSTBK-1))
+                return SBALE_ERROR( QRC_ENOSPC, dev,sbal,sbalk,*sb);
+            *sb = *sb + 1;
+            FETCH_DW( sba,   sbal->sbale[*sb].addr   );
+            FETCH_FW( sblen, sbal->sbale[*sb].length );
+            if (!sblen)
+                return SBALE_ERROR( QRC_EZEROBLK, dev,sbal,sbalk,*sb);
+            if (STORCHK( sba, sblen-1, sbalk, STORKEY_CHANGE, dev))
+                return SBALE_ERROR( QRC_ESTORCHK, dev,sbal,sbalk,*sb);
+
+            /* Point to new data source */
+            sbsrc = (BYTE*)(dev->mainstor + sba);
+        }
+
+        /* This storage block holds the next fragment */
+        len = min( (U32)dev->bufres, sblen );
+        iov[*iovcnt].iov_base = sbsrc;
+        iov[*iovcnt].iov_len  = len;
+        *iovcnt = *iovcnt + 1;
+
+        dev->buflen += len;
+        dev->bufres -= len;
+        sbsrc       += len;
+        sblen       -= len;
+    }
+
+    return QRC_SUCCESS;
+}
+#endif /* defined( QETH_SCATTER_GATHER ) */
+
+
+#if defined( QETH_VNET_HDR )
+/*-------------------------------------------------------------------*/
+/* Accumulate, and fold, a ones' complement checksum (RFC 1071).     */
+/*-------------------------------------------------------------------*/
+static U32 csum_add( U32 sum, BYTE* p, int len )
+{
+    for (; len > 1; p += 2, len -= 2)
+        sum += (p[0] << 8) | p[1];
+    if (len)
+        sum += p[0] << 8;
+    return sum;
+}
+
+static U16 csum_fold( U32 sum )
+{
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (U16) sum;
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Write a packet/frame for which the guest requested checksum       */
+/* offload (flags in the OSA header) or, when mss is non-zero, TCP   */
+/* segmentation offload, to a TUN/TAP interface which has virtio-net */
+/* headers. The host is left to calculate the transport checksum and */
+/* to split the packet into segments. The packet/frame is gathered   */
+/* from the queue buffer storage described by iov; only its protocol */
+/* headers, which are corrected, are copied. Returns 1 without       */
+/* writing anything if the packet/frame cannot be offloaded, leaving */
+/* any checksums to be calculated by csum_packet.                    */
+/*-------------------------------------------------------------------*/
+static QRC write_offload_packet( DEVBLK* dev, OSA_GRP *grp, BYTE* hdr,
+                                 U16 mss, int pktlen,
+                                 struct iovec* iov, int iovcnt )
+{
+    BYTE pkt[ sizeof( ETHFRM ) + 4 + 60 + 60 ];  /* Protocol headers */
+    struct iovec oiov[ QMAXSTBK+1 ];    /* Output packet/frame       */
+    VNET_HDR vnet;                      /* Work left for the host    */
+    BYTE* ip;                           /* Ptr to IP header          */
+    BYTE* l4;                           /* Ptr to TCP/UDP header     */
+    BYTE  tpcsum;                       /* Transport cksum requested */
+    BYTE  proto;                        /* IP protocol               */
+    int   skip = 0;                     /* Header not sent to a TUN  */
+    int   l2len = 0;                    /* Ethernet header length    */
+    int   iphl, l4hl, hlen;             /* Header lengths            */
+    int   iplen;                        /* IP packet length          */
+    int   csoff;                        /* Offset of transport cksum */
+    int   cplen, i, n, off;
+    U16   hwEthernetType = 0;
+    U32   sum;
+
+    /* Layer 2 frames keep their Ethernet header, Layer 3 pass through
+       packets have one which isn't written to the TUN device */
+    if (hdr[0] == HDR_ID_LAYER2 || hdr[0] == HDR_ID_L2_TSO)
+    {
+        tpcsum = ((OSA_HDR2*)hdr)->flags[1] & HDR2_FLAGS1_TPCKSUM;
+        l2len = sizeof( ETHFRM );
+    }
+    else
+    {
+        tpcsum = ((OSA_HDR3*)hdr)->ext_flags & HDR3_EXFLAG_TPCKSUM;
+        if (((OSA_HDR3*)hdr)->flags & HDR3_FLAGS_PASSTHRU)
+            skip = sizeof( ETHFRM );
+    }
+
+    /* Copy the protocol headers, which may span Storage Blocks */
+    for (i=0, cplen=0; i < iovcnt && cplen < (int)sizeof( pkt ); i++)
+    {
+        n = min( (int)iov[i].iov_len, (int)sizeof( pkt ) - cplen );
+        memcpy( pkt + cplen, iov[i].iov_base, n );
+        cplen += n;
+    }
+
+    /* Locate the IP header */
+    if (l2len || skip)
+    {
+        if (cplen < (int)sizeof( ETHFRM ) + 4)
+            return 1;
+        FETCH_HW( hwEthernetType, ((ETHFRM*)pkt)->hwEthernetType );
+        if (hwEthernetType == ETH_TYPE_VLANTAG)
+        {
+            FETCH_HW( hwEthernetType, pkt + sizeof( ETHFRM ) + 2 );
+            if (l2len) l2len += 4; else skip += 4;
+        }
+    }
+    ip = pkt + skip + l2len;
+    if (cplen < skip + l2len + (int)sizeof( IP4FRM ))
+        return 1;
+
+    switch (ip[0] >> 4)
+    {
+    case 4:
+        if (hwEthernetType && hwEthernetType != ETH_TYPE_IP)
+            return 1;
+        iphl  = (ip[0] & 0x0F) * 4;
+        proto = ((IP4FRM*)ip)->bProtocol;
+        break;
+    case 6:
+        if (hwEthernetType && hwEthernetType != ETH_TYPE_IPV6)
+            return 1;
+        iphl  = sizeof( IP6FRM );
+        proto = ((IP6FRM*)ip)->bNextHeader;
+        break;
+    default:
+        return 1;
+    }
+    if (iphl < (int)sizeof( IP4FRM ) || cplen < skip + l2len + iphl)
+        return 1;
+
+    /* Locate the TCP or UDP header (no segmentation for UDP) */
+    l4 = ip + iphl;
+    if (proto == 6)
+    {
+        if (cplen < skip + l2len + iphl + 20)
+            return 1;
+        l4hl  = (l4[12] >> 4) * 4;
+        csoff = 16;
+        if (l4hl < 20)
+            return 1;
+    }
+    else if (proto == 17 && !mss)
+    {
+        l4hl  = 8;
+        csoff = 6;
+    }
+    else
+        return 1;
+    hlen = skip + l2len + iphl + l4hl;
+    if (hlen > cplen || hlen > pktlen)
+        return 1;
+
+    /* Correct the IP length, which needn't have been set for TCP
+       segmentation offload, and IPv4 header checksum, which needn't
+       have been calculated, and start the pseudo header checksum */
+    iplen = pktlen - skip - l2len;
+    if ((ip[0] >> 4) == 4)
+    {
+        if (iplen > 0xFFFF)
+            return 1;
+        STORE_HW( ((IP4FRM*)ip)->hwTotalLength, (U16) iplen );
+        STORE_HW( ((IP4FRM*)ip)->hwChecksum, 0 );
+        STORE_HW( ((IP4FRM*)ip)->hwChecksum, (U16) ~csum_fold( csum_add( 0, ip, iphl )));
+        sum = csum_add( 0, ip + 12, 8 );
+    }
+    else
+    {
+        STORE_HW( ((IP6FRM*)ip)->bPayloadLength, (U16)(iplen - iphl) );
+        sum = csum_add( 0, ip + 8, 32 );
+    }
+
+    /* Have the host complete the transport checksum (seeded with the
+       pseudo header checksum) and, maybe, segment the packet */
+    memset( &vnet, 0, sizeof( vnet ));
+    vnet.hdr_len = hlen - skip;
+    if (tpcsum || mss)
+    {
+        sum += proto + (iplen - iphl);
+        STORE_HW( l4 + csoff, csum_fold( sum ));
+        vnet.flags       = VNET_HDR_F_NEEDS_CSUM;
+        vnet.csum_start  = l2len + iphl;
+        vnet.csum_offset = csoff;
+    }
+    if (mss)
+    {
+        vnet.gso_type = ((ip[0] >> 4) == 4) ? VNET_HDR_GSO_TCPV4
+                                            : VNET_HDR_GSO_TCPV6;
+        vnet.gso_size = mss;
+    }
+
+    /* Debugging */
+    if (grp->debugmask & DBGQETHPACKET)
+    {
+        // HHC00910 "%1d:%04X %s: Send%s packet of size %d bytes to device %s"
+        WRMSG( HHC00910, "D", LCSS_DEVNUM, dev->typname,
+            mss ? " TSO" : " offload", pktlen - skip, grp->ttifname );
+        net_data_trace( dev, pkt + skip, hlen - skip, FROM_GUEST, 'D', "Header", 0 );
+    }
+
+    /* The corrected headers, then the rest straight from storage */
+    oiov[0].iov_base = pkt + skip;
+    oiov[0].iov_len  = hlen - skip;
+    for (i=0, n=1, off=hlen; i < iovcnt; i++)
+    {
+        if (off >= (int)iov[i].iov_len)
+        {
+            off -= iov[i].iov_len;
+            continue;
+        }
+        oiov[n].iov_base = (BYTE*)iov[i].iov_base + off;
+        oiov[n].iov_len  = iov[i].iov_len - off;
+        off = 0;
+        n++;
+    }
+
+    return write_packet( dev, grp, NULL, pktlen - skip, oiov, n, &vnet );
+}
+
+
+/*-------------------------------------------------------------------*/
+/* Calculate the checksums the guest requested (flags in the OSA     */
+/* header) of a packet/frame which write_offload_packet couldn't     */
+/* pass on to the host: the IPv4 header checksum and the TCP or UDP  */
+/* checksum, following any IPv6 extension headers. The packet/frame  */
+/* must be in contiguous storage, pkt, which is updated in place.    */
+/* Anything which isn't understood is left as it is.                 */
+/*-------------------------------------------------------------------*/
+static void csum_packet( BYTE* hdr, BYTE* pkt, int pktlen )
+{
+    BYTE* ip;                           /* Ptr to IP header          */
+    BYTE* l4;                           /* Ptr to TCP/UDP header     */
+    BYTE  pkcsum, tpcsum;               /* Checksums requested       */
+    BYTE  proto;                        /* IP protocol               */
+    int   off = 0;                      /* Offset of IP header       */
+    int   iphl, l4len;                  /* IP header, L4 lengths     */
+    int   csoff;                        /* Offset of transport cksum */
+    U16   hwEthernetType = 0;
+    U16   cs;
+    U32   sum;
+
+    /* Locate the IP header */
+    if (hdr[0] == HDR_ID_LAYER2)
+    {
+        pkcsum = ((OSA_HDR2*)hdr)->flags[1] & HDR2_FLAGS1_PKCKSUM;
+        tpcsum = ((OSA_HDR2*)hdr)->flags[1] & HDR2_FLAGS1_TPCKSUM;
+        off = sizeof( ETHFRM );
+    }
+    else
+    {
+        pkcsum = ((OSA_HDR3*)hdr)->ext_flags & HDR3_EXFLAG_PKCKSUM;
+        tpcsum = ((OSA_HDR3*)hdr)->ext_flags & HDR3_EXFLAG_TPCKSUM;
+        if (((OSA_HDR3*)hdr)->flags & HDR3_FLAGS_PASSTHRU)
+            off = sizeof( ETHFRM );
+    }
+    if (off)
+    {
+        if (pktlen < off + 4)
+            return;
+        FETCH_HW( hwEthernetType, ((ETHFRM*)pkt)->hwEthernetType );
+        if (hwEthernetType == ETH_TYPE_VLANTAG)
+        {
+            FETCH_HW( hwEthernetType, pkt + off + 2 );
+            off += 4;
+        }
+    }
+    ip = pkt + off;
+    if (pktlen < off + (int)sizeof( IP4FRM ))
+        return;
+
+    switch (ip[0] >> 4)
+    {
+    case 4:
+        if (hwEthernetType && hwEthernetType != ETH_TYPE_IP)
+            return;
+        iphl = (ip[0] & 0x0F) * 4;
+        if (iphl < (int)sizeof( IP4FRM ) || pktlen < off + iphl)
+            return;
+        if (pkcsum)
+        {
+            STORE_HW( ((IP4FRM*)ip)->hwChecksum, 0 );
+            STORE_HW( ((IP4FRM*)ip)->hwChecksum, (U16) ~csum_fold( csum_add( 0, ip, iphl )));
+        }
+        /* (Fragments after the first have no transport header) */
+        if ((ip[6] & 0x1F) || ip[7])
+            return;
+        proto = ((IP4FRM*)ip)->bProtocol;
+        sum = csum_add( 0, ip + 12, 8 );
+        break;
+    case 6:
+        if (hwEthernetType && hwEthernetType != ETH_TYPE_IPV6)
+            return;
+        iphl  = sizeof( IP6FRM );
+        proto = ((IP6FRM*)ip)->bNextHeader;
+        /* Skip the Hop-by-Hop, Routing and Destination Options headers */
+        while (proto == 0 || proto == 43 || proto == 60)
+        {
+            if (pktlen < off + iphl + 8)
+                return;
+            proto = ip[iphl];
+            iphl += (ip[iphl+1] + 1) * 8;
+        }
+        sum = csum_add( 0, ip + 8, 32 );
+        break;
+    default:
+        return;
+    }
+
+    /* Calculate the TCP or UDP checksum */
+    if (!tpcsum)
+        return;
+    if (proto == 6)
+        csoff = 16;
+    else if (proto == 17)
+        csoff = 6;
+    else
+        return;
+    l4 = ip + iphl;
+    l4len = pktlen - off - iphl;
+    if (l4len < csoff + 2)
+        return;
+    sum += proto + l4len;
+    STORE_HW( l4 + csoff, 0 );
+    cs = (U16) ~csum_fold( csum_add( sum, l4, l4len ));
+    if (!cs && proto == 17)
+        cs = 0xFFFF;
+    STORE_HW( l4 + csoff, cs );
+}
+#endif /* defined( QETH_VNET_HDR ) */
+
+
+/*-------------------------------------------------------------------*/
+/* Determine whether the packet/frame just read can be passed to the */
+/* guest marked as having had its checksums verified: the host says  */
+/* it did so and the guest has started the inbound checksum assist.  */
+/*-------------------------------------------------------------------*/
+static BYTE rx_csum_verified( OSA_GRP *grp, int iPktVer )
+{
+#if defined( QETH_VNET_HDR )
+    if (grp->ttvnet && (grp->ttvhdr.flags & VNET_HDR_F_DATA_VALID))
+    {
+        if (iPktVer == 4)
+            return (grp->ipae4 & IPA_INBOUND_CHECKSUM) ? TRUE : FALSE;
+        if (iPktVer == 6)
+            return (grp->ipae6 & IPA_INBOUND_CHECKSUM_V6) ? TRUE : FALSE;
+    }
+#else
+    UNREFERENCED( grp );
+    UNREFERENCED( iPktVer );
+#endif
+    return FALSE;
+}
+
+
 /*-------------------------------------------------------------------*/
 /* Read one L2 frame from TAP device into queue buffer storage.      */
 /*-------------------------------------------------------------------*/
@@ -3102,13 +3793,20 @@ static QRC read_L2_packets( DEVBLK* dev, OSA_GRP *grp,
     int sb = 0;     /* Start with Storage Block zero */
     U16  hwEthernetType;
     char cPktType[8];
+    struct iovec iov[QMAXSTBK];
+    int iovcnt = 0;
 
     do {
+#if defined( QETH_SCATTER_GATHER )
+        /* Read directly into the Storage Blocks if possible */
+        iovcnt = build_input_iovec( dev, grp, sbal, sbalk, sb,
+                                    sizeof( OSA_HDR2 ), iov );
+#endif
         /* Find (another) frame for our MAC */
-        eth = (ETHFRM*)dev->buf;
+        eth = (ETHFRM*)(iovcnt ? iov[0].iov_base : dev->buf);
         for(;;)
         {
-            if ((qrc = read_packet( dev, grp )) < 0)
+            if ((qrc = read_packet( dev, grp, iov, iovcnt )) < 0)
                 return qrc; /*(probably EOF)*/
 
             /* Verify the frame is being sent to us */
@@ -3135,6 +3833,12 @@ static QRC read_L2_packets( DEVBLK* dev, OSA_GRP *grp,
             break;
         }
 
+        /* Pass on the host's verification of the transport checksum */
+        FETCH_HW( hwEthernetType, eth->hwEthernetType );
+        if (rx_csum_verified( grp, (hwEthernetType == ETH_TYPE_IP)   ? 4 :
+                                   (hwEthernetType == ETH_TYPE_IPV6) ? 6 : 0 ))
+            o2hdr.flags[1] |= HDR2_FLAGS1_TPCKSUM;
+
         /* Debugging */
         if (grp->debugmask & DBGQETHPACKET)
         {
@@ -3155,11 +3859,17 @@ static QRC read_L2_packets( DEVBLK* dev, OSA_GRP *grp,
         }
 
         /* Copy header and frame to buffer storage block(s) */
-        qrc = copy_packet_to_storage( dev, grp, sbal, sb, sbalk,
+#if defined( QETH_SCATTER_GATHER )
+        if (iovcnt)
+            qrc = finish_packet_in_storage( dev, grp, sbal, &sb, sbalk,
+                                            (BYTE*) &o2hdr, sizeof( o2hdr ));
+        else
+#endif
+        qrc = copy_packet_to_storage( dev, grp, sbal, &sb, sbalk,
                                       (BYTE*) &o2hdr, sizeof( o2hdr ),
                                       dev->buf, dev->buflen );
     }
-    while (qrc >= 0 && grp->rdpack && more_packets( dev ) && ++sb < QMAXSTBK);
+    while (qrc >= 0 && grp->rdpack && more_packets( dev, grp ) && ++sb < QMAXSTBK);
 
     /* Mark end of buffer */
     if (sb >= QMAXSTBK) sb--;
@@ -3183,11 +3893,21 @@ static QRC read_L3_packets( DEVBLK* dev, OSA_GRP *grp,
     int sb = 0;     /* Start with Storage Block zero */
     int   iPktVer;
     char  cPktType[8];
+    BYTE* pkt;
+    struct iovec iov[QMAXSTBK];
+    int iovcnt = 0;
 
     do
     {
+#if defined( QETH_SCATTER_GATHER )
+        /* Read directly into the Storage Blocks if possible */
+        iovcnt = build_input_iovec( dev, grp, sbal, sbalk, sb,
+                                    sizeof( OSA_HDR3 ), iov );
+#endif
+        pkt = iovcnt ? iov[0].iov_base : dev->buf;
+
         /* Read another packet into the device buffer */
-        if ((qrc = read_packet( dev, grp )) != 0)
+        if ((qrc = read_packet( dev, grp, iov, iovcnt )) != 0)
             return qrc; /*(probably EOF)*/
 
         /* Build the Layer 3 OSA header */
@@ -3199,10 +3919,10 @@ static QRC read_L3_packets( DEVBLK* dev, OSA_GRP *grp,
 
         /* Check the IP packet version. The first 4-bits of the     */
         /* first byte of the IP header contains the version number. */
-        iPktVer = ( ( dev->buf[0] & 0xF0 ) >> 4 );
+        iPktVer = ( ( pkt[0] & 0xF0 ) >> 4 );
         if (iPktVer == 4)
         {
-            ip4 = (IP4FRM*)dev->buf;
+            ip4 = (IP4FRM*)pkt;
             STRLCPY( cPktType, " IPv4" );
             memcpy( &o3hdr.dest_addr[12], &ip4->lDstIP, 4 );
             memcpy( o3hdr.in_cksum, ip4->hwChecksum, 2 );
@@ -3213,7 +3933,7 @@ static QRC read_L3_packets( DEVBLK* dev, OSA_GRP *grp,
         }
         else if (iPktVer == 6)
         {
-            ip6 = (IP6FRM*)dev->buf;
+            ip6 = (IP6FRM*)pkt;
             STRLCPY( cPktType, " IPv6" );
             memcpy( o3hdr.dest_addr, ip6->bDstAddr, 16 );
             o3hdr.flags = l3_cast_type_ipv6( o3hdr.dest_addr, grp );
@@ -3229,6 +3949,10 @@ static QRC read_L3_packets( DEVBLK* dev, OSA_GRP *grp,
             STRLCPY( cPktType, "" );
         }
 
+        /* Pass on the host's verification of the checksums */
+        if (rx_csum_verified( grp, iPktVer ))
+            o3hdr.ext_flags |= HDR3_EXFLAG_TPCKSUM | HDR3_EXFLAG_PKCKSUM;
+
         /* Debugging */
         if (grp->debugmask & DBGQETHPACKET)
         {
@@ -3240,11 +3964,17 @@ static QRC read_L3_packets( DEVBLK* dev, OSA_GRP *grp,
         }
 
         /* Copy header and packet to buffer storage block(s) */
-        qrc = copy_packet_to_storage( dev, grp, sbal, sb, sbalk,
+#if defined( QETH_SCATTER_GATHER )
+        if (iovcnt)
+            qrc = finish_packet_in_storage( dev, grp, sbal, &sb, sbalk,
+                                            (BYTE*) &o3hdr, sizeof( o3hdr ));
+        else
+#endif
+        qrc = copy_packet_to_storage( dev, grp, sbal, &sb, sbalk,
                                       (BYTE*) &o3hdr, sizeof( o3hdr ),
                                       dev->buf, dev->buflen );
     }
-    while (qrc >= 0 && grp->rdpack && more_packets( dev ) && ++sb < QMAXSTBK);
+    while (qrc >= 0 && grp->rdpack && more_packets( dev, grp ) && ++sb < QMAXSTBK);
 
     /* Mark end of buffer */
     if (sb >= QMAXSTBK) sb--;
@@ -3333,7 +4063,7 @@ static QRC read_l3r_buffers( DEVBLK* dev, OSA_GRP *grp,
             }
 
             /* Copy header and packet to buffer storage block(s) */
-            qrc = copy_packet_to_storage( dev, grp, sbal, sb, sbalk,
+            qrc = copy_packet_to_storage( dev, grp, sbal, &sb, sbalk,
                                           (BYTE*)&o3hdr, sizeof(o3hdr),
                                           bufdata, datalen );
         }
@@ -3382,6 +4112,10 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
     int iPktVer;
     int iTraceLen;
     char cPktType[8];
+    struct iovec iov[QMAXSTBK];         /* Packet/frame fragments    */
+    int iovcnt = 0;                     /* Number of fragments       */
+    BYTE csum;                          /* Checksum offload flags    */
+    U16 mss;                            /* TCP segmentation offload  */
 
 
     sb = 0;                             /* Start w/Storage Block 0   */
@@ -3390,6 +4124,8 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
     {
         /* Save starting Storage Block number */
         ssb = sb;
+        csum = 0;
+        mss = 0;
 
         /* Retrieve the (next) Storage Block and check its key */
         FETCH_DW( sba,   sbal->sbale[sb].addr   );
@@ -3441,6 +4177,7 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
             FETCH_HW( length, o2hdr->pktlen );
             pktlen = length;
          /* eth = (ETHFRM*)pkt; */
+            csum = o2hdr->flags[1] & (HDR2_FLAGS1_TPCKSUM | HDR2_FLAGS1_PKCKSUM);
             break;
         }
         case HDR_ID_LAYER3:
@@ -3450,9 +4187,32 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
             pkt = hdr + hdrlen;
             FETCH_HW( length, o3hdr->length );
             pktlen = length;
+            csum = o3hdr->ext_flags & (HDR3_EXFLAG_TPCKSUM | HDR3_EXFLAG_PKCKSUM);
             break;
         }
         case HDR_ID_TSO:
+        case HDR_ID_L2_TSO:
+        {
+            /* (OSA_HDR2 and OSA_HDR3 are both 32 bytes long) */
+            OSA_HDR_TSO* tso = (OSA_HDR_TSO*)(hdr + sizeof(OSA_HDR3));
+            U32 payload;
+            /* Only offered when it can be passed on to the host */
+            if (!grp->ttvoffl)
+                return SBALE_ERROR( QRC_EPKTYP, dev,sbal,sbalk,sb);
+            FETCH_HW( length, tso->hdr_tot_len );
+            hdrlen = sizeof(OSA_HDR3) + length;
+            if (length < sizeof(OSA_HDR_TSO) || sblen < (U32)hdrlen)
+                return SBALE_ERROR( QRC_EPKTYP, dev,sbal,sbalk,sb);
+            pkt = hdr + hdrlen;
+            /* The packet is its protocol headers and the TCP payload */
+            FETCH_HW( mss, tso->mss );
+            FETCH_FW( payload, tso->payload_len );
+            FETCH_HW( length, tso->dg_hdr_len );
+            if (!mss || payload > (U32)dev->bufsize)
+                return SBALE_ERROR( QRC_EPKSIZ, dev,sbal,sbalk,sb);
+            pktlen = length + payload;
+            break;
+        }
         case HDR_ID_OSN:
         default:
             return SBALE_ERROR( QRC_EPKTYP, dev,sbal,sbalk,sb);
@@ -3468,9 +4228,17 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
         dev->bufres = pktlen;
         dev->buflen = 0;
 
+#if defined( QETH_SCATTER_GATHER )
+        /* Or rather, locate its fragments in the Storage Blocks */
+        if ((qrc = gather_storage_fragments( dev, grp, sbal, sbalk,
+                                             &sb, pkt, sblen,
+                                             iov, &iovcnt )) < 0)
+            return qrc;
+#else
         if ((qrc = copy_storage_fragments( dev, grp, sbal, sbalk,
                                            &sb, pkt, sblen )) < 0)
             return qrc;
+#endif
 
         /* Save ending flag */
         flag0 = sbal->sbale[sb].flags[0];
@@ -3480,10 +4248,54 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
             DBGTRC( dev, "Output SBALE(%d-%d): Len: %04X (%d)",
                 ssb, sb, dev->buflen, dev->buflen );
 
+#if defined( QETH_VNET_HDR )
+        /* Leave checksumming and segmentation to the host if asked */
+        if (mss || (csum && grp->ttvoffl && ((grp->ipae4 | grp->ipae6)
+                        & (IPA_OUTBOUND_CHECKSUM | IPA_OUTBOUND_CHECKSUM_V6))))
+        {
+            if ((qrc = write_offload_packet( dev, grp, hdr, mss, dev->buflen,
+                                             iov, iovcnt )) != 1)
+                continue;
+            if (mss)
+                return SBALE_ERROR( QRC_EPKTYP, dev,sbal,sbalk,sb);
+
+            /* Otherwise calculate the checksums here, in a copy */
+            {
+                int i, off;
+                for (i=0, off=0; i < iovcnt; off += iov[i++].iov_len)
+                    memcpy( dev->buf + off, iov[i].iov_base, iov[i].iov_len );
+                iovcnt = 0;
+            }
+            csum_packet( hdr, dev->buf, dev->buflen );
+        }
+#else
+        UNREFERENCED( csum );
+#endif
+
         /* Initialize packet pointer and packet length */
         pkt    = dev->buf;
         pktlen = dev->buflen;
 
+#if defined( QETH_SCATTER_GATHER )
+        /* A packet/frame contained in a single Storage Block is used
+           where it is. One split across several Storage Blocks is
+           gathered straight from them too unless it needs to be looked
+           at (Layer 3 and packet tracing), in which case it's copied. */
+        if (iovcnt == 1)
+        {
+            pkt = iov[0].iov_base;
+            iovcnt = 0;
+        }
+        else if (grp->l3 || hdr_id == HDR_ID_LAYER3
+            || (grp->debugmask & DBGQETHPACKET))
+        {
+            int i, off;
+            for (i=0, off=0; i < iovcnt; off += iov[i++].iov_len)
+                memcpy( dev->buf + off, iov[i].iov_base, iov[i].iov_len );
+            iovcnt = 0;
+        }
+#endif
+
         /* I know the following looks pretty weird but it seems to be         */
         /* necessary when using IPv6 over layer 3. IPv6 uses ICMPv6 Neighbor  */
         /* Solicitation (NS) & Neighbor Advertisment (NA) to determine the    */
@@ -3520,6 +4332,7 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
                     {
                         /* Can't write L2 Ethernet frame to L3 tun device! */
                         dev->qdio.dropcnt++;
+                        grp->ttq[ grp->tttxq ].dropcnt++;
                         if (grp->debugmask & DBGQETHDROP)
                         {
                             // "%1d:%04X %s: %s: Output dropped: %s"
@@ -3586,7 +4399,7 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
         }
 
         /* Write the packet */
-        qrc = write_packet( dev, grp, pkt, pktlen );
+        qrc = write_packet( dev, grp, pkt, pktlen, iov, iovcnt, NULL );
 
 #if defined( ENABLE_IPV6 )
 
@@ -3625,15 +4438,22 @@ static QRC write_buffered_packets( DEVBLK* dev, OSA_GRP *grp,
 /* When we reach the end of the buffer queue we will advance to the  */
 /* next available queue. When a queue is newly enabled we start at   */
 /* the beginning of the queue (this is handled in signal adapter).   */
+/* When multiple TUN/TAP queues are in use, packets arriving on TAP  */
+/* queue n go to Input Queue n whenever the guest has enabled it.    */
 /*-------------------------------------------------------------------*/
 static void process_input_queues( DEVBLK *dev )
 {
 OSA_GRP *grp = (OSA_GRP*)dev->group->grp_data;
 int sqn = dev->qdio.i_qpos;             /* Starting queue number     */
 int mq = dev->qdio.i_qcnt;              /* Maximum number of queues  */
-int qn = sqn;                           /* Working queue number      */
+int qn;                                 /* Working queue number      */
 int did_read = 0;                       /* Indicates some data read  */
 
+    if (grp->ttmq > 1 && grp->ttrxq < mq
+        && (dev->qdio.i_qmask & (0x80000000 >> grp->ttrxq)))
+        sqn = grp->ttrxq;
+    qn = sqn;
+
     PTT_QETH_TRACE( "prinq entr", 0,0,0 );
     do
     {
@@ -3740,13 +4560,14 @@ int did_read = 0;                       /* Indicates some data read  */
        and again, because its 'select' function still indicates
        that the socket still has unread data waiting to be read.
     */
-    if (!did_read && more_packets( dev ))
+    if (!did_read && more_packets( dev, grp ))
     {
         char buff[4096];
-        int packet_len = TUNTAP_Read( grp->ttfd, buff, sizeof( buff ));
+        int packet_len = TUNTAP_Read( grp->ttq[ grp->ttrxq ].fd, buff, sizeof( buff ));
         if (packet_len)
         {
             dev->qdio.dropcnt++;
+            grp->ttq[ grp->ttrxq ].dropcnt++;
             PTT_QETH_TRACE( "*prcinq drop", dev->qdio.i_qmask, 0, 0 );
             if (grp->debugmask & DBGQETHDROP)
             {
@@ -3814,6 +4635,9 @@ int found_buff = 0;                     /* Found primed O/P buffer   */
 
                         sk = dev->qdio.o_sbalk[qn];
 
+                        /* Output Queue n goes to TUN/TAP queue n */
+                        grp->tttxq = qn % grp->ttmq;
+
                         if ((qrc = write_buffered_packets( dev, grp, sbal, sk )) >= 0)
                             slsb->slsbe[bn] = SLSBE_OUTPUT_COMPLETED;
                     }
@@ -4178,6 +5002,9 @@ U32 mask4;
 
             grp->ttdev = strdup( DEF_NETDEV );
             grp->ttfd  = -1;
+            grp->ttmq  =  1;
+            for (i=0; i < OSA_MAXTTQ; i++)
+                grp->ttq[i].fd = -1;
         }
         else
             /* This code is executed for the second and subsequent devices in the group. */
@@ -4284,6 +5111,14 @@ U32 mask4;
             grp->ttchpid = strdup(argv[++i]);
             continue;
         }
+#if defined( __linux__ )
+        else if(!strcasecmp("mq",argv[i]) && (i+1) < argc)
+        {
+            free( grp->ttmqs );
+            grp->ttmqs = strdup(argv[++i]);
+            continue;
+        }
+#endif
         else if (!strcasecmp("debug",argv[i]))
         {
             grp->debugmask = DBGQETHPACKET+DBGQETHDATA+DBGQETHUPDOWN;
@@ -4557,6 +5392,24 @@ U32 mask4;
             }
         }
 
+        /* Check the number of TUNTAP queues */
+        if (grp->ttmqs)
+        {
+            int mq;
+            if (sscanf( grp->ttmqs, "%d%c", &mq, &c ) != 1
+                || mq < 1 || mq > OSA_MAXTTQ)
+            {
+                // HHC00916 "%1d:%04X %s: option %s value %s invalid"
+                WRMSG( HHC00916, "E", LCSS_DEVNUM, dev->typname,
+                                      "mq", grp->ttmqs );
+                retcode = -1;
+                free( grp->ttmqs );
+                grp->ttmqs = NULL;
+            }
+            else
+                grp->ttmq = mq;
+        }
+
         /* Initialize each device's Full Link Address array */
         cua = dev->group->memdev[0];
         destlink = 0x000D; // ZZ FIXME: where should this come from?
@@ -4599,7 +5452,7 @@ OSA_GRP *grp;
 
     if (dev->group->acount == dev->group->members)
     {
-        char ttifname[IFNAMSIZ+2];
+        char ttifname[IFNAMSIZ+10];
         char dropped[17] = {0}; // " dr[%u]"
 
         STRLCPY( ttifname, grp->ttifname );
@@ -4609,6 +5462,13 @@ OSA_GRP *grp;
         if (grp->debugmask & DBGQETHDROP)
             MSGBUF( dropped, " dr[%u]", dev->qdio.dropcnt );
 
+        if (grp->ttmq > 1)
+        {
+            char mq[16];
+            MSGBUF( mq, "mq[%d] ", grp->ttmq );
+            STRLCAT( ttifname, mq );
+        }
+
         MSGBUF( qdiostat, "%stx[%u] rx[%u]%s "
             , ttifname
             , dev->qdio.txcnt
@@ -4663,6 +5523,13 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
         PTT_QETH_TRACE( "b4 clos ttfd", 0,0,0 );
         grp->ttfd = -1;
         dev->fd = -1;
+        grp->ttq[0].fd = -1;
+        for (i=1; i < grp->ttmq; i++)
+        {
+            if (grp->ttq[i].fd > 0)
+                TUNTAP_Close(grp->ttq[i].fd, grp->internal);
+            grp->ttq[i].fd = -1;
+        }
         if(ttfd > 0)
             TUNTAP_Close(ttfd, grp->internal);
         PTT_QETH_TRACE( "af clos ttfd", 0,0,0 );
@@ -4685,6 +5552,7 @@ OSA_GRP *grp = (OSA_GRP*)(group ? group->grp_data : NULL);
         free( grp->ttpfxlen6 );
         free( grp->ttmtu     );
         free( grp->ttchpid   );
+        free( grp->ttmqs     );
 
         PTT_QETH_TRACE( "af clos othr", 0,0,0 );
 
@@ -5375,6 +6243,7 @@ U32 num;                                /* Number of bytes to move   */
     struct timeval tv;                      /* select polling        */
     int fd;                                 /* select fd             */
     int rc=0;                               /* select rc (0=timeout) */
+    int q;                                  /* TUNTAP queue number   */
     BYTE sig;                               /* thread pipe signal    */
 
         /*
@@ -5431,10 +6300,14 @@ U32 num;                                /* Number of bytes to move   */
                 USLEEP( OSA_TIMEOUTUS );
                 continue;
             }
-#else // Linux: always do 'qeth_select' on both file descriptors
+#else // Linux: always do 'qeth_select' on all file descriptors
             FD_SET( grp->ppfd[0], &readset );
-            FD_SET( grp->ttfd,    &readset );
-            fd = max( grp->ppfd[0], grp->ttfd );
+            fd = grp->ppfd[0];
+            for (q=0; q < grp->ttmq; q++)
+            {
+                FD_SET( grp->ttq[q].fd, &readset );
+                fd = max( fd, grp->ttq[q].fd );
+            }
 #endif // (Windows or Linux)
 
             /* Wait (but only very briefly) for more work to arrive */
@@ -5476,9 +6349,14 @@ U32 num;                                /* Number of bytes to move   */
                 continue;
             }
 
-            /* Check if any new packets have arrived */
-            if ((rc && FD_ISSET( grp->ttfd, &readset )) || grp->l3r.firstbhr)
+            /* Check if any new packets have arrived on each queue */
+            for (q=0; q < grp->ttmq; q++)
             {
+                if (!((rc && FD_ISSET( grp->ttq[q].fd, &readset ))
+                      || (!q && grp->l3r.firstbhr)))
+                    continue;
+                grp->ttrxq = q;
+
                 /* Process packets if Queue is available */
                 if (likely( dev->qdio.i_qmask ))
                 {
@@ -5494,9 +6372,10 @@ U32 num;                                /* Number of bytes to move   */
                 }
                 else /* (no I/P queues? VERY unlikely!) */
                 {
-                    if (QRC_SUCCESS == read_packet( dev, grp ))
+                    if (QRC_SUCCESS == read_packet( dev, grp, NULL, 0 ))
                     {
                         dev->qdio.dropcnt++;
+                        grp->ttq[ grp->ttrxq ].dropcnt++;
                         PTT_QETH_TRACE( "*actq drop", dev->qdio.i_qmask, 0, 0 );
                         if (grp->debugmask & DBGQETHDROP)
                         {
@@ -31,6 +31,7 @@
 #define OSA_MAXIPV4            32     /* Max supported IPv4 addresses*/
 #define OSA_MAXIPV6            32     /* Max supported IPv6 addresses*/
 #define OSA_MAXMAC             32     /* Max supported MAC addresses */
+#define OSA_MAXTTQ              8     /* Max TUNTAP queues (mq)      */
 #define OSA_TIMEOUTUS       50000     /* Read select timeout (usecs) */
 
 #define QTOKEN1        0xD8C5E3F1     /* QETH token 1 (QET1 ebcdic)  */
@@ -159,6 +160,37 @@ typedef struct _OSA_IPV6 {
 } OSA_IPV6;
 
 
+/*-------------------------------------------------------------------*/
+/* OSA TUNTAP queue structure                                        */
+/*-------------------------------------------------------------------*/
+typedef struct _OSA_TTQ {
+        int     fd;             /* File Descriptor of this queue     */
+        unsigned rxcnt;         /* Packets read from this queue      */
+        unsigned txcnt;         /* Packets written to this queue     */
+        unsigned dropcnt;       /* Packets dropped on this queue     */
+        unsigned rxlast;        /* rxcnt at last statistics display  */
+        unsigned txlast;        /* txcnt at last statistics display  */
+} OSA_TTQ;
+
+
+/*-------------------------------------------------------------------*/
+/* TUNTAP virtio-net header (IFF_VNET_HDR), in host byte order       */
+/*-------------------------------------------------------------------*/
+typedef struct _VNET_HDR {
+        BYTE    flags;          /* Flags                             */
+#define VNET_HDR_F_NEEDS_CSUM   0x01  /* Checksum to be completed    */
+#define VNET_HDR_F_DATA_VALID   0x02  /* Checksum already verified   */
+        BYTE    gso_type;       /* Segmentation offload type         */
+#define VNET_HDR_GSO_NONE       0x00
+#define VNET_HDR_GSO_TCPV4      0x01
+#define VNET_HDR_GSO_TCPV6      0x04
+        U16     hdr_len;        /* Length of the protocol headers    */
+        U16     gso_size;       /* Segment size (TCP MSS)            */
+        U16     csum_start;     /* Offset at which to checksum from  */
+        U16     csum_offset;    /* Offset of checksum from there     */
+} VNET_HDR;
+
+
 /*-------------------------------------------------------------------*/
 /* OSA Group Structure                                               */
 /*-------------------------------------------------------------------*/
@@ -186,6 +218,7 @@ typedef struct _OSA_GRP {
     char *ttpfxlen6;            /* IPv6 Prefix length of interface   */
 
     char *ttchpid;              /* chpid                             */
+    char *ttmqs;                /* Number of TUNTAP queues (mq)      */
 
     BYTE  confipaddr4[4];       /* IPv4 address of the interface in  */
                                 /* network byte order. This variable */
@@ -243,6 +276,15 @@ typedef struct _OSA_GRP {
     int   oqPCI;                /* Output Queue PCI was requested    */
 
     int   ttfd;                 /* File Descriptor TUNTAP Device     */
+    int   ttmq;                 /* Number of TUNTAP queues in use    */
+    int   ttrxq;                /* TUNTAP queue currently read from  */
+    int   tttxq;                /* TUNTAP queue currently written to */
+    OSA_TTQ ttq[OSA_MAXTTQ];    /* TUNTAP queues (ttq[0].fd = ttfd)  */
+    U64   ttqtod;               /* Time of last statistics display   */
+    int   ttvnet;               /* TUNTAP uses virtio-net headers    */
+    int   ttvoffl;              /* Host takes checksum/TSO offloads  */
+    VNET_HDR ttvhdr;            /* virtio-net header of last read    */
+                                /* (usecs), see qeth_cmd 'STATS'     */
     int   ppfd[2];              /* Thread signalling socket pipe     */
                                 /* [0] = read end, [1] = write end   */
 
@@ -285,6 +327,7 @@ typedef struct _OSA_GRP {
 #define HDR_ID_LAYER2    0x02   /* Ethernet Layer 2 Frame            */
 #define HDR_ID_TSO       0x03   /* Layer 3 TCP Segmentation Offload  */
 #define HDR_ID_OSN       0x04   /* Channel Data Link Control (CDLC)  */
+#define HDR_ID_L2_TSO    0x06   /* Layer 2 TCP Segmentation Offload  */
 
 
 /*-------------------------------------------------------------------*/
@@ -315,6 +358,9 @@ struct OSA_HDR2 {
 #define HDR2_FLAGS0_BROADCAST   0x05
 #define HDR2_FLAGS0_MULTICAST   0x04
 #define HDR2_FLAGS0_NOCAST      0x00
+#define HDR2_FLAGS1_UDP         0x40  /* 1=UDP packet; 0=TCP           */
+#define HDR2_FLAGS1_TPCKSUM     0x20  /* Trnspt cksum; 1=chked/request */
+#define HDR2_FLAGS1_PKCKSUM     0x10  /* PktHdr cksum; 1=chked/request */
 #define HDR2_FLAGS2_MULTICAST   0x01
 #define HDR2_FLAGS2_BROADCAST   0x02
 #define HDR2_FLAGS2_UNICAST     0x03
@@ -356,8 +402,8 @@ struct OSA_HDR3 {
 
 #define HDR3_EXFLAG_UNUSED    0x80  /* Unused; must be zero          */
 #define HDR3_EXFLAG_UDP       0x40  /* 1=UDP packet; 0=TCP           */
-#define HDR3_EXFLAG_TPCKSUM   0x20  /* Trnspt cksum; 1=chked, 0=not  */
-#define HDR3_EXFLAG_PKCKSUM   0x10  /* PktHdr cksum; 1=chked, 0=not  */
+#define HDR3_EXFLAG_TPCKSUM   0x20  /* Trnspt cksum; 1=chked/request */
+#define HDR3_EXFLAG_PKCKSUM   0x10  /* PktHdr cksum; 1=chked/request */
 #define HDR3_EXFLAG_SRCMAC    0x08  /* External source MAC present   */
 #define HDR3_EXFLAG_VLANTAG   0x04  /* VLAN Tag in dest_addr 12-13   */
 #define HDR3_EXFLAG_TOKENID   0x02  /* Token Id present              */
@@ -372,6 +418,26 @@ struct OSA_HDR3 {
 typedef struct OSA_HDR3 OSA_HDR3;
 
 
+/*-------------------------------------------------------------------*/
+/* OSA TCP Segmentation Offload extension header. Follows the        */
+/* OSA_HDR3 (HDR_ID_TSO) or OSA_HDR2 (HDR_ID_L2_TSO) header.         */
+/*-------------------------------------------------------------------*/
+struct OSA_HDR_TSO {
+/*000*/ HWORD   hdr_tot_len;    /* Length of this extension header   */
+/*002*/ BYTE    imb_hdr_no;     /* (1)                               */
+/*003*/ BYTE    resv003;        /*                                   */
+/*004*/ BYTE    hdr_type;       /* (1)                               */
+/*005*/ BYTE    hdr_version;    /* (1)                               */
+/*006*/ HWORD   hdr_len;        /* (28)                              */
+/*008*/ FWORD   payload_len;    /* Length of the TCP payload         */
+/*00C*/ HWORD   mss;            /* TCP maximum segment size          */
+/*00E*/ HWORD   dg_hdr_len;     /* Length of the protocol headers    */
+/*010*/ BYTE    resv010[16];    /*                                   */
+/*020*/ } ATTRIBUTE_PACKED;     /* Total length: 32 bytes            */
+
+typedef struct OSA_HDR_TSO OSA_HDR_TSO;
+
+
 #if defined(_MSVC_)
  #pragma pack(pop)
 #endif
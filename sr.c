@@ -127,18 +127,8 @@ BYTE     psw[16];
 
     TRACE("SR: Waiting for I/O Queue to clear...\n");
 
-    OBTAIN_IOQLOCK();
-    {
-        while (sysblk.ioq)
-        {
-            RELEASE_IOQLOCK();
-            {
-                USLEEP( 1000 );
-            }
-            OBTAIN_IOQLOCK();
-        }
-    }
-    RELEASE_IOQLOCK();
+    while (queued_io_requests())
+        USLEEP( 1000 );
 
     /* Wait for active I/Os to complete */
     TRACE("SR: Waiting for Active I/Os to Complete...\n");
@@ -0,0 +1,233 @@
+ TITLE '   MVC-CLC-XC-01-performance (Test MVC, CLC and XC instructions)'
+***********************************************************************
+*
+*        MVC, CLC and XC instruction performance tests
+*
+*        NOTE: This source is provided for information only. The
+*              .tst file loads the assembled program directly via
+*              'r' commands.
+*
+*                         ********************
+*                         **   IMPORTANT!   **
+*                         ********************
+*
+*              This test uses the Hercules Diagnose X'008' interface
+*              to display messages and thus your .tst runtest script
+*              MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  This program ONLY tests the performance of the MVC, CLC and XC
+*  instructions on 256 byte operands.
+*
+*     Tests:
+*
+*           1. MVC  0(256,R8),0(R9) - no crossed pages
+*           2. MVC  0(256,R8),0(R9) - both operands cross
+*           3. CLC  0(256,R8),0(R9) - no crossed pages
+*           4. CLC  0(256,R8),0(R9) - both operands cross
+*           5. XC   0(256,R8),0(R9) - no crossed pages
+*           6. XC   0(256,R8),0(R9) - both operands cross
+*
+*  Timing is only performed when TIMEFLAG is set to X'FF'. Otherwise
+*  each test is run 1,000 times as a functional check only.
+*
+*  The condition code of the last CLC and XC of tests 3 to 6 is saved
+*  at CCSAVE. The .tst compares these and both complete operand-1
+*  areas, including the part past the page boundary.
+*
+***********************************************************************
+                                                                EJECT
+PERFTST  START 0
+         USING PERFTST,R0            Low core addressability
+*
+         ORG   PERFTST+X'1A0'        z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+*
+         ORG   PERFTST+X'1D0'        z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEADDEAD')
+*
+         ORG   PERFTST+X'200'        Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*               The actual "MVC-CLC-XC-01-performance" program...
+***********************************************************************
+*
+BEGIN    CLI   TIMEFLAG,X'FF'        Timing requested?
+         JNE   NOTIME                No, functional check only
+         MVC   COUNT,BIGCNT          Yes, use the big iteration count
+NOTIME   DS    0H
+*
+*        Initialize both second operands to X'00'...X'FF'
+*
+         LGFI  R9,OPND2A
+         LGHI  R1,255
+FILL2A   STC   R1,0(R1,R9)
+         BCT   R1,FILL2A
+*
+         LGFI  R9,OPND2C
+         LGHI  R1,255
+FILL2C   STC   R1,0(R1,R9)
+         BCT   R1,FILL2C
+                                                                EJECT
+*
+*        MVC: within page, then both operands crossing
+*
+         LGFI  R8,OPND1A
+         LGFI  R9,OPND2A
+         LA    R10,TEXT1
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP1    MVC   0(256,R8),0(R9)
+         BCT   R7,LOOP1
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+         LGFI  R8,OPND1C
+         LGFI  R9,OPND2C
+         LA    R10,TEXT2
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP2    MVC   0(256,R8),0(R9)
+         BCT   R7,LOOP2
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        CLC: within page, then both operands crossing
+*
+         LGFI  R8,OPND1A
+         LGFI  R9,OPND2A
+         LA    R10,TEXT3
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP3    CLC   0(256,R8),0(R9)
+         JNE   FAIL
+         BCT   R7,LOOP3
+         IPM   R2                    Save the condition code
+         SRL   R2,28
+         STC   R2,CCSAVE+0
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+         LGFI  R8,OPND1C
+         LGFI  R9,OPND2C
+         LA    R10,TEXT4
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP4    CLC   0(256,R8),0(R9)
+         JNE   FAIL
+         BCT   R7,LOOP4
+         IPM   R2                    Save the condition code
+         SRL   R2,28
+         STC   R2,CCSAVE+1
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        XC: within page, then both operands crossing.
+*        An even iteration count leaves operand-1 unchanged.
+*
+         LGFI  R8,OPND1A
+         LGFI  R9,OPND2A
+         LA    R10,TEXT5
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP5    XC    0(256,R8),0(R9)
+         BCT   R7,LOOP5
+         IPM   R2                    Save the condition code
+         SRL   R2,28
+         STC   R2,CCSAVE+2
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+         CLC   0(256,R8),0(R9)
+         JNE   FAIL
+*
+         LGFI  R8,OPND1C
+         LGFI  R9,OPND2C
+         LA    R10,TEXT6
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP6    XC    0(256,R8),0(R9)
+         BCT   R7,LOOP6
+         IPM   R2                    Save the condition code
+         SRL   R2,28
+         STC   R2,CCSAVE+3
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+         CLC   0(256,R8),0(R9)
+         JNE   FAIL
+*
+         LPSWE GOODPSW               Load SUCCESS PSW
+FAIL     LPSWE FAILPSW               Load FAILURE PSW
+                                                                EJECT
+***********************************************************************
+*        REPORT: issue timing message for test text at R10
+***********************************************************************
+*
+REPORT   CLI   TIMEFLAG,X'FF'        Timing requested?
+         BNER  R14                   No, just return
+         LG    R1,ENDCLOCK
+         SG    R1,BEGCLOCK
+         SRLG  R1,R1,12              Convert to microseconds
+         CVD   R1,DWORK
+         UNPK  MSGNUM,DWORK
+         OI    MSGNUM+L'MSGNUM-1,X'F0'
+         MVC   MSGTXT,0(R10)
+         LA    R1,MSGCMD
+         LA    R2,MSGLEN
+         DC    X'83',X'12',X'0008'   DIAGNOSE R1,R2,X'008'
+         BR    R14
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+*
+         ORG   PERFTST+X'800'
+TIMEFLAG DC    X'00'                 X'FF' = run timing tests
+         ORG   PERFTST+X'808'
+COUNT    DC    F'1000'               Iteration count
+BIGCNT   DC    F'1000000'            Iteration count when timing
+BEGCLOCK DC    D'0'
+ENDCLOCK DC    D'0'
+         ORG   PERFTST+X'828'
+DWORK    DC    D'0'
+*
+         ORG   PERFTST+X'840'
+MSGCMD   DC    C'MSGNOH * '
+MSGTXT   DC    CL40' '
+MSGNUM   DC    CL10' '
+         DC    C' usecs'
+MSGLEN   EQU   *-MSGCMD
+*
+         ORG   PERFTST+X'900'
+TEXT1    DC    CL40'1000000 x MVC  256 bytes, within page : '
+TEXT2    DC    CL40'1000000 x MVC  256 bytes, both cross  : '
+TEXT3    DC    CL40'1000000 x CLC  256 bytes, within page : '
+TEXT4    DC    CL40'1000000 x CLC  256 bytes, both cross  : '
+TEXT5    DC    CL40'1000000 x XC   256 bytes, within page : '
+TEXT6    DC    CL40'1000000 x XC   256 bytes, both cross  : '
+*
+         ORG   PERFTST+X'A00'
+CCSAVE   DC    4X'FF'                Condition codes of tests 3 to 6
+*
+         ORG   PERFTST+X'E00'
+GOODPSW  DC    X'0002000180000000',AD(0)
+FAILPSW  DC    X'0002000180000000',AD(X'BAD1')
+*
+OPND1A   EQU   X'10000'              Operand-1, within page
+OPND2A   EQU   X'11000'              Operand-2, within page
+OPND1C   EQU   X'12F80'              Operand-1, crosses at X'13000'
+OPND2C   EQU   X'14FC0'              Operand-2, crosses at X'15000'
+                                                                EJECT
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R7       EQU   7
+R8       EQU   8
+R9       EQU   9
+R10      EQU   10
+R14      EQU   14
+R15      EQU   15
+*
+         END
@@ -0,0 +1,177 @@
+*Testcase MVC-CLC-XC-01-performance (Test MVC, CLC and XC instructions)
+
+# ------------------------------------------------------------------------------
+#  This ONLY tests the performance of the MVC, CLC and XC instructions
+#  on 256 byte operands, both within a page and with both operands
+#  crossing a page boundary.
+#
+#  The default is to NOT run performance tests. To enable this performance
+#  test, uncomment the "#r 800=ff   # (enable timing tests)" line below.
+#  Without it each test is only run 1,000 times as a functional check.
+#
+#     Tests:
+#
+#           1. MVC  0(256,R8),0(R9) - no crossed pages
+#           2. MVC  0(256,R8),0(R9) - both operands cross
+#           3. CLC  0(256,R8),0(R9) - no crossed pages
+#           4. CLC  0(256,R8),0(R9) - both operands cross
+#           5. XC   0(256,R8),0(R9) - no crossed pages
+#           6. XC   0(256,R8),0(R9) - both operands cross
+#
+#     Output:
+#
+#         For each test, a console line will the generated with timing
+#         results, as follows:
+#
+#              1000000 x MVC  256 bytes, within page : 0000060030 usecs
+#              1000000 x MVC  256 bytes, both cross  : 0000117908 usecs
+#              ...
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+r           1A0=00000001800000000000000000000200
+r           1D0=000200018000000000000000DEADDEAD
+r           200=95FF0800A7740005D2030808080CC091
+r           210=00011000A71900FF4211900046100218
+r           220=C09100014FC0A71900FF421190004610
+r           230=022AC08100010000C0910001100041A0
+r           240=090058700808B2050810D2FF80009000
+r           250=4670024AB20508184DE00382C0810001
+r           260=2F80C09100014FC041A0092858700808
+r           270=B2050810D2FF8000900046700274B205
+r           280=08184DE00382C08100010000C0910001
+r           290=100041A0095058700808B2050810D5FF
+r           2A0=80009000A774006D4670029EB2220020
+r           2B0=8820001C42200A00B20508184DE00382
+r           2C0=C08100012F80C09100014FC041A00978
+r           2D0=58700808B2050810D5FF80009000A774
+r           2E0=0050467002D8B22200208820001C4220
+r           2F0=0A01B20508184DE00382C08100010000
+r           300=C0910001100041A009A058700808B205
+r           310=0810D7FF8000900046700312B2220020
+r           320=8820001C42200A02B20508184DE00382
+r           330=D5FF80009000A7740024C08100012F80
+r           340=C09100014FC041A009C858700808B205
+r           350=0810D7FF8000900046700352B2220020
+r           360=8820001C42200A03B20508184DE00382
+r           370=D5FF80009000A7740004B2B20E00B2B2
+r           380=0E1095FF0800077EE31008180004E310
+r           390=08100009EB11000C000C4E100828F397
+r           3A0=0871082896F0087AD2270849A0004110
+r           3B0=0840412000418312000807FE
+r           800=00
+r           808=000003E8000F4240
+r           810=00000000000000000000000000000000
+r           828=0000000000000000
+r           840=D4E2C7D5D6C8405C4040404040404040
+r           850=40404040404040404040404040404040
+r           860=40404040404040404040404040404040
+r           870=404040404040404040404040A4A28583
+r           880=A2
+r           900=F1F0F0F0F0F0F040A740D4E5C34040F2
+r           910=F5F64082A8A385A26B40A689A3888995
+r           920=4097818785407A40F1F0F0F0F0F0F040
+r           930=A740D4E5C34040F2F5F64082A8A385A2
+r           940=6B408296A38840839996A2A240407A40
+r           950=F1F0F0F0F0F0F040A740C3D3C34040F2
+r           960=F5F64082A8A385A26B40A689A3888995
+r           970=4097818785407A40F1F0F0F0F0F0F040
+r           980=A740C3D3C34040F2F5F64082A8A385A2
+r           990=6B408296A38840839996A2A240407A40
+r           9A0=F1F0F0F0F0F0F040A740E7C3404040F2
+r           9B0=F5F64082A8A385A26B40A689A3888995
+r           9C0=4097818785407A40F1F0F0F0F0F0F040
+r           9D0=A740E7C3404040F2F5F64082A8A385A2
+r           9E0=6B408296A38840839996A2A240407A40
+r           A00=FFFFFFFF
+r           E00=00020001800000000000000000000000
+r           E10=0002000180000000000000000000BAD1
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           800=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Compare
+
+# Operand-1 within page, and the bytes past its end
+r           10000.10
+*Want       00010203 04050607 08090A0B 0C0D0E0F
+r           10010.10
+*Want       10111213 14151617 18191A1B 1C1D1E1F
+r           10020.10
+*Want       20212223 24252627 28292A2B 2C2D2E2F
+r           10030.10
+*Want       30313233 34353637 38393A3B 3C3D3E3F
+r           10040.10
+*Want       40414243 44454647 48494A4B 4C4D4E4F
+r           10050.10
+*Want       50515253 54555657 58595A5B 5C5D5E5F
+r           10060.10
+*Want       60616263 64656667 68696A6B 6C6D6E6F
+r           10070.10
+*Want       70717273 74757677 78797A7B 7C7D7E7F
+r           10080.10
+*Want       80818283 84858687 88898A8B 8C8D8E8F
+r           10090.10
+*Want       90919293 94959697 98999A9B 9C9D9E9F
+r           100A0.10
+*Want       A0A1A2A3 A4A5A6A7 A8A9AAAB ACADAEAF
+r           100B0.10
+*Want       B0B1B2B3 B4B5B6B7 B8B9BABB BCBDBEBF
+r           100C0.10
+*Want       C0C1C2C3 C4C5C6C7 C8C9CACB CCCDCECF
+r           100D0.10
+*Want       D0D1D2D3 D4D5D6D7 D8D9DADB DCDDDEDF
+r           100E0.10
+*Want       E0E1E2E3 E4E5E6E7 E8E9EAEB ECEDEEEF
+r           100F0.10
+*Want       F0F1F2F3 F4F5F6F7 F8F9FAFB FCFDFEFF
+r           10100.10
+*Want       00000000 00000000 00000000 00000000
+
+# Operand-1 crossing at X'13000', and the bytes past its end
+r           12F80.10
+*Want       00010203 04050607 08090A0B 0C0D0E0F
+r           12F90.10
+*Want       10111213 14151617 18191A1B 1C1D1E1F
+r           12FA0.10
+*Want       20212223 24252627 28292A2B 2C2D2E2F
+r           12FB0.10
+*Want       30313233 34353637 38393A3B 3C3D3E3F
+r           12FC0.10
+*Want       40414243 44454647 48494A4B 4C4D4E4F
+r           12FD0.10
+*Want       50515253 54555657 58595A5B 5C5D5E5F
+r           12FE0.10
+*Want       60616263 64656667 68696A6B 6C6D6E6F
+r           12FF0.10
+*Want       70717273 74757677 78797A7B 7C7D7E7F
+r           13000.10
+*Want       80818283 84858687 88898A8B 8C8D8E8F
+r           13010.10
+*Want       90919293 94959697 98999A9B 9C9D9E9F
+r           13020.10
+*Want       A0A1A2A3 A4A5A6A7 A8A9AAAB ACADAEAF
+r           13030.10
+*Want       B0B1B2B3 B4B5B6B7 B8B9BABB BCBDBEBF
+r           13040.10
+*Want       C0C1C2C3 C4C5C6C7 C8C9CACB CCCDCECF
+r           13050.10
+*Want       D0D1D2D3 D4D5D6D7 D8D9DADB DCDDDEDF
+r           13060.10
+*Want       E0E1E2E3 E4E5E6E7 E8E9EAEB ECEDEEEF
+r           13070.10
+*Want       F0F1F2F3 F4F5F6F7 F8F9FAFB FCFDFEFF
+r           13080.10
+*Want       00000000 00000000 00000000 00000000
+
+# Condition code of the last CLC and XC of tests 3 to 6
+r           A00.4
+*Want       00000101
+
+*Done
@@ -0,0 +1,255 @@
+ TITLE '   MVCLE-CLCLE-STR-01-performance (Test long operand instructions)'
+***********************************************************************
+*
+*        CLCLE, MVCLE, CLST, SRST and MVST performance tests
+*
+*        NOTE: This source is provided for information only. The
+*              .tst file loads the assembled program directly via
+*              'r' commands.
+*
+*                         ********************
+*                         **   IMPORTANT!   **
+*                         ********************
+*
+*              This test uses the Hercules Diagnose X'008' interface
+*              to display messages and thus your .tst runtest script
+*              MUST contain a "DIAG8CMD ENABLE" statement within it!
+*
+***********************************************************************
+*
+*  This program ONLY tests the performance of the CLCLE, MVCLE, CLST,
+*  SRST and MVST instructions on 64K operands, including their CC=3
+*  re-execution at each CPU determined completion point.
+*
+*     Tests:              (R0 = X'01', the terminating character)
+*
+*           1. CLCLE  64K at X'20000' and X'30000', equal
+*           2. MVCLE  64K from X'30000' to X'40000'
+*           3. CLST   strings at X'20000' and X'30000', ending at +X'FFFF'
+*           4. SRST   X'30000' up to X'40000', found at X'3FFFF'
+*           5. MVST   string at X'30000' to X'50000'
+*
+*  Both source strings are X'C1' bytes ending in the terminator.
+*
+*  After each test the condition code of its last iteration is saved
+*  in CCSAVE, one byte per test, and its R2-R5 in REGSAVE, 32 bytes
+*  per test. When CLST finds the operands equal, and SRST and MVST
+*  find the terminator, the registers left unchanged are those of the
+*  last CPU determined completion point, and so are not checked.
+*
+*  Timing is only performed when TIMEFLAG is set to X'FF'. Otherwise
+*  each test is run once as a functional check only.
+*
+***********************************************************************
+                                                                EJECT
+PERFTST  START 0
+         USING PERFTST,R0            Low core addressability
+*
+         ORG   PERFTST+X'1A0'        z/Architecure RESTART PSW
+         DC    X'0000000180000000'
+         DC    AD(BEGIN)
+*
+         ORG   PERFTST+X'1D0'        z/Architecure PROGRAM CHECK PSW
+         DC    X'0002000180000000'
+         DC    AD(X'DEADDEAD')
+*
+         ORG   PERFTST+X'200'        Start of actual test program...
+                                                                EJECT
+***********************************************************************
+*             The actual "MVCLE-CLCLE-STR-01-performance" program...
+***********************************************************************
+*
+BEGIN    CLI   TIMEFLAG,X'FF'        Timing requested?
+         JNE   NOTIME                No, functional check only
+         MVC   COUNT,BIGCNT          Yes, use the big iteration count
+NOTIME   LA    R11,REGSAVE           First register save entry
+         LA    R12,CCSAVE            First condition code save byte
+*
+*        Fill both strings with X'C1' and terminate them with X'01'
+*
+         LGFI  R2,OPND1
+         LGFI  R3,X'FFFF'
+         LGR   R4,R2
+         LGHI  R5,0
+FILL1    MVCLE R2,R4,X'C1'
+         JO    FILL1
+         MVI   0(R2),X'01'
+*
+         LGFI  R2,OPND2
+         LGFI  R3,X'FFFF'
+         LGR   R4,R2
+FILL2    MVCLE R2,R4,X'C1'
+         JO    FILL2
+         MVI   0(R2),X'01'
+*
+         LGHI  R0,1                  Terminating character
+                                                                EJECT
+*
+*        CLCLE: equal 64K operands
+*
+         LA    R10,TEXT1
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP1    LGFI  R2,OPND1
+         LGFI  R3,X'10000'
+         LGFI  R4,OPND2
+         LGFI  R5,X'10000'
+CLCLE1   CLCLE R2,R4,0
+         JO    CLCLE1
+         JNZ   FAIL
+         BCT   R7,LOOP1
+         BAS   R13,SAVE
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        MVCLE: 64K from OPND2 to OPND3
+*
+         LA    R10,TEXT2
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP2    LGFI  R2,OPND3
+         LGFI  R3,X'10000'
+         LGFI  R4,OPND2
+         LGFI  R5,X'10000'
+MVCLE2   MVCLE R2,R4,0
+         JO    MVCLE2
+         BCT   R7,LOOP2
+         BAS   R13,SAVE
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        CLST: equal 64K strings
+*
+         LA    R10,TEXT3
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP3    LGFI  R2,OPND1
+         LGFI  R4,OPND2
+CLST3    CLST  R2,R4
+         JO    CLST3
+         JNZ   FAIL
+         BCT   R7,LOOP3
+         BAS   R13,SAVE
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        SRST: terminator found at the end of OPND2
+*
+         LA    R10,TEXT4
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP4    LGFI  R2,OPND3
+         LGFI  R4,OPND2
+SRST4    SRST  R2,R4
+         JO    SRST4
+         BRC   10,FAIL               (not found)
+         BCT   R7,LOOP4
+         BAS   R13,SAVE
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+*        MVST: 64K string from OPND2 to OPND4
+*
+         LA    R10,TEXT5
+         L     R7,COUNT
+         STCK  BEGCLOCK
+LOOP5    LGFI  R2,OPND4
+         LGFI  R4,OPND2
+MVST5    MVST  R2,R4
+         JO    MVST5
+         BRC   10,FAIL               (not moved)
+         BCT   R7,LOOP5
+         BAS   R13,SAVE
+         STCK  ENDCLOCK
+         BAS   R14,REPORT
+*
+         LPSWE GOODPSW               Load SUCCESS PSW
+FAIL     LPSWE FAILPSW               Load FAILURE PSW
+                                                                EJECT
+***********************************************************************
+*        SAVE: save condition code and R2-R5 of the test just run
+***********************************************************************
+*
+SAVE     IPM   R1
+         SRL   R1,28
+         STC   R1,0(,R12)
+         LA    R12,1(,R12)
+         STMG  R2,R5,0(R11)
+         LA    R11,32(,R11)
+         BR    R13
+*
+***********************************************************************
+*        REPORT: issue timing message for test text at R10
+***********************************************************************
+*
+REPORT   CLI   TIMEFLAG,X'FF'        Timing requested?
+         BNER  R14                   No, just return
+         LG    R1,ENDCLOCK
+         SG    R1,BEGCLOCK
+         SRLG  R1,R1,12              Convert to microseconds
+         CVD   R1,DWORK
+         UNPK  MSGNUM,DWORK
+         OI    MSGNUM+L'MSGNUM-1,X'F0'
+         MVC   MSGTXT,0(R10)
+         LA    R1,MSGCMD
+         LA    R2,MSGLEN
+         DC    X'83',X'12',X'0008'   DIAGNOSE R1,R2,X'008'
+         BR    R14
+                                                                EJECT
+***********************************************************************
+*        Working storage
+***********************************************************************
+*
+         ORG   PERFTST+X'800'
+TIMEFLAG DC    X'00'                 X'FF' = run timing tests
+         ORG   PERFTST+X'808'
+COUNT    DC    F'1'                  Iteration count
+BIGCNT   DC    F'10000'              Iteration count when timing
+BEGCLOCK DC    D'0'
+ENDCLOCK DC    D'0'
+         ORG   PERFTST+X'828'
+DWORK    DC    D'0'
+*
+         ORG   PERFTST+X'840'
+MSGCMD   DC    C'MSGNOH * '
+MSGTXT   DC    CL40' '
+MSGNUM   DC    CL10' '
+         DC    C' usecs'
+MSGLEN   EQU   *-MSGCMD
+*
+         ORG   PERFTST+X'900'
+TEXT1    DC    CL40'10000 x CLCLE 64K, equal              : '
+TEXT2    DC    CL40'10000 x MVCLE 64K                     : '
+TEXT3    DC    CL40'10000 x CLST  64K, equal              : '
+TEXT4    DC    CL40'10000 x SRST  64K, found at end       : '
+TEXT5    DC    CL40'10000 x MVST  64K                     : '
+*
+         ORG   PERFTST+X'A00'
+CCSAVE   DC    XL8'00'               Condition code of each test
+         ORG   PERFTST+X'A20'
+REGSAVE  DC    5XL32'00'             R2-R5 of each test
+*
+         ORG   PERFTST+X'E00'
+GOODPSW  DC    X'0002000180000000',AD(0)
+FAILPSW  DC    X'0002000180000000',AD(X'BAD1')
+*
+OPND1    EQU   X'20000'              CLCLE/CLST operand-1
+OPND2    EQU   X'30000'              Source operand, all tests
+OPND3    EQU   X'40000'              MVCLE target, SRST end
+OPND4    EQU   X'50000'              MVST target
+                                                                EJECT
+R0       EQU   0
+R1       EQU   1
+R2       EQU   2
+R3       EQU   3
+R4       EQU   4
+R5       EQU   5
+R7       EQU   7
+R10      EQU   10
+R11      EQU   11
+R12      EQU   12
+R13      EQU   13
+R14      EQU   14
+R15      EQU   15
+*
+         END
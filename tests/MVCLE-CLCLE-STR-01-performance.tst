@@ -0,0 +1,127 @@
+*Testcase MVCLE-CLCLE-STR-01-performance (Test long operand instructions)
+
+# ------------------------------------------------------------------------------
+#  This ONLY tests the performance of CLCLE, MVCLE, CLST, SRST and MVST
+#  on 64K operands, including their CC=3 re-execution at each CPU
+#  determined completion point.
+#
+#  The default is to NOT run performance tests. To enable this performance
+#  test, uncomment the "#r 800=ff   # (enable timing tests)" line below.
+#  Without it each test is only run once as a functional check.
+#
+#  The condition code and R2-R5 each test ends with are saved at X'A00'
+#  and X'A20' and compared below, along with the MVCLE and MVST targets.
+#  See MVCLE-CLCLE-STR-01-performance.asm for the program source.
+#
+#     Tests:              (R0 = X'01', the terminating character)
+#
+#           1. CLCLE  64K at X'20000' and X'30000', equal
+#           2. MVCLE  64K from X'30000' to X'40000'
+#           3. CLST   strings at X'20000' and X'30000', ending at +X'FFFF'
+#           4. SRST   X'30000' up to X'40000', found at X'3FFFF'
+#           5. MVST   string at X'30000' to X'50000'
+#
+#     Output:
+#
+#         For each test, a console line will the generated with timing
+#         results, as follows:
+#
+#              10000 x CLCLE 64K, equal              : 0000022154 usecs
+#              10000 x MVCLE 64K                     : 0000024057 usecs
+#              ...
+# ------------------------------------------------------------------------------
+
+mainsize    16
+numcpu      1
+sysclear
+archlvl     z/Arch
+
+r           1A0=00000001800000000000000000000200
+r           1D0=0002000180000000FFFFFFFFDEADDEAD
+r           200=95FF0800A7740005D2030808080C41B0
+r           210=0A2041C00A00C02100020000C0310000
+r           220=FFFFB9040042A7590000A82400C1A714
+r           230=FFFE92012000C02100030000C0310000
+r           240=FFFFB9040042A82400C1A714FFFE9201
+r           250=2000A709000141A0090058700808B205
+r           260=0810C02100020000C03100010000C041
+r           270=00030000C05100010000A9240000A714
+r           280=FFFEA7740078467002624DD00376B205
+r           290=08184DE0039241A0092858700808B205
+r           2A0=0810C02100040000C03100010000C041
+r           2B0=00030000C05100010000A8240000A714
+r           2C0=FFFE467002A24DD00376B20508184DE0
+r           2D0=039241A0095058700808B2050810C021
+r           2E0=00020000C04100030000B25D0024A714
+r           2F0=FFFEA7740040467002DE4DD00376B205
+r           300=08184DE0039241A0097858700808B205
+r           310=0810C02100040000C04100030000B25E
+r           320=0024A714FFFEA7A40026467003124DD0
+r           330=0376B20508184DE0039241A009A05870
+r           340=0808B2050810C02100050000C0410003
+r           350=0000B2550024A714FFFEA7A4000C4670
+r           360=03464DD00376B20508184DE00392B2B2
+r           370=0E00B2B20E10B22200108810001C4210
+r           380=C00041C0C001EB25B000002441B0B020
+r           390=07FD95FF0800077EE31008180004E310
+r           3A0=08100009EB11000C000C4E100828F397
+r           3B0=0871082896F0087AD2270849A0004110
+r           3C0=0840412000418312000807FE
+r           808=0000000100002710
+r           840=D4E2C7D5D6C8405C4040404040404040
+r           850=40404040404040404040404040404040
+r           860=40404040404040404040404040404040
+r           870=404040404040404040404040A4A28583
+r           880=A2
+r           900=F1F0F0F0F040A740C3D3C3D3C540F6F4
+r           910=D26B408598A481934040404040404040
+r           920=4040404040407A40F1F0F0F0F040A740
+r           930=D4E5C3D3C540F6F4D240404040404040
+r           940=40404040404040404040404040407A40
+r           950=F1F0F0F0F040A740C3D3E2E34040F6F4
+r           960=D26B408598A481934040404040404040
+r           970=4040404040407A40F1F0F0F0F040A740
+r           980=E2D9E2E34040F6F4D26B408696A49584
+r           990=4081A340859584404040404040407A40
+r           9A0=F1F0F0F0F040A740D4E5E2E34040F6F4
+r           9B0=D2404040404040404040404040404040
+r           9C0=4040404040407A40
+r           E00=00020001800000000000000000000000
+r           E10=0002000180000000000000000000BAD1
+
+diag8cmd    enable    # (needed for messages to Hercules console)
+#r           800=ff    # (enable timing tests)
+runtest     300       # (test duration, depends on host)
+diag8cmd    disable   # (reset back to default)
+
+*Compare
+# Condition codes: CLCLE, MVCLE, CLST, SRST, MVST
+r           A00.8
+*Want       00000001 01000000
+# CLCLE: R2-R5 at the end of both operands
+r           A20.10
+*Want       00000000 00030000 00000000 00000000
+r           A30.10
+*Want       00000000 00040000 00000000 00000000
+# MVCLE: R2-R5 at the end of both operands
+r           A40.10
+*Want       00000000 00050000 00000000 00000000
+r           A50.10
+*Want       00000000 00040000 00000000 00000000
+# SRST: R2 -> terminator
+r           A80.10
+*Want       00000000 0003FFFF 00000000 00000000
+# MVST: R2 -> terminator in operand-1
+r           AA0.10
+*Want       00000000 0005FFFF 00000000 00000000
+# MVCLE and MVST targets
+r           40000.10
+*Want       C1C1C1C1 C1C1C1C1 C1C1C1C1 C1C1C1C1
+r           4FFF0.10
+*Want       C1C1C1C1 C1C1C1C1 C1C1C1C1 C1C1C101
+r           50000.10
+*Want       C1C1C1C1 C1C1C1C1 C1C1C1C1 C1C1C1C1
+r           5FFF0.10
+*Want       C1C1C1C1 C1C1C1C1 C1C1C1C1 C1C1C101
+
+*Done
@@ -0,0 +1,59 @@
+*Testcase TR-TRT-01-xpage: TR and TRT with operands crossing pages
+sysclear
+archlvl z/Arch
+
+r 1a0=00000001800000000000000000000200  # z/Arch restart PSW
+r 1d0=0002000180000000000000000000DEAD  # z/Arch pgm new PSW
+
+r 200=C08100014FF0                    # LGFI  R8,X'14FF0'      operand-1, crosses
+r 206=C09100012F80                    # LGFI  R9,X'12F80'      TR table, crosses
+r 20c=DC1F80009000                    # TR    0(32,R8),0(R9)
+r 212=C09100016F80                    # LGFI  R9,X'16F80'      TRT table, crosses
+r 218=A7190000                        # LGHI  R1,0
+r 21c=A7290000                        # LGHI  R2,0
+r 220=DD1F80009000                    # TRT   0(32,R8),0(R9)   hit on 2nd page
+r 226=B2220030                        # IPM   R3
+r 22a=E31009000024                    # STG   R1,X'900'
+r 230=E32009080024                    # STG   R2,X'908'
+r 236=50300910                        # ST    R3,X'910'
+r 23a=DD0F80009000                    # TRT   0(16,R8),0(R9)   no hit
+r 240=B2220030                        # IPM   R3
+r 244=50300914                        # ST    R3,X'914'
+r 248=B2B20300                        # LPSWE GOODPSW
+r 300=00020001800000000000000000000000  # GOODPSW
+
+r 14ff0=000102030405060708090A0B0C0D0E0F  # operand-1
+r 15000=101112131415161718191A1B1C1D1E1F
+
+r 12f80=0102030405060708090A0B0C0D0E0F10  # TR table: X'00'->X'01', ...
+r 12f90=1112131415161718191A1B1C1D1E1F20
+r 12fa0=2122232425262728292A2B2C2D2E2F30
+r 12fb0=3132333435363738393A3B3C3D3E3F40
+r 12fc0=4142434445464748494A4B4C4D4E4F50
+r 12fd0=5152535455565758595A5B5C5D5E5F60
+r 12fe0=6162636465666768696A6B6C6D6E6F70
+r 12ff0=7172737475767778797A7B7C7D7E7F80
+r 13000=8182838485868788898A8B8C8D8E8F90
+r 13010=9192939495969798999A9B9C9D9E9FA0
+r 13020=A1A2A3A4A5A6A7A8A9AAABACADAEAFB0
+r 13030=B1B2B3B4B5B6B7B8B9BABBBCBDBEBFC0
+r 13040=C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0
+r 13050=D1D2D3D4D5D6D7D8D9DADBDCDDDEDFE0
+r 13060=E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0
+r 13070=F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF00
+
+r 16f95=AA                              # TRT table: only X'15' is non-zero
+
+runtest .1
+
+*Compare
+r 14ff0.10
+*Want 01020304 05060708 090A0B0C 0D0E0F10
+r 15000.10
+*Want 11121314 15161718 191A1B1C 1D1E1F20
+r 900.10
+*Want 00000000 00015004 00000000 000000AA
+r 910.8
+*Want 10000000 00000000
+
+*Done
@@ -0,0 +1,56 @@
+*Testcase TR-TRT-02-inpage: TR and TRT with operands and tables within a page
+sysclear
+archlvl z/Arch
+
+r 1a0=00000001800000000000000000000200  # z/Arch restart PSW
+r 1d0=0002000180000000000000000000DEAD  # z/Arch pgm new PSW
+
+r 200=C08100003000                    # LGFI  R8,X'3000'
+r 206=C09100003100                    # LGFI  R9,X'3100'
+r 20c=C0A100003200                    # LGFI  R10,X'3200'
+r 212=DC1480009000                    # TR    X'0'(21,R8),X'0'(R9)          in page, 21 bytes
+r 218=A7190000                        # LGHI  R1,0
+r 21c=A7290000                        # LGHI  R2,0
+r 220=DD148000A000                    # TRT   X'0'(21,R8),X'0'(R10)         hit on byte 11
+r 226=E31009000024                    # STG   R1,X'900'
+r 22c=E32009080024                    # STG   R2,X'908'
+r 232=B2220050                        # IPM   R5
+r 236=50500A00                        # ST    R5,X'A00'
+r 23a=DD078000A000                    # TRT   X'0'(8,R8),X'0'(R10)          no hit
+r 240=B2220050                        # IPM   R5
+r 244=50500A04                        # ST    R5,X'A04'
+r 248=DD0B8000A000                    # TRT   X'0'(12,R8),X'0'(R10)         hit on last byte
+r 24e=B2220050                        # IPM   R5
+r 252=50500A08                        # ST    R5,X'A08'
+r 256=C0B100003500                    # LGFI  R11,X'3500'
+r 25c=DC07B010B000                    # TR    X'10'(8,R11),X'0'(R11)        operand is in the table
+r 262=B2B20400                        # LPSWE GOODPSW
+r 400=00020001800000000000000000000000  # GOODPSW
+
+r 3000=000102030405060708090A0B0C0D0E0F  # operand-1
+r 3010=1011121314151617
+
+r 3100=0102030405060708090A0B0C0D0E0F10  # TR table: X'00'->X'01', ...
+r 3110=1112131415161718191A1B1C1D1E1F20
+
+r 320c=CC                               # TRT table: only X'0C' is non-zero
+
+r 3500=0102030405060708090A0B0C0D0E0F10  # TR table, operand is at X'3510'
+r 3510=1110101112101310
+
+runtest .1
+
+*Compare
+r 3000.10
+*Want 01020304 05060708 090A0B0C 0D0E0F10
+r 3010.8
+*Want 11121314 15151617
+r 900.10
+*Want 00000000 0000300B 00000000 000000CC
+r a00.C
+*Want 10000000 00000000 20000000
+# Each byte is translated with the table as already changed
+r 3510.8
+*Want 10101010 10101010
+
+*Done
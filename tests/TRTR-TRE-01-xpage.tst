@@ -0,0 +1,116 @@
+*Testcase TRTR-TRE-01-xpage: TRTR and TRE within a page and crossing pages
+sysclear
+archlvl z/Arch
+
+r 1a0=00000001800000000000000000000200  # z/Arch restart PSW
+r 1d0=0002000180000000000000000000DEAD  # z/Arch pgm new PSW
+
+r 200=C08100003000                    # LGFI  R8,X'3000'
+r 206=C0A100003200                    # LGFI  R10,X'3200'
+r 20c=C0B100014FF0                    # LGFI  R11,X'14FF0'
+r 212=C0C100003300                    # LGFI  R12,X'3300'
+r 218=A7190000                        # LGHI  R1,0
+r 21c=A7290000                        # LGHI  R2,0
+r 220=D00F801FA000                    # TRTR  X'1F'(16,R8),X'0'(R10)        hit on X'1A'
+r 226=E31009000024                    # STG   R1,X'900'
+r 22c=E32009080024                    # STG   R2,X'908'
+r 232=B2220050                        # IPM   R5
+r 236=50500A00                        # ST    R5,X'A00'
+r 23a=D009800FA000                    # TRTR  X'F'(10,R8),X'0'(R10)         no hit
+r 240=B2220050                        # IPM   R5
+r 244=50500A04                        # ST    R5,X'A04'
+r 248=D00A800FA000                    # TRTR  X'F'(11,R8),X'0'(R10)         hit on last byte
+r 24e=E31009100024                    # STG   R1,X'910'
+r 254=B2220050                        # IPM   R5
+r 258=50500A08                        # ST    R5,X'A08'
+r 25c=D01FB01FC000                    # TRTR  X'1F'(32,R11),X'0'(R12)       crosses, hit on 1st page
+r 262=E31009180024                    # STG   R1,X'918'
+r 268=E32009200024                    # STG   R2,X'920'
+r 26e=B2220050                        # IPM   R5
+r 272=50500A0C                        # ST    R5,X'A0C'
+r 276=C04100003400                    # LGFI  R4,X'3400'
+r 27c=A709000C                        # LGHI  R0,X'C'
+r 280=C02100005000                    # LGFI  R2,X'5000'
+r 286=A7390015                        # LGHI  R3,X'15'
+r 28a=B2A50024                        # TRE   R2,R4                       stops at X'0C'
+r 28e=B2220050                        # IPM   R5
+r 292=50500A10                        # ST    R5,X'A10'
+r 296=E32009300024                    # STG   R2,X'930'
+r 29c=E33009380024                    # STG   R3,X'938'
+r 2a2=A70900FF                        # LGHI  R0,X'FF'
+r 2a6=C02100005100                    # LGFI  R2,X'5100'
+r 2ac=A7390015                        # LGHI  R3,X'15'
+r 2b0=B2A50024                        # TRE   R2,R4                       in page, all
+r 2b4=B2220050                        # IPM   R5
+r 2b8=50500A14                        # ST    R5,X'A14'
+r 2bc=E32009400024                    # STG   R2,X'940'
+r 2c2=E33009480024                    # STG   R3,X'948'
+r 2c8=C02100015FF8                    # LGFI  R2,X'15FF8'
+r 2ce=A7390018                        # LGHI  R3,X'18'
+r 2d2=B2A50024                        # TRE   R2,R4                       crosses, CC3
+r 2d6=B2220050                        # IPM   R5
+r 2da=50500A18                        # ST    R5,X'A18'
+r 2de=B2A50024                        # TRE   R2,R4
+r 2e2=A714FFFE                        # BRC   1,*-4                       CC3: keep going
+r 2e6=B2220050                        # IPM   R5
+r 2ea=50500A1C                        # ST    R5,X'A1C'
+r 2ee=E32009500024                    # STG   R2,X'950'
+r 2f4=E33009580024                    # STG   R3,X'958'
+r 2fa=B2B20400                        # LPSWE GOODPSW
+r 400=00020001800000000000000000000000  # GOODPSW
+
+r 3000=000102030405060708090A0B0C0D0E0F  # TRTR operand-1
+r 3010=101112131415161718191A1B1C1D1E1F
+r 3205=55                               # TRTR table: X'05' and X'1A'
+r 321a=AA
+r 3305=55                               # TRTR table: X'05' only
+
+r 14ff0=000102030405060708090A0B0C0D0E0F  # TRTR operand-1, crosses
+r 15000=101112131415161718191A1B1C1D1E1F
+
+r 3400=0102030405060708090A0B0C0D0E0F10  # TRE table: X'00'->X'01', ...
+r 3410=1112131415161718191A1B1C1D1E1F20
+
+r 5000=000102030405060708090A0B0C0D0E0F  # TRE operand-1
+r 5010=1011121314151617
+r 5100=000102030405060708090A0B0C0D0E0F  # TRE operand-1
+r 5110=1011121314151617
+r 15ff8=0001020304050607                # TRE operand-1, crosses
+r 16000=08090A0B0C0D0E0F1011121314151617
+
+runtest .1
+
+*Compare
+r 900.10
+*Want 00000000 0000301A 00000000 000000AA
+r 910.8
+*Want 00000000 00003005
+r 918.8
+*Want 00000000 00014FF5
+r 920.8
+*Want 00000000 00000055
+r a00.10
+*Want 10000000 00000000 20000000 10000000
+# TRE: stopped at the test byte, all on the page, crossing
+r 5000.10
+*Want 01020304 05060708 090A0B0C 0C0D0E0F
+r 5010.8
+*Want 10111213 14151617
+r 5100.10
+*Want 01020304 05060708 090A0B0C 0D0E0F10
+r 5110.8
+*Want 11121314 15151617
+r 15ff8.8
+*Want 01020304 05060708
+r 16000.10
+*Want 090A0B0C 0D0E0F10 11121314 15161718
+r 930.10
+*Want 00000000 0000500C 00000000 00000009
+r 940.10
+*Want 00000000 00005115 00000000 00000000
+r 950.10
+*Want 00000000 00016010 00000000 00000000
+r a10.10
+*Want 10000000 00000000 30000000 00000000
+
+*Done
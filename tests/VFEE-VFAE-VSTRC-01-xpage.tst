@@ -0,0 +1,130 @@
+*Testcase VFEE-VFAE-VSTRC-01-xpage: vector string searches on an operand crossing pages
+
+# ------------------------------------------------------------------------------
+#  VFEE, VFENE, VFAE and VSTRC on byte, halfword and word elements, with
+#  and without zero search and result type, on a string loaded from
+#  X'10FF8' across a page boundary.  The last case also loads its second
+#  operand across a page.  Each result is stored at X'900' and each
+#  condition code at X'A00'.
+# ------------------------------------------------------------------------------
+
+sysclear
+archlvl z/Arch
+
+r 1a0=00000001800000000000000000000200  # z/Arch restart PSW
+r 1d0=0002000180000000000000000000DEAD  # z/Arch pgm new PSW
+
+r 200=B6000A80                        # STCTL R0,R0,X'A80'
+r 204=96060A81                        # OI    X'A81',X'06'         AFP and vector
+r 208=B7000A80                        # LCTL  R0,R0,X'A80'
+r 20c=C08100010FF8                    # LGFI  R8,X'10FF8'
+r 212=E72080000006                    # VL    V2,X'0'(R8)
+r 218=C09100012100                    # LGFI  R9,X'12100'
+r 21e=E73090000006                    # VL    V3,X'0'(R9)
+r 224=E71230100080                    # VFEE  V1,V2,V3,0,1  equal at 10
+r 22a=B2220030                        # IPM   R3
+r 22e=50300A00                        # ST    R3,X'A00'
+r 232=E7100900000E                    # VST   V1,X'900'
+r 238=E71230300080                    # VFEE  V1,V2,V3,0,3  equal at 10, zero at 12
+r 23e=B2220030                        # IPM   R3
+r 242=50300A04                        # ST    R3,X'A04'
+r 246=E7100910000E                    # VST   V1,X'910'
+r 24c=C09100012150                    # LGFI  R9,X'12150'
+r 252=E73090000006                    # VL    V3,X'0'(R9)
+r 258=E71230300080                    # VFEE  V1,V2,V3,0,3  no equal, zero at 12
+r 25e=B2220030                        # IPM   R3
+r 262=50300A08                        # ST    R3,X'A08'
+r 266=E7100920000E                    # VST   V1,X'920'
+r 26c=C09100012110                    # LGFI  R9,X'12110'
+r 272=E73090000006                    # VL    V3,X'0'(R9)
+r 278=E71230101081                    # VFENE V1,V2,V3,1,1  halfword 3 low
+r 27e=B2220030                        # IPM   R3
+r 282=50300A0C                        # ST    R3,X'A0C'
+r 286=E7100930000E                    # VST   V1,X'930'
+r 28c=C09100012120                    # LGFI  R9,X'12120'
+r 292=E73090000006                    # VL    V3,X'0'(R9)
+r 298=E71230102082                    # VFAE  V1,V2,V3,2,1  word 2 in set
+r 29e=B2220030                        # IPM   R3
+r 2a2=50300A10                        # ST    R3,X'A10'
+r 2a6=E7100940000E                    # VST   V1,X'940'
+r 2ac=E71230502082                    # VFAE  V1,V2,V3,2,5  RT
+r 2b2=B2220030                        # IPM   R3
+r 2b6=50300A14                        # ST    R3,X'A14'
+r 2ba=E7100950000E                    # VST   V1,X'950'
+r 2c0=C09100012130                    # LGFI  R9,X'12130'
+r 2c6=E73090000006                    # VL    V3,X'0'(R9)
+r 2cc=E74090100006                    # VL    V4,X'10'(R9)
+r 2d2=E7123090408A                    # VSTRC V1,V2,V3,V4,0,9  IN, not A-H at 8
+r 2d8=B2220030                        # IPM   R3
+r 2dc=50300A18                        # ST    R3,X'A18'
+r 2e0=E7100960000E                    # VST   V1,X'960'
+r 2e6=C09100012160                    # LGFI  R9,X'12160'
+r 2ec=E73090000006                    # VL    V3,X'0'(R9)
+r 2f2=E74090100006                    # VL    V4,X'10'(R9)
+r 2f8=E71230B0408A                    # VSTRC V1,V2,V3,V4,0,11  IN ZS, zero at 12
+r 2fe=B2220030                        # IPM   R3
+r 302=50300A1C                        # ST    R3,X'A1C'
+r 306=E7100970000E                    # VST   V1,X'970'
+r 30c=C09100012180                    # LGFI  R9,X'12180'
+r 312=E73090000006                    # VL    V3,X'0'(R9)
+r 318=E74090100006                    # VL    V4,X'10'(R9)
+r 31e=E7123150408A                    # VSTRC V1,V2,V3,V4,1,5  RT, halfwords 0-2
+r 324=B2220030                        # IPM   R3
+r 328=50300A20                        # ST    R3,X'A20'
+r 32c=E7100980000E                    # VST   V1,X'980'
+r 332=C09100011FF8                    # LGFI  R9,X'11FF8'
+r 338=E73090000006                    # VL    V3,X'0'(R9)
+r 33e=E71230300081                    # VFENE V1,V2,V3,0,3  byte 5 high
+r 344=B2220030                        # IPM   R3
+r 348=50300A24                        # ST    R3,X'A24'
+r 34c=E7100990000E                    # VST   V1,X'990'
+r 352=B2B20400                        # LPSWE GOODPSW
+r 400=00020001800000000000000000000000  # GOODPSW
+
+r 10ff8=4142434445464748                # string, crosses: "ABCDEFGHIJKL" 00 "NOP"
+r 11000=494A4B4C004E4F50
+r 11ff8=4142434445404748                # second operand, crosses
+r 12000=494A4B4C004E4F50
+
+r 12100=585858585858585858584B5858585858  # VFEE: only byte 10 equal
+r 12110=4142434445465858494A4B4C004E4F50  # VFENE: halfword 3 differs
+r 12120=11111111494A4B4C2222222233333333  # VFAE: word set
+r 12130=41480000000000000000000000000000  # VSTRC: range X'41'-X'48'
+r 12140=A0C00000000000000000000000000000  #        GE, LE
+r 12150=58585858585858585858585858585858  # VFEE: nothing equal
+r 12160=414C0000000000000000000000000000  # VSTRC: range X'41'-X'4C'
+r 12170=A0C00000000000000000000000000000  #        GE, LE
+r 12180=41424548000000000000000000000000  # VSTRC: range X'4142'-X'4548'
+r 12190=A000C000000000000000000000000000  #        GE, LE
+
+runtest .1
+
+*Compare
+r 900.10
+*Want 00000000 0000000A 00000000 00000000
+r 910.10
+*Want 00000000 0000000A 00000000 00000000
+r 920.10
+*Want 00000000 0000000C 00000000 00000000
+r 930.10
+*Want 00000000 00000006 00000000 00000000
+r 940.10
+*Want 00000000 00000008 00000000 00000000
+r 950.10
+*Want 00000000 00000000 FFFFFFFF 00000000
+r 960.10
+*Want 00000000 00000008 00000000 00000000
+r 970.10
+*Want 00000000 0000000C 00000000 00000000
+r 980.10
+*Want FFFFFFFF FFFF0000 00000000 00000000
+r 990.10
+*Want 00000000 00000005 00000000 00000000
+r a00.10
+*Want 10000000 20000000 00000000 10000000
+r a10.10
+*Want 10000000 10000000 10000000 00000000
+r a20.8
+*Want 10000000 20000000
+
+*Done
@@ -155,6 +155,144 @@ CPU_BITMAP      intmask = 0;            /* Interrupt CPU mask        */
 } /* end function check_timer_event */
 
 
+/*-------------------------------------------------------------------*/
+/* Take one instruction profile sample of every started CPU          */
+/*                                                                   */
+/* The CPU's instruction pointer fields are read without any kind of */
+/* serialization whatsoever so the CPU thread is never slowed down.  */
+/* The instruction is only fetched from mainstor when the pointers   */
+/* appear consistent, otherwise the sample is charged to the PSW     */
+/* instruction address with an unknown instruction.                  */
+/*-------------------------------------------------------------------*/
+static void profile_sample( U64 usecs )
+{
+int      i, n;                          /* Loop indexes              */
+REGS    *regs;                          /* -> REGS                   */
+PROFENT *pe;                            /* -> Profile entry          */
+BYTE    *ip, *aip, *aie;                /* Instruction pointers      */
+U64      ia;                            /* Instruction address       */
+BYTE     inst[6];                       /* Instruction bytes         */
+BYTE     state;                         /* CPU state                 */
+U32      hash;                          /* Table index               */
+
+    obtain_lock( &sysblk.proflock );
+
+    for (i=0; i < sysblk.hicpu; i++)
+    {
+        obtain_lock( &sysblk.cpulock[ i ]);
+        {
+            if (0
+                || !IS_CPU_ONLINE( i )
+                || sysblk.regs[ i ]->cpustate != CPUSTATE_STARTED
+            )
+            {
+                release_lock( &sysblk.cpulock[ i ]);
+                continue;
+            }
+
+            regs  = sysblk.regs[ i ];
+            state = 0;
+
+#if defined( _FEATURE_SIE )
+            if (regs->sie_active && regs->guestregs)
+            {
+                regs   = regs->guestregs;
+                state |= PROF_SIE;
+            }
+#endif
+            if (WAITSTATE( &regs->psw ))
+                state |= PROF_WAIT;
+            else if (PROBSTATE( &regs->psw ))
+                state |= PROF_PROB;
+
+            memset( inst, 0, sizeof( inst ));
+
+            ip  = regs->ip;
+            aip = regs->aip;
+            aie = regs->aie;
+
+            if (1
+                && !(state & PROF_WAIT)
+                && aie != INVALID_AIE
+                && ip >= aip
+                && ip <  aie        /* (aie is 5 bytes before page end) */
+                && ip >= sysblk.mainstor
+                && ip <  sysblk.mainstor + sysblk.mainsize - 6
+            )
+            {
+                ia = regs->AIV_G + (ip - aip);
+                inst[0] = ip[0];
+                inst[1] = ip[1];
+                if (inst[0] >= 0x40)
+                {
+                    inst[2] = ip[2];
+                    inst[3] = ip[3];
+                }
+                if (inst[0] >= 0xC0)
+                {
+                    inst[4] = ip[4];
+                    inst[5] = ip[5];
+                }
+            }
+            else
+                ia = regs->psw.IA_G;
+
+            ia &= regs->psw.AMASK_G;
+
+            /* Find or create this instruction's profile entry */
+            if (!sysblk.profent[ i ])
+                sysblk.profent[ i ] = calloc( PROF_ENTRIES, sizeof( PROFENT ));
+
+            sysblk.profsamples[ i ]++;
+
+            if (!(pe = sysblk.profent[ i ]))
+            {
+                sysblk.profdropped[ i ]++;
+                release_lock( &sysblk.cpulock[ i ]);
+                continue;
+            }
+
+            hash = (U32)(((ia ^ fetch_hw( inst )) * 0x9E3779B97F4A7C15ULL) >> 32);
+
+            for (n=0; n < PROF_PROBES; n++)
+            {
+                pe = &sysblk.profent[ i ][ (hash + n) & (PROF_ENTRIES - 1) ];
+
+                if (!pe->count)
+                {
+                    pe->ia        = ia;
+                    pe->arch_mode = regs->arch_mode;
+                    pe->state     = state;
+                    memcpy( pe->inst, inst, sizeof( inst ));
+                    break;
+                }
+
+                if (1
+                    && pe->ia        == ia
+                    && pe->state     == state
+                    && pe->arch_mode == regs->arch_mode
+                    && memcmp( pe->inst, inst, sizeof( inst )) == 0
+                )
+                    break;
+            }
+
+            if (n < PROF_PROBES)
+            {
+                pe->count++;
+                pe->usecs += usecs;
+            }
+            else
+                sysblk.profdropped[ i ]++;
+        }
+        release_lock( &sysblk.cpulock[ i ]);
+
+    } /* end for(cpu) */
+
+    release_lock( &sysblk.proflock );
+
+} /* end function profile_sample */
+
+
 /*-------------------------------------------------------------------*/
 /* TOD clock and timer thread                                        */
 /*                                                                   */
@@ -207,6 +345,18 @@ bool    txf_PPA;                        /* true == PPA assist needed */
         /* Update TOD clock and save TOD clock value */
         now = update_tod_clock();
 
+        /* Take an instruction profile sample when it's time to */
+        if (sysblk.profusecs)
+        {
+            if (!sysblk.proflast || now < sysblk.proflast)
+                sysblk.proflast = now;
+            else if ((now - sysblk.proflast) >= sysblk.profusecs * ETOD_USEC)
+            {
+                profile_sample( (now - sysblk.proflast) / ETOD_USEC );
+                sysblk.proflast = now;
+            }
+        }
+
         intv_secs = now - then;
 
         if (intv_secs >= one_sec)             /* Period expired? */
@@ -47,6 +47,19 @@
   #define IFF_ONE_QUEUE   0x2000    /* Use only one packet queue     */
 #endif // !defined(HAVE_LINUX_IF_TUN_H)
 
+#if !defined(IFF_MULTI_QUEUE)
+  #define IFF_MULTI_QUEUE 0x0100    /* Multiple packet queues        */
+#endif
+#if !defined(IFF_VNET_HDR)
+  #define IFF_VNET_HDR    0x4000    /* Packets have virtio-net hdr   */
+#endif
+#if !defined(TUNSETOFFLOAD)
+  #define TUNSETOFFLOAD   _IOW('T', 208, unsigned int)
+#endif
+#if !defined(TUNGETIFF)
+  #define TUNGETIFF       _IOR('T', 210, unsigned int)
+#endif
+
   /* Passed  from ctc_ctci to tuntap to indicate that the interface  */
   /* is configured and that only the interface name is to be set.    */
   #define IFF_NO_HERCIFC  0x10000
@@ -194,6 +207,8 @@ extern void net_data_trace( DEVBLK* dev, BYTE* addr, int len, BYTE dir, BYTE sev
   #define TUNTAP_Open           open
   #define TUNTAP_Read           read
   #define TUNTAP_Write          write
+  #define TUNTAP_Readv          readv
+  #define TUNTAP_Writev         writev
   #define TUNTAP_BegMWrite(f,n)
   #define TUNTAP_EndMWrite(f)
   #define TUNTAP_IOCtl          ioctl
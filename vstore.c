@@ -103,6 +103,10 @@ extern inline QW   ARCH_DEP( vfetch16 )( VADR addr, int arn, REGS* regs );
 
 extern inline BYTE* ARCH_DEP( instfetch )( REGS* regs, int exec );
 
+extern inline void ARCH_DEP( opwin )( OPWIN* w, VADR addr, int len, int arn,
+                                      REGS* regs, int acctype, BYTE key );
+extern inline void ARCH_DEP( opwin_changed )( OPWIN* w );
+
 // (needed by dyncrypt.c)
 INL_DLL_EXPORT inline void ARCH_DEP( vstorec )( const void* src, BYTE len, VADR addr, int arn, REGS* regs );
 INL_DLL_EXPORT inline void ARCH_DEP( vfetchc )( void* dest, BYTE len, VADR addr, int arn, REGS* regs );
@@ -157,6 +161,9 @@ extern inline void ARCH_DEP( move_chars_rl )( VADR addr1, int arn1, BYTE key1,
 /*-------------------------------------------------------------------*/
 
 extern inline void concpy    ( REGS* regs, void* d, void* s, int n );
+extern inline int  opwin_run  ( const OPWIN* a, const OPWIN* b, int off,
+                                BYTE** pa, BYTE** pb );
+extern inline bool opwin_bitop( BYTE* d, BYTE* s, int n, int op );
 #if defined( _FEATURE_061_MISC_INSTR_EXT_FACILITY_3 )
 extern inline void concpy_rl ( REGS* regs, void* d, void* s, int n );
 #endif
@@ -305,6 +305,91 @@ inline void concpy_rl( REGS* regs, void* d, void* s, int n )
 
 #endif // defined( FEATURE_061_MISC_INSTR_EXT_FACILITY_3 )
 
+#ifndef _VSTORE_OPWIN
+#define _VSTORE_OPWIN
+
+/*-------------------------------------------------------------------*/
+/*                 Storage operand window (OPWIN)                    */
+/*-------------------------------------------------------------------*/
+/* An operand window describes a storage operand no longer than one  */
+/* page as at most two runs of contiguous mainstor, one for each     */
+/* page the operand touches. It is filled in by ARCH_DEP( opwin )    */
+/* which translates and checks both pages once, after which the      */
+/* instruction can work directly on mainstor without any further     */
+/* address translation, key checking or page crossing checks.        */
+/*-------------------------------------------------------------------*/
+struct OPWIN
+{
+    BYTE*   m[2];               /* Mainstor address of each run or   */
+                                /* NULL if the operand has one run   */
+    BYTE*   sk[2];              /* Storage key of each run's page    */
+    int     len1;               /* Length of the first run           */
+    int     len;                /* Total length of the operand       */
+};
+
+/*-------------------------------------------------------------------*/
+/* Find the longest run at offset 'off' contiguous in both windows   */
+/*-------------------------------------------------------------------*/
+inline int opwin_run( const OPWIN* a, const OPWIN* b, int off,
+                      BYTE** pa, BYTE** pb )
+{
+    int  na, nb;
+
+    if (off < a->len1) { *pa = a->m[0] + off;             na = a->len1 - off; }
+    else               { *pa = a->m[1] + (off - a->len1); na = a->len  - off; }
+
+    if (off < b->len1) { *pb = b->m[0] + off;             nb = b->len1 - off; }
+    else               { *pb = b->m[1] + (off - b->len1); nb = b->len  - off; }
+
+    return na < nb ? na : nb;
+}
+
+/*-------------------------------------------------------------------*/
+/* AND, OR or XOR 'n' source bytes into the destination, 8 bytes at  */
+/* a time unless the destination starts less than 8 bytes after the  */
+/* source (which must then be processed a byte at a time). Returns   */
+/* true if any bit of the result is one.                             */
+/*-------------------------------------------------------------------*/
+#define OPWIN_AND   0
+#define OPWIN_OR    1
+#define OPWIN_XOR   2
+
+inline bool opwin_bitop( BYTE* d, BYTE* s, int n, int op )
+{
+    U64  v, any = 0;
+
+    if (!(d > s && d - s < 8))
+    {
+        for (; n >= 8; n -= 8, d += 8, s += 8)
+        {
+            v = fetch_dw_noswap( d );
+            switch (op)
+            {
+            case OPWIN_AND: v &= fetch_dw_noswap( s ); break;
+            case OPWIN_OR:  v |= fetch_dw_noswap( s ); break;
+            default:        v ^= fetch_dw_noswap( s ); break;
+            }
+            store_dw_noswap( d, v );
+            any |= v;
+        }
+    }
+
+    for (; n; n--, d++, s++)
+    {
+        switch (op)
+        {
+        case OPWIN_AND: *d &= *s; break;
+        case OPWIN_OR:  *d |= *s; break;
+        default:        *d ^= *s; break;
+        }
+        any |= *d;
+    }
+
+    return any != 0;
+}
+
+#endif // _VSTORE_OPWIN
+
 /*-------------------------------------------------------------------*/
 /* Store a two-byte integer into virtual storage operand             */
 /*                                                                   */
@@ -1102,6 +1187,62 @@ int     len;                            /* Length for page crossing  */
 
 } /* end function ARCH_DEP( instfetch ) */
 
+/*-------------------------------------------------------------------*/
+/*              Translate a storage operand window                   */
+/*                                                                   */
+/* Input:                                                            */
+/*      w       Pointer to the OPWIN to be filled in                 */
+/*      addr    Logical address of leftmost operand byte             */
+/*      len     Operand length minus 1 (less than the page size)     */
+/*      arn     Access register number                               */
+/*      regs    CPU register context                                 */
+/*      acctype Type of access requested                             */
+/*      key     Storage access key                                   */
+/*                                                                   */
+/*      Both pages of an operand which crosses a page boundary are   */
+/*      translated before returning so any access exception is       */
+/*      recognized before the instruction modifies any storage.      */
+/*      When ACCTYPE_WRITE_SKP is used the caller must then call     */
+/*      opwin_changed once it has finished updating the operand.     */
+/*                                                                   */
+/*      A program check may be generated if the logical address      */
+/*      causes an addressing, translation, or protection             */
+/*      exception, and in this case the function does not return.   */
+/*-------------------------------------------------------------------*/
+inline void ARCH_DEP( opwin )( OPWIN* w, VADR addr, int len, int arn,
+                               REGS* regs, int acctype, BYTE key )
+{
+    w->len = len + 1;
+
+    if (NOCROSSPAGE( addr, len ))
+    {
+        w->len1  = len + 1;
+        w->m[0]  = MADDRL( addr, len + 1, arn, regs, acctype, key );
+        w->sk[0] = regs->dat.storkey;
+        w->m[1]  = NULL;
+        w->sk[1] = NULL;
+    }
+    else
+    {
+        w->len1  = PAGEFRAME_PAGESIZE - (addr & PAGEFRAME_BYTEMASK);
+        w->m[0]  = MADDRL( addr, w->len1, arn, regs, acctype, key );
+        w->sk[0] = regs->dat.storkey;
+        w->m[1]  = MADDRL( (addr + w->len1) & ADDRESS_MAXWRAP( regs ),
+                           w->len - w->len1, arn, regs, acctype, key );
+        w->sk[1] = regs->dat.storkey;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/* Set the reference and change bits of an ACCTYPE_WRITE_SKP window  */
+/*-------------------------------------------------------------------*/
+inline void ARCH_DEP( opwin_changed )( OPWIN* w )
+{
+    ARCH_DEP( or_storage_key_by_ptr )( w->sk[0], (STORKEY_REF | STORKEY_CHANGE) );
+    if (w->m[1])
+        ARCH_DEP( or_storage_key_by_ptr )( w->sk[1], (STORKEY_REF | STORKEY_CHANGE) );
+}
+
 /*-------------------------------------------------------------------*/
 /*                  Move characters left to right                    */
 /*              using specified keys and address spaces              */
@@ -1149,103 +1290,38 @@ inline void ARCH_DEP( move_chars )( VADR addr1, int arn1, BYTE key1,
                                     VADR addr2, int arn2, BYTE key2,
                                     int len, REGS* regs )
 {
-BYTE   *dest1,   *dest2;                /* Destination addresses     */
-BYTE   *source1, *source2;              /* Source addresses          */
-BYTE   *sk1,     *sk2;                  /* Storage key addresses     */
-int     len1,     len2;                 /* Lengths to copy           */
+OPWIN   w1, w2;                         /* Operand windows           */
+BYTE   *dest, *source;                  /* Mainstor addresses        */
+int     off, n;                         /* Offset and run length     */
 
     ITIMER_SYNC( addr2, len, regs );
 
     /* Quick out if copying just 1 byte */
     if (unlikely( !len ))
     {
-        source1 = MADDR( addr2, arn2, regs, ACCTYPE_READ,  key2 );
-        dest1   = MADDR( addr1, arn1, regs, ACCTYPE_WRITE, key1 );
-        *dest1 = *source1;
+        source = MADDR( addr2, arn2, regs, ACCTYPE_READ,  key2 );
+        dest   = MADDR( addr1, arn1, regs, ACCTYPE_WRITE, key1 );
+        *dest = *source;
         ITIMER_UPDATE( addr1, len, regs );
         return;
     }
 
-    /* Translate addresses of leftmost operand bytes */
-    source1 = MADDRL( addr2, len+1, arn2, regs, ACCTYPE_READ, key2 );
-    dest1   = MADDRL( addr1, len+1, arn1, regs, ACCTYPE_WRITE_SKP, key1 );
-    sk1 = regs->dat.storkey;
+    /* Translate both operands (and both pages of each if needed) */
+    ARCH_DEP( opwin )( &w2, addr2, len, arn2, regs, ACCTYPE_READ,      key2 );
+    ARCH_DEP( opwin )( &w1, addr1, len, arn1, regs, ACCTYPE_WRITE_SKP, key1 );
 
-    /* There are several scenarios (in optimal order):
-     * (1) dest boundary and source boundary not crossed
-     * (2) dest boundary not crossed and source boundary crossed
-     * (3) dest boundary crossed and source boundary not crossed
-     * (4) dest boundary and source boundary are crossed
-     *     (a) dest and source boundary cross at the same time
-     *     (b) dest boundary crossed first
-     *     (c) source boundary crossed first
-     * Note: since the operand length is limited to 256 bytes,
-     *       neither operand can cross more than one 2K boundary.
-     */
-    if (NOCROSSPAGE( addr1, len ))
+    /* Copy each run of bytes contiguous in both operands. Since the
+       operand length is limited to 256 bytes there are at most three
+       such runs (when each operand crosses a boundary at a different
+       point) and just one when neither operand crosses a boundary. */
+    for (off=0; off < w1.len; off += n)
     {
-        if (NOCROSSPAGE( addr2, len ))
-        {
-            /* (1) - No boundaries are crossed */
-            concpy( regs, dest1, source1, len + 1 );
-        }
-        else
-        {
-            /* (2) - Source operand crosses a boundary */
-            len1 = PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK);
-            source2 = MADDRL( (addr2 + len1) & ADDRESS_MAXWRAP( regs ),
-                   len + 1 - len1, arn2, regs, ACCTYPE_READ, key2 );
-
-            concpy( regs, dest1,        source1,       len1     );
-            concpy( regs, dest1 + len1, source2, len - len1 + 1 );
-        }
-        *sk1 |= (STORKEY_REF | STORKEY_CHANGE);
+        n = opwin_run( &w1, &w2, off, &dest, &source );
+        concpy( regs, dest, source, n );
     }
-    else
-    {
-        /* Destination operand crosses a boundary */
-        len1 = PAGEFRAME_PAGESIZE - (addr1 & PAGEFRAME_BYTEMASK);
-        dest2 = MADDRL( (addr1 + len1) & ADDRESS_MAXWRAP( regs ),
-            len + 1 - len1, arn1, regs, ACCTYPE_WRITE_SKP, key1 );
-        sk2 = regs->dat.storkey;
 
-        if (NOCROSSPAGE( addr2, len ))
-        {
-             /* (3) - Source operand crosses a boundary */
-             concpy( regs, dest1, source1,              len1     );
-             concpy( regs, dest2, source1 + len1, len - len1 + 1 );
-        }
-        else
-        {
-            /* (4) - Both operands cross a boundary */
-            len2 = PAGEFRAME_PAGESIZE - (addr2 & PAGEFRAME_BYTEMASK);
-            source2 = MADDRL( (addr2 + len2) & ADDRESS_MAXWRAP( regs ),
-                len + 1 - len2, arn2, regs, ACCTYPE_READ, key2 );
+    ARCH_DEP( opwin_changed )( &w1 );
 
-            if (len1 == len2)
-            {
-                /* (4a) - Both operands cross at the same time */
-                concpy( regs, dest1, source1,       len1     );
-                concpy( regs, dest2, source2, len - len1 + 1 );
-            }
-            else if (len1 < len2)
-            {
-                /* (4b) - Destination operand crosses first */
-                concpy( regs, dest1,               source1,               len1     );
-                concpy( regs, dest2,               source1 + len1, len2 - len1     );
-                concpy( regs, dest2 + len2 - len1, source2,        len  - len2 + 1 );
-            }
-            else
-            {
-                /* (4c) - Source operand crosses first */
-                concpy( regs, dest1,        source1,                      len2     );
-                concpy( regs, dest1 + len2, source2,               len1 - len2     );
-                concpy( regs, dest2,        source2 + len1 - len2, len -  len1 + 1 );
-            }
-        }
-        *sk1 |= (STORKEY_REF | STORKEY_CHANGE);
-        *sk2 |= (STORKEY_REF | STORKEY_CHANGE);
-    }
     ITIMER_UPDATE( addr1, len, regs );
 
 } /* end function ARCH_DEP(move_chars) */
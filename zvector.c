@@ -74,6 +74,117 @@ static void vector_processing_trap( REGS *regs, int vix, U32 vic )
     regs->program_interrupt( regs, PGM_VECTOR_PROCESSING_EXCEPTION );
 }
 
+/*-------------------------------------------------------------------*/
+/* Host SIMD helpers                                                 */
+/*                                                                   */
+/* Used only where feat900.h allows intrinsics (FEATURE_V128_SSE),  */
+/* so they need no run-time CPU check. On x64 hosts a vector         */
+/* register is stored byte reversed (see VR_B), so lane k of an      */
+/* element size holds the element (count-1-k); element-wise          */
+/* operations are unaffected, and zv_first() maps a movemask back to */
+/* the lowest indexed element. Other hosts keep the scalar code,     */
+/* which the compiler vectorizes.                                    */
+/*-------------------------------------------------------------------*/
+#if defined( FEATURE_V128_SSE )
+
+#define ZV_SIMD
+
+/* Broadcast an element of size m4 (0=byte ... 2=word) */
+static INLINE __m128i zv_set1( U32 e, int m4 )
+{
+    switch (m4)
+    {
+    case 0:  return _mm_set1_epi8 ( (char)  e );
+    case 1:  return _mm_set1_epi16( (short) e );
+    default: return _mm_set1_epi32( (int)   e );
+    }
+}
+
+/* Element-wise equal compare for element size m4 (0-2) */
+static INLINE __m128i zv_cmpeq( __m128i a, __m128i b, int m4 )
+{
+    switch (m4)
+    {
+    case 0:  return _mm_cmpeq_epi8 ( a, b );
+    case 1:  return _mm_cmpeq_epi16( a, b );
+    default: return _mm_cmpeq_epi32( a, b );
+    }
+}
+
+/* Element-wise unsigned greater-than compare for size m4 (0-2) */
+static INLINE __m128i zv_cmpgt_u( __m128i a, __m128i b, int m4 )
+{
+    __m128i bias = zv_set1( 0x80000000 >> (32 - (8 << m4)), m4 );
+
+    a = _mm_xor_si128( a, bias );
+    b = _mm_xor_si128( b, bias );
+
+    switch (m4)
+    {
+    case 0:  return _mm_cmpgt_epi8 ( a, b );
+    case 1:  return _mm_cmpgt_epi16( a, b );
+    default: return _mm_cmpgt_epi32( a, b );
+    }
+}
+
+/* Byte index of the lowest indexed element set in a movemask, or 16 */
+static INLINE int zv_first( U32 mask, int m4 )
+{
+    int  hi;
+
+    if (!mask)
+        return 16;
+#if defined( _MSC_VER )
+    {
+        unsigned long  b;
+        _BitScanReverse( &b, mask );
+        hi = (int) b;
+    }
+#else
+    hi = 31 - __builtin_clz( mask );
+#endif
+    return (15 - hi) & ~((1 << m4) - 1);
+}
+
+/* Common result and condition code of VFAE and VSTRC, given the
+   element-wise compare results (irt1) and zero search hits (irt2) */
+static INLINE void zv_string_result( REGS* regs, int v1, int m4,
+                                     __m128i irt1, __m128i irt2,
+                                     bool in, bool rt, bool zs, bool cs )
+{
+    int  lxt1, lxt2;
+
+    if (in)
+        irt1 = _mm_xor_si128( irt1, _mm_set1_epi32( -1 ));
+
+    lxt1 = zv_first( _mm_movemask_epi8( irt1 ), m4 );
+    lxt2 = zs ? zv_first( _mm_movemask_epi8( irt2 ), m4 ) : 16;
+
+    if (rt)
+        regs->VR_Q( v1 ).v = irt1;
+    else
+    {
+        regs->VR_D( v1, 0 ) = min( lxt1, lxt2 );
+        regs->VR_D( v1, 1 ) = 0;
+    }
+
+    if (cs)
+    {
+        // cc 1 and 3 are possible when ZS is 0 or 1.
+        if (lxt1 == 16 && lxt2 == 16)
+            regs->psw.cc = 3;
+        else if (lxt1 < 16 && lxt2 == 16)
+            regs->psw.cc = 1;
+        // cc 0 and 2 are only possible when ZS is 1.
+        else if (lxt1 < lxt2)
+            regs->psw.cc = 2;
+        else
+            regs->psw.cc = 0;
+    }
+}
+
+#endif /* defined( FEATURE_V128_SSE ) */
+
 #endif /*!defined(_ZVECTOR_ARCH_INDEPENDENT_)*/
 
 /*===================================================================*/
@@ -2797,6 +2908,25 @@ DEF_INST( vector_find_element_equal )
     zf = ef = FALSE;
     zi = ei = 16;     // Number of bytes in vector
 
+#if defined( ZV_SIMD )
+    {
+        __m128i  x = regs->VR_Q( v2 ).v;
+        U32      mask;
+
+        UNREFERENCED( i );
+
+        mask = _mm_movemask_epi8( zv_cmpeq( x, regs->VR_Q( v3 ).v, m4 ));
+        ef = (mask != 0);
+        ei = zv_first( mask, m4 );
+
+        if (M5_ZS)
+        {
+            mask = _mm_movemask_epi8( zv_cmpeq( x, _mm_setzero_si128(), m4 ));
+            zf = (mask != 0);
+            zi = zv_first( mask, m4 );
+        }
+    }
+#else
     switch (m4)
     {
     case 0:  /* Byte */
@@ -2869,6 +2999,7 @@ DEF_INST( vector_find_element_equal )
         }
         break;
     }
+#endif
 
     if (ef == TRUE)
     {
@@ -2939,6 +3070,33 @@ DEF_INST( vector_find_element_not_equal )
     zi = nei = 16;  // Number of bytes in vector
     newcc = 3;  // All equal, no zero
 
+#if defined( ZV_SIMD )
+    {
+        __m128i  x = regs->VR_Q( v2 ).v;
+        U32      mask;
+
+        mask = 0xFFFF & ~_mm_movemask_epi8( zv_cmpeq( x, regs->VR_Q( v3 ).v, m4 ));
+        if (mask)
+        {
+            nef = TRUE;
+            nei = zv_first( mask, m4 );
+            i   = nei >> m4;
+            switch (m4)
+            {
+            case 0:  newcc = (regs->VR_B(v2,i) < regs->VR_B(v3,i)) ? 1 : 2; break;
+            case 1:  newcc = (regs->VR_H(v2,i) < regs->VR_H(v3,i)) ? 1 : 2; break;
+            default: newcc = (regs->VR_F(v2,i) < regs->VR_F(v3,i)) ? 1 : 2; break;
+            }
+        }
+
+        if (M5_ZS)
+        {
+            mask = _mm_movemask_epi8( zv_cmpeq( x, _mm_setzero_si128(), m4 ));
+            zf = (mask != 0);
+            zi = zv_first( mask, m4 );
+        }
+    }
+#else
     switch (m4)
     {
     case 0:  /* Byte */
@@ -3014,6 +3172,7 @@ DEF_INST( vector_find_element_not_equal )
         }
         break;
     }
+#endif
 
     if (nef == TRUE)
     {
@@ -3085,9 +3244,11 @@ DEF_INST( vector_find_any_element_equal )
 
     int     v1, v2, v3, m4, m5;
     int     i, j;
+#if !defined( ZV_SIMD )
     int     lxt1, lxt2;                // Lowest indexed true
     int     mxt;                       // Maximum indexed true
     BYTE    irt1[16], irt2[16];        // First and second intermediate results
+#endif
 
     VRR_B( inst, regs, v1, v2, v3, m4, m5 );
 
@@ -3098,6 +3259,29 @@ DEF_INST( vector_find_any_element_equal )
 #define M5_ZS ((m5 & 0x2) != 0) // Zero Search
 #define M5_CS ((m5 & 0x1) != 0) // Condition Code Set
 
+#if defined( ZV_SIMD )
+    if (m4 > 2)
+        ARCH_DEP( program_interrupt )( regs, PGM_SPECIFICATION_EXCEPTION );
+    {
+        __m128i  x   = regs->VR_Q( v2 ).v;
+        __m128i  any = _mm_setzero_si128();
+        U32      e;
+
+        // Compare the elements of the second operand with each
+        // element of the third operand
+        for (i = 0, j = 16 >> m4; i < j; i++)
+        {
+            e = (m4 == 0) ? regs->VR_B( v3, i )
+              : (m4 == 1) ? regs->VR_H( v3, i )
+              :             regs->VR_F( v3, i );
+            any = _mm_or_si128( any, zv_cmpeq( x, zv_set1( e, m4 ), m4 ));
+        }
+
+        zv_string_result( regs, v1, m4, any,
+                          zv_cmpeq( x, _mm_setzero_si128(), m4 ),
+                          M5_IN, M5_RT, M5_ZS, M5_CS );
+    }
+#else
     for (i=0; i<16; i++)
     {
         irt1[i] = irt2[i] = FALSE;
@@ -3264,6 +3448,7 @@ DEF_INST( vector_find_any_element_equal )
         else
             regs->psw.cc = 0;
     }
+#endif
 
 #undef M5_IN
 #undef M5_RT
@@ -4178,11 +4363,14 @@ DEF_INST( vector_blend )
 DEF_INST( vector_string_range_compare )
 {
     int     v1, v2, v3, v4, m5, m6;
-    int     i, j;
+    int     j;
+#if !defined( ZV_SIMD )
+    int     i;
     int     lxt1, lxt2;                // Lowest indexed true
     int     mxt;                       // Maximum indexed true
     BYTE    irt1[16], irt2[16];        // First and second intermediate results
     BYTE    erc, orc;                  // Even and Odd range comparison results
+#endif
 
     VRR_D( inst, regs, v1, v2, v3, v4, m5, m6 );
 
@@ -4193,6 +4381,46 @@ DEF_INST( vector_string_range_compare )
 #define M6_ZS ((m6 & 0x2) != 0) // Zero Search
 #define M6_CS ((m6 & 0x1) != 0) // Condition Code Set
 
+#if defined( ZV_SIMD )
+    if (m5 > 2)
+        ARCH_DEP( program_interrupt )( regs, PGM_SPECIFICATION_EXCEPTION );
+    {
+        __m128i  x   = regs->VR_Q( v2 ).v;
+        __m128i  irt = _mm_setzero_si128();
+        __m128i  rc[2], bound;
+        U32      e, c, eq, lt, gt;
+        int      k;
+
+        eq = 0x80000000 >> (32 - (8 << m5));  // control bits of
+        lt = eq >> 1;                         // the fourth operand
+        gt = eq >> 2;                         // element
+
+        // Compare the elements of the second operand with the range
+        // formed by each even/odd element pair of the third operand
+        for (j = 0; j < (16 >> m5); j += 2)
+        {
+            for (k = 0; k < 2; k++)
+            {
+                switch (m5)
+                {
+                case 0:  e = regs->VR_B( v3, j+k ); c = regs->VR_B( v4, j+k ); break;
+                case 1:  e = regs->VR_H( v3, j+k ); c = regs->VR_H( v4, j+k ); break;
+                default: e = regs->VR_F( v3, j+k ); c = regs->VR_F( v4, j+k ); break;
+                }
+                bound = zv_set1( e, m5 );
+                rc[k] = _mm_setzero_si128();
+                if (c & eq) rc[k] = _mm_or_si128( rc[k], zv_cmpeq  ( x, bound, m5 ));
+                if (c & lt) rc[k] = _mm_or_si128( rc[k], zv_cmpgt_u( bound, x, m5 ));
+                if (c & gt) rc[k] = _mm_or_si128( rc[k], zv_cmpgt_u( x, bound, m5 ));
+            }
+            irt = _mm_or_si128( irt, _mm_and_si128( rc[0], rc[1] ));
+        }
+
+        zv_string_result( regs, v1, m5, irt,
+                          zv_cmpeq( x, _mm_setzero_si128(), m5 ),
+                          M6_IN, M6_RT, M6_ZS, M6_CS );
+    }
+#else
     for (i=0; i<16; i++)
     {
         irt1[i] = irt2[i] = FALSE;
@@ -4371,6 +4599,7 @@ DEF_INST( vector_string_range_compare )
         else
             regs->psw.cc = 0;
     }
+#endif
 
 #undef M6_IN
 #undef M6_RT
@@ -4606,8 +4835,10 @@ vector_string_search_end:
 DEF_INST( vector_permute )
 {
     int     v1, v2, v3, v4, m5, m6;
+#if !defined( ZV_SIMD )
     int     i, j;
     SV      temp;
+#endif
 
     VRR_E( inst, regs, v1, v2, v3, v4, m5, m6 );
 
@@ -4617,6 +4848,20 @@ DEF_INST( vector_permute )
 
     ZVECTOR_CHECK( regs );
 
+#if defined( ZV_SIMD )
+    {
+        /* Element j of v2||v3 is host byte 15-(j&15) of v2 or v3 */
+        __m128i  idx = _mm_and_si128( regs->VR_Q( v4 ).v, _mm_set1_epi8( 0x1f ));
+        __m128i  hix = _mm_xor_si128( _mm_and_si128( idx, _mm_set1_epi8( 0x0f )),
+                                      _mm_set1_epi8( 0x0f ));
+        __m128i  sel = _mm_cmpgt_epi8( idx, _mm_set1_epi8( 0x0f ));
+        __m128i  r2  = _mm_shuffle_epi8( regs->VR_Q( v2 ).v, hix );
+        __m128i  r3  = _mm_shuffle_epi8( regs->VR_Q( v3 ).v, hix );
+
+        regs->VR_Q( v1 ).v = _mm_or_si128( _mm_andnot_si128( sel, r2 ),
+                                           _mm_and_si128( sel, r3 ));
+    }
+#else
     SV_D( temp, 0 ) = regs->VR_D( v2, 0 );
     SV_D( temp, 1 ) = regs->VR_D( v2, 1 );
     SV_D( temp, 2 ) = regs->VR_D( v3, 0 );
@@ -4626,6 +4871,7 @@ DEF_INST( vector_permute )
         j = regs->VR_B(v4, i) & 0x1f;
         regs->VR_B(v1, i) = SV_B( temp, j );
     }
+#endif
 
     ZVECTOR_END( regs );
 }
@@ -7440,6 +7686,21 @@ DEF_INST(vector_add)
 
     ZVECTOR_CHECK(regs);
 
+#if defined( ZV_SIMD )
+    if (m4 <= 3)
+    {
+        __m128i  a = regs->VR_Q(v2).v, b = regs->VR_Q(v3).v;
+
+        switch (m4)
+        {
+        case 0:  regs->VR_Q(v1).v = _mm_add_epi8 ( a, b ); break;
+        case 1:  regs->VR_Q(v1).v = _mm_add_epi16( a, b ); break;
+        case 2:  regs->VR_Q(v1).v = _mm_add_epi32( a, b ); break;
+        default: regs->VR_Q(v1).v = _mm_add_epi64( a, b ); break;
+        }
+    }
+    else
+#endif
     switch (m4)
     {
     case 0:  /* Byte */
@@ -7553,6 +7814,21 @@ DEF_INST(vector_subtract)
 
     ZVECTOR_CHECK(regs);
 
+#if defined( ZV_SIMD )
+    if (m4 <= 3)
+    {
+        __m128i  a = regs->VR_Q(v2).v, b = regs->VR_Q(v3).v;
+
+        switch (m4)
+        {
+        case 0:  regs->VR_Q(v1).v = _mm_sub_epi8 ( a, b ); break;
+        case 1:  regs->VR_Q(v1).v = _mm_sub_epi16( a, b ); break;
+        case 2:  regs->VR_Q(v1).v = _mm_sub_epi32( a, b ); break;
+        default: regs->VR_Q(v1).v = _mm_sub_epi64( a, b ); break;
+        }
+    }
+    else
+#endif
     switch (m4)
     {
     case 0:  /* Byte */
@@ -7610,6 +7886,18 @@ DEF_INST( vector_compare_equal )
     if ( m4 == 4 && !FACILITY_ENABLED( 198_VECTOR_ENH_3, regs ) )
         ARCH_DEP( program_interrupt )( regs, PGM_SPECIFICATION_EXCEPTION );
 
+#if defined( ZV_SIMD )
+    if (m4 <= 2)
+    {
+        __m128i  r = zv_cmpeq( regs->VR_Q( v2 ).v, regs->VR_Q( v3 ).v, m4 );
+        U32      mask = _mm_movemask_epi8( r );
+
+        regs->VR_Q( v1 ).v = r;
+        el = 16;
+        eq = (mask == 0xFFFF) ? 16 : (mask != 0) ? 1 : 0;
+    }
+    else
+#endif
     switch (m4)
     {
     case 0:  /* Byte */